@@ -0,0 +1,255 @@
+#include "AgentEnv.h"
+
+/*
+================================================================================================
+
+	AgentEnv
+
+================================================================================================
+*/
+
+static const size_t CACHE_LINE_SIZE = 64;
+
+// how many envs each job steps, small enough to balance across workers but big enough that the job overhead disappears
+static const u32 ENVS_PER_JOB = 256;
+
+static const float32 ACTION_MOVE_DIRECTIONS[] = {
+	0.0f,	// AGENT_ACTION_IDLE
+	-1.0f,	// AGENT_ACTION_LEFT
+	1.0f,	// AGENT_ACTION_RIGHT
+};
+
+/*
+========================
+AgentEnv::AgentEnv
+========================
+*/
+AgentEnv::AgentEnv() {
+	mWorlds = nullptr;
+	mNumEnvs = 0;
+	mNumBlockWords = 0;
+
+	mStateMemory = nullptr;
+
+	mTickDelta = 0.0f;
+
+	mJobSystem = nullptr;
+
+	mJobActions = nullptr;
+	mJobBuffers = nullptr;
+}
+
+/*
+========================
+AgentEnv::~AgentEnv
+========================
+*/
+AgentEnv::~AgentEnv() {
+	Shutdown();
+}
+
+/*
+========================
+AgentEnv::Init
+========================
+*/
+void AgentEnv::Init( const blockTable_t* blockTable, const u32 numEnvs, const u32 seed, const float32 tickDelta ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call AgentEnv::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( numEnvs > 0 ), "AgentEnv needs at least one env!\n" );
+
+	mNumEnvs = numEnvs;
+	mNumBlockWords = ( blockTable->GetNumBlocks() + 31 ) / 32;
+	mTickDelta = tickDelta;
+
+	// same layout as the batch runner, every state on its own cache lines so workers never share one
+	size_t stateSize = GameState::CalcSizeBytes( blockTable->GetNumBlocks() );
+	size_t stateStride = ( stateSize + CACHE_LINE_SIZE - 1 ) & ~( CACHE_LINE_SIZE - 1 );
+
+	mStateMemory = new u8[( stateStride * mNumEnvs ) + CACHE_LINE_SIZE];
+	u8* alignedMemory = reinterpret_cast<u8*>( ( reinterpret_cast<uintptr_t>( mStateMemory ) + CACHE_LINE_SIZE - 1 ) & ~( CACHE_LINE_SIZE - 1 ) );
+
+	mWorlds = new GameWorld[mNumEnvs];
+
+	for ( u32 envIndex = 0; envIndex < mNumEnvs; envIndex++ ) {
+		u32 envSeed = seed ^ ( ( envIndex + 1 ) * 0x9E3779B9 );
+		mWorlds[envIndex].Init( blockTable, envSeed, alignedMemory + ( envIndex * stateStride ) );
+	}
+}
+
+/*
+========================
+AgentEnv::Shutdown
+========================
+*/
+void AgentEnv::Shutdown() {
+	// the worlds don't own their state memory so they have to go first
+	delete[] mWorlds;
+	mWorlds = nullptr;
+
+	delete[] mStateMemory;
+	mStateMemory = nullptr;
+
+	mNumEnvs = 0;
+	mNumBlockWords = 0;
+}
+
+/*
+========================
+AgentEnv::Reset
+========================
+*/
+void AgentEnv::Reset( const agentBuffers_t& outBuffers ) {
+	mJobBuffers = &outBuffers;
+
+	RunJobs( ResetJob );
+
+	mJobBuffers = nullptr;
+}
+
+/*
+========================
+AgentEnv::Step
+========================
+*/
+void AgentEnv::Step( const u8* actions, const agentBuffers_t& outBuffers ) {
+	mJobActions = actions;
+	mJobBuffers = &outBuffers;
+
+	RunJobs( StepJob );
+
+	mJobActions = nullptr;
+	mJobBuffers = nullptr;
+}
+
+/*
+========================
+AgentEnv::Observe
+========================
+*/
+void AgentEnv::Observe( const agentBuffers_t& outBuffers ) const {
+	for ( u32 envIndex = 0; envIndex < mNumEnvs; envIndex++ ) {
+		ObserveEnv( envIndex, outBuffers );
+	}
+}
+
+/*
+========================
+AgentEnv::ResetEnv
+========================
+*/
+void AgentEnv::ResetEnv( const u32 envIndex ) {
+	GameWorld& world = mWorlds[envIndex];
+
+	// the random state carries on from the last episode so every episode plays out differently
+	world.ResetLevel();
+
+	// agents don't get to sit on the start screen
+	world.GetState().GetHeader().mCurrentState = GAME_STATE_PLAYING;
+}
+
+/*
+========================
+AgentEnv::ObserveEnv
+========================
+*/
+void AgentEnv::ObserveEnv( const u32 envIndex, const agentBuffers_t& outBuffers ) const {
+	const GameState& state = mWorlds[envIndex].GetState();
+	const gameStateHeader_t& header = state.GetHeader();
+
+	if ( outBuffers.mBallPositions ) {
+		outBuffers.mBallPositions[( envIndex * 2 ) + 0] = header.mBallPosition.x;
+		outBuffers.mBallPositions[( envIndex * 2 ) + 1] = header.mBallPosition.y;
+	}
+
+	if ( outBuffers.mBallVelocities ) {
+		glm::vec2 velocity = header.mBallDirection * header.mBallMoveSpeed;
+		outBuffers.mBallVelocities[( envIndex * 2 ) + 0] = velocity.x;
+		outBuffers.mBallVelocities[( envIndex * 2 ) + 1] = velocity.y;
+	}
+
+	if ( outBuffers.mPaddlePositions ) {
+		outBuffers.mPaddlePositions[envIndex] = header.mPlayerPosition.x;
+	}
+
+	if ( outBuffers.mBlockBits ) {
+		memcpy( outBuffers.mBlockBits + ( envIndex * mNumBlockWords ), state.GetBlockBits(), mNumBlockWords * sizeof( u32 ) );
+	}
+}
+
+/*
+========================
+AgentEnv::RunJobs
+========================
+*/
+void AgentEnv::RunJobs( jobFunc_t func ) {
+	if ( mJobSystem ) {
+		mJobSystem->ParallelFor( mNumEnvs, ENVS_PER_JOB, func, this );
+	} else {
+		func( this, 0, mNumEnvs, JobSystem::GetWorkerIndex() );
+	}
+}
+
+/*
+========================
+AgentEnv::ResetJob
+========================
+*/
+void AgentEnv::ResetJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	AgentEnv* env = static_cast<AgentEnv*>( data );
+
+	for ( u32 envIndex = start; envIndex < end; envIndex++ ) {
+		env->ResetEnv( envIndex );
+		env->ObserveEnv( envIndex, *env->mJobBuffers );
+	}
+}
+
+/*
+========================
+AgentEnv::StepJob
+========================
+*/
+void AgentEnv::StepJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	AgentEnv* env = static_cast<AgentEnv*>( data );
+	const agentBuffers_t& buffers = *env->mJobBuffers;
+
+	worldInput_t input = {};
+	input.mStartPressed = true;	// so that losing a life carries straight on
+
+	for ( u32 envIndex = start; envIndex < end; envIndex++ ) {
+		GameWorld& world = env->mWorlds[envIndex];
+		const gameStateHeader_t& header = world.GetState().GetHeader();
+
+		u8 action = env->mJobActions[envIndex];
+		assertf( ( action <= AGENT_ACTION_RIGHT ), "Invalid agent action!\n" );
+
+		input.mMoveDirection = ACTION_MOVE_DIRECTIONS[action];
+
+		u32 scoreBefore = header.mPlayerScore;
+
+		world.Tick( input, env->mTickDelta );
+
+		bool32 done = header.mCurrentState == GAME_STATE_HIGH_SCORE;
+
+		if ( buffers.mRewards ) {
+			buffers.mRewards[envIndex] = static_cast<float32>( header.mPlayerScore - scoreBefore );
+		}
+
+		if ( buffers.mDones ) {
+			buffers.mDones[envIndex] = done ? 1 : 0;
+		}
+
+		if ( done ) {
+			env->ResetEnv( envIndex );
+		}
+
+		env->ObserveEnv( envIndex, buffers );
+	}
+}
\ No newline at end of file
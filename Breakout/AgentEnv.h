@@ -0,0 +1,92 @@
+#ifndef __AGENT_ENV_H__
+#define __AGENT_ENV_H__
+
+#include <mstd/mstd.h>
+
+#include "GameWorld.h"
+#include "JobSystem.h"
+
+enum agentAction_t {
+	AGENT_ACTION_IDLE	= 0,
+	AGENT_ACTION_LEFT,
+	AGENT_ACTION_RIGHT,
+};
+
+// caller-owned output buffers, laid out one env after another
+// any of these can be null if the caller doesn't want them
+struct agentBuffers_t {
+	float32*				mBallPositions;		// 2 floats per env
+	float32*				mBallVelocities;	// 2 floats per env
+	float32*				mPaddlePositions;	// 1 float per env (x only, the paddle never moves vertically)
+	u32*					mBlockBits;			// GetNumBlockWords() u32s per env, bit set means the block is still there
+	float32*				mRewards;			// 1 float per env, only written by Step()
+	u8*						mDones;				// 1 byte per env, only written by Step()
+};
+
+/*
+================================================================================================
+
+	Breakout Agent Environment
+
+	A gym-style reset/step/observe API over a vector of GameWorlds for training bots.
+
+	Every call works on the whole vector at once and writes straight into buffers the caller
+	owns, so nothing gets allocated or copied through anything in between. If a job system is
+	given the envs get split across its workers.
+
+	Reward is the score gained that step. Losing a life doesn't end an episode, losing the last
+	one or clearing every block does. Envs that finish get reset straight away inside Step(),
+	so the observation written for a done env is the first one of its next episode.
+
+================================================================================================
+*/
+
+class AgentEnv {
+public:
+							AgentEnv();
+							~AgentEnv();
+
+	// the block table is shared by every env and MUST outlive this
+	void					Init( const blockTable_t* blockTable, const u32 numEnvs, const u32 seed, const float32 tickDelta );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mWorlds != nullptr; }
+
+	inline u32				GetNumEnvs() const { return mNumEnvs; }
+	inline u32				GetNumBlockWords() const { return mNumBlockWords; }
+
+	// null means run everything on the calling thread
+	inline void				SetJobSystem( JobSystem* jobSystem ) { mJobSystem = jobSystem; }
+
+	void					Reset( const agentBuffers_t& outBuffers );
+
+	// actions MUST have GetNumEnvs() entries, each one an agentAction_t
+	void					Step( const u8* actions, const agentBuffers_t& outBuffers );
+
+	void					Observe( const agentBuffers_t& outBuffers ) const;
+
+private:
+	GameWorld*				mWorlds;
+	u32						mNumEnvs;
+	u32						mNumBlockWords;
+
+	u8*						mStateMemory;
+
+	float32					mTickDelta;
+
+	JobSystem*				mJobSystem;
+
+	// only valid for the duration of a Step() or Reset() so the jobs can get at them
+	const u8*				mJobActions;
+	const agentBuffers_t*	mJobBuffers;
+
+private:
+	void					ResetEnv( const u32 envIndex );
+	void					ObserveEnv( const u32 envIndex, const agentBuffers_t& outBuffers ) const;
+
+	void					RunJobs( jobFunc_t func );
+
+	static void				ResetJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+	static void				StepJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+#endif // __AGENT_ENV_H__
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "BatchRunner.h"
+
+#include "JobSystem.h"
+
+/*
+================================================================================================
+
+	BatchRunner
+
+================================================================================================
+*/
+
+static const size_t CACHE_LINE_SIZE = 64;
+
+/*
+========================
+BotRandom
+========================
+*/
+static float32 BotRandom( u32& state, const float32 min, const float32 max ) {
+	// same xorshift32 as the game state, but the bot keeps its own state so it doesn't change the world's random numbers
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	float32 t = static_cast<float32>( state >> 8 ) / static_cast<float32>( 1 << 24 );
+	return min + ( max - min ) * t;
+}
+
+/*
+========================
+WorldSeed
+========================
+*/
+static u32 WorldSeed( const u32 batchSeed, const u32 worldIndex ) {
+	u32 seed = batchSeed ^ ( ( worldIndex + 1 ) * 0x9E3779B9 );
+
+	// xorshift can't start at 0
+	return ( seed != 0 ) ? seed : 1;
+}
+
+/*
+========================
+BatchRunner::BatchRunner
+========================
+*/
+BatchRunner::BatchRunner() {
+	memset( &mDesc, 0, sizeof( batchDesc_t ) );
+
+	mWorlds = nullptr;
+	mOutcomes = nullptr;
+
+	mStateMemory = nullptr;
+	mStateStride = 0;
+}
+
+/*
+========================
+BatchRunner::~BatchRunner
+========================
+*/
+BatchRunner::~BatchRunner() {
+	Shutdown();
+}
+
+/*
+========================
+BatchRunner::Init
+========================
+*/
+void BatchRunner::Init( const blockTable_t* blockTable, const batchDesc_t& desc ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call BatchRunner::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( desc.mNumWorlds > 0 ), "A batch needs at least one world!\n" );
+
+	mDesc = desc;
+
+	size_t stateSize = GameState::CalcSizeBytes( blockTable->GetNumBlocks() );
+	mStateStride = ( stateSize + CACHE_LINE_SIZE - 1 ) & ~( CACHE_LINE_SIZE - 1 );
+
+	// over-allocate by a line so the first state can be aligned
+	mStateMemory = new u8[( mStateStride * mDesc.mNumWorlds ) + CACHE_LINE_SIZE];
+	u8* alignedMemory = reinterpret_cast<u8*>( ( reinterpret_cast<uintptr_t>( mStateMemory ) + CACHE_LINE_SIZE - 1 ) & ~( CACHE_LINE_SIZE - 1 ) );
+
+	mWorlds = new GameWorld[mDesc.mNumWorlds];
+	mOutcomes = new worldOutcome_t[mDesc.mNumWorlds];
+
+	for ( u32 worldIndex = 0; worldIndex < mDesc.mNumWorlds; worldIndex++ ) {
+		mWorlds[worldIndex].Init( blockTable, WorldSeed( mDesc.mSeed, worldIndex ), alignedMemory + ( worldIndex * mStateStride ) );
+	}
+
+	memset( mOutcomes, 0, mDesc.mNumWorlds * sizeof( worldOutcome_t ) );
+}
+
+/*
+========================
+BatchRunner::Shutdown
+========================
+*/
+void BatchRunner::Shutdown() {
+	// the worlds don't own their state memory so they have to go first
+	delete[] mWorlds;
+	mWorlds = nullptr;
+
+	delete[] mOutcomes;
+	mOutcomes = nullptr;
+
+	delete[] mStateMemory;
+	mStateMemory = nullptr;
+	mStateStride = 0;
+}
+
+/*
+========================
+BatchRunner::Run
+========================
+*/
+void BatchRunner::Run( JobSystem* jobSystem, batchResults_t& outResults ) {
+	assertf( IsInitialised(), "BatchRunner::Run() called before BatchRunner::Init()!\n" );
+
+	u32 numWorkers = jobSystem->GetNumWorkers();
+
+	// a few jobs per worker so that one worker getting a run of long games doesn't hold everyone up
+	u32 granularity = max( mDesc.mNumWorlds / ( numWorkers * 8 ), 1u );
+
+	timestamp_t start = timeNow();
+	jobSystem->ParallelFor( mDesc.mNumWorlds, granularity, RunWorldsJob, this );
+	timestamp_t end = timeNow();
+
+	memset( &outResults, 0, sizeof( batchResults_t ) );
+	outResults.mNumWorlds = mDesc.mNumWorlds;
+	outResults.mNumWorkers = numWorkers;
+	outResults.mMilliseconds = deltaMilliseconds( start, end );
+	outResults.mMinScore = UINT32_MAX;
+
+	u64 totalScore = 0;
+
+	for ( u32 worldIndex = 0; worldIndex < mDesc.mNumWorlds; worldIndex++ ) {
+		const worldOutcome_t& outcome = mOutcomes[worldIndex];
+
+		outResults.mTotalTicks += outcome.mTicks;
+
+		outResults.mNumCleared += outcome.mCleared ? 1 : 0;
+		outResults.mNumTimedOut += outcome.mTimedOut ? 1 : 0;
+
+		outResults.mMinScore = min( outResults.mMinScore, outcome.mScore );
+		outResults.mMaxScore = max( outResults.mMaxScore, outcome.mScore );
+		totalScore += outcome.mScore;
+	}
+
+	outResults.mTicksPerSecond = outResults.mTotalTicks / ( outResults.mMilliseconds / 1000.0 );
+	outResults.mAverageScore = static_cast<float32>( static_cast<float64>( totalScore ) / mDesc.mNumWorlds );
+	outResults.mAverageTicks = static_cast<float32>( static_cast<float64>( outResults.mTotalTicks ) / mDesc.mNumWorlds );
+}
+
+/*
+========================
+BatchRunner::PrintResults
+========================
+*/
+void BatchRunner::PrintResults( const batchResults_t& results ) {
+	printf( "Worlds:       %u (%u workers)\n", results.mNumWorlds, results.mNumWorkers );
+	printf( "Total ticks:  %llu in %.2f ms (%.0f ticks/s)\n", results.mTotalTicks, results.mMilliseconds, results.mTicksPerSecond );
+	printf( "Cleared:      %u\n", results.mNumCleared );
+	printf( "Timed out:    %u\n", results.mNumTimedOut );
+	printf( "Score:        min %u, max %u, avg %.2f\n", results.mMinScore, results.mMaxScore, results.mAverageScore );
+	printf( "Ticks/world:  avg %.2f\n", results.mAverageTicks );
+}
+
+/*
+========================
+BatchRunner::RunWorld
+========================
+*/
+void BatchRunner::RunWorld( const u32 worldIndex ) {
+	GameWorld& world = mWorlds[worldIndex];
+	const gameStateHeader_t& state = world.GetState().GetHeader();
+
+	// re-seed as well as reset so that running the batch again plays out exactly the same
+	world.GetState().GetHeader().mRandomState = WorldSeed( mDesc.mSeed, worldIndex );
+	world.ResetLevel();
+
+	u32 botRandomState = WorldSeed( ~mDesc.mSeed, worldIndex );
+
+	float32 aimOffset = BotRandom( botRandomState, -mDesc.mBot.mAimError, mDesc.mBot.mAimError );
+
+	worldInput_t input = {};
+	input.mStartPressed = true;
+
+	u32 tick = 0;
+	for ( ; tick < mDesc.mMaxTicks && state.mCurrentState != GAME_STATE_HIGH_SCORE; tick++ ) {
+		float32 distance = ( state.mBallPosition.x + aimOffset ) - state.mPlayerPosition.x;
+
+		if ( distance > mDesc.mBot.mDeadZone ) {
+			input.mMoveDirection = 1.0f;
+		} else if ( distance < -mDesc.mBot.mDeadZone ) {
+			input.mMoveDirection = -1.0f;
+		} else {
+			input.mMoveDirection = 0.0f;
+		}
+
+		u32 events = world.Tick( input, mDesc.mTickDelta );
+
+		if ( events & GAME_EVENT_BIT( GAME_EVENT_HIT_PLAYER ) ) {
+			aimOffset = BotRandom( botRandomState, -mDesc.mBot.mAimError, mDesc.mBot.mAimError );
+		}
+	}
+
+	worldOutcome_t& outcome = mOutcomes[worldIndex];
+	outcome.mScore = state.mPlayerScore;
+	outcome.mBlocksHit = state.mHitBlocks;
+	outcome.mLivesLeft = state.mPlayerLives;
+	outcome.mTicks = tick;
+	outcome.mCleared = state.mHitBlocks == world.GetState().GetNumBlocks();
+	outcome.mTimedOut = state.mCurrentState != GAME_STATE_HIGH_SCORE;
+}
+
+/*
+========================
+BatchRunner::RunWorldsJob
+========================
+*/
+void BatchRunner::RunWorldsJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	BatchRunner* runner = static_cast<BatchRunner*>( data );
+
+	for ( u32 worldIndex = start; worldIndex < end; worldIndex++ ) {
+		runner->RunWorld( worldIndex );
+	}
+}
\ No newline at end of file
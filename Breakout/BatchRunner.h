@@ -0,0 +1,100 @@
+#ifndef __BATCH_RUNNER_H__
+#define __BATCH_RUNNER_H__
+
+#include <mstd/mstd.h>
+
+#include "GameWorld.h"
+
+class JobSystem;
+
+// a simple paddle bot that chases the ball
+struct botParams_t {
+	float32					mAimError;		// how far off the ball the bot aims, re-rolled every time it hits the ball
+	float32					mDeadZone;		// don't move if the paddle is this close to where it's aiming
+};
+
+struct batchDesc_t {
+	u32						mNumWorlds;
+	u32						mMaxTicks;		// worlds that haven't finished by now are counted as timed out
+	float32					mTickDelta;		// seconds
+	u32						mSeed;
+
+	botParams_t				mBot;
+};
+
+struct worldOutcome_t {
+	u32						mScore;
+	u32						mBlocksHit;
+	u32						mLivesLeft;
+	u32						mTicks;
+	bool32					mCleared;
+	bool32					mTimedOut;
+};
+
+struct batchResults_t {
+	u32						mNumWorlds;
+	u32						mNumWorkers;
+
+	u64						mTotalTicks;
+	float64					mMilliseconds;
+	float64					mTicksPerSecond;
+
+	u32						mNumCleared;
+	u32						mNumTimedOut;
+
+	u32						mMinScore, mMaxScore;
+	float32					mAverageScore;
+	float32					mAverageTicks;
+};
+
+/*
+================================================================================================
+
+	Breakout Batch Runner
+
+	Runs lots of headless GameWorlds at once with a bot playing each one.
+
+	All of the world states live in one slab, each one padded out to a cache line so that two
+	workers never write to the same line. Jobs are handed contiguous ranges of worlds and run
+	each world in the range to the end before moving on to the next, so a world's state stays
+	in cache for its whole game and no locks are needed at all.
+
+	Every world is seeded from the batch seed and its index, so a batch plays out exactly the
+	same no matter how many workers run it.
+
+================================================================================================
+*/
+
+class BatchRunner {
+public:
+							BatchRunner();
+							~BatchRunner();
+
+	// the block table is shared by every world and MUST outlive the runner
+	void					Init( const blockTable_t* blockTable, const batchDesc_t& desc );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mWorlds != nullptr; }
+
+	// resets every world first, so this can be called as many times as you want
+	void					Run( JobSystem* jobSystem, batchResults_t& outResults );
+
+	inline const worldOutcome_t&	GetOutcome( const u32 worldIndex ) const { return mOutcomes[worldIndex]; }
+
+	static void				PrintResults( const batchResults_t& results );
+
+private:
+	batchDesc_t				mDesc;
+
+	GameWorld*				mWorlds;
+	worldOutcome_t*			mOutcomes;
+
+	u8*						mStateMemory;
+	size_t					mStateStride;
+
+private:
+	void					RunWorld( const u32 worldIndex );
+
+	static void				RunWorldsJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+#endif // __BATCH_RUNNER_H__
\ No newline at end of file
@@ -0,0 +1,1150 @@
+#include "Benchmark.h"
+
+#include "Defines.h"
+#include "GameState.h"
+#include "GameWorld.h"
+#include "BatchRunner.h"
+#include "AgentEnv.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include "LevelStreamer.h"
+#include "QuadScene.h"
+#include "Renderer.h"
+#include "UI.h"
+
+#include "gl/VulkanStandIn.h"
+
+/*
+================================================================================================
+
+	Benchmarks
+
+================================================================================================
+*/
+
+typedef void ( *benchmarkFunc_t )();
+
+struct benchmark_t {
+	const char*			mName;
+	benchmarkFunc_t		mFunc;
+};
+
+static const size_t BENCHMARK_BYTES_PER_RUN = 1024 * 1024 * 1024;
+
+// set by a benchmark that checks its own results and finds them wrong, so the run fails
+static bool32 gBenchmarkRegressed = false;
+
+static const u32 BENCHMARK_BLOCK_COUNTS[] = {
+	NUM_BLOCKS_MAX, 1024, 64 * 1024, 1024 * 1024
+};
+
+/*
+========================
+BenchmarkGameStateSnapshot
+========================
+*/
+static void BenchmarkGameStateSnapshot() {
+	printf( "%-10s %-12s %-14s %-14s %-10s\n", "BLOCKS", "STATE BYTES", "SNAPSHOT (us)", "RESTORE (us)", "GB/S" );
+
+	for ( u32 numBlocks : BENCHMARK_BLOCK_COUNTS ) {
+		GameState state;
+		state.Init( numBlocks );
+		state.SetAllBlocksActive();
+
+		size_t sizeBytes = state.GetSizeBytes();
+		u8* snapshot = new u8[sizeBytes];
+
+		// aim for roughly 1GB copied per run so that the small states still get a stable number
+		u32 numIterations = static_cast<u32>( max( static_cast<size_t>( 64 ), BENCHMARK_BYTES_PER_RUN / sizeBytes ) );
+
+		timestamp_t start = timeNow();
+		for ( u32 i = 0; i < numIterations; i++ ) {
+			state.Snapshot( snapshot );
+		}
+		timestamp_t end = timeNow();
+		float64 snapshotMicroseconds = deltaMilliseconds( start, end ) * 1000.0 / numIterations;
+
+		start = timeNow();
+		for ( u32 i = 0; i < numIterations; i++ ) {
+			// flip a block every time so the copies can't be skipped
+			state.SetBlockActive( i % numBlocks, ( i & 1 ) );
+			state.Restore( snapshot );
+		}
+		end = timeNow();
+		float64 restoreMicroseconds = deltaMilliseconds( start, end ) * 1000.0 / numIterations;
+
+		float64 gigabytesPerSecond = ( sizeBytes / ( snapshotMicroseconds * 1000.0 ) );
+
+		printf( "%-10u %-12zu %-14.4f %-14.4f %-10.2f\n", numBlocks, sizeBytes, snapshotMicroseconds, restoreMicroseconds, gigabytesPerSecond );
+
+		delete[] snapshot;
+		snapshot = nullptr;
+	}
+}
+
+/*
+========================
+BenchmarkBatch
+========================
+*/
+static void BenchmarkBatch() {
+	Level level;
+	level.CreateDefault();
+	const blockTable_t& blockTable = level.GetBlockTable();
+
+	batchDesc_t desc = {};
+	desc.mNumWorlds = 1024;
+	desc.mMaxTicks = 60 * 60 * 2;	// two minutes of game time at 60hz
+	desc.mTickDelta = 1.0f / 60.0f;
+	desc.mSeed = 0x1234ABCD;
+	desc.mBot.mAimError = 0.9f;
+	desc.mBot.mDeadZone = 0.1f;
+
+	BatchRunner runner;
+	runner.Init( &blockTable, desc );
+
+	u32 numHardwareThreads = max( std::thread::hardware_concurrency(), 1u );
+
+	array<batchResults_t> runs;
+
+	// every world plays out the same regardless of worker count so each run does identical work
+	for ( u32 numWorkers = 1; ; numWorkers = min( numWorkers * 2, numHardwareThreads ) ) {
+		JobSystem jobSystem;
+		jobSystem.Init( numWorkers );
+
+		batchResults_t results = {};
+		runner.Run( &jobSystem, results );
+		runs.add( results );
+
+		jobSystem.Shutdown();
+
+		if ( numWorkers == numHardwareThreads ) {
+			break;
+		}
+	}
+
+	// print after all the runs so the job system init messages don't get mixed into the table
+	printf( "%-10s %-14s %-16s %-14s\n", "WORKERS", "TIME (ms)", "TICKS/S", "EFFICIENCY (%)" );
+
+	float64 singleWorkerTicksPerSecond = runs[0].mTicksPerSecond;
+
+	for ( size_t runIndex = 0; runIndex < runs.length(); runIndex++ ) {
+		const batchResults_t& results = runs[runIndex];
+
+		float64 efficiency = results.mTicksPerSecond / ( singleWorkerTicksPerSecond * results.mNumWorkers );
+
+		printf( "%-10u %-14.2f %-16.0f %-14.2f\n", results.mNumWorkers, results.mMilliseconds, results.mTicksPerSecond, efficiency * 100.0 );
+	}
+
+	printf( "\n" );
+	BatchRunner::PrintResults( runs[runs.length() - 1] );
+
+	runner.Shutdown();
+}
+
+/*
+========================
+BenchmarkAgentEnv
+========================
+*/
+static void BenchmarkAgentEnv() {
+	const u32 numEnvs = 4096;
+	const u32 numSteps = 1000;
+
+	Level level;
+	level.CreateDefault();
+	const blockTable_t& blockTable = level.GetBlockTable();
+
+	AgentEnv env;
+	env.Init( &blockTable, numEnvs, 0x1234ABCD, 1.0f / 60.0f );
+
+	// what a training loop would own
+	array<float32> ballPositions;
+	array<float32> ballVelocities;
+	array<float32> paddlePositions;
+	array<u32> blockBits;
+	array<float32> rewards;
+	array<u8> dones;
+	array<u8> actions;
+
+	ballPositions.resize( numEnvs * 2 );
+	ballVelocities.resize( numEnvs * 2 );
+	paddlePositions.resize( numEnvs );
+	blockBits.resize( numEnvs * env.GetNumBlockWords() );
+	rewards.resize( numEnvs );
+	dones.resize( numEnvs );
+	actions.resize( numEnvs );
+
+	agentBuffers_t buffers = {};
+	buffers.mBallPositions = ballPositions.data();
+	buffers.mBallVelocities = ballVelocities.data();
+	buffers.mPaddlePositions = paddlePositions.data();
+	buffers.mBlockBits = blockBits.data();
+	buffers.mRewards = rewards.data();
+	buffers.mDones = dones.data();
+
+	JobSystem jobSystem;
+	jobSystem.Init();
+
+	printf( "%-10s %-10s %-14s %-16s %-10s\n", "WORKERS", "ENVS", "TIME (ms)", "STEPS/S", "EPISODES" );
+
+	for ( u32 pass = 0; pass < 2; pass++ ) {
+		env.SetJobSystem( ( pass == 0 ) ? nullptr : &jobSystem );
+		env.Reset( buffers );
+
+		u32 actionRandomState = 0x9E3779B9;
+		u32 numEpisodes = 0;
+
+		timestamp_t start = timeNow();
+
+		for ( u32 step = 0; step < numSteps; step++ ) {
+			// random agent, cheap enough that it doesn't show up in the timing
+			for ( u32 envIndex = 0; envIndex < numEnvs; envIndex++ ) {
+				actionRandomState ^= actionRandomState << 13;
+				actionRandomState ^= actionRandomState >> 17;
+				actionRandomState ^= actionRandomState << 5;
+
+				actions[envIndex] = static_cast<u8>( actionRandomState % 3 );
+			}
+
+			env.Step( actions.data(), buffers );
+
+			for ( u32 envIndex = 0; envIndex < numEnvs; envIndex++ ) {
+				numEpisodes += dones[envIndex];
+			}
+		}
+
+		timestamp_t end = timeNow();
+		float64 milliseconds = deltaMilliseconds( start, end );
+		float64 stepsPerSecond = ( static_cast<float64>( numEnvs ) * numSteps ) / ( milliseconds / 1000.0 );
+
+		u32 numWorkers = ( pass == 0 ) ? 1 : jobSystem.GetNumWorkers();
+
+		printf( "%-10u %-10u %-14.2f %-16.0f %-10u\n", numWorkers, numEnvs, milliseconds, stepsPerSecond, numEpisodes );
+	}
+
+	jobSystem.Shutdown();
+
+	env.Shutdown();
+}
+
+static const u32 BENCHMARK_BALL_COUNTS[] = {
+	256, 1024, 4096, 8192
+};
+
+/*
+========================
+BenchmarkMultiBall
+========================
+*/
+static void BenchmarkMultiBall() {
+	const u32 numTicks = 600;	// ten seconds at 60hz
+	const float32 tickDelta = 1.0f / 60.0f;
+
+	// a lot smaller than normal so that thousands of them can actually fit on screen without all overlapping
+	const glm::vec2 ballHalfSize( 0.04f );
+
+	Level level;
+	level.CreateDefault();
+	const blockTable_t& blockTable = level.GetBlockTable();
+
+	printf( "%-10s %-12s %-12s %-12s %-14s %-16s\n", "BALLS", "AVG (ms)", "MAX (ms)", "TICKS/S", "PAIRS TESTED", "ALL PAIRS" );
+
+	for ( u32 numBalls : BENCHMARK_BALL_COUNTS ) {
+		GameWorld world;
+		world.Init( &blockTable, 0x1234ABCD, nullptr, numBalls );
+
+		gameStateHeader_t& state = world.GetState().GetHeader();
+
+		worldInput_t input = {};
+		input.mStartPressed = true;
+
+		u32 spawnRandomState = 0x9E3779B9;
+
+		float64 totalMilliseconds = 0.0;
+		float64 maxMilliseconds = 0.0;
+		u64 totalPairs = 0;
+		u32 numTimedTicks = 0;
+
+		for ( u32 tick = 0; tick < numTicks; tick++ ) {
+			// keep the level full and the pool topped up so that every tick does the same amount of work
+			world.GetState().SetAllBlocksActive();
+			state.mHitBlocks = 0;
+			state.mPlayerLives = NUM_MAX_PLAYER_LIVES;
+			state.mBallHalfSize = ballHalfSize;
+
+			// spread them over the bottom half of the screen, spawning them all in one spot would just test the worst case
+			while ( state.mCurrentState == GAME_STATE_PLAYING && state.mNumBalls < numBalls ) {
+				spawnRandomState ^= spawnRandomState << 13;
+				spawnRandomState ^= spawnRandomState >> 17;
+				spawnRandomState ^= spawnRandomState << 5;
+
+				float32 x = ( ( spawnRandomState & 0xFFFF ) / 65535.0f ) * 2.0f - 1.0f;
+				float32 y = ( ( spawnRandomState >> 16 ) / 65535.0f );
+
+				glm::vec2 position( x * ( GameWorld::SCREEN_BOUND_RIGHT - 0.5f ), -y * ( GameWorld::SCREEN_BOUND_TOP - 1.0f ) );
+				world.SpawnBalls( 1, position );
+			}
+
+			input.mMoveDirection = ( state.mBallPosition.x > state.mPlayerPosition.x ) ? 1.0f : -1.0f;
+
+			// the main ball died, don't count the ticks that get it going again
+			if ( state.mCurrentState != GAME_STATE_PLAYING ) {
+				world.Tick( input, tickDelta );
+				continue;
+			}
+
+			timestamp_t start = timeNow();
+			world.Tick( input, tickDelta );
+			timestamp_t end = timeNow();
+
+			float64 milliseconds = deltaMilliseconds( start, end );
+			totalMilliseconds += milliseconds;
+			maxMilliseconds = max( maxMilliseconds, milliseconds );
+
+			totalPairs += world.GetNumBallPairsTested();
+			numTimedTicks++;
+		}
+
+		float64 averageMilliseconds = totalMilliseconds / numTimedTicks;
+		u64 allPairs = ( static_cast<u64>( numBalls ) * ( numBalls - 1 ) ) / 2;
+
+		printf( "%-10u %-12.4f %-12.4f %-12.0f %-14llu %-16llu\n", numBalls, averageMilliseconds, maxMilliseconds, 1000.0 / averageMilliseconds, totalPairs / numTimedTicks, allPairs );
+
+		world.Shutdown();
+	}
+}
+
+/*
+========================
+BenchmarkLevelLoad
+========================
+*/
+static void BenchmarkLevelLoad() {
+	const char* filename = "benchmark_level.lvl";
+
+	static const glm::vec4 palette[] = {
+		glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f ),
+		glm::vec4( 0.0f, 1.0f, 0.0f, 1.0f ),
+		glm::vec4( 0.0f, 0.0f, 1.0f, 1.0f ),
+	};
+
+	printf( "%-10s %-12s %-12s %-14s %-16s\n", "BLOCKS", "FILE BYTES", "LOAD (ms)", "TOUCH (ms)", "WORLD INIT (ms)" );
+
+	for ( u32 numBlocks : BENCHMARK_BLOCK_COUNTS ) {
+		// a grid of tiny blocks over the top half of the screen
+		u32 numColumns = static_cast<u32>( sqrtf( static_cast<float32>( numBlocks ) ) ) + 1;
+		u32 numRows = ( numBlocks + numColumns - 1 ) / numColumns;
+
+		glm::vec2 halfSize( GameWorld::SCREEN_BOUND_RIGHT / numColumns, ( GameWorld::SCREEN_BOUND_TOP * 0.5f ) / numRows );
+
+		glm::vec2* positions = new glm::vec2[numBlocks];
+		glm::vec2* halfSizes = new glm::vec2[numBlocks];
+		u32* colorIndices = new u32[numBlocks];
+		u32* scoreValues = new u32[numBlocks];
+		u8* hitPoints = new u8[numBlocks];
+
+		for ( u32 blockIndex = 0; blockIndex < numBlocks; blockIndex++ ) {
+			u32 column = blockIndex % numColumns;
+			u32 row = blockIndex / numColumns;
+
+			positions[blockIndex] = glm::vec2( -GameWorld::SCREEN_BOUND_RIGHT + ( ( column * 2 + 1 ) * halfSize.x ), GameWorld::SCREEN_BOUND_TOP - ( ( row * 2 + 1 ) * halfSize.y ) );
+			halfSizes[blockIndex] = halfSize;
+			colorIndices[blockIndex] = row % 3;
+			scoreValues[blockIndex] = 1;
+			hitPoints[blockIndex] = static_cast<u8>( 1 + ( row % 2 ) );
+		}
+
+		blockTable_t sourceTable = {};
+		sourceTable.mPalette = palette;
+		sourceTable.mNumColors = 3;
+		sourceTable.mPositions = positions;
+		sourceTable.mHalfSizes = halfSizes;
+		sourceTable.mColorIndices = colorIndices;
+		sourceTable.mScoreValues = scoreValues;
+		sourceTable.mHitPoints = hitPoints;
+		sourceTable.mNumBlocks = numBlocks;
+
+		if ( !Level::Write( filename, sourceTable ) ) {
+			error( "Failed to write benchmark level \"%s\"\n", filename );
+			return;
+		}
+
+		Level level;
+
+		timestamp_t start = timeNow();
+		bool32 loaded = level.Load( filename );
+		timestamp_t end = timeNow();
+		float64 loadMilliseconds = deltaMilliseconds( start, end );
+
+		if ( !loaded ) {
+			error( "Failed to load benchmark level \"%s\"\n", filename );
+			return;
+		}
+
+		const blockTable_t& blockTable = level.GetBlockTable();
+
+		// first read of every block, this is where the pages actually get pulled in
+		start = timeNow();
+		float32 sum = 0.0f;
+		for ( u32 blockIndex = 0; blockIndex < blockTable.GetNumBlocks(); blockIndex++ ) {
+			sum += blockTable.mPositions[blockIndex].x + blockTable.mHalfSizes[blockIndex].y + blockTable.mHitPoints[blockIndex];
+		}
+		end = timeNow();
+		float64 touchMilliseconds = deltaMilliseconds( start, end );
+
+		start = timeNow();
+		GameWorld world;
+		world.Init( &blockTable, 0x1234ABCD );
+		world.ResetLevel();
+		end = timeNow();
+		float64 worldInitMilliseconds = deltaMilliseconds( start, end );
+
+		// print the sum so the touch loop can't be thrown away
+		printf( "%-10u %-12zu %-12.4f %-14.4f %-16.4f (%.0f)\n", numBlocks, level.GetSizeBytes(), loadMilliseconds, touchMilliseconds, worldInitMilliseconds, sum );
+
+		world.Shutdown();
+		level.Unload();
+
+		remove( filename );
+
+		delete[] positions;
+		delete[] halfSizes;
+		delete[] colorIndices;
+		delete[] scoreValues;
+		delete[] hitPoints;
+	}
+}
+
+static const float32 BENCHMARK_SCROLL_SPEEDS[] = {
+	0.05f, 0.5f, 2.0f, 8.0f
+};
+
+/*
+========================
+BenchmarkEndless
+========================
+*/
+static void BenchmarkEndless() {
+	const u32 numTicks = 4000;
+
+	JobSystem jobSystem;
+	jobSystem.Init();
+
+	printf( "Streamer memory: %zu bytes, %u workers\n\n", sizeof( LevelStreamer ), jobSystem.GetNumWorkers() );
+
+	printf( "%-14s %-10s %-10s %-8s %-14s %-14s %-16s %-8s %-14s\n", "SCROLL/TICK", "AVG (ms)", "MAX (ms)", "CHUNKS", "GEN AVG (ms)", "GEN MAX (ms)", "LATENCY MAX (ms)", "STALLS", "STALL MAX (ms)" );
+
+	for ( float32 scrollSpeed : BENCHMARK_SCROLL_SPEEDS ) {
+		LevelStreamer streamer;
+		streamer.Init( 0x1234ABCD, &jobSystem );
+
+		GameWorld world;
+		world.Init( &streamer.GetBlockTable(), 0x1234ABCD, nullptr, MULTI_BALL_SPAWN_COUNT );
+		streamer.Reset( world );
+
+		float64 totalMilliseconds = 0.0;
+		float64 maxMilliseconds = 0.0;
+
+		for ( u32 tick = 0; tick < numTicks; tick++ ) {
+			timestamp_t start = timeNow();
+			streamer.Advance( world, scrollSpeed );
+			timestamp_t end = timeNow();
+
+			float64 milliseconds = deltaMilliseconds( start, end );
+			totalMilliseconds += milliseconds;
+			maxMilliseconds = max( maxMilliseconds, milliseconds );
+		}
+
+		const streamerStats_t& stats = streamer.GetStats();
+
+		printf( "%-14.2f %-10.4f %-10.4f %-8u %-14.4f %-14.4f %-16.4f %-8u %-14.4f\n",
+			scrollSpeed, totalMilliseconds / numTicks, maxMilliseconds, stats.mChunksGenerated,
+			stats.GetAverageGenerateMilliseconds(), stats.mMaxGenerateMilliseconds, stats.mMaxLatencyMilliseconds,
+			stats.mStalls, stats.mMaxStallMilliseconds );
+
+		world.Shutdown();
+		streamer.Shutdown();
+	}
+
+	jobSystem.Shutdown();
+}
+
+static const u32 BENCHMARK_QUAD_COUNTS[] = {
+	100, 10 * 1000, 1000 * 1000
+};
+
+/*
+========================
+AppendQuad
+========================
+*/
+static void AppendQuad( quadInstance_t* instances, u32& numQuads, const glm::vec2& position, const glm::vec2& halfSize, const u32 colorIndex ) {
+	quadInstance_t& instance = instances[numQuads++];
+	instance.mPosition = position;
+	instance.mHalfSize = glm::packHalf2x16( halfSize );
+	instance.mMaterial = packQuadMaterial( colorIndex, 0 );
+}
+
+/*
+========================
+BenchmarkQuadUpload
+========================
+*/
+static void BenchmarkQuadUpload() {
+	// a block breaks every this many frames, everything else is static apart from the ball and paddle
+	const u32 framesPerBreak = 8;
+	const u32 numFrames = 256;
+	const u32 numDynamicQuads = 2;
+	const u32 maxRanges = 64;
+
+	printf( "Only the CPU side, the bytes are what would be copied to the GPU each frame\n\n" );
+	printf( "%-10s %-14s %-16s %-14s %-16s %-12s %-10s\n", "QUADS", "FULL (ms)", "FULL BYTES", "DIRTY (ms)", "DIRTY BYTES", "RANGES", "SPEEDUP" );
+
+	for ( u32 numQuads : BENCHMARK_QUAD_COUNTS ) {
+		u32 numStaticQuads = numQuads - numDynamicQuads;
+
+		// stands in for the instance buffer on the GPU
+		quadInstance_t* gpuInstances = new quadInstance_t[numQuads];
+
+		// the whole list, rebuilt from scratch every frame
+		quadInstance_t* fullInstances = new quadInstance_t[numQuads];
+
+		QuadScene scene;
+		scene.Init( numQuads );
+		scene.SetNumQuads( numQuads );
+
+		quadRange_t ranges[maxRanges];
+
+		bool32* broken = new bool32[numStaticQuads];
+		memset( broken, 0, numStaticQuads * sizeof( bool32 ) );
+
+		float64 fullMilliseconds = 0.0;
+		float64 dirtyMilliseconds = 0.0;
+		size_t fullBytes = 0;
+		size_t dirtyBytes = 0;
+		u32 numRanges = 0;
+
+		for ( u32 frame = 0; frame < numFrames; frame++ ) {
+			glm::vec2 ballPosition( static_cast<float32>( frame ) * 0.01f, 0.0f );
+			glm::vec2 playerPosition( static_cast<float32>( frame ) * -0.01f, -4.0f );
+
+			if ( frame % framesPerBreak == 0 ) {
+				broken[( frame * 2654435761u ) % numStaticQuads] = true;
+			}
+
+			// full rewrite, every quad gets rebuilt and sent every frame
+			timestamp_t start = timeNow();
+			u32 numFullQuads = 0;
+			for ( u32 i = 0; i < numStaticQuads; i++ ) {
+				if ( broken[i] ) {
+					continue;
+				}
+
+				glm::vec2 position( static_cast<float32>( i % 1000 ) * 0.01f, static_cast<float32>( i / 1000 ) * 0.01f );
+				AppendQuad( fullInstances, numFullQuads, position, glm::vec2( 0.5f, 0.25f ), 0 );
+			}
+			AppendQuad( fullInstances, numFullQuads, ballPosition, glm::vec2( 0.1f ), 1 );
+			AppendQuad( fullInstances, numFullQuads, playerPosition, glm::vec2( 1.0f, 0.1f ), 1 );
+
+			size_t fullSizeBytes = numFullQuads * sizeof( quadInstance_t );
+			memcpy( gpuInstances, fullInstances, fullSizeBytes );
+			timestamp_t end = timeNow();
+
+			fullMilliseconds += deltaMilliseconds( start, end );
+			fullBytes += fullSizeBytes;
+
+			// retained, the static quads get set once and only what changed goes up
+			start = timeNow();
+			if ( frame == 0 ) {
+				for ( u32 i = 0; i < numStaticQuads; i++ ) {
+					glm::vec2 position( static_cast<float32>( i % 1000 ) * 0.01f, static_cast<float32>( i / 1000 ) * 0.01f );
+					scene.Set( i, position, glm::vec2( 0.5f, 0.25f ), 0 );
+				}
+			}
+
+			if ( frame % framesPerBreak == 0 ) {
+				scene.Hide( ( frame * 2654435761u ) % numStaticQuads );
+			}
+
+			scene.Set( numStaticQuads, ballPosition, glm::vec2( 0.1f ), 1 );
+			scene.Set( numStaticQuads + 1, playerPosition, glm::vec2( 1.0f, 0.1f ), 1 );
+
+			u32 numFrameRanges = scene.BuildDirtyRanges( ranges, maxRanges );
+			for ( u32 i = 0; i < numFrameRanges; i++ ) {
+				size_t rangeSizeBytes = ranges[i].mCount * sizeof( quadInstance_t );
+
+				memcpy( gpuInstances + ranges[i].mFirst, scene.GetInstances() + ranges[i].mFirst, rangeSizeBytes );
+				dirtyBytes += rangeSizeBytes;
+			}
+			end = timeNow();
+
+			dirtyMilliseconds += deltaMilliseconds( start, end );
+			numRanges += numFrameRanges;
+		}
+
+		// read something back so none of the writes can be thrown away
+		u32 check = static_cast<u32>( glm::unpackHalf2x16( gpuInstances[0].mHalfSize ).x * 100.0f );
+
+		printf( "%-10u %-14.4f %-16zu %-14.4f %-16zu %-12.2f %-10.2f (%u)\n", numQuads,
+			fullMilliseconds / numFrames, fullBytes / numFrames,
+			dirtyMilliseconds / numFrames, dirtyBytes / numFrames,
+			static_cast<float32>( numRanges ) / numFrames, fullMilliseconds / dirtyMilliseconds, check );
+
+		delete[] broken;
+		broken = nullptr;
+
+		scene.Shutdown();
+
+		delete[] fullInstances;
+		fullInstances = nullptr;
+
+		delete[] gpuInstances;
+		gpuInstances = nullptr;
+	}
+}
+
+/*
+========================
+InitStandInRenderer
+========================
+*/
+static void InitStandInRenderer( const u32 maxQuads = Renderer::DEFAULT_MAX_QUADS ) {
+	// no driver even when there is one, so the numbers are the engine's and nothing else's
+	VulkanStandIn::Install( false );
+
+	gJobSystem = new JobSystem();
+	gRenderer = new Renderer();
+	gUI = new UI();
+
+	gJobSystem->Init();
+	gRenderer->Init( false, false, false, false, false, maxQuads );
+	gUI->Init( GAME_WIDTH, GAME_HEIGHT );
+
+	gRenderer->GetContext()->GetRenderStateManager()->WaitForBackgroundPipelines();
+}
+
+/*
+========================
+ShutdownStandInRenderer
+========================
+*/
+static void ShutdownStandInRenderer() {
+	delete gUI;
+	gUI = nullptr;
+
+	delete gRenderer;
+	gRenderer = nullptr;
+
+	delete gJobSystem;
+	gJobSystem = nullptr;
+
+	vulkanStandInStats_t stats = VulkanStandIn::GetStats();
+	if ( stats.mValidationErrors > 0 ) {
+		error( "The Vulkan stand-in caught %llu validation errors!\n", stats.mValidationErrors );
+		gBenchmarkRegressed = true;
+	}
+
+	VulkanStandIn::Uninstall();
+}
+
+static const u32 BENCHMARK_RENDER_QUAD_COUNTS[] = {
+	100, 1000, 10 * 1000
+};
+
+static const u32 BENCHMARK_RENDER_QUAD_COUNT_MAX = 10 * 1000;
+
+static const u32 BENCHMARK_RENDER_TEXT_LINES[] = {
+	0, 4, 32
+};
+
+/*
+========================
+BenchmarkRenderSubmit
+========================
+*/
+static void BenchmarkRenderSubmit() {
+	const u32 numFrames = 256;
+
+	InitStandInRenderer( BENCHMARK_RENDER_QUAD_COUNT_MAX );
+
+	printf( "CPU side only, on the Vulkan stand-in without a driver\n\n" );
+	printf( "%-8s %-6s %-12s %-12s %-12s %-8s %-10s %-10s %-10s\n", "QUADS", "LINES", "QUADS (us)", "UI (us)", "SUBMIT (us)", "DRAWS", "BINDS", "COMMANDS", "BARRIERS" );
+
+	for ( u32 numQuads : BENCHMARK_RENDER_QUAD_COUNTS ) {
+		if ( numQuads > gRenderer->GetMaxQuads() ) {
+			error( "The renderer only has room for %u quads, can't measure %u!\n", gRenderer->GetMaxQuads(), numQuads );
+			gBenchmarkRegressed = true;
+			continue;
+		}
+
+		for ( u32 i = 0; i < numQuads; i++ ) {
+			glm::vec2 position( static_cast<float32>( i % 100 ) * 0.1f, static_cast<float32>( i / 100 ) * 0.05f );
+			gRenderer->SetQuad( i, position, glm::vec2( 0.04f, 0.02f ), i % 4 );
+		}
+
+		gRenderer->SetNumQuads( numQuads );
+
+		for ( u32 numLines : BENCHMARK_RENDER_TEXT_LINES ) {
+			float64 quadsMicroseconds = 0.0;
+			float64 uiMicroseconds = 0.0;
+			float64 submitMicroseconds = 0.0;
+			vulkanStandInStats_t frameStats = {};
+
+			for ( u32 frame = 0; frame < numFrames; frame++ ) {
+				gUI->Begin();
+
+				if ( numLines > 0 ) {
+					gUI->PushWindow( ImVec2( 0, 0 ), ImVec4( 0, 0, 0, 0 ) );
+					for ( u32 line = 0; line < numLines; line++ ) {
+						ImGui::Text( "LINE %u OF FRAME %u", line, frame );
+					}
+					gUI->PopWindow();
+				}
+
+				gUI->End();
+
+				// whatever imgui decided to draw this frame, each command in it is a draw of its own
+				u32 numUIDraws = 0;
+				ImDrawData* drawData = ImGui::GetDrawData();
+				if ( drawData && drawData->TotalVtxCount > 0 ) {
+					for ( s32 i = 0; i < drawData->CmdListsCount; i++ ) {
+						numUIDraws += static_cast<u32>( drawData->CmdLists[i]->CmdBuffer.Size );
+					}
+				}
+
+				VulkanStandIn::ResetStats();
+
+				gRenderer->StartFrame();
+
+				timestamp_t start = timeNow();
+				gRenderer->DrawElements();
+				timestamp_t end = timeNow();
+				quadsMicroseconds += deltaMilliseconds( start, end ) * 1000.0;
+
+				start = timeNow();
+				gUI->Render();
+				end = timeNow();
+				uiMicroseconds += deltaMilliseconds( start, end ) * 1000.0;
+
+				start = timeNow();
+				gRenderer->EndFrame();
+				end = timeNow();
+				submitMicroseconds += deltaMilliseconds( start, end ) * 1000.0;
+
+				frameStats = VulkanStandIn::GetStats();
+
+				// one draw per slice of quads and one per imgui command, anything more is a regression
+				u32 numSlices = Renderer::CalcNumQuadSlices( numQuads );
+				u64 expectedDraws = numSlices + numUIDraws;
+
+				if ( frameStats.mDraws != expectedDraws ) {
+					error( "Frame %u with %u quads and %u lines of text made %llu draws, expected %llu!\n", frame, numQuads, numLines, frameStats.mDraws, expectedDraws );
+					gBenchmarkRegressed = true;
+					break;
+				}
+			}
+
+			printf( "%-8u %-6u %-12.2f %-12.2f %-12.2f %-8llu %-10llu %-10llu %-10llu\n", numQuads, numLines,
+				quadsMicroseconds / numFrames, uiMicroseconds / numFrames, submitMicroseconds / numFrames,
+				frameStats.mDraws, frameStats.mPipelineBinds + frameStats.mDescriptorSetBinds + frameStats.mBufferBinds, frameStats.mCommands, frameStats.mBarriers );
+		}
+	}
+
+	ShutdownStandInRenderer();
+}
+
+static const u32 BENCHMARK_QUAD_SUBMIT_COUNTS[] = {
+	100, 10 * 1000, 1000 * 1000
+};
+
+static const u32 BENCHMARK_QUAD_SUBMIT_COUNT_MAX = 1000 * 1000;
+
+/*
+========================
+BenchmarkQuadSubmit
+========================
+*/
+static void BenchmarkQuadSubmit() {
+	InitStandInRenderer( BENCHMARK_QUAD_SUBMIT_COUNT_MAX );
+
+	printf( "CPU side only, on the Vulkan stand-in without a driver\n\n" );
+	printf( "%-8s %-14s %-8s %-8s %-10s %-16s %-8s %-8s %-10s %-10s\n", "QUADS",
+		"PER QUAD (us)", "DRAWS", "BINDS", "COMMANDS",
+		"INSTANCED (us)", "DRAWS", "BINDS", "COMMANDS", "SPEEDUP" );
+
+	for ( u32 numQuads : BENCHMARK_QUAD_SUBMIT_COUNTS ) {
+		if ( numQuads > gRenderer->GetMaxQuads() ) {
+			error( "The renderer only has room for %u quads, can't measure %u!\n", gRenderer->GetMaxQuads(), numQuads );
+			gBenchmarkRegressed = true;
+			continue;
+		}
+
+		// a million draws a frame on the per quad side takes a while, and a few frames is plenty at that size
+		const u32 numFrames = ( numQuads >= 1000 * 1000 ) ? 8 : 64;
+
+		for ( u32 i = 0; i < numQuads; i++ ) {
+			glm::vec2 position( static_cast<float32>( i % 100 ) * 0.1f, static_cast<float32>( i / 100 ) * 0.05f );
+			gRenderer->SetQuad( i, position, glm::vec2( 0.04f, 0.02f ), i % 4 );
+		}
+
+		gRenderer->SetNumQuads( numQuads );
+
+		// per quad first, then instanced
+		float64 recordMicroseconds[2] = {};
+		vulkanStandInStats_t frameStats[2] = {};
+
+		for ( u32 mode = 0; mode < 2; mode++ ) {
+			bool32 drawPerQuad = mode == 0;
+			gRenderer->SetDrawPerQuad( drawPerQuad );
+
+			u32 numSlices = Renderer::CalcNumQuadSlices( numQuads );
+			u64 expectedDraws = drawPerQuad ? numQuads : numSlices;
+
+			for ( u32 frame = 0; frame < numFrames; frame++ ) {
+				VulkanStandIn::ResetStats();
+
+				gRenderer->StartFrame();
+
+				timestamp_t start = timeNow();
+				gRenderer->DrawElements();
+				timestamp_t end = timeNow();
+				recordMicroseconds[mode] += deltaMilliseconds( start, end ) * 1000.0;
+
+				gRenderer->EndFrame();
+
+				frameStats[mode] = VulkanStandIn::GetStats();
+
+				if ( frameStats[mode].mDraws != expectedDraws ) {
+					error( "Frame %u with %u quads made %llu draws, expected %llu!\n", frame, numQuads, frameStats[mode].mDraws, expectedDraws );
+					gBenchmarkRegressed = true;
+					break;
+				}
+			}
+
+			recordMicroseconds[mode] /= numFrames;
+		}
+
+		printf( "%-8u %-14.2f %-8llu %-8llu %-10llu %-16.2f %-8llu %-8llu %-10llu %-10.2f\n", numQuads,
+			recordMicroseconds[0], frameStats[0].mDraws, frameStats[0].mPipelineBinds + frameStats[0].mDescriptorSetBinds + frameStats[0].mBufferBinds, frameStats[0].mCommands,
+			recordMicroseconds[1], frameStats[1].mDraws, frameStats[1].mPipelineBinds + frameStats[1].mDescriptorSetBinds + frameStats[1].mBufferBinds, frameStats[1].mCommands,
+			recordMicroseconds[0] / recordMicroseconds[1] );
+	}
+
+	gRenderer->SetDrawPerQuad( false );
+
+	ShutdownStandInRenderer();
+}
+
+static const size_t BENCHMARK_STAGING_CHUNK_SIZES[] = {
+	256, 64 * 1024, 4 * 1024 * 1024
+};
+
+static const size_t BENCHMARK_STAGING_CHUNK_SIZE_MAX = 4 * 1024 * 1024;
+
+/*
+========================
+BenchmarkStagingSubmit
+========================
+*/
+static void BenchmarkStagingSubmit() {
+	const size_t totalBytes = 256 * 1024 * 1024;
+
+	InitStandInRenderer();
+
+	VulkanContext* context = gRenderer->GetContext();
+	StagingManager* stagingManager = context->GetStagingManager();
+
+	// where every chunk is copied to, only the copy is recorded so it's never read
+	bufferDesc_t desc = {};
+	desc.mDataSizeBytes = BENCHMARK_STAGING_CHUNK_SIZE_MAX;
+	desc.mBufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	desc.mMemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	Buffer destination( context );
+	destination.AllocBuffer( desc );
+
+	printf( "CPU side only, on the Vulkan stand-in without a driver\n\n" );
+	printf( "%-10s %-10s %-14s %-14s %-10s %-10s %-16s %-16s\n", "CHUNK", "CHUNKS", "STAGE (us)", "FLUSH (us)", "SUBMITS", "BARRIERS", "BYTES COPIED", "BYTES FLUSHED" );
+
+	for ( size_t chunkSize : BENCHMARK_STAGING_CHUNK_SIZES ) {
+		u32 numChunks = static_cast<u32>( totalBytes / chunkSize );
+
+		// everything in flight from the last size has to be done first, so it isn't counted against this one
+		stagingManager->Flush();
+		context->WaitDeviceIdle();
+		VulkanStandIn::ResetStats();
+
+		timestamp_t start = timeNow();
+		for ( u32 i = 0; i < numChunks; i++ ) {
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkBuffer stagingBuffer = VK_NULL_HANDLE;
+			VkDeviceSize stagingOffset = 0;
+
+			u8* data = stagingManager->Stage( chunkSize, YETI_DEFAULT_BYTE_ALIGNMENT, commandBuffer, stagingBuffer, stagingOffset );
+			memset( data, static_cast<s32>( i ), chunkSize );
+
+			VkBufferCopy region = {};
+			region.srcOffset = stagingOffset;
+			region.size = chunkSize;
+			vkCmdCopyBuffer( commandBuffer, stagingBuffer, destination.GetAPIHandle(), 1, &region );
+		}
+		timestamp_t end = timeNow();
+		float64 stageMicroseconds = deltaMilliseconds( start, end ) * 1000.0;
+
+		start = timeNow();
+		stagingManager->Flush();
+		end = timeNow();
+		float64 flushMicroseconds = deltaMilliseconds( start, end ) * 1000.0;
+
+		vulkanStandInStats_t stats = VulkanStandIn::GetStats();
+
+		if ( stats.mBytesCopied != static_cast<u64>( numChunks ) * chunkSize ) {
+			error( "Staged %zu bytes but only %llu were copied!\n", numChunks * chunkSize, stats.mBytesCopied );
+			gBenchmarkRegressed = true;
+		}
+
+		printf( "%-10zu %-10u %-14.2f %-14.2f %-10llu %-10llu %-16llu %-16llu\n", chunkSize, numChunks,
+			stageMicroseconds, flushMicroseconds, stats.mSubmits, stats.mBarriers, stats.mBytesCopied, stats.mBytesFlushed );
+	}
+
+	context->WaitDeviceIdle();
+	destination.UnallocBuffer();
+
+	ShutdownStandInRenderer();
+}
+
+// none bigger than BENCHMARK_DESCRIPTOR_SET_COUNT_MAX, which is no more than one frame's transient pages hold (SETS_PER_PAGE * MAX_FRAME_PAGES)
+static const u32 BENCHMARK_DESCRIPTOR_SET_COUNTS[] = {
+	16, 128, 512
+};
+
+static const u32 BENCHMARK_DESCRIPTOR_SET_COUNT_MAX = 512;
+
+static const u32 BENCHMARK_DESCRIPTORS_PER_SET = 3;
+
+/*
+========================
+BenchmarkDescriptorAlloc
+========================
+*/
+static void BenchmarkDescriptorAlloc() {
+	InitStandInRenderer();
+
+	VulkanContext* context = gRenderer->GetContext();
+	DescriptorAllocator* descriptorAllocator = context->GetDescriptorAllocator();
+	RenderStateManager* renderStateManager = context->GetRenderStateManager();
+
+	// every frame context gets used a few times, so a transient pool that was never reset would show
+	const u32 numFrames = context->GetNumFramesInFlight() * 4;
+
+	// never read, it's only there to have something for the descriptors to point at
+	bufferDesc_t desc = {};
+	desc.mDataSizeBytes = 256;
+	desc.mBufferUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	desc.mMemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	Buffer buffer( context );
+	buffer.AllocBuffer( desc );
+
+	// the same as the renderer's, two uniform buffers and a storage buffer is as much as a set from any page has room for
+	VkDescriptorSetLayoutBinding bindings[BENCHMARK_DESCRIPTORS_PER_SET] = {
+		{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
+		{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
+		{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
+	};
+
+	uniformLayoutDesc_t layoutDesc = {};
+	layoutDesc.mBindings = bindings;
+	layoutDesc.mNumBindings = BENCHMARK_DESCRIPTORS_PER_SET;
+
+	u32 layoutID = renderStateManager->AcquireLayout( layoutDesc );
+
+	descriptorData_t data[DescriptorAllocator::MAX_DESCRIPTORS_PER_SET] = {};
+	for ( u32 i = 0; i < BENCHMARK_DESCRIPTORS_PER_SET; i++ ) {
+		data[descriptorAllocator->GetDataIndex( layoutID, i )].mBuffer = buffer.GetDescriptorInfo();
+	}
+
+	bool32 hasTemplates = context->UsesDescriptorUpdateTemplates();
+
+	descriptorAllocation_t* allocations = new descriptorAllocation_t[BENCHMARK_DESCRIPTOR_SET_COUNT_MAX];
+
+	// what's on the free list for the benchmark's layout from the last count, the transient frames have retired them by then
+	u32 numFreed = 0;
+
+	printf( "CPU side only, on the Vulkan stand-in without a driver%s\n\n", hasTemplates ? "" : ", which has no update templates" );
+	printf( "%-8s %-12s %-12s %-14s %-14s %-16s %-8s %-12s %-10s\n", "SETS", "ALLOC (us)", "REUSE (us)", "WRITES (us)", "TEMPLATE (us)", "TRANSIENT (us)", "PAGES", "FRAME POOLS", "REUSED" );
+
+	for ( u32 numSets : BENCHMARK_DESCRIPTOR_SET_COUNTS ) {
+		u64 expectedWrites = static_cast<u64>( numSets ) * BENCHMARK_DESCRIPTORS_PER_SET;
+
+		// anything the last count freed comes straight back, the rest are new sets out of the pages
+		u32 reusedBefore = descriptorAllocator->GetNumSetsReused();
+
+		timestamp_t start = timeNow();
+		for ( u32 i = 0; i < numSets; i++ ) {
+			allocations[i] = descriptorAllocator->Alloc( layoutID );
+		}
+		timestamp_t end = timeNow();
+		float64 allocMicroseconds = deltaMilliseconds( start, end ) * 1000.0;
+
+		if ( descriptorAllocator->GetNumSetsReused() - reusedBefore != min( numSets, numFreed ) ) {
+			error( "Allocating %u sets with %u freed reused %u of them!\n", numSets, numFreed, descriptorAllocator->GetNumSetsReused() - reusedBefore );
+			gBenchmarkRegressed = true;
+		}
+
+		// everything freed has to wait out the frames in flight, then come off the free list without making a new page
+		u32 numPages = descriptorAllocator->GetNumPages();
+		reusedBefore = descriptorAllocator->GetNumSetsReused();
+
+		start = timeNow();
+		for ( u32 i = 0; i < numSets; i++ ) {
+			descriptorAllocator->Free( allocations[i] );
+		}
+		end = timeNow();
+		float64 reuseMicroseconds = deltaMilliseconds( start, end ) * 1000.0;
+
+		for ( u32 frame = 0; frame < context->GetNumFramesInFlight(); frame++ ) {
+			if ( descriptorAllocator->GetNumSetsRetired() != numSets ) {
+				error( "%u freed sets were ready to reuse after %u frames, the GPU could still be reading them!\n", numSets - descriptorAllocator->GetNumSetsRetired(), frame );
+				gBenchmarkRegressed = true;
+			}
+
+			gRenderer->StartFrame();
+			gRenderer->EndFrame();
+		}
+
+		start = timeNow();
+		for ( u32 i = 0; i < numSets; i++ ) {
+			allocations[i] = descriptorAllocator->Alloc( layoutID );
+		}
+		end = timeNow();
+		reuseMicroseconds += deltaMilliseconds( start, end ) * 1000.0;
+
+		u32 numReused = descriptorAllocator->GetNumSetsReused() - reusedBefore;
+
+		if ( numReused != numSets || descriptorAllocator->GetNumPages() != numPages ) {
+			error( "Freeing and allocating %u sets again reused %u of them and made %u new pages!\n", numSets, numReused, descriptorAllocator->GetNumPages() - numPages );
+			gBenchmarkRegressed = true;
+		}
+
+		// vkUpdateDescriptorSets() first, then templates if the context has them
+		float64 updateMicroseconds[2] = {};
+
+		for ( u32 mode = 0; mode < 2; mode++ ) {
+			bool32 useTemplates = mode == 1;
+			if ( useTemplates && !hasTemplates ) {
+				break;
+			}
+
+			descriptorAllocator->SetUseUpdateTemplates( useTemplates );
+
+			VulkanStandIn::ResetStats();
+
+			start = timeNow();
+			for ( u32 i = 0; i < numSets; i++ ) {
+				descriptorAllocator->Update( allocations[i].mSet, layoutID, data );
+			}
+			end = timeNow();
+			updateMicroseconds[mode] = deltaMilliseconds( start, end ) * 1000.0;
+
+			vulkanStandInStats_t stats = VulkanStandIn::GetStats();
+
+			if ( stats.mDescriptorWrites != expectedWrites ) {
+				error( "Updating %u sets %s wrote %llu descriptors, expected %llu!\n", numSets, useTemplates ? "with templates" : "with vkUpdateDescriptorSets()", stats.mDescriptorWrites, expectedWrites );
+				gBenchmarkRegressed = true;
+			}
+		}
+
+		descriptorAllocator->SetUseUpdateTemplates( hasTemplates );
+
+		// freed before the transient frames so they've been retired by the time the next count allocates
+		for ( u32 i = 0; i < numSets; i++ ) {
+			descriptorAllocator->Free( allocations[i] );
+		}
+
+		numFreed = numSets;
+
+		// the frame's pools are reset when it comes round again, so they only ever grow to what one frame needs
+		float64 transientMicroseconds = 0.0;
+
+		for ( u32 frame = 0; frame < numFrames; frame++ ) {
+			gRenderer->StartFrame();
+
+			start = timeNow();
+			for ( u32 i = 0; i < numSets; i++ ) {
+				VkDescriptorSet set = descriptorAllocator->AllocTransient( layoutID );
+				descriptorAllocator->Update( set, layoutID, data );
+			}
+			end = timeNow();
+			transientMicroseconds += deltaMilliseconds( start, end ) * 1000.0;
+
+			gRenderer->EndFrame();
+		}
+
+		u32 poolsPerFrame = ( numSets + DescriptorAllocator::SETS_PER_PAGE - 1 ) / DescriptorAllocator::SETS_PER_PAGE;
+		u32 expectedFramePools = poolsPerFrame * context->GetNumFramesInFlight();
+
+		if ( descriptorAllocator->GetNumFramePools() != expectedFramePools ) {
+			error( "%u transient sets a frame for %u frames made %u pools, expected %u!\n", numSets, numFrames, descriptorAllocator->GetNumFramePools(), expectedFramePools );
+			gBenchmarkRegressed = true;
+		}
+
+		printf( "%-8u %-12.2f %-12.2f %-14.2f %-14.2f %-16.2f %-8u %-12u %-10u\n", numSets,
+			allocMicroseconds, reuseMicroseconds, updateMicroseconds[0], updateMicroseconds[1], transientMicroseconds / numFrames,
+			descriptorAllocator->GetNumPages(), descriptorAllocator->GetNumFramePools(), numReused );
+	}
+
+	delete[] allocations;
+	allocations = nullptr;
+
+	context->WaitDeviceIdle();
+
+	// forgets the sets still on the free and retired lists along with it
+	renderStateManager->ReleaseLayout( layoutID );
+
+	buffer.UnallocBuffer();
+
+	ShutdownStandInRenderer();
+}
+
+static const benchmark_t BENCHMARKS[] = {
+	{ "game_state",		BenchmarkGameStateSnapshot },
+	{ "batch",			BenchmarkBatch },
+	{ "agent_env",		BenchmarkAgentEnv },
+	{ "multi_ball",		BenchmarkMultiBall },
+	{ "level_load",		BenchmarkLevelLoad },
+	{ "endless",		BenchmarkEndless },
+	{ "quad_submit",	BenchmarkQuadSubmit },
+	{ "quad_upload",	BenchmarkQuadUpload },
+	{ "render_submit",	BenchmarkRenderSubmit },
+	{ "staging_submit",	BenchmarkStagingSubmit },
+	{ "descriptor_alloc",	BenchmarkDescriptorAlloc },
+};
+
+/*
+========================
+RunBenchmarks
+========================
+*/
+bool32 RunBenchmarks( const char* name ) {
+	bool32 ranAny = false;
+
+	for ( const benchmark_t& benchmark : BENCHMARKS ) {
+		if ( name && strcmp( name, benchmark.mName ) != 0 ) {
+			continue;
+		}
+
+		printf( "------- Benchmark: %s -------\n", benchmark.mName );
+		benchmark.mFunc();
+		printf( "\n" );
+
+		ranAny = true;
+	}
+
+	if ( !ranAny ) {
+		error( "No benchmark called \"%s\" exists!\n", name );
+	}
+
+	return ranAny && !gBenchmarkRegressed;
+}
\ No newline at end of file
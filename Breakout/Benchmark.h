@@ -0,0 +1,27 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <mstd/mstd.h>
+
+/*
+================================================================================================
+
+	Breakout Benchmarks
+
+	Headless timing runs for the systems that need to scale past what the game itself does.
+	Run them instead of the game via the command line:
+
+		Breakout.exe -benchmark [name]
+
+	Leaving out the name runs every benchmark. Each benchmark prints its own results.
+
+	The rendering ones run on the Vulkan stand-in, so they don't need a GPU, and check the
+	draws it counted against what the frame should have made.
+
+================================================================================================
+*/
+
+// returns false if no benchmark matched the name, or one of them caught a regression
+bool32	RunBenchmarks( const char* name );
+
+#endif // __BENCHMARK_H__
\ No newline at end of file
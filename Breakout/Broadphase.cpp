@@ -0,0 +1,137 @@
+#include "Broadphase.h"
+
+#include "GameState.h"
+
+/*
+================================================================================================
+
+	Broadphase
+
+================================================================================================
+*/
+
+/*
+========================
+gridBounds_t::Init
+========================
+*/
+void gridBounds_t::Init( const float32 minX, const float32 minY, const float32 maxX, const float32 maxY, const float32 cellSize ) {
+	assertf( ( cellSize > 0.0f ), "Grid cell size must be > 0!\n" );
+
+	mMinX = minX;
+	mMinY = minY;
+	mInvCellSize = 1.0f / cellSize;
+
+	mNumCellsX = max( static_cast<u32>( ceilf( ( maxX - minX ) * mInvCellSize ) ), 1u );
+	mNumCellsY = max( static_cast<u32>( ceilf( ( maxY - minY ) * mInvCellSize ) ), 1u );
+}
+
+/*
+========================
+BlockGrid::Build
+========================
+*/
+void BlockGrid::Build( const blockTable_t& blockTable, const gridBounds_t& bounds ) {
+	mBounds = bounds;
+
+	u32 numCells = mBounds.GetNumCells();
+	u32 numBlocks = blockTable.GetNumBlocks();
+
+	mCellStarts.resize( numCells + 1 );
+	memset( mCellStarts.data(), 0, mCellStarts.length() * sizeof( u32 ) );
+
+	// first pass counts how many blocks land in each cell, second pass fills them in
+	// counts are stored one cell ahead so the prefix sum turns them straight into start offsets
+	for ( u32 blockIndex = 0; blockIndex < numBlocks; blockIndex++ ) {
+		const glm::vec2& position = blockTable.mPositions[blockIndex];
+		const glm::vec2& halfSize = blockTable.mHalfSizes[blockIndex];
+
+		u32 minX = mBounds.CellX( position.x - halfSize.x );
+		u32 maxX = mBounds.CellX( position.x + halfSize.x );
+		u32 minY = mBounds.CellY( position.y - halfSize.y );
+		u32 maxY = mBounds.CellY( position.y + halfSize.y );
+
+		for ( u32 cellY = minY; cellY <= maxY; cellY++ ) {
+			for ( u32 cellX = minX; cellX <= maxX; cellX++ ) {
+				mCellStarts[cellX + ( cellY * mBounds.mNumCellsX ) + 1]++;
+			}
+		}
+	}
+
+	for ( u32 cellIndex = 0; cellIndex < numCells; cellIndex++ ) {
+		mCellStarts[cellIndex + 1] += mCellStarts[cellIndex];
+	}
+
+	mBlockIndices.resize( mCellStarts[numCells] );
+
+	array<u32> cellWriteOffsets;
+	cellWriteOffsets.resize( numCells );
+	memcpy( cellWriteOffsets.data(), mCellStarts.data(), numCells * sizeof( u32 ) );
+
+	for ( u32 blockIndex = 0; blockIndex < numBlocks; blockIndex++ ) {
+		const glm::vec2& position = blockTable.mPositions[blockIndex];
+		const glm::vec2& halfSize = blockTable.mHalfSizes[blockIndex];
+
+		u32 minX = mBounds.CellX( position.x - halfSize.x );
+		u32 maxX = mBounds.CellX( position.x + halfSize.x );
+		u32 minY = mBounds.CellY( position.y - halfSize.y );
+		u32 maxY = mBounds.CellY( position.y + halfSize.y );
+
+		for ( u32 cellY = minY; cellY <= maxY; cellY++ ) {
+			for ( u32 cellX = minX; cellX <= maxX; cellX++ ) {
+				u32 cellIndex = cellX + ( cellY * mBounds.mNumCellsX );
+				mBlockIndices[cellWriteOffsets[cellIndex]++] = blockIndex;
+			}
+		}
+	}
+}
+
+/*
+========================
+BallGrid::Init
+========================
+*/
+void BallGrid::Init( const gridBounds_t& bounds, const u32 maxBalls ) {
+	mBounds = bounds;
+
+	u32 numCells = mBounds.GetNumCells();
+
+	mCellStarts.resize( numCells + 1 );
+	mCellCounts.resize( numCells );
+	mBallCells.resize( maxBalls );
+	mBallIndices.resize( maxBalls );
+}
+
+/*
+========================
+BallGrid::Build
+========================
+*/
+void BallGrid::Build( const float32* positionsX, const float32* positionsY, const u32 numBalls ) {
+	assertf( ( numBalls <= mBallIndices.length() ), "Too many balls for this grid!\n" );
+
+	u32 numCells = mBounds.GetNumCells();
+
+	memset( mCellCounts.data(), 0, numCells * sizeof( u32 ) );
+
+	for ( u32 ballIndex = 0; ballIndex < numBalls; ballIndex++ ) {
+		u32 cellIndex = mBounds.CellX( positionsX[ballIndex] ) + ( mBounds.CellY( positionsY[ballIndex] ) * mBounds.mNumCellsX );
+
+		mBallCells[ballIndex] = cellIndex;
+		mCellCounts[cellIndex]++;
+	}
+
+	u32 offset = 0;
+	for ( u32 cellIndex = 0; cellIndex < numCells; cellIndex++ ) {
+		mCellStarts[cellIndex] = offset;
+		offset += mCellCounts[cellIndex];
+
+		// reuse the counts as write offsets for the fill
+		mCellCounts[cellIndex] = mCellStarts[cellIndex];
+	}
+	mCellStarts[numCells] = offset;
+
+	for ( u32 ballIndex = 0; ballIndex < numBalls; ballIndex++ ) {
+		mBallIndices[mCellCounts[mBallCells[ballIndex]]++] = ballIndex;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef __BROADPHASE_H__
+#define __BROADPHASE_H__
+
+#include <mstd/mstd.h>
+
+struct blockTable_t;
+
+// a uniform grid laid over a rectangle, anything outside of it gets clamped to the edge cells
+struct gridBounds_t {
+	float32					mMinX, mMinY;
+	float32					mInvCellSize;
+	u32						mNumCellsX, mNumCellsY;
+
+	void					Init( const float32 minX, const float32 minY, const float32 maxX, const float32 maxY, const float32 cellSize );
+
+	inline u32				GetNumCells() const { return mNumCellsX * mNumCellsY; }
+
+	inline u32				CellX( const float32 x ) const;
+	inline u32				CellY( const float32 y ) const;
+};
+
+/*
+================================================================================================
+
+	Breakout Broadphase
+
+	Two uniform grids stored as flat arrays (a start offset per cell into one list of indices)
+	so that finding everything near a point never chases a pointer.
+
+	BlockGrid is built once per block table since the blocks never move. A block goes in every
+	cell it overlaps.
+
+	BallGrid is rebuilt every tick with a counting sort, which is O(balls) with no allocations.
+	The cell size MUST be at least as big as a ball so that two balls can only touch if they're
+	in the same or neighbouring cells.
+
+================================================================================================
+*/
+
+class BlockGrid {
+public:
+	void					Build( const blockTable_t& blockTable, const gridBounds_t& bounds );
+
+	inline const gridBounds_t&	GetBounds() const { return mBounds; }
+
+	// blocks in a cell are mBlockIndices[GetCellStart( cell ), GetCellStart( cell + 1 ))
+	inline u32				GetCellStart( const u32 cellIndex ) const { return mCellStarts[cellIndex]; }
+	inline u32				GetBlockIndex( const u32 index ) const { return mBlockIndices[index]; }
+
+private:
+	gridBounds_t			mBounds;
+
+	array<u32>				mCellStarts;	// one more than the number of cells
+	array<u32>				mBlockIndices;
+};
+
+class BallGrid {
+public:
+	void					Init( const gridBounds_t& bounds, const u32 maxBalls );
+
+	void					Build( const float32* positionsX, const float32* positionsY, const u32 numBalls );
+
+	// calls func once for every pair of balls in the same or neighbouring cells, returns how many pairs were tested
+	template<typename pairFunc_t>
+	u32						ForEachPair( pairFunc_t func ) const;
+
+private:
+	gridBounds_t			mBounds;
+
+	array<u32>				mCellStarts;	// one more than the number of cells
+	array<u32>				mCellCounts;
+	array<u32>				mBallCells;
+	array<u32>				mBallIndices;
+};
+
+/*
+========================
+gridBounds_t::CellX
+========================
+*/
+u32 gridBounds_t::CellX( const float32 x ) const {
+	s32 cell = static_cast<s32>( ( x - mMinX ) * mInvCellSize );
+	return static_cast<u32>( min( max( cell, 0 ), static_cast<s32>( mNumCellsX ) - 1 ) );
+}
+
+/*
+========================
+gridBounds_t::CellY
+========================
+*/
+u32 gridBounds_t::CellY( const float32 y ) const {
+	s32 cell = static_cast<s32>( ( y - mMinY ) * mInvCellSize );
+	return static_cast<u32>( min( max( cell, 0 ), static_cast<s32>( mNumCellsY ) - 1 ) );
+}
+
+/*
+========================
+BallGrid::ForEachPair
+========================
+*/
+template<typename pairFunc_t>
+u32 BallGrid::ForEachPair( pairFunc_t func ) const {
+	// only look at the neighbours "ahead" of each cell so that every pair of cells is visited once
+	static const s32 NEIGHBOUR_OFFSETS[][2] = {
+		{ 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }
+	};
+
+	u32 numPairs = 0;
+
+	for ( u32 cellY = 0; cellY < mBounds.mNumCellsY; cellY++ ) {
+		for ( u32 cellX = 0; cellX < mBounds.mNumCellsX; cellX++ ) {
+			u32 cellIndex = cellX + ( cellY * mBounds.mNumCellsX );
+			u32 start = mCellStarts[cellIndex];
+			u32 end = mCellStarts[cellIndex + 1];
+
+			// pairs within this cell
+			for ( u32 i = start; i < end; i++ ) {
+				for ( u32 j = i + 1; j < end; j++ ) {
+					func( mBallIndices[i], mBallIndices[j] );
+					numPairs++;
+				}
+			}
+
+			// pairs with the neighbours
+			for ( const s32* offset : NEIGHBOUR_OFFSETS ) {
+				s32 neighbourX = static_cast<s32>( cellX ) + offset[0];
+				s32 neighbourY = static_cast<s32>( cellY ) + offset[1];
+
+				if ( neighbourX < 0 || neighbourX >= static_cast<s32>( mBounds.mNumCellsX ) || neighbourY >= static_cast<s32>( mBounds.mNumCellsY ) ) {
+					continue;
+				}
+
+				u32 neighbourIndex = static_cast<u32>( neighbourX ) + ( static_cast<u32>( neighbourY ) * mBounds.mNumCellsX );
+				u32 neighbourStart = mCellStarts[neighbourIndex];
+				u32 neighbourEnd = mCellStarts[neighbourIndex + 1];
+
+				for ( u32 i = start; i < end; i++ ) {
+					for ( u32 j = neighbourStart; j < neighbourEnd; j++ ) {
+						func( mBallIndices[i], mBallIndices[j] );
+						numPairs++;
+					}
+				}
+			}
+		}
+	}
+
+	return numPairs;
+}
+
+#endif // __BROADPHASE_H__
\ No newline at end of file
@@ -5,21 +5,33 @@
 #define GAME_WIDTH					640
 #define GAME_HEIGHT					480
 
-#define RENDERER_NUM_BUFFERS		3
+#define RENDERER_NUM_BUFFERS		3	// swap chain images
+#define RENDERER_NUM_FRAMES_IN_FLIGHT	2	// how many frames the CPU can record ahead of the GPU
+#define RENDERER_PALETTE_SIZE		512	// how many colors quads can pick from, MUST match unlit_3d.vert
+#define RENDERER_QUADS_PER_SLICE	256	// fewest quads each recording job draws, see Renderer::CalcQuadsPerSlice()
 #define ORTHO_SIZE					5.0f
 
 #define NUM_BLOCKS_COLUMNS			11
 #define NUM_BLOCKS_ROWS				6
 #define NUM_BLOCKS_MAX				( NUM_BLOCKS_ROWS * NUM_BLOCKS_COLUMNS )
 
+#define ENDLESS_CHUNK_ROWS			4
+#define ENDLESS_NUM_CHUNKS			8	// how many chunks can be resident at once, this is all the memory endless mode gets
+#define NUM_ENDLESS_BLOCKS_MAX		( NUM_BLOCKS_COLUMNS * ENDLESS_CHUNK_ROWS * ENDLESS_NUM_CHUNKS )
+
 #define PLAYER_MOVE_SPEED			10.0f
 #define BALL_START_MOVE_SPEED		6.0f
 #define BALL_MOVE_SPEED_INCREASE	0.2f
 
+#define NUM_BALLS_MAX				1024	// extra balls for multi-ball, on top of the main one
+#define MULTI_BALL_SPAWN_COUNT		64
+
 #define NUM_MAX_PLAYER_LIVES		3
 
 #define BASE_PATH					"res/"
 #define SCORES_FILE_PATH			BASE_PATH "scores.dat"
+#define LEVEL_FILE_PATH				BASE_PATH "levels/level_01.lvl"
+#define PIPELINE_CACHE_FILE_PATH	BASE_PATH "pipeline_cache.dat"
 
 #define SCORE_NAME_LENGTH_MAX		3
 #define NUM_MAX_SCORE_ENTRIES		10
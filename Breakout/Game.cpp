@@ -4,9 +4,9 @@
 #include "Renderer.h"
 #include "InputHandler.h"
 #include "SoundSystem.h"
-#include "Entity.h"
 #include "UI.h"
 #include "ScoresManager.h"
+#include "JobSystem.h"
 
 /*
 ================================================================================================
@@ -27,12 +27,12 @@ enum key_t {
 
 	KEY_MUTE_SOUND	= SDL_SCANCODE_S,
 	KEY_SHOW_DEBUG	= SDL_SCANCODE_F3,
-};
 
-const u32 Game::BLOCK_ROW_SCORES[] = {
-	7, 7, 4, 4, 1, 1
+	KEY_MULTI_BALL	= SDL_SCANCODE_B,
 };
 
+const glm::vec4 Game::PLAYER_COLOR = glm::vec4( 200, 72, 72, 255 ) / 255.0f;
+
 /*
 ========================
 Game::Game
@@ -45,11 +45,20 @@ Game::Game() {
 	mSoundHitWalls = nullptr;
 	mSoundHitBlock = nullptr;
 
-	mPlayer = nullptr;
-	mBall = nullptr;
-
 	mMute = false;
 	mShowDebug = false;
+
+	mEndless = false;
+
+	mEventCursor = 0;
+	memset( mEventCounts, 0, sizeof( mEventCounts ) );
+	mNumEventsDropped = 0;
+
+	mBlockQuadsDirty = true;
+	mStreamerVersion = 0;
+
+	mNumBlockColors = 0;
+	mPlayerColorIndex = 0;
 }
 
 /*
@@ -66,17 +75,20 @@ Game::~Game() {
 Game::Init
 ========================
 */
-bool32 Game::Init() {
+bool32 Game::Init( const bool32 endless, const bool32 usePipelineCache, const bool32 useDynamicRendering, const bool32 useBindless, const bool32 useSoftware ) {
 	if ( IsRunning() ) {
 		return false;
 	}
 
 	printf( "------- Game init called -------\n" );
 
+	timestamp_t start = timeNow();
+
 	seedRandom();
 
 	SDL_Init( SDL_INIT_VIDEO | SDL_INIT_EVENTS );
 
+	gJobSystem = new JobSystem();
 	gWindow = new Window();
 	gInput = new InputHandler();
 	gRenderer = new Renderer();
@@ -84,11 +96,43 @@ bool32 Game::Init() {
 	gUI = new UI();
 	gScoresManager = new ScoresManager();
 
+	gJobSystem->Init();
+
 	gWindow->Init();
 
 	gInput->Init();
 
-	gRenderer->Init();
+	u32 seed = static_cast<u32>( time( nullptr ) );
+
+	mEndless = endless;
+
+	if ( mEndless ) {
+		mStreamer.Init( seed, gJobSystem );
+
+		mWorld.Init( &mStreamer.GetBlockTable(), seed, nullptr, NUM_BALLS_MAX );
+		mStreamer.Reset( mWorld );
+	} else {
+		bool32 loaded = mLevel.Load( LEVEL_FILE_PATH );
+
+		// every block gets a quad, and there's only so big the renderer's instance buffer can be
+		if ( loaded && Renderer::CalcNumQuads( mLevel.GetBlockTable().GetNumBlocks() ) > Renderer::MAX_QUADS ) {
+			error( "%s has %u blocks, the renderer only has room for %u!\n", LEVEL_FILE_PATH, mLevel.GetBlockTable().GetNumBlocks(), Renderer::MAX_QUADS - Renderer::CalcNumQuads( 0 ) );
+			mLevel.Unload();
+			loaded = false;
+		}
+
+		if ( loaded ) {
+			mLevel.Prefetch( gJobSystem );
+		} else {
+			printf( "Using the default level instead\n" );
+			mLevel.CreateDefault();
+		}
+
+		mWorld.Init( &mLevel.GetBlockTable(), seed, nullptr, NUM_BALLS_MAX );
+	}
+
+	// sized for whatever the level turned out to be, see UpdateQuads()
+	gRenderer->Init( usePipelineCache, useDynamicRendering, useBindless, false, useSoftware, Renderer::CalcNumQuads( mWorld.GetBlockTable()->GetNumBlocks() ) );
 
 	gSoundSystem->Init();
 
@@ -102,28 +146,18 @@ bool32 Game::Init() {
 
 	gScoresManager->Init();
 
-	// init game entities
-	mBlocks.resize( NUM_BLOCKS_MAX );
-	for ( u32 rowIndex = 0; rowIndex < NUM_BLOCKS_ROWS; rowIndex++ ) {
-		for ( u32 columnIndex = 0; columnIndex < NUM_BLOCKS_COLUMNS; columnIndex++ ) {
-			size_t blockIndex = columnIndex + ( rowIndex * NUM_BLOCKS_COLUMNS );
-
-			float32 blockX = -5.0f + columnIndex;
-			float32 blockY = 4.0f - ( rowIndex * 0.5f );
-			glm::vec3 pos( blockX, blockY, 1.0f );
+	UploadPalette();
 
-			glm::vec2 blockSize( 0.5f, 0.25f );
-
-			mBlocks[blockIndex] = new Entity( pos, blockSize, Entity::COLORS[rowIndex], BLOCK_ROW_SCORES[rowIndex] );
-		}
+	// the first frame would wait on these anyway, and this way the timings cover every pipeline
+	VulkanContext* context = gRenderer->GetContext();
+	if ( context ) {
+		context->GetRenderStateManager()->WaitForBackgroundPipelines();
+		context->GetRenderStateManager()->PrintStats();
+		context->GetPipelineCache()->PrintStats();
+		context->GetDescriptorAllocator()->PrintStats();
 	}
 
-	mPlayer = new Entity();
-	mBall = new Entity();
-
-	ResetLevel();
-
-	printf( "------- Game init complete -------\n\n" );
+	printf( "------- Game init complete. Time Taken: %f ms -------\n\n", deltaMilliseconds( start, timeNow() ) );
 
 	mRunning = true;
 
@@ -140,16 +174,10 @@ void Game::Shutdown() {
 	gSoundSystem->DestroyAudioObject( mSoundHitWalls );
 	gSoundSystem->DestroyAudioObject( mSoundHitPlayer );
 
-	delete mPlayer;
-	mPlayer = nullptr;
+	mWorld.Shutdown();
 
-	delete mBall;
-	mBall = nullptr;
-
-	for ( Entity* block : mBlocks ) {
-		delete block;
-		block = nullptr;
-	}
+	mStreamer.Shutdown();
+	mLevel.Unload();
 
 	delete gUI;
 	gUI = nullptr;
@@ -166,6 +194,9 @@ void Game::Shutdown() {
 	delete gWindow;
 	gWindow = nullptr;
 
+	delete gJobSystem;
+	gJobSystem = nullptr;
+
 	SDL_Quit();
 
 	mRunning = false;
@@ -226,34 +257,85 @@ void Game::Frame() {
 
 		gUI->Begin();
 
-		switch ( mCurrentState ) {
-		case GAME_STATE_WAITING:
-			StateWaiting();
-			break;
+		if ( gInput->IsKeyPressed( KEY_MUTE_SOUND ) ) {
+			mMute = !mMute;
+			gSoundSystem->MuteMainChannel( mMute );
+		}
 
-		case GAME_STATE_PLAYING:
-			StatePlaying();
-			break;
+		// the high score table needs the ui so it can't live in the world
+		if ( mWorld.GetState().GetHeader().mCurrentState == GAME_STATE_HIGH_SCORE ) {
+			StateHighScore();
+		} else {
+			worldInput_t input = {};
 
-		case GAME_STATE_DIED:
-			StateDied();
-			break;
+			if ( gInput->IsKeyDown( KEY_MOVE_LEFT ) ) {
+				input.mMoveDirection -= 1.0f;
+			}
 
-		case GAME_STATE_HIGH_SCORE:
-			StateHighScore();
-			break;
+			if ( gInput->IsKeyDown( KEY_MOVE_RIGHT ) ) {
+				input.mMoveDirection += 1.0f;
+			}
+
+			input.mStartPressed = gInput->IsKeyPressed( KEY_START_GAME );
+
+			if ( gInput->IsKeyPressed( KEY_MULTI_BALL ) && mWorld.GetState().GetHeader().mCurrentState == GAME_STATE_PLAYING ) {
+				mWorld.SpawnBalls( MULTI_BALL_SPAWN_COUNT, mWorld.GetState().GetHeader().mBallPosition );
+			}
+
+			u32 eventTypes = mWorld.Tick( input, mDeltaTime );
+			PlayWorldEventSounds( eventTypes );
+			ReadWorldEvents();
+
+			if ( mEndless ) {
+				mStreamer.Update( mWorld );
+			}
 		}
 
 		// show hud
 		{
 			gUI->PushWindow( ImVec2( 0, 0 ), ImVec4( 0, 0, 0, 0 ) );
 
-			ImGui::Text( "SCORE: %d", mPlayerScore );
-			ImGui::SameLine(); ImGui::Text( "LIVES: %d", mPlayerLives );
+			const gameStateHeader_t& state = mWorld.GetState().GetHeader();
+
+			ImGui::Text( "SCORE: %d", state.mPlayerScore );
+			ImGui::SameLine(); ImGui::Text( "LIVES: %d", state.mPlayerLives );
 			ImGui::Text( "MUTE: %s", mMute ? "ON" : "OFF" );
 
 			if ( mShowDebug ) {
 				ImGui::Text( "%s", mDebugText.c_str() );
+				ImGui::Text( "BALLS: %u (%u PAIRS TESTED)", state.mNumBalls + 1, mWorld.GetNumBallPairsTested() );
+				ImGui::Text( "EVENTS: %u WALL, %u BLOCK, %u PLAYER, %u LIFE (%u DROPPED)",
+					mEventCounts[GAME_EVENT_HIT_WALL], mEventCounts[GAME_EVENT_HIT_BLOCK], mEventCounts[GAME_EVENT_HIT_PLAYER], mEventCounts[GAME_EVENT_LIFE_LOST], mNumEventsDropped );
+
+				VulkanContext* context = gRenderer->GetContext();
+
+				if ( context ) {
+					const quadUploadStats_t& uploadStats = gRenderer->GetUploadStats();
+					ImGui::Text( "QUAD UPLOAD: %u QUADS IN %u RANGES (%zu BYTES)", uploadStats.mNumQuads, uploadStats.mNumRanges, uploadStats.mSizeBytes );
+					const FrameAllocator* frameAllocator = context->GetFrameAllocator();
+					ImGui::Text( "FRAME ALLOCATOR: %zu / %zu BYTES PEAK", frameAllocator->GetPeakBytes(), frameAllocator->GetRegionSizeBytes() );
+					const renderGraphStats_t& graphStats = context->GetRenderGraph()->GetStats();
+					ImGui::Text( "RENDER GRAPH: %u PASSES (%u CULLED), %u BARRIERS", graphStats.mNumPasses, graphStats.mNumCulledPasses, graphStats.mNumBarriers );
+
+					// these are a few frames behind, reading them back as soon as they're done would stall
+					const GPUProfiler* profiler = context->GetGPUProfiler();
+					for ( u32 scopeIndex = 0; scopeIndex < profiler->GetNumScopes(); scopeIndex++ ) {
+						const gpuScopeTiming_t& scope = profiler->GetScope( scopeIndex );
+						ImGui::Text( "GPU %s: %.3f MS (AVG %.3f MS)", scope.mName, scope.mMilliseconds, scope.mAverageMilliseconds );
+					}
+				} else {
+					// last frame's, this one hasn't been drawn yet
+					const rasteriserStats_t& stats = gRenderer->GetRasteriser()->GetStats();
+					ImGui::Text( "SOFTWARE: %u QUADS, %u TRIANGLES, %u BINNED", stats.mNumQuads, stats.mNumTriangles, stats.mNumBinEntries );
+					ImGui::Text( "BIN: %.3f MS, RASTERISE: %.3f MS", stats.mBinMilliseconds, stats.mRasteriseMilliseconds );
+				}
+
+				if ( mEndless ) {
+					const streamerStats_t& stats = mStreamer.GetStats();
+
+					ImGui::Text( "CHUNKS: %u (GEN AVG %.3f MS, MAX %.3f MS)", stats.mChunksGenerated, stats.GetAverageGenerateMilliseconds(), stats.mMaxGenerateMilliseconds );
+					ImGui::Text( "STALLS: %u (MAX %.3f MS)", stats.mStalls, stats.mMaxStallMilliseconds );
+				}
 			}
 
 			gUI->PopWindow();
@@ -266,11 +348,7 @@ void Game::Frame() {
 	{
 		gRenderer->StartFrame();
 
-		for ( Entity* block : mBlocks ) {
-			block->Render();
-		}
-		mBall->Render();
-		mPlayer->Render();
+		UpdateQuads();
 
 		gRenderer->DrawElements();
 
@@ -300,41 +378,15 @@ void Game::Frame() {
 
 /*
 ========================
-Game::StateWaiting
-========================
-*/
-void Game::StateWaiting() {
-	if ( gInput->IsKeyPressed( KEY_START_GAME ) ) {
-		mCurrentState = GAME_STATE_PLAYING;
-	}
-}
-
-/*
-========================
-Game::StatePlaying
+Game::ResetLevel
 ========================
 */
-void Game::StatePlaying() {
-	UpdatePlayer();
-	UpdateBall();
-
-	if ( mHitBlocks == mBlocks.length() ) {
-		GameOver();
-	}
-}
+void Game::ResetLevel() {
+	mWorld.ResetLevel();
+	mBlockQuadsDirty = true;
 
-/*
-========================
-Game::StateDied
-========================
-*/
-void Game::StateDied() {
-	if ( gInput->IsKeyPressed( KEY_START_GAME ) ) {
-		if ( mPlayerLives > 0 ) {
-			ResetPlayerAndBall();
-		} else {
-			GameOver();
-		}
+	if ( mEndless ) {
+		mStreamer.Reset( mWorld );
 	}
 }
 
@@ -365,7 +417,9 @@ void Game::StateHighScore() {
 
 	// if player got a new high score let them enter their name
 	// otherwise wait for them to press the continue button
-	if ( gScoresManager->RankScore( mPlayerScore ) == -1 ) {
+	u32 playerScore = mWorld.GetState().GetHeader().mPlayerScore;
+
+	if ( gScoresManager->RankScore( playerScore ) == -1 ) {
 		if ( gInput->IsKeyPressed( KEY_START_GAME ) ) {
 			ResetLevel();
 		}
@@ -378,7 +432,7 @@ void Game::StateHighScore() {
 		if ( ImGui::InputText( "", inputBuffer, SCORE_NAME_LENGTH_MAX + 1, ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CharsUppercase ) ) {
 			inputBuffer[SCORE_NAME_LENGTH_MAX] = 0;
 
-			gScoresManager->TryAddScore( inputBuffer, mPlayerScore );
+			gScoresManager->TryAddScore( inputBuffer, playerScore );
 			gScoresManager->WriteScores();
 
 			ResetLevel();
@@ -390,204 +444,141 @@ void Game::StateHighScore() {
 
 /*
 ========================
-Game::UpdatePlayer
+Game::PlayWorldEventSounds
 ========================
 */
-void Game::UpdatePlayer() {
-	mPlayer->UpdateBB();
-
-	// reset direction on a per-frame basis
-	mPlayerDirection = glm::vec3( 0.0f );
-
-	if ( gInput->IsKeyDown( KEY_MOVE_LEFT ) && mPlayer->GetBB().GetLeft() >= -6.5f ) {
-		mPlayerDirection.x = -1.0f;
+void Game::PlayWorldEventSounds( const u32 eventTypes ) {
+	// one sound per type of event no matter how many of them happened, otherwise multi-ball is deafening
+	if ( eventTypes & GAME_EVENT_BIT( GAME_EVENT_HIT_WALL ) ) {
+		gSoundSystem->PlaySound( mSoundHitWalls );
 	}
 
-	if ( gInput->IsKeyDown( KEY_MOVE_RIGHT ) && mPlayer->GetBB().GetRight() <= 6.5f ) {
-		mPlayerDirection.x = 1.0f;
+	if ( eventTypes & GAME_EVENT_BIT( GAME_EVENT_HIT_BLOCK ) ) {
+		gSoundSystem->PlaySound( mSoundHitBlock );
 	}
 
-	if ( gInput->IsKeyPressed( KEY_MUTE_SOUND ) ) {
-		mMute = !mMute;
-		gSoundSystem->MuteMainChannel( mMute );
+	if ( eventTypes & GAME_EVENT_BIT( GAME_EVENT_HIT_PLAYER ) ) {
+		gSoundSystem->PlaySound( mSoundHitPlayer );
 	}
-
-	mPlayer->Translate( mPlayerDirection * PLAYER_MOVE_SPEED * mDeltaTime );
 }
 
 /*
 ========================
-Game::UpdateBall
+Game::ReadWorldEvents
 ========================
 */
-void Game::UpdateBall() {
-	mBall->UpdateBB();
-
-	glm::vec4 pointScreen( 2.0f * GAME_WIDTH / GAME_WIDTH - 1.0f, 2.0f * GAME_HEIGHT / GAME_HEIGHT - 1.0f, 1.0f, 1.0f );
-
-	glm::vec3 screenToWorld = gRenderer->GetClipToWorld() * pointScreen;
-	float32 screenBoundRight = screenToWorld.x;
-	float32 screenBoundTop = screenToWorld.y;
-
-	// check collision with screen bounds
-	if ( mBall->GetBB().GetLeft() <= -screenBoundRight ) {
-		mBall->TranslateX( mBallMoveSpeed * mDeltaTime );
-		mBallDirection.x *= -1.0f;
-
-		gSoundSystem->PlaySound( mSoundHitWalls );
-	}
-
-	if ( mBall->GetBB().GetRight() >= screenBoundRight ) {
-		mBall->TranslateX( -mBallMoveSpeed * mDeltaTime );
-		mBallDirection.x *= -1.0f;
-
-		gSoundSystem->PlaySound( mSoundHitWalls );
-	}
-
-	if ( mBall->GetBB().GetBottom() <= -screenBoundTop ) {
-		mCurrentState = GAME_STATE_DIED;
-		mPlayerLives--;
-	}
-
-	if ( mBall->GetBB().GetTop() >= screenBoundTop ) {
-		mBall->TranslateY( -mBallMoveSpeed * mDeltaTime );
-		mBallDirection.y *= -1.0f;
+void Game::ReadWorldEvents() {
+	const u32 batchSize = 256;
+	gameEvent_t events[batchSize];
 
-		gSoundSystem->PlaySound( mSoundHitWalls );
-	}
+	const GameEventQueue& queue = mWorld.GetEvents();
 
-	// check collision with blocks
-	for ( Entity* block : mBlocks ) {
-		if ( !block->IsActive() ) {
-			continue;
-		}
+	u32 numEvents = 0;
+	u32 numDropped = 0;
 
-		bbCollisionSide_t collision = mBall->GetSideCollidedWith( block );
+	while ( ( numEvents = queue.Read( mEventCursor, events, batchSize, &numDropped ) ) > 0 ) {
+		for ( u32 i = 0; i < numEvents; i++ ) {
+			const gameEvent_t& event = events[i];
 
-		// I imagine this can be condensed some more
-		// but this is good _enough_?
-		if ( collision != BB_COLLISION_SIDE_NONE ) {
-			switch ( collision ) {
-			case BB_COLLISION_SIDE_TOP:
-			case BB_COLLISION_SIDE_BOTTOM:
-				mBallDirection.y *= -1.0f;
-				mBall->TranslateY( mBallMoveSpeed * mBallDirection.y * mDeltaTime );
-				break;
+			mEventCounts[event.mType]++;
 
-			case BB_COLLISION_SIDE_LEFT:
-			case BB_COLLISION_SIDE_RIGHT:
-				mBallDirection.x *= -1.0f;
-				mBall->TranslateX( mBallMoveSpeed * mBallDirection.x * mDeltaTime );
-				break;
-
-			default:
-				// nothing
-				break;
+			// a broken block is the only thing that changes a block's quad mid-level
+			if ( event.mType == GAME_EVENT_HIT_BLOCK && ( event.mFlags & GAME_EVENT_FLAG_BLOCK_BROKEN ) ) {
+				gRenderer->HideQuad( event.mBlockIndex );
 			}
-
-			mPlayerScore += block->GetScoreValue();
-			block->SetActive( false );
-			mHitBlocks++;
-
-			gSoundSystem->PlaySound( mSoundHitBlock );
-
-			break;
 		}
-	}
-
-	// check collision with player
-	bbCollisionSide_t collisionSide = mBall->GetSideCollidedWith( mPlayer );
-	switch ( collisionSide ) {
-	case BB_COLLISION_SIDE_TOP:
-		mBall->TranslateY( -mBallMoveSpeed * mDeltaTime );
-		mBallDirection.y *= -1.0f;
-
-		gSoundSystem->PlaySound( mSoundHitPlayer );
-		break;
-
-	case BB_COLLISION_SIDE_BOTTOM: {
-		mBall->TranslateY( mBallMoveSpeed * mDeltaTime );
-
-		float32 dx = mBall->GetPosition().x - mPlayer->GetPosition().x;
-		float32 variance = random<float32>( 0.25f, 1.0f );
-		float32 newDirX = ( mBallDirection.x + mPlayerDirection.x + dx ) * variance;
 
-		mBallDirection.x = glm::clamp( newDirX, -1.0f, 1.0f );
-		mBallDirection.y *= -1.0f;
-
-		mBallMoveSpeed += mBallSpeedIncrease;
-
-		gSoundSystem->PlaySound( mSoundHitPlayer );
-		break;
-	}
-
-	case BB_COLLISION_SIDE_LEFT:
-		mBall->TranslateX( mBallMoveSpeed * PLAYER_MOVE_SPEED * mDeltaTime );
-		mBallDirection.x = 1.0f;
-
-		gSoundSystem->PlaySound( mSoundHitPlayer );
-		break;
-
-	case BB_COLLISION_SIDE_RIGHT:
-		mBall->TranslateX( -mBallMoveSpeed * PLAYER_MOVE_SPEED * mDeltaTime );
-		mBallDirection.x = -1.0f;
-
-		gSoundSystem->PlaySound( mSoundHitPlayer );
-		break;
+		// missed some breaks so don't know which blocks went
+		if ( numDropped > 0 ) {
+			mBlockQuadsDirty = true;
+		}
 
-	case BB_COLLISION_SIDE_NONE:
-	default:
-		// nothing
-		break;
+		mNumEventsDropped += numDropped;
 	}
-
-	mBall->Translate( mBallDirection * mBallMoveSpeed * mDeltaTime );
 }
 
 /*
 ========================
-Game::ResetPlayerAndBall
+Game::UploadPalette
 ========================
 */
-void Game::ResetPlayerAndBall() {
-	// init player
-	glm::vec3 playerStartPos( 0.0f, -4.0f, 1.0f );
-	glm::vec2 playerSize( 1.0f, 0.15f );
-	mPlayer->Init( playerStartPos, playerSize, Entity::COLORS[0] );
-
-	// init ball
-	glm::vec3 ballStartPos = playerStartPos + glm::vec3( 0.0f, 0.5f, 0.0f );
-	glm::vec2 ballSize( 0.15f, 0.15f );
-	mBall->Init( ballStartPos, ballSize, Entity::COLORS[0] );
-	
-	mBallDirection = glm::vec3( 1.0f, 1.0f, 0.0f );
-	mBallMoveSpeed = BALL_START_MOVE_SPEED;
-
-	mCurrentState = GAME_STATE_WAITING;
+void Game::UploadPalette() {
+	const blockTable_t& blockTable = *mWorld.GetBlockTable();
+
+	// block color indices go straight through, the player's color comes after the last one
+	mNumBlockColors = min( blockTable.mNumColors, static_cast<u32>( RENDERER_PALETTE_SIZE - 1 ) );
+	mPlayerColorIndex = mNumBlockColors;
+
+	glm::vec4 palette[RENDERER_PALETTE_SIZE];
+	memcpy( palette, blockTable.mPalette, mNumBlockColors * sizeof( glm::vec4 ) );
+	palette[mPlayerColorIndex] = PLAYER_COLOR;
+
+	gRenderer->SetPalette( palette, mPlayerColorIndex + 1 );
 }
 
 /*
 ========================
-Game::ResetLevel
+Game::UpdateQuads
 ========================
 */
-void Game::ResetLevel() {
-	for ( Entity* block : mBlocks ) {
-		block->SetActive( true );
+void Game::UpdateQuads() {
+	const GameState& worldState = mWorld.GetState();
+	const gameStateHeader_t& state = worldState.GetHeader();
+
+	if ( mEndless && mStreamer.GetBlockTableVersion() != mStreamerVersion ) {
+		mStreamerVersion = mStreamer.GetBlockTableVersion();
+		mBlockQuadsDirty = true;
+	}
+
+	if ( mBlockQuadsDirty ) {
+		SyncBlockQuads();
+		mBlockQuadsDirty = false;
+	}
+
+	// block i is quad i, the balls and the paddle come after all of them
+	u32 quadIndex = mWorld.GetBlockTable()->GetNumBlocks();
+
+	gRenderer->SetQuad( quadIndex++, state.mBallPosition, state.mBallHalfSize, mPlayerColorIndex );
+
+	constBallPool_t balls = worldState.GetBalls();
+	for ( u32 ballIndex = 0; ballIndex < NUM_BALLS_MAX; ballIndex++ ) {
+		if ( ballIndex < state.mNumBalls ) {
+			glm::vec2 position( balls.mPositionsX[ballIndex], balls.mPositionsY[ballIndex] );
+			gRenderer->SetQuad( quadIndex++, position, state.mBallHalfSize, mPlayerColorIndex );
+		} else {
+			gRenderer->HideQuad( quadIndex++ );
+		}
 	}
 
-	mPlayerLives = NUM_MAX_PLAYER_LIVES;
-	mPlayerScore = 0;
-	mHitBlocks = 0;
+	gRenderer->SetQuad( quadIndex++, state.mPlayerPosition, state.mPlayerHalfSize, mPlayerColorIndex );
 
-	ResetPlayerAndBall();
+	gRenderer->SetNumQuads( quadIndex );
 }
 
 /*
 ========================
-Game::GameOver
+Game::SyncBlockQuads
 ========================
 */
-void Game::GameOver() {
-	mCurrentState = GAME_STATE_HIGH_SCORE;
+void Game::SyncBlockQuads() {
+	const GameState& worldState = mWorld.GetState();
+	const blockTable_t& blockTable = *mWorld.GetBlockTable();
+
+	// only the blocks that actually differ from what the renderer already has get uploaded
+	for ( u32 blockIndex = 0; blockIndex < blockTable.GetNumBlocks(); blockIndex++ ) {
+		if ( !worldState.IsBlockActive( blockIndex ) ) {
+			gRenderer->HideQuad( blockIndex );
+			continue;
+		}
+
+		// endless mode keeps chunks resident above the top of the screen
+		if ( blockTable.mPositions[blockIndex].y - blockTable.mHalfSizes[blockIndex].y > GameWorld::SCREEN_BOUND_TOP ) {
+			gRenderer->HideQuad( blockIndex );
+			continue;
+		}
+
+		// color indices come straight from the level file so don't trust them
+		u32 colorIndex = min( blockTable.mColorIndices[blockIndex], mNumBlockColors - 1 );
+		gRenderer->SetQuad( blockIndex, blockTable.mPositions[blockIndex], blockTable.mHalfSizes[blockIndex], colorIndex );
+	}
 }
\ No newline at end of file
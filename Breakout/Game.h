@@ -17,6 +17,9 @@
 #pragma warning( default : 4201 )
 
 #include "Defines.h"
+#include "GameWorld.h"
+#include "Level.h"
+#include "LevelStreamer.h"
 
 class Window;
 class InputHandler;
@@ -24,15 +27,6 @@ class Renderer;
 class SoundSystem;
 struct audioObject_t;
 
-class Entity;
-
-enum gameState_t {
-	GAME_STATE_WAITING,
-	GAME_STATE_PLAYING,
-	GAME_STATE_DIED,
-	GAME_STATE_HIGH_SCORE,
-};
-
 /*
 ================================================================================================
 
@@ -48,7 +42,9 @@ public:
 						Game();
 						~Game();
 
-	bool32				Init();
+	// endless mode streams in procedurally generated blocks instead of loading a level
+	// software draws on the CPU and doesn't need Vulkan, see SoftwareRasteriser
+	bool32				Init( const bool32 endless = false, const bool32 usePipelineCache = true, const bool32 useDynamicRendering = true, const bool32 useBindless = false, const bool32 useSoftware = false );
 	void				Shutdown();
 
 	void				Frame();
@@ -58,7 +54,7 @@ public:
 	inline float32		GetDeltaTime() const { return mDeltaTime; }
 
 private:
-	static const u32	BLOCK_ROW_SCORES[];
+	static const glm::vec4	PLAYER_COLOR;
 
 	// not sure where else these could live
 	audioObject_t*		mSoundHitPlayer;
@@ -67,18 +63,10 @@ private:
 
 	string				mDebugText;
 
-	array<Entity*>		mBlocks;
-	Entity*				mPlayer;
-	Entity*				mBall;
-
-	glm::vec3			mBallDirection, mPlayerDirection;
-	
-	float32				mBallMoveSpeed;
-	float32				mBallSpeedIncrease;
-
-	u32					mPlayerScore;
-	u32					mPlayerLives;
-	u32					mHitBlocks;
+	GameWorld			mWorld;
+	Level				mLevel;
+	LevelStreamer		mStreamer;
+	bool32				mEndless;
 
 	SDL_Event			mEvent;
 
@@ -91,24 +79,33 @@ private:
 	float32				mFPSTimer;
 	u32					mFrames;
 
-	gameState_t			mCurrentState;
-
 	bool32				mMute;
 	bool32				mShowDebug;
 
-private:
-	void				StateWaiting();
-	void				StatePlaying();
-	void				StateDied();
-	void				StateHighScore();
+	// running totals of every event the world has made, for the debug hud
+	u32					mEventCursor;
+	u32					mEventCounts[GAME_EVENT_COUNT];
+	u32					mNumEventsDropped;
+
+	// blocks are retained quads, this is set when they all need looking at again instead of just the ones that broke
+	bool32				mBlockQuadsDirty;
+	u32					mStreamerVersion;
 
-	void				UpdatePlayer();
-	void				UpdateBall();
+	// the renderer's palette is the block colors and then the player's
+	u32					mNumBlockColors;
+	u32					mPlayerColorIndex;
 
-	void				ResetPlayerAndBall();
+private:
 	void				ResetLevel();
 
-	void				GameOver();
+	void				StateHighScore();
+
+	void				PlayWorldEventSounds( const u32 eventTypes );
+	void				ReadWorldEvents();
+
+	void				UploadPalette();
+	void				UpdateQuads();
+	void				SyncBlockQuads();
 };
 
 extern Game* gGame;
@@ -0,0 +1,112 @@
+#include "GameEventQueue.h"
+
+/*
+================================================================================================
+
+	GameEventQueue
+
+================================================================================================
+*/
+
+/*
+========================
+GameEventQueue::GameEventQueue
+========================
+*/
+GameEventQueue::GameEventQueue() {
+	mEvents = nullptr;
+	mMask = 0;
+
+	mHead = 0;
+	mTickStart = 0;
+	mTickTypes = 0;
+}
+
+/*
+========================
+GameEventQueue::~GameEventQueue
+========================
+*/
+GameEventQueue::~GameEventQueue() {
+	Shutdown();
+}
+
+/*
+========================
+GameEventQueue::Init
+========================
+*/
+void GameEventQueue::Init( const u32 capacity ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call GameEventQueue::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( capacity > 0 ), "GameEventQueue needs room for at least one event!\n" );
+
+	u32 powerOf2 = 1;
+	while ( powerOf2 < capacity ) {
+		powerOf2 <<= 1;
+	}
+
+	mEvents = new gameEvent_t[powerOf2];
+	mMask = powerOf2 - 1;
+
+	mHead = 0;
+	mTickStart = 0;
+	mTickTypes = 0;
+}
+
+/*
+========================
+GameEventQueue::Shutdown
+========================
+*/
+void GameEventQueue::Shutdown() {
+	delete[] mEvents;
+	mEvents = nullptr;
+
+	mMask = 0;
+}
+
+/*
+========================
+GameEventQueue::BeginTick
+========================
+*/
+void GameEventQueue::BeginTick() {
+	// if the last tick wrote more than fits then its first events have already been overwritten
+	assertf( ( GetNumTickEvents() <= GetCapacity() ), "GameEventQueue overflowed in one tick, it needs to be bigger!\n" );
+
+	mTickStart = mHead;
+	mTickTypes = 0;
+}
+
+/*
+========================
+GameEventQueue::Read
+========================
+*/
+u32 GameEventQueue::Read( u32& cursor, gameEvent_t* outEvents, const u32 maxEvents, u32* outNumDropped ) const {
+	u32 numDropped = 0;
+
+	// fell too far behind, the oldest ones are gone
+	if ( mHead - cursor > GetCapacity() ) {
+		numDropped = ( mHead - cursor ) - GetCapacity();
+		cursor = mHead - GetCapacity();
+	}
+
+	u32 numEvents = min( mHead - cursor, maxEvents );
+
+	for ( u32 i = 0; i < numEvents; i++ ) {
+		outEvents[i] = mEvents[( cursor + i ) & mMask];
+	}
+
+	cursor += numEvents;
+
+	if ( outNumDropped ) {
+		*outNumDropped = numDropped;
+	}
+
+	return numEvents;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef __GAME_EVENT_QUEUE_H__
+#define __GAME_EVENT_QUEUE_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+// things that happened during a tick that something outside the collision code cares about
+enum gameEventType_t {
+	GAME_EVENT_HIT_WALL		= 0,
+	GAME_EVENT_HIT_BLOCK,
+	GAME_EVENT_HIT_PLAYER,
+	GAME_EVENT_LIFE_LOST,
+
+	GAME_EVENT_COUNT
+};
+
+#define GAME_EVENT_BIT( type )		( 1u << ( type ) )
+
+enum gameEventFlag_t {
+	GAME_EVENT_FLAG_NONE			= 0,
+	GAME_EVENT_FLAG_EXTRA_BALL		= 1 << 0,	// it was a multi-ball ball and not the main one
+	GAME_EVENT_FLAG_BLOCK_BROKEN	= 1 << 1,	// the block ran out of hit points
+};
+
+struct gameEvent_t {
+	u16						mType;			// gameEventType_t
+	u16						mFlags;			// gameEventFlag_t
+	u32						mBlockIndex;	// only for GAME_EVENT_HIT_BLOCK
+	glm::vec2				mPosition;		// where the ball was
+};
+
+/*
+================================================================================================
+
+	Breakout Game Event Queue
+
+	A fixed size ring of gameEvent_ts. Collision code just appends to it and carries on, and
+	everything that reacts to what happened (scoring, sound, stats) reads the events back in
+	one batch once the tick is done.
+
+	Every event gets a sequence number that only ever goes up. The events for the current tick
+	are [GetTickStart(), GetHead()). Consumers that don't run every tick keep their own cursor
+	and call Read(), which copies the events out so they can be handed to another thread. The
+	ring MUST be big enough for one tick's worth of events, anything older than the last
+	GetCapacity() events is overwritten and a Read() that falls that far behind skips them.
+
+	GetTickTypes() has a bit set for every type of event written this tick, so something that
+	only wants to know if a type happened (e.g. only one hit sound per tick) doesn't have to
+	look at the events at all.
+
+================================================================================================
+*/
+
+class GameEventQueue {
+public:
+							GameEventQueue();
+							~GameEventQueue();
+
+	// capacity gets rounded up to a power of 2
+	void					Init( const u32 capacity );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mEvents != nullptr; }
+
+	inline u32				GetCapacity() const { return mMask + 1; }
+
+	void					BeginTick();
+
+	inline void				Push( const gameEventType_t type, const u32 flags, const u32 blockIndex, const glm::vec2& position );
+
+	inline u32				GetTickStart() const { return mTickStart; }
+	inline u32				GetHead() const { return mHead; }
+	inline u32				GetTickTypes() const { return mTickTypes; }
+
+	inline u32				GetNumTickEvents() const { return mHead - mTickStart; }
+
+	// sequence MUST be one of the last GetCapacity() events
+	inline const gameEvent_t&	GetEvent( const u32 sequence ) const { return mEvents[sequence & mMask]; }
+
+	// copies up to maxEvents events starting at cursor into outEvents and moves cursor past them
+	// returns how many were copied, outNumDropped is how many were skipped because they'd already been overwritten
+	u32						Read( u32& cursor, gameEvent_t* outEvents, const u32 maxEvents, u32* outNumDropped = nullptr ) const;
+
+private:
+	gameEvent_t*			mEvents;
+	u32						mMask;
+
+	u32						mHead;
+	u32						mTickStart;
+	u32						mTickTypes;
+};
+
+/*
+========================
+GameEventQueue::Push
+========================
+*/
+void GameEventQueue::Push( const gameEventType_t type, const u32 flags, const u32 blockIndex, const glm::vec2& position ) {
+	gameEvent_t& event = mEvents[mHead & mMask];
+	event.mType = static_cast<u16>( type );
+	event.mFlags = static_cast<u16>( flags );
+	event.mBlockIndex = blockIndex;
+	event.mPosition = position;
+
+	mHead++;
+	mTickTypes |= GAME_EVENT_BIT( type );
+}
+
+#endif // __GAME_EVENT_QUEUE_H__
\ No newline at end of file
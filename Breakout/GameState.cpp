@@ -0,0 +1,170 @@
+#include "GameState.h"
+
+/*
+================================================================================================
+
+	GameState
+
+================================================================================================
+*/
+
+/*
+========================
+GameState::GameState
+========================
+*/
+GameState::GameState() {
+	mMemory = nullptr;
+	mSizeBytes = 0;
+	mOwnsMemory = false;
+
+	mHeader = nullptr;
+	mBlockBits = nullptr;
+	mHitPoints = nullptr;
+	memset( &mBalls, 0, sizeof( ballPool_t ) );
+}
+
+/*
+========================
+GameState::~GameState
+========================
+*/
+GameState::~GameState() {
+	Shutdown();
+}
+
+/*
+========================
+GameState::Init
+========================
+*/
+void GameState::Init( const u32 numBlocks, const u32 maxBalls, void* memory ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call GameState::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mSizeBytes = CalcSizeBytes( numBlocks, maxBalls );
+	mOwnsMemory = memory == nullptr;
+	mMemory = mOwnsMemory ? new u8[mSizeBytes] : static_cast<u8*>( memory );
+	memset( mMemory, 0, mSizeBytes );
+
+	mHeader = reinterpret_cast<gameStateHeader_t*>( mMemory );
+	mBlockBits = reinterpret_cast<u32*>( mMemory + sizeof( gameStateHeader_t ) );
+
+	mHitPoints = reinterpret_cast<u8*>( mBlockBits + ( ( numBlocks + 31 ) / 32 ) );
+
+	float32* ballComponents = reinterpret_cast<float32*>( mHitPoints + ( ( numBlocks + 3 ) & ~3u ) );
+	mBalls.mPositionsX = ballComponents;
+	mBalls.mPositionsY = ballComponents + maxBalls;
+	mBalls.mVelocitiesX = ballComponents + ( maxBalls * 2 );
+	mBalls.mVelocitiesY = ballComponents + ( maxBalls * 3 );
+
+	mHeader->mNumBlocks = numBlocks;
+	mHeader->mMaxBalls = maxBalls;
+	mHeader->mRandomState = 0x9E3779B9;	// xorshift can't start at 0
+}
+
+/*
+========================
+GameState::Shutdown
+========================
+*/
+void GameState::Shutdown() {
+	if ( mOwnsMemory ) {
+		delete[] mMemory;
+	}
+	mMemory = nullptr;
+	mSizeBytes = 0;
+	mOwnsMemory = false;
+
+	mHeader = nullptr;
+	mBlockBits = nullptr;
+	mHitPoints = nullptr;
+	memset( &mBalls, 0, sizeof( ballPool_t ) );
+}
+
+/*
+========================
+GameState::CalcSizeBytes
+========================
+*/
+size_t GameState::CalcSizeBytes( const u32 numBlocks, const u32 maxBalls ) {
+	size_t numBlockWords = ( numBlocks + 31 ) / 32;
+	size_t hitPointsBytes = ( numBlocks + 3 ) & ~3u;	// keeps the balls aligned
+
+	return sizeof( gameStateHeader_t ) + ( numBlockWords * sizeof( u32 ) ) + hitPointsBytes + ( maxBalls * 4 * sizeof( float32 ) );
+}
+
+/*
+========================
+GameState::SetAllBlocksActive
+========================
+*/
+void GameState::SetAllBlocksActive() {
+	u32 numBlocks = mHeader->mNumBlocks;
+	u32 numFullWords = numBlocks / 32;
+
+	memset( mBlockBits, 0xFF, numFullWords * sizeof( u32 ) );
+
+	// don't set the bits past the last block otherwise counting them breaks
+	u32 remainder = numBlocks & 31;
+	if ( remainder > 0 ) {
+		mBlockBits[numFullWords] = ( 1u << remainder ) - 1;
+	}
+}
+
+/*
+========================
+GameState::SetAllBlockHitPoints
+========================
+*/
+void GameState::SetAllBlockHitPoints( const u8* hitPoints ) {
+	memcpy( mHitPoints, hitPoints, mHeader->mNumBlocks );
+}
+
+/*
+========================
+GameState::RandomFloat
+========================
+*/
+float32 GameState::RandomFloat( const float32 min, const float32 max ) {
+	// xorshift32 so that the random numbers are part of the snapshot
+	u32 x = mHeader->mRandomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	mHeader->mRandomState = x;
+
+	float32 t = static_cast<float32>( x >> 8 ) / static_cast<float32>( 1 << 24 );
+	return min + ( max - min ) * t;
+}
+
+/*
+========================
+GameState::Snapshot
+========================
+*/
+void GameState::Snapshot( void* dest ) const {
+	memcpy( dest, mMemory, mSizeBytes );
+}
+
+/*
+========================
+GameState::Restore
+========================
+*/
+void GameState::Restore( const void* source ) {
+	memcpy( mMemory, source, mSizeBytes );
+}
+
+/*
+========================
+GameState::CopyFrom
+========================
+*/
+void GameState::CopyFrom( const GameState& other ) {
+	assertf( ( mSizeBytes == other.mSizeBytes ), "Cannot copy game states that were initialised with a different number of blocks!\n" );
+
+	memcpy( mMemory, other.mMemory, mSizeBytes );
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#ifndef __GAME_STATE_H__
+#define __GAME_STATE_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+enum gameState_t {
+	GAME_STATE_WAITING,
+	GAME_STATE_PLAYING,
+	GAME_STATE_DIED,
+	GAME_STATE_HIGH_SCORE,
+};
+
+// everything about the game that changes while it's being played
+// this MUST stay POD because the whole thing gets memcpy'd for snapshots
+struct gameStateHeader_t {
+	glm::vec2						mBallPosition;
+	glm::vec2						mBallHalfSize;
+	glm::vec2						mBallDirection;
+
+	glm::vec2						mPlayerPosition;
+	glm::vec2						mPlayerHalfSize;
+	glm::vec2						mPlayerDirection;
+
+	float32							mBallMoveSpeed;
+
+	u32								mPlayerScore;
+	u32								mPlayerLives;
+	u32								mHitBlocks;
+
+	u32								mRandomState;
+
+	u32								mNumBlocks;
+
+	// multi-ball, these don't include the main ball above
+	u32								mMaxBalls;
+	u32								mNumBalls;
+
+	gameState_t						mCurrentState;
+};
+
+// the extra balls for multi-ball, one array per component so they can be walked straight through
+// all of them share the main ball's half size, the ones in use are always [0, mNumBalls)
+struct ballPool_t {
+	float32*						mPositionsX;
+	float32*						mPositionsY;
+	float32*						mVelocitiesX;
+	float32*						mVelocitiesY;
+};
+
+// the same arrays for anything that only has a const GameState, so it can't write through them
+struct constBallPool_t {
+	const float32*					mPositionsX;
+	const float32*					mPositionsY;
+	const float32*					mVelocitiesX;
+	const float32*					mVelocitiesY;
+};
+
+// the layout of the blocks never changes while playing so it doesn't live in the game state
+// this doesn't own any of the memory it points to, see Level
+struct blockTable_t {
+	const glm::vec4*				mPalette;
+	u32								mNumColors;
+
+	const glm::vec2*				mPositions;
+	const glm::vec2*				mHalfSizes;
+	const u32*						mColorIndices;
+	const u32*						mScoreValues;
+	const u8*						mHitPoints;		// how many hits each block takes to break when the level starts
+	u32								mNumBlocks;
+
+	inline u32						GetNumBlocks() const { return mNumBlocks; }
+};
+
+/*
+================================================================================================
+
+	Breakout Game State
+
+	One contiguous block of memory that holds all the mutable gameplay state: a header for the
+	ball, the player, and the score followed by one bit per block for whether or not that block
+	is still active, then how many hit points each block has left, then the pool of extra balls
+	for multi-ball (if there is one).
+
+	Because nothing inside the block points to anything else a snapshot or a restore is a
+	single memcpy, so it's cheap enough to do every tick (rewind, save states, what-if sims).
+
+================================================================================================
+*/
+
+class GameState {
+public:
+									GameState();
+									~GameState();
+
+	// if memory is null the state allocates (and owns) its own memory
+	// otherwise memory MUST be at least CalcSizeBytes( numBlocks, maxBalls ) big and outlive the state
+	void							Init( const u32 numBlocks, const u32 maxBalls = 0, void* memory = nullptr );
+	void							Shutdown();
+	inline bool32					IsInitialised() const { return mMemory != nullptr; }
+
+	inline gameStateHeader_t&		GetHeader() { return *mHeader; }
+	inline const gameStateHeader_t&	GetHeader() const { return *mHeader; }
+
+	inline u32						GetNumBlocks() const { return mHeader->mNumBlocks; }
+
+	inline bool32					IsBlockActive( const u32 blockIndex ) const;
+	inline void						SetBlockActive( const u32 blockIndex, const bool32 active );
+	void							SetAllBlocksActive();
+
+	inline u8						GetBlockHitPoints( const u32 blockIndex ) const { return mHitPoints[blockIndex]; }
+	inline void						SetBlockHitPoints( const u32 blockIndex, const u8 hitPoints ) { mHitPoints[blockIndex] = hitPoints; }
+	void							SetAllBlockHitPoints( const u8* hitPoints );
+
+	// takes one hit point off the block, returns true if that broke it
+	inline bool32					DamageBlock( const u32 blockIndex );
+
+	inline const u32*				GetBlockBits() const { return mBlockBits; }
+
+	// the pointers are the state's, only the balls they point at can be written through the non-const one
+	inline const ballPool_t&		GetBalls() { return mBalls; }
+	inline constBallPool_t			GetBalls() const { return { mBalls.mPositionsX, mBalls.mPositionsY, mBalls.mVelocitiesX, mBalls.mVelocitiesY }; }
+
+	// returns a random float in the range [min, max) and advances the random state
+	float32							RandomFloat( const float32 min, const float32 max );
+
+	inline size_t					GetSizeBytes() const { return mSizeBytes; }
+	static size_t					CalcSizeBytes( const u32 numBlocks, const u32 maxBalls = 0 );
+
+	// dest/source MUST be at least GetSizeBytes() big
+	void							Snapshot( void* dest ) const;
+	void							Restore( const void* source );
+
+	// both states MUST have been initialised with the same number of blocks
+	void							CopyFrom( const GameState& other );
+
+private:
+	u8*								mMemory;
+	size_t							mSizeBytes;
+	bool32							mOwnsMemory;
+
+	gameStateHeader_t*				mHeader;
+	u32*							mBlockBits;
+	u8*								mHitPoints;
+	ballPool_t						mBalls;
+};
+
+/*
+========================
+GameState::IsBlockActive
+========================
+*/
+bool32 GameState::IsBlockActive( const u32 blockIndex ) const {
+	return ( mBlockBits[blockIndex >> 5] >> ( blockIndex & 31 ) ) & 1;
+}
+
+/*
+========================
+GameState::SetBlockActive
+========================
+*/
+void GameState::SetBlockActive( const u32 blockIndex, const bool32 active ) {
+	u32 mask = 1u << ( blockIndex & 31 );
+
+	if ( active ) {
+		mBlockBits[blockIndex >> 5] |= mask;
+	} else {
+		mBlockBits[blockIndex >> 5] &= ~mask;
+	}
+}
+
+/*
+========================
+GameState::DamageBlock
+========================
+*/
+bool32 GameState::DamageBlock( const u32 blockIndex ) {
+	u8& hitPoints = mHitPoints[blockIndex];
+
+	// <= so that a block with 0 hit points still breaks in one hit
+	if ( hitPoints <= 1 ) {
+		hitPoints = 0;
+		return true;
+	}
+
+	hitPoints--;
+	return false;
+}
+
+#endif // __GAME_STATE_H__
\ No newline at end of file
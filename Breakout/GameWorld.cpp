@@ -0,0 +1,570 @@
+#include "GameWorld.h"
+
+#include "BB.h"
+
+/*
+================================================================================================
+
+	GameWorld
+
+================================================================================================
+*/
+
+// matches the orthographic projection the renderer sets up
+const float32 GameWorld::SCREEN_BOUND_RIGHT = ( static_cast<float32>( GAME_WIDTH ) / static_cast<float32>( GAME_HEIGHT ) ) * ORTHO_SIZE;
+const float32 GameWorld::SCREEN_BOUND_TOP = ORTHO_SIZE;
+
+const float32 GameWorld::GRID_CELL_SIZE = 0.5f;
+
+// the most events one ball can make in a tick: two walls, a block, and the player
+// the main ball also checks every wall separately and can lose a life
+static const u32 MAX_EVENTS_MAIN_BALL = 8;
+static const u32 MAX_EVENTS_EXTRA_BALL = 4;
+
+/*
+========================
+GameWorld::GameWorld
+========================
+*/
+GameWorld::GameWorld() {
+	mBlockTable = nullptr;
+
+	mNumBallPairsTested = 0;
+}
+
+/*
+========================
+GameWorld::~GameWorld
+========================
+*/
+GameWorld::~GameWorld() {
+	Shutdown();
+}
+
+/*
+========================
+GameWorld::Init
+========================
+*/
+void GameWorld::Init( const blockTable_t* blockTable, const u32 seed, void* stateMemory, const u32 maxBalls ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call GameWorld::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( blockTable, "GameWorld::Init() needs a block table!\n" );
+
+	mBlockTable = blockTable;
+
+	mState.Init( mBlockTable->GetNumBlocks(), maxBalls, stateMemory );
+
+	mEventQueue.Init( MAX_EVENTS_MAIN_BALL + ( maxBalls * MAX_EVENTS_EXTRA_BALL ) );
+
+	gridBounds_t bounds;
+	bounds.Init( -SCREEN_BOUND_RIGHT, -SCREEN_BOUND_TOP, SCREEN_BOUND_RIGHT, SCREEN_BOUND_TOP, GRID_CELL_SIZE );
+
+	// every ball finds its blocks through the grid, the main one included
+	mBlockGrid.Build( *mBlockTable, bounds );
+
+	if ( maxBalls > 0 ) {
+		mBallGrid.Init( bounds, maxBalls );
+	}
+
+	// xorshift can't start at 0
+	if ( seed != 0 ) {
+		mState.GetHeader().mRandomState = seed;
+	}
+
+	ResetLevel();
+}
+
+/*
+========================
+GameWorld::Shutdown
+========================
+*/
+void GameWorld::Shutdown() {
+	mState.Shutdown();
+	mEventQueue.Shutdown();
+
+	mBlockTable = nullptr;
+}
+
+/*
+========================
+GameWorld::Tick
+========================
+*/
+u32 GameWorld::Tick( const worldInput_t& input, const float32 deltaTime ) {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	mEventQueue.BeginTick();
+
+	switch ( state.mCurrentState ) {
+	case GAME_STATE_WAITING:
+		if ( input.mStartPressed ) {
+			state.mCurrentState = GAME_STATE_PLAYING;
+		}
+		break;
+
+	case GAME_STATE_PLAYING:
+		UpdatePlayer( input, deltaTime );
+		UpdateBall( deltaTime );
+
+		if ( state.mNumBalls > 0 ) {
+			UpdateExtraBalls( deltaTime );
+		}
+
+		ScoreTickEvents();
+
+		if ( state.mHitBlocks == mState.GetNumBlocks() ) {
+			state.mCurrentState = GAME_STATE_HIGH_SCORE;
+		}
+		break;
+
+	case GAME_STATE_DIED:
+		if ( input.mStartPressed ) {
+			if ( state.mPlayerLives > 0 ) {
+				ResetPlayerAndBall();
+			} else {
+				state.mCurrentState = GAME_STATE_HIGH_SCORE;
+			}
+		}
+		break;
+
+	case GAME_STATE_HIGH_SCORE:
+		// game is over, whoever owns the world decides when to reset it
+		break;
+	}
+
+	return mEventQueue.GetTickTypes();
+}
+
+/*
+========================
+GameWorld::UpdatePlayer
+========================
+*/
+void GameWorld::UpdatePlayer( const worldInput_t& input, const float32 deltaTime ) {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	BB playerBB( state.mPlayerPosition, state.mPlayerHalfSize );
+
+	// reset direction on a per-frame basis
+	state.mPlayerDirection = glm::vec2( 0.0f );
+
+	if ( input.mMoveDirection < 0.0f && playerBB.GetLeft() >= -6.5f ) {
+		state.mPlayerDirection.x = -1.0f;
+	}
+
+	if ( input.mMoveDirection > 0.0f && playerBB.GetRight() <= 6.5f ) {
+		state.mPlayerDirection.x = 1.0f;
+	}
+
+	state.mPlayerPosition += state.mPlayerDirection * PLAYER_MOVE_SPEED * deltaTime;
+}
+
+/*
+========================
+GameWorld::UpdateBall
+========================
+*/
+void GameWorld::UpdateBall( const float32 deltaTime ) {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	BB ballBB( state.mBallPosition, state.mBallHalfSize );
+	BB playerBB( state.mPlayerPosition, state.mPlayerHalfSize );
+
+	const float32 screenBoundRight = SCREEN_BOUND_RIGHT;
+	const float32 screenBoundTop = SCREEN_BOUND_TOP;
+
+	// check collision with screen bounds
+	if ( ballBB.GetLeft() <= -screenBoundRight ) {
+		state.mBallPosition.x += state.mBallMoveSpeed * deltaTime;
+		state.mBallDirection.x *= -1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+	}
+
+	if ( ballBB.GetRight() >= screenBoundRight ) {
+		state.mBallPosition.x -= state.mBallMoveSpeed * deltaTime;
+		state.mBallDirection.x *= -1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+	}
+
+	if ( ballBB.GetBottom() <= -screenBoundTop ) {
+		state.mCurrentState = GAME_STATE_DIED;
+		state.mPlayerLives--;
+
+		mEventQueue.Push( GAME_EVENT_LIFE_LOST, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+	}
+
+	if ( ballBB.GetTop() >= screenBoundTop ) {
+		state.mBallPosition.y -= state.mBallMoveSpeed * deltaTime;
+		state.mBallDirection.y *= -1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+	}
+
+	// check collision with blocks, the same way as the extra balls
+	// only the signs of the direction get changed so it works as a velocity
+	CollideWithBlocks( state.mBallPosition, state.mBallDirection, state.mBallHalfSize, GAME_EVENT_FLAG_NONE );
+
+	// check collision with player
+	bbCollisionSide_t collisionSide = ballBB.GetSideCollidedWith( playerBB );
+	switch ( collisionSide ) {
+	case BB_COLLISION_SIDE_TOP:
+		state.mBallPosition.y -= state.mBallMoveSpeed * deltaTime;
+		state.mBallDirection.y *= -1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_PLAYER, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+		break;
+
+	case BB_COLLISION_SIDE_BOTTOM: {
+		state.mBallPosition.y += state.mBallMoveSpeed * deltaTime;
+
+		float32 dx = state.mBallPosition.x - state.mPlayerPosition.x;
+		float32 variance = mState.RandomFloat( 0.25f, 1.0f );
+		float32 newDirX = ( state.mBallDirection.x + state.mPlayerDirection.x + dx ) * variance;
+
+		state.mBallDirection.x = glm::clamp( newDirX, -1.0f, 1.0f );
+		state.mBallDirection.y *= -1.0f;
+
+		state.mBallMoveSpeed += BALL_MOVE_SPEED_INCREASE;
+
+		mEventQueue.Push( GAME_EVENT_HIT_PLAYER, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+		break;
+	}
+
+	case BB_COLLISION_SIDE_LEFT:
+		state.mBallPosition.x += state.mBallMoveSpeed * PLAYER_MOVE_SPEED * deltaTime;
+		state.mBallDirection.x = 1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_PLAYER, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+		break;
+
+	case BB_COLLISION_SIDE_RIGHT:
+		state.mBallPosition.x -= state.mBallMoveSpeed * PLAYER_MOVE_SPEED * deltaTime;
+		state.mBallDirection.x = -1.0f;
+
+		mEventQueue.Push( GAME_EVENT_HIT_PLAYER, GAME_EVENT_FLAG_NONE, 0, state.mBallPosition );
+		break;
+
+	case BB_COLLISION_SIDE_NONE:
+	default:
+		// nothing
+		break;
+	}
+
+	state.mBallPosition += state.mBallDirection * state.mBallMoveSpeed * deltaTime;
+}
+
+/*
+========================
+GameWorld::ResetPlayerAndBall
+========================
+*/
+void GameWorld::ResetPlayerAndBall() {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	// init player
+	state.mPlayerPosition = glm::vec2( 0.0f, -4.0f );
+	state.mPlayerHalfSize = glm::vec2( 1.0f, 0.15f );
+	state.mPlayerDirection = glm::vec2( 0.0f );
+
+	// init ball
+	state.mBallPosition = state.mPlayerPosition + glm::vec2( 0.0f, 0.5f );
+	state.mBallHalfSize = glm::vec2( 0.15f, 0.15f );
+	state.mBallDirection = glm::vec2( 1.0f, 1.0f );
+	state.mBallMoveSpeed = BALL_START_MOVE_SPEED;
+
+	// losing a life ends multi-ball
+	state.mNumBalls = 0;
+
+	state.mCurrentState = GAME_STATE_WAITING;
+}
+
+/*
+========================
+GameWorld::ResetLevel
+========================
+*/
+void GameWorld::ResetLevel() {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	mState.SetAllBlocksActive();
+	mState.SetAllBlockHitPoints( mBlockTable->mHitPoints );
+
+	state.mPlayerLives = NUM_MAX_PLAYER_LIVES;
+	state.mPlayerScore = 0;
+	state.mHitBlocks = 0;
+
+	ResetPlayerAndBall();
+}
+
+/*
+========================
+GameWorld::RebuildBlockGrid
+========================
+*/
+void GameWorld::RebuildBlockGrid() {
+	mBlockGrid.Build( *mBlockTable, mBlockGrid.GetBounds() );
+}
+
+/*
+========================
+GameWorld::SpawnBalls
+========================
+*/
+u32 GameWorld::SpawnBalls( const u32 count, const glm::vec2& position ) {
+	gameStateHeader_t& state = mState.GetHeader();
+	const ballPool_t& balls = mState.GetBalls();
+
+	assertf( ( state.mBallHalfSize.x * 2.0f <= GRID_CELL_SIZE ), "Balls are too big for the broadphase grid!\n" );
+
+	u32 numToSpawn = min( count, state.mMaxBalls - state.mNumBalls );
+
+	for ( u32 i = 0; i < numToSpawn; i++ ) {
+		u32 ballIndex = state.mNumBalls++;
+
+		// somewhere in the upper quarter circle so they all head towards the blocks
+		float32 angle = mState.RandomFloat( PI * 0.25f, PI * 0.75f );
+
+		balls.mPositionsX[ballIndex] = position.x;
+		balls.mPositionsY[ballIndex] = position.y;
+		balls.mVelocitiesX[ballIndex] = cosf( angle ) * BALL_START_MOVE_SPEED;
+		balls.mVelocitiesY[ballIndex] = sinf( angle ) * BALL_START_MOVE_SPEED;
+	}
+
+	return numToSpawn;
+}
+
+/*
+========================
+GameWorld::UpdateExtraBalls
+========================
+*/
+void GameWorld::UpdateExtraBalls( const float32 deltaTime ) {
+	gameStateHeader_t& state = mState.GetHeader();
+	const ballPool_t& balls = mState.GetBalls();
+
+	const glm::vec2 halfSize = state.mBallHalfSize;
+
+	BB playerBB( state.mPlayerPosition, state.mPlayerHalfSize );
+
+	u32 ballIndex = 0;
+	while ( ballIndex < state.mNumBalls ) {
+		glm::vec2 position( balls.mPositionsX[ballIndex], balls.mPositionsY[ballIndex] );
+		glm::vec2 velocity( balls.mVelocitiesX[ballIndex], balls.mVelocitiesY[ballIndex] );
+
+		position += velocity * deltaTime;
+
+		// extra balls that fall out the bottom just disappear, swap the last one in to keep the pool packed
+		if ( position.y - halfSize.y <= -SCREEN_BOUND_TOP ) {
+			u32 lastIndex = --state.mNumBalls;
+
+			balls.mPositionsX[ballIndex] = balls.mPositionsX[lastIndex];
+			balls.mPositionsY[ballIndex] = balls.mPositionsY[lastIndex];
+			balls.mVelocitiesX[ballIndex] = balls.mVelocitiesX[lastIndex];
+			balls.mVelocitiesY[ballIndex] = balls.mVelocitiesY[lastIndex];
+			continue;
+		}
+
+		// screen bounds, push back inside instead of just flipping so they can't get stuck in the wall
+		if ( position.x - halfSize.x <= -SCREEN_BOUND_RIGHT ) {
+			position.x = -SCREEN_BOUND_RIGHT + halfSize.x;
+			velocity.x = glm::abs( velocity.x );
+			mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_EXTRA_BALL, 0, position );
+		} else if ( position.x + halfSize.x >= SCREEN_BOUND_RIGHT ) {
+			position.x = SCREEN_BOUND_RIGHT - halfSize.x;
+			velocity.x = -glm::abs( velocity.x );
+			mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_EXTRA_BALL, 0, position );
+		}
+
+		if ( position.y + halfSize.y >= SCREEN_BOUND_TOP ) {
+			position.y = SCREEN_BOUND_TOP - halfSize.y;
+			velocity.y = -glm::abs( velocity.y );
+			mEventQueue.Push( GAME_EVENT_HIT_WALL, GAME_EVENT_FLAG_EXTRA_BALL, 0, position );
+		}
+
+		// player, only bounce when coming down so a ball inside the paddle can't flip back and forth
+		BB ballBB( position, halfSize );
+		if ( velocity.y < 0.0f && ballBB.GetSideCollidedWith( playerBB ) != BB_COLLISION_SIDE_NONE ) {
+			float32 speed = glm::length( velocity );
+			float32 dx = ( position.x - state.mPlayerPosition.x ) / state.mPlayerHalfSize.x;
+
+			velocity = glm::normalize( glm::vec2( dx, 1.0f ) ) * speed;
+
+			mEventQueue.Push( GAME_EVENT_HIT_PLAYER, GAME_EVENT_FLAG_EXTRA_BALL, 0, position );
+		}
+
+		CollideWithBlocks( position, velocity, halfSize, GAME_EVENT_FLAG_EXTRA_BALL );
+
+		balls.mPositionsX[ballIndex] = position.x;
+		balls.mPositionsY[ballIndex] = position.y;
+		balls.mVelocitiesX[ballIndex] = velocity.x;
+		balls.mVelocitiesY[ballIndex] = velocity.y;
+
+		ballIndex++;
+	}
+
+	CollideBallsWithEachOther();
+}
+
+/*
+========================
+GameWorld::HitBlock
+========================
+*/
+void GameWorld::HitBlock( const u32 blockIndex, const u32 flags, const glm::vec2& position ) {
+	// the block has to go straight away so nothing else can hit it this tick
+	bool32 broken = mState.DamageBlock( blockIndex );
+	if ( broken ) {
+		mState.SetBlockActive( blockIndex, false );
+	}
+
+	mEventQueue.Push( GAME_EVENT_HIT_BLOCK, flags | ( broken ? GAME_EVENT_FLAG_BLOCK_BROKEN : GAME_EVENT_FLAG_NONE ), blockIndex, position );
+}
+
+/*
+========================
+GameWorld::ScoreTickEvents
+========================
+*/
+void GameWorld::ScoreTickEvents() {
+	gameStateHeader_t& state = mState.GetHeader();
+
+	if ( !( mEventQueue.GetTickTypes() & GAME_EVENT_BIT( GAME_EVENT_HIT_BLOCK ) ) ) {
+		return;
+	}
+
+	for ( u32 sequence = mEventQueue.GetTickStart(); sequence != mEventQueue.GetHead(); sequence++ ) {
+		const gameEvent_t& event = mEventQueue.GetEvent( sequence );
+
+		if ( event.mType != GAME_EVENT_HIT_BLOCK || !( event.mFlags & GAME_EVENT_FLAG_BLOCK_BROKEN ) ) {
+			continue;
+		}
+
+		state.mPlayerScore += mBlockTable->mScoreValues[event.mBlockIndex];
+		state.mHitBlocks++;
+	}
+}
+
+/*
+========================
+GameWorld::CollideWithBlocks
+========================
+*/
+void GameWorld::CollideWithBlocks( glm::vec2& position, glm::vec2& velocity, const glm::vec2& halfSize, const u32 eventFlags ) {
+	const gridBounds_t& bounds = mBlockGrid.GetBounds();
+
+	BB ballBB( position, halfSize );
+
+	u32 minX = bounds.CellX( position.x - halfSize.x );
+	u32 maxX = bounds.CellX( position.x + halfSize.x );
+	u32 minY = bounds.CellY( position.y - halfSize.y );
+	u32 maxY = bounds.CellY( position.y + halfSize.y );
+
+	for ( u32 cellY = minY; cellY <= maxY; cellY++ ) {
+		for ( u32 cellX = minX; cellX <= maxX; cellX++ ) {
+			u32 cellIndex = cellX + ( cellY * bounds.mNumCellsX );
+
+			for ( u32 i = mBlockGrid.GetCellStart( cellIndex ); i < mBlockGrid.GetCellStart( cellIndex + 1 ); i++ ) {
+				u32 blockIndex = mBlockGrid.GetBlockIndex( i );
+
+				if ( !mState.IsBlockActive( blockIndex ) ) {
+					continue;
+				}
+
+				BB blockBB( mBlockTable->mPositions[blockIndex], mBlockTable->mHalfSizes[blockIndex] );
+				bbCollisionSide_t collision = ballBB.GetSideCollidedWith( blockBB );
+
+				if ( collision == BB_COLLISION_SIDE_NONE ) {
+					continue;
+				}
+
+				// the side is the side of the ball that hit
+				switch ( collision ) {
+				case BB_COLLISION_SIDE_TOP:
+					velocity.y = -glm::abs( velocity.y );
+					break;
+
+				case BB_COLLISION_SIDE_BOTTOM:
+					velocity.y = glm::abs( velocity.y );
+					break;
+
+				case BB_COLLISION_SIDE_LEFT:
+					velocity.x = glm::abs( velocity.x );
+					break;
+
+				case BB_COLLISION_SIDE_RIGHT:
+					velocity.x = -glm::abs( velocity.x );
+					break;
+
+				default:
+					// nothing
+					break;
+				}
+
+				HitBlock( blockIndex, eventFlags, position );
+
+				// one block per ball per tick
+				return;
+			}
+		}
+	}
+}
+
+/*
+========================
+GameWorld::CollideBallsWithEachOther
+========================
+*/
+void GameWorld::CollideBallsWithEachOther() {
+	const gameStateHeader_t& state = mState.GetHeader();
+	const ballPool_t& balls = mState.GetBalls();
+
+	const float32 width = state.mBallHalfSize.x * 2.0f;
+	const float32 height = state.mBallHalfSize.y * 2.0f;
+
+	mBallGrid.Build( balls.mPositionsX, balls.mPositionsY, state.mNumBalls );
+
+	mNumBallPairsTested = mBallGrid.ForEachPair( [&]( const u32 a, const u32 b ) {
+		float32 dx = balls.mPositionsX[b] - balls.mPositionsX[a];
+		float32 dy = balls.mPositionsY[b] - balls.mPositionsY[a];
+
+		float32 overlapX = width - glm::abs( dx );
+		float32 overlapY = height - glm::abs( dy );
+
+		if ( overlapX <= 0.0f || overlapY <= 0.0f ) {
+			return;
+		}
+
+		// same mass so a head on bounce is just swapping velocities along the axis with the least overlap
+		// then push them both half of the way out
+		if ( overlapX < overlapY ) {
+			float32 relative = balls.mVelocitiesX[b] - balls.mVelocitiesX[a];
+			if ( relative * dx < 0.0f ) {
+				float32 temp = balls.mVelocitiesX[a];
+				balls.mVelocitiesX[a] = balls.mVelocitiesX[b];
+				balls.mVelocitiesX[b] = temp;
+			}
+
+			float32 push = ( dx < 0.0f ? -overlapX : overlapX ) * 0.5f;
+			balls.mPositionsX[a] -= push;
+			balls.mPositionsX[b] += push;
+		} else {
+			float32 relative = balls.mVelocitiesY[b] - balls.mVelocitiesY[a];
+			if ( relative * dy < 0.0f ) {
+				float32 temp = balls.mVelocitiesY[a];
+				balls.mVelocitiesY[a] = balls.mVelocitiesY[b];
+				balls.mVelocitiesY[b] = temp;
+			}
+
+			float32 push = ( dy < 0.0f ? -overlapY : overlapY ) * 0.5f;
+			balls.mPositionsY[a] -= push;
+			balls.mPositionsY[b] += push;
+		}
+	} );
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef __GAME_WORLD_H__
+#define __GAME_WORLD_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+#include "Defines.h"
+#include "GameState.h"
+#include "Broadphase.h"
+#include "GameEventQueue.h"
+
+// what the player (or a bot) is doing this tick
+struct worldInput_t {
+	float32					mMoveDirection;		// -1 is left, 1 is right, 0 is idle
+	bool32					mStartPressed;
+};
+
+/*
+================================================================================================
+
+	Breakout Game World
+
+	All the gameplay rules for one game of Breakout, without any windowing, input, sound, or
+	rendering. Everything it changes lives in its GameState and the block layout is shared and
+	read-only, so any number of worlds can be stepped at once on any threads.
+
+	Collisions don't do anything beyond bouncing the ball and damaging blocks, they push a
+	gameEvent_t and move on. Scoring runs over the tick's events once everything has moved,
+	and whoever owns the world can read the same events afterwards for sound, stats, etc.
+
+================================================================================================
+*/
+
+class GameWorld {
+public:
+	// half the size of the visible play area in world units
+	static const float32		SCREEN_BOUND_RIGHT;
+	static const float32		SCREEN_BOUND_TOP;
+
+	// MUST be at least as big as a ball
+	static const float32		GRID_CELL_SIZE;
+
+public:
+								GameWorld();
+								~GameWorld();
+
+	// if stateMemory is null the world allocates its own state memory
+	// maxBalls is how many extra balls multi-ball can have on top of the main one
+	void						Init( const blockTable_t* blockTable, const u32 seed, void* stateMemory = nullptr, const u32 maxBalls = 0 );
+	void						Shutdown();
+	inline bool32				IsInitialised() const { return mBlockTable != nullptr; }
+
+	inline GameState&			GetState() { return mState; }
+	inline const GameState&		GetState() const { return mState; }
+
+	inline const blockTable_t*	GetBlockTable() const { return mBlockTable; }
+
+	// returns the GameEventQueue::GetTickTypes() bits for this tick
+	u32							Tick( const worldInput_t& input, const float32 deltaTime );
+
+	inline const GameEventQueue&	GetEvents() const { return mEventQueue; }
+
+	void						ResetPlayerAndBall();
+	void						ResetLevel();
+
+	// call after moving blocks around in the block table
+	void						RebuildBlockGrid();
+
+	// spawns extra balls at position heading upwards, returns how many actually fit in the pool
+	u32							SpawnBalls( const u32 count, const glm::vec2& position );
+
+	// how many ball vs ball pairs the broadphase handed out last tick
+	inline u32					GetNumBallPairsTested() const { return mNumBallPairsTested; }
+
+private:
+	GameState					mState;
+
+	const blockTable_t*			mBlockTable;
+
+	GameEventQueue				mEventQueue;
+
+	// the ball grid is only built when there are extra balls
+	BlockGrid					mBlockGrid;
+	BallGrid					mBallGrid;
+	u32							mNumBallPairsTested;
+
+private:
+	void						UpdatePlayer( const worldInput_t& input, const float32 deltaTime );
+	void						UpdateBall( const float32 deltaTime );
+	void						UpdateExtraBalls( const float32 deltaTime );
+
+	// takes a hit point off the block and takes it out if it broke, scoring happens later in ScoreTickEvents()
+	void						HitBlock( const u32 blockIndex, const u32 flags, const glm::vec2& position );
+
+	void						ScoreTickEvents();
+
+	// bounces the velocity away from the first block it hits and hits that block with eventFlags
+	void						CollideWithBlocks( glm::vec2& position, glm::vec2& velocity, const glm::vec2& halfSize, const u32 eventFlags );
+	void						CollideBallsWithEachOther();
+};
+
+#endif // __GAME_WORLD_H__
\ No newline at end of file
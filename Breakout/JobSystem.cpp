@@ -0,0 +1,240 @@
+#include "JobSystem.h"
+
+/*
+================================================================================================
+
+	JobSystem
+
+================================================================================================
+*/
+
+JobSystem* gJobSystem = nullptr;
+
+static thread_local u32 tWorkerIndex = 0;
+
+/*
+========================
+JobSystem::JobSystem
+========================
+*/
+JobSystem::JobSystem() {
+	mJobsHead = mJobsTail = 0;
+
+	mThreads = nullptr;
+	mNumThreads = 0;
+
+	mRunning = false;
+	mInitialised = false;
+}
+
+/*
+========================
+JobSystem::~JobSystem
+========================
+*/
+JobSystem::~JobSystem() {
+	Shutdown();
+}
+
+/*
+========================
+JobSystem::Init
+========================
+*/
+void JobSystem::Init( const u32 numWorkers ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call JobSystem::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	u32 numHardwareThreads = max( std::thread::hardware_concurrency(), 1u );
+	u32 numTotalWorkers = ( numWorkers == 0 ) ? numHardwareThreads : numWorkers;
+
+	printf( "------- Initialising Job System (%u workers) -------\n", numTotalWorkers );
+
+	tWorkerIndex = 0;
+
+	mRunning = true;
+
+	// the main thread counts as a worker
+	mNumThreads = numTotalWorkers - 1;
+	mThreads = new std::thread[mNumThreads];
+	for ( u32 i = 0; i < mNumThreads; i++ ) {
+		mThreads[i] = std::thread( &JobSystem::WorkerLoop, this, i + 1 );
+	}
+
+	mInitialised = true;
+
+	printf( "------- Job System initialised -------\n\n" );
+}
+
+/*
+========================
+JobSystem::Shutdown
+========================
+*/
+void JobSystem::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mRunning = false;
+	}
+	mJobAdded.notify_all();
+
+	for ( u32 i = 0; i < mNumThreads; i++ ) {
+		mThreads[i].join();
+	}
+
+	delete[] mThreads;
+	mThreads = nullptr;
+	mNumThreads = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+JobSystem::GetWorkerIndex
+========================
+*/
+u32 JobSystem::GetWorkerIndex() {
+	return tWorkerIndex;
+}
+
+/*
+========================
+JobSystem::Submit
+========================
+*/
+void JobSystem::Submit( jobFunc_t func, void* data, const u32 start, const u32 end, jobCounter_t* counter ) {
+	job_t job = { func, data, start, end, counter };
+
+	if ( counter ) {
+		counter->mPending++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		u32 nextTail = ( mJobsTail + 1 ) % MAX_QUEUED_JOBS;
+		if ( nextTail != mJobsHead ) {
+			mJobs[mJobsTail] = job;
+			mJobsTail = nextTail;
+
+			mJobAdded.notify_one();
+			return;
+		}
+	}
+
+	// queue is full so just do it now rather than block
+	RunJob( job );
+}
+
+/*
+========================
+JobSystem::Wait
+========================
+*/
+void JobSystem::Wait( jobCounter_t* counter ) {
+	while ( counter->mPending > 0 ) {
+		job_t job;
+		bool32 gotJob = false;
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			gotJob = PopJob( job );
+		}
+
+		if ( gotJob ) {
+			RunJob( job );
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*
+========================
+JobSystem::ParallelFor
+========================
+*/
+void JobSystem::ParallelFor( const u32 count, const u32 granularity, jobFunc_t func, void* data ) {
+	assertf( ( granularity > 0 ), "ParallelFor() granularity must be > 0!\n" );
+
+	if ( count == 0 ) {
+		return;
+	}
+
+	// not worth waking anyone up for one job
+	if ( count <= granularity || mNumThreads == 0 ) {
+		func( data, 0, count, GetWorkerIndex() );
+		return;
+	}
+
+	jobCounter_t counter;
+
+	for ( u32 start = 0; start < count; start += granularity ) {
+		u32 end = min( start + granularity, count );
+		Submit( func, data, start, end, &counter );
+	}
+
+	Wait( &counter );
+}
+
+/*
+========================
+JobSystem::WorkerLoop
+========================
+*/
+void JobSystem::WorkerLoop( const u32 workerIndex ) {
+	tWorkerIndex = workerIndex;
+
+	while ( true ) {
+		job_t job;
+
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mJobAdded.wait( lock, [this]() { return !mRunning || mJobsHead != mJobsTail; } );
+
+			if ( !mRunning && mJobsHead == mJobsTail ) {
+				return;
+			}
+
+			PopJob( job );
+		}
+
+		RunJob( job );
+	}
+}
+
+/*
+========================
+JobSystem::PopJob
+========================
+*/
+bool32 JobSystem::PopJob( job_t& outJob ) {
+	if ( mJobsHead == mJobsTail ) {
+		return false;
+	}
+
+	outJob = mJobs[mJobsHead];
+	mJobsHead = ( mJobsHead + 1 ) % MAX_QUEUED_JOBS;
+
+	return true;
+}
+
+/*
+========================
+JobSystem::RunJob
+========================
+*/
+void JobSystem::RunJob( const job_t& job ) {
+	job.mFunc( job.mData, job.mStart, job.mEnd, tWorkerIndex );
+
+	if ( job.mCounter ) {
+		job.mCounter->mPending--;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include <mstd/mstd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// start and end are the range of items this job is responsible for
+typedef void ( *jobFunc_t )( void* data, const u32 start, const u32 end, const u32 workerIndex );
+
+// counts how many jobs submitted against it haven't finished yet
+struct jobCounter_t {
+	std::atomic<u32>		mPending;
+
+							jobCounter_t() : mPending( 0 ) {}
+};
+
+/*
+================================================================================================
+
+	Breakout Job System
+
+	A fixed pool of worker threads pulling jobs off one shared ring buffer. The thread that
+	calls Wait() helps run jobs until its counter hits zero instead of sleeping, so a
+	ParallelFor() from the main thread uses every core including its own.
+
+	Worker index 0 is always the thread that called Init() (the main thread). Workers are
+	numbered 1 to GetNumWorkers() - 1, which makes the index safe to use for per-thread data.
+
+================================================================================================
+*/
+
+class JobSystem {
+public:
+	static const u32		MAX_QUEUED_JOBS = 4096;
+
+public:
+							JobSystem();
+							~JobSystem();
+
+	// 0 means one worker per hardware thread
+	void					Init( const u32 numWorkers = 0 );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	// includes the main thread
+	inline u32				GetNumWorkers() const { return mNumThreads + 1; }
+
+	// returns the index of the calling thread, 0 for the main thread
+	static u32				GetWorkerIndex();
+
+	void					Submit( jobFunc_t func, void* data, const u32 start, const u32 end, jobCounter_t* counter );
+	void					Wait( jobCounter_t* counter );
+
+	// splits [0, count) into jobs of granularity items and blocks until they have all run
+	void					ParallelFor( const u32 count, const u32 granularity, jobFunc_t func, void* data );
+
+private:
+	struct job_t {
+		jobFunc_t			mFunc;
+		void*				mData;
+		u32					mStart, mEnd;
+		jobCounter_t*		mCounter;
+	};
+
+	job_t					mJobs[MAX_QUEUED_JOBS];
+	u32						mJobsHead, mJobsTail;
+
+	std::thread*			mThreads;
+	u32						mNumThreads;
+
+	std::mutex				mMutex;
+	std::condition_variable	mJobAdded;
+
+	bool32					mRunning;
+	bool32					mInitialised;
+
+private:
+	void					WorkerLoop( const u32 workerIndex );
+
+	// must be called with mMutex locked
+	bool32					PopJob( job_t& outJob );
+
+	static void				RunJob( const job_t& job );
+};
+
+extern JobSystem* gJobSystem;
+
+#endif // __JOB_SYSTEM_H__
\ No newline at end of file
@@ -0,0 +1,408 @@
+#include "Level.h"
+
+#include "Defines.h"
+
+// mstd already pulls in Windows.h
+#if !MSTD_OS_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+================================================================================================
+
+	Level
+
+================================================================================================
+*/
+
+const u32 Level::FILE_MAGIC = 0x564C4B42;	// "BKLV"
+const u32 Level::FILE_VERSION = 1;
+const u32 Level::FILE_ALIGNMENT = 16;
+const u32 Level::MAX_BLOCKS = 16 * 1024 * 1024;
+const u32 Level::MAX_COLORS = 256;
+
+static const size_t PREFETCH_PAGE_SIZE = 4096;
+static const u32 PREFETCH_PAGES_PER_JOB = 256;
+
+static const glm::vec4 DEFAULT_PALETTE[] = {
+	glm::vec4( 200, 72, 72, 255 ) / 255.0f,
+	glm::vec4( 198, 108, 58, 255 ) / 255.0f,
+	glm::vec4( 180, 122, 48, 255 ) / 255.0f,
+	glm::vec4( 162, 162, 42, 255 ) / 255.0f,
+	glm::vec4( 72, 160, 72, 255 ) / 255.0f,
+	glm::vec4( 66, 72, 200, 255 ) / 255.0f,
+};
+
+static const u32 DEFAULT_ROW_SCORES[] = {
+	7, 7, 4, 4, 1, 1
+};
+
+/*
+========================
+AlignOffset
+========================
+*/
+static u32 AlignOffset( const u32 offset ) {
+	return ( offset + Level::FILE_ALIGNMENT - 1 ) & ~( Level::FILE_ALIGNMENT - 1 );
+}
+
+/*
+========================
+Level::Level
+========================
+*/
+Level::Level() {
+	mData = nullptr;
+	mSizeBytes = 0;
+	mIsMapped = false;
+
+	memset( &mBlockTable, 0, sizeof( blockTable_t ) );
+
+	mPrefetchJobSystem = nullptr;
+}
+
+/*
+========================
+Level::~Level
+========================
+*/
+Level::~Level() {
+	Unload();
+}
+
+/*
+========================
+Level::Load
+========================
+*/
+bool32 Level::Load( const char* filename ) {
+	if ( IsLoaded() ) {
+		Unload();
+	}
+
+	void* mapped = nullptr;
+	size_t sizeBytes = 0;
+
+#if MSTD_OS_WINDOWS
+	HANDLE file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		warning( "Unable to open level file %s\n", filename );
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx( file, &fileSize );
+	sizeBytes = static_cast<size_t>( fileSize.QuadPart );
+
+	// the view keeps the file and the mapping alive so both handles can go straight away
+	HANDLE mapping = ( sizeBytes > 0 ) ? CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL ) : NULL;
+	if ( mapping ) {
+		mapped = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		CloseHandle( mapping );
+	}
+
+	CloseHandle( file );
+#else
+	int file = open( filename, O_RDONLY );
+	if ( file == -1 ) {
+		warning( "Unable to open level file %s\n", filename );
+		return false;
+	}
+
+	struct stat fileStat;
+	fstat( file, &fileStat );
+	sizeBytes = static_cast<size_t>( fileStat.st_size );
+
+	if ( sizeBytes > 0 ) {
+		mapped = mmap( nullptr, sizeBytes, PROT_READ, MAP_PRIVATE, file, 0 );
+		if ( mapped == MAP_FAILED ) {
+			mapped = nullptr;
+		}
+	}
+
+	close( file );
+#endif
+
+	if ( !mapped ) {
+		warning( "Unable to map level file %s\n", filename );
+		return false;
+	}
+
+	mData = static_cast<const u8*>( mapped );
+	mSizeBytes = sizeBytes;
+	mIsMapped = true;
+
+	if ( !SetupBlockTable( filename ) ) {
+		Unload();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+========================
+Level::CreateDefault
+========================
+*/
+void Level::CreateDefault() {
+	if ( IsLoaded() ) {
+		Unload();
+	}
+
+	glm::vec2 positions[NUM_BLOCKS_MAX];
+	glm::vec2 halfSizes[NUM_BLOCKS_MAX];
+	u32 colorIndices[NUM_BLOCKS_MAX];
+	u32 scoreValues[NUM_BLOCKS_MAX];
+	u8 hitPoints[NUM_BLOCKS_MAX];
+
+	for ( u32 rowIndex = 0; rowIndex < NUM_BLOCKS_ROWS; rowIndex++ ) {
+		for ( u32 columnIndex = 0; columnIndex < NUM_BLOCKS_COLUMNS; columnIndex++ ) {
+			size_t blockIndex = columnIndex + ( rowIndex * NUM_BLOCKS_COLUMNS );
+
+			float32 blockX = -5.0f + columnIndex;
+			float32 blockY = 4.0f - ( rowIndex * 0.5f );
+
+			positions[blockIndex] = glm::vec2( blockX, blockY );
+			halfSizes[blockIndex] = glm::vec2( 0.5f, 0.25f );
+			colorIndices[blockIndex] = rowIndex;
+			scoreValues[blockIndex] = DEFAULT_ROW_SCORES[rowIndex];
+			hitPoints[blockIndex] = 1;
+		}
+	}
+
+	blockTable_t source = {};
+	source.mPalette = DEFAULT_PALETTE;
+	source.mNumColors = NUM_BLOCKS_ROWS;
+	source.mPositions = positions;
+	source.mHalfSizes = halfSizes;
+	source.mColorIndices = colorIndices;
+	source.mScoreValues = scoreValues;
+	source.mHitPoints = hitPoints;
+	source.mNumBlocks = NUM_BLOCKS_MAX;
+
+	levelFileHeader_t header = MakeHeader( source.mNumBlocks, source.mNumColors );
+
+	u8* image = new u8[header.mFileSizeBytes];
+	WriteImage( image, header, source );
+
+	mData = image;
+	mSizeBytes = header.mFileSizeBytes;
+	mIsMapped = false;
+
+	SetupBlockTable( "default" );
+}
+
+/*
+========================
+Level::Unload
+========================
+*/
+void Level::Unload() {
+	if ( !IsLoaded() ) {
+		return;
+	}
+
+	// can't pull the memory out from under the prefetch
+	if ( mPrefetchJobSystem ) {
+		mPrefetchJobSystem->Wait( &mPrefetchCounter );
+		mPrefetchJobSystem = nullptr;
+	}
+
+	if ( mIsMapped ) {
+#if MSTD_OS_WINDOWS
+		UnmapViewOfFile( mData );
+#else
+		munmap( const_cast<u8*>( mData ), mSizeBytes );
+#endif
+	} else {
+		delete[] mData;
+	}
+
+	mData = nullptr;
+	mSizeBytes = 0;
+	mIsMapped = false;
+
+	memset( &mBlockTable, 0, sizeof( blockTable_t ) );
+}
+
+/*
+========================
+Level::Prefetch
+========================
+*/
+void Level::Prefetch( JobSystem* jobSystem ) {
+	if ( !IsLoaded() || !mIsMapped ) {
+		return;
+	}
+
+	u32 numPages = static_cast<u32>( ( mSizeBytes + PREFETCH_PAGE_SIZE - 1 ) / PREFETCH_PAGE_SIZE );
+
+	mPrefetchJobSystem = jobSystem;
+
+	for ( u32 start = 0; start < numPages; start += PREFETCH_PAGES_PER_JOB ) {
+		jobSystem->Submit( PrefetchJob, this, start, min( start + PREFETCH_PAGES_PER_JOB, numPages ), &mPrefetchCounter );
+	}
+}
+
+/*
+========================
+Level::Write
+========================
+*/
+bool32 Level::Write( const char* filename, const blockTable_t& blockTable ) {
+	assertf( ( blockTable.mNumBlocks <= MAX_BLOCKS && blockTable.mNumColors <= MAX_COLORS ), "Block table is too big to write as a level!\n" );
+
+	levelFileHeader_t header = MakeHeader( blockTable.mNumBlocks, blockTable.mNumColors );
+
+	u8* image = new u8[header.mFileSizeBytes];
+	WriteImage( image, header, blockTable );
+
+	// the mstd file functions can't truncate an existing file
+	FILE* file = fopen( filename, "wb" );
+	bool32 result = file && fwrite( image, header.mFileSizeBytes, 1, file ) == 1;
+
+	if ( file ) {
+		fclose( file );
+	}
+
+	delete[] image;
+	image = nullptr;
+
+	if ( !result ) {
+		error( "Failed to write level file %s\n", filename );
+	}
+
+	return result;
+}
+
+/*
+========================
+Level::SetupBlockTable
+========================
+*/
+bool32 Level::SetupBlockTable( const char* name ) {
+	if ( mSizeBytes < sizeof( levelFileHeader_t ) ) {
+		error( "Level %s is too small to be a level file!\n", name );
+		return false;
+	}
+
+	const levelFileHeader_t* header = reinterpret_cast<const levelFileHeader_t*>( mData );
+
+	if ( header->mMagic != FILE_MAGIC ) {
+		error( "Level %s is not a level file!\n", name );
+		return false;
+	}
+
+	if ( header->mVersion != FILE_VERSION ) {
+		error( "Level %s is version %u, expected version %u!\n", name, header->mVersion, FILE_VERSION );
+		return false;
+	}
+
+	// keeps the offsets below from overflowing
+	if ( header->mNumBlocks > MAX_BLOCKS || header->mNumColors > MAX_COLORS ) {
+		error( "Level %s has too many blocks or colors!\n", name );
+		return false;
+	}
+
+	// the offsets come from the file so they have to be checked before anything reads them
+	levelFileHeader_t expected = MakeHeader( header->mNumBlocks, header->mNumColors );
+	if ( memcmp( header, &expected, sizeof( levelFileHeader_t ) ) != 0 || expected.mFileSizeBytes != mSizeBytes ) {
+		error( "Level %s has a corrupt header!\n", name );
+		return false;
+	}
+
+	if ( header->mNumColors == 0 ) {
+		error( "Level %s has no colors in its palette!\n", name );
+		return false;
+	}
+
+	mBlockTable.mPalette = reinterpret_cast<const glm::vec4*>( mData + header->mOffsetPalette );
+	mBlockTable.mNumColors = header->mNumColors;
+
+	mBlockTable.mPositions = reinterpret_cast<const glm::vec2*>( mData + header->mOffsetPositions );
+	mBlockTable.mHalfSizes = reinterpret_cast<const glm::vec2*>( mData + header->mOffsetHalfSizes );
+	mBlockTable.mColorIndices = reinterpret_cast<const u32*>( mData + header->mOffsetColorIndices );
+	mBlockTable.mScoreValues = reinterpret_cast<const u32*>( mData + header->mOffsetScoreValues );
+	mBlockTable.mHitPoints = mData + header->mOffsetHitPoints;
+	mBlockTable.mNumBlocks = header->mNumBlocks;
+
+	return true;
+}
+
+/*
+========================
+Level::MakeHeader
+========================
+*/
+levelFileHeader_t Level::MakeHeader( const u32 numBlocks, const u32 numColors ) {
+	levelFileHeader_t header = {};
+	header.mMagic = FILE_MAGIC;
+	header.mVersion = FILE_VERSION;
+
+	header.mNumBlocks = numBlocks;
+	header.mNumColors = numColors;
+
+	u32 offset = AlignOffset( sizeof( levelFileHeader_t ) );
+
+	header.mOffsetPalette = offset;
+	offset = AlignOffset( offset + ( numColors * sizeof( glm::vec4 ) ) );
+
+	header.mOffsetPositions = offset;
+	offset = AlignOffset( offset + ( numBlocks * sizeof( glm::vec2 ) ) );
+
+	header.mOffsetHalfSizes = offset;
+	offset = AlignOffset( offset + ( numBlocks * sizeof( glm::vec2 ) ) );
+
+	header.mOffsetColorIndices = offset;
+	offset = AlignOffset( offset + ( numBlocks * sizeof( u32 ) ) );
+
+	header.mOffsetScoreValues = offset;
+	offset = AlignOffset( offset + ( numBlocks * sizeof( u32 ) ) );
+
+	header.mOffsetHitPoints = offset;
+	offset = AlignOffset( offset + ( numBlocks * sizeof( u8 ) ) );
+
+	header.mFileSizeBytes = offset;
+
+	return header;
+}
+
+/*
+========================
+Level::WriteImage
+========================
+*/
+void Level::WriteImage( u8* outImage, const levelFileHeader_t& header, const blockTable_t& blockTable ) {
+	memset( outImage, 0, header.mFileSizeBytes );
+
+	memcpy( outImage, &header, sizeof( levelFileHeader_t ) );
+
+	memcpy( outImage + header.mOffsetPalette, blockTable.mPalette, header.mNumColors * sizeof( glm::vec4 ) );
+
+	memcpy( outImage + header.mOffsetPositions, blockTable.mPositions, header.mNumBlocks * sizeof( glm::vec2 ) );
+	memcpy( outImage + header.mOffsetHalfSizes, blockTable.mHalfSizes, header.mNumBlocks * sizeof( glm::vec2 ) );
+	memcpy( outImage + header.mOffsetColorIndices, blockTable.mColorIndices, header.mNumBlocks * sizeof( u32 ) );
+	memcpy( outImage + header.mOffsetScoreValues, blockTable.mScoreValues, header.mNumBlocks * sizeof( u32 ) );
+	memcpy( outImage + header.mOffsetHitPoints, blockTable.mHitPoints, header.mNumBlocks * sizeof( u8 ) );
+}
+
+/*
+========================
+Level::PrefetchJob
+========================
+*/
+void Level::PrefetchJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	const Level* level = static_cast<const Level*>( data );
+
+	// reading one byte from each page is enough to fault it in
+	volatile u8 sink = 0;
+	for ( u32 pageIndex = start; pageIndex < end; pageIndex++ ) {
+		sink += level->mData[pageIndex * PREFETCH_PAGE_SIZE];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef __LEVEL_H__
+#define __LEVEL_H__
+
+#include <mstd/mstd.h>
+
+#include "GameState.h"
+#include "JobSystem.h"
+
+// everything in a level file is little endian and every section starts on a LEVEL_FILE_ALIGNMENT boundary
+// offsets are from the start of the file
+struct levelFileHeader_t {
+	u32						mMagic;
+	u32						mVersion;
+
+	u32						mNumBlocks;
+	u32						mNumColors;
+
+	u32						mOffsetPalette;			// glm::vec4 per color
+	u32						mOffsetPositions;		// glm::vec2 per block
+	u32						mOffsetHalfSizes;		// glm::vec2 per block
+	u32						mOffsetColorIndices;	// u32 per block
+	u32						mOffsetScoreValues;		// u32 per block
+	u32						mOffsetHitPoints;		// u8 per block
+
+	u32						mFileSizeBytes;
+	u32						mReserved;
+};
+
+/*
+================================================================================================
+
+	Breakout Level
+
+	A block layout and its palette. Level files are laid out exactly how the block table wants
+	them in memory so loading one is just mapping the file and pointing the block table at it,
+	no parsing or copying. Nothing gets read until something actually uses it, so even huge
+	levels load in about the same time as small ones.
+
+	Prefetch() touches every page of the file on a worker so that the page faults happen there
+	instead of in the middle of the first frame that uses the level.
+
+	The built in level gets built into memory using the same layout as the file, so both kinds
+	of level go through the same code.
+
+================================================================================================
+*/
+
+class Level {
+public:
+	static const u32		FILE_MAGIC;
+	static const u32		FILE_VERSION;
+	static const u32		FILE_ALIGNMENT;
+
+	static const u32		MAX_BLOCKS;
+	static const u32		MAX_COLORS;
+
+public:
+							Level();
+							~Level();
+
+	// returns false if the file can't be opened or isn't a valid level
+	bool32					Load( const char* filename );
+
+	// the original 66 block layout
+	void					CreateDefault();
+
+	void					Unload();
+	inline bool32			IsLoaded() const { return mData != nullptr; }
+	inline size_t			GetSizeBytes() const { return mSizeBytes; }
+
+	void					Prefetch( JobSystem* jobSystem );
+
+	inline const blockTable_t&	GetBlockTable() const { return mBlockTable; }
+
+	static bool32			Write( const char* filename, const blockTable_t& blockTable );
+
+private:
+	const u8*				mData;
+	size_t					mSizeBytes;
+	bool32					mIsMapped;
+
+	blockTable_t			mBlockTable;
+
+	JobSystem*				mPrefetchJobSystem;
+	jobCounter_t			mPrefetchCounter;
+
+private:
+	bool32					SetupBlockTable( const char* name );
+
+	static levelFileHeader_t	MakeHeader( const u32 numBlocks, const u32 numColors );
+	static void				WriteImage( u8* outImage, const levelFileHeader_t& header, const blockTable_t& blockTable );
+
+	static void				PrefetchJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+#endif // __LEVEL_H__
\ No newline at end of file
@@ -0,0 +1,466 @@
+#include "LevelStreamer.h"
+
+#include "GameWorld.h"
+
+/*
+================================================================================================
+
+	LevelStreamer
+
+================================================================================================
+*/
+
+const float32 LevelStreamer::ROW_HEIGHT = 0.5f;
+const float32 LevelStreamer::FIELD_BOTTOM = 1.5f;
+const float32 LevelStreamer::CLIMB_LINE = 1.0f;
+
+static const glm::vec2 BLOCK_HALF_SIZE( 0.5f, 0.25f );
+
+// harder blocks get the warmer colors
+static const glm::vec4 ENDLESS_PALETTE[] = {
+	glm::vec4( 66, 72, 200, 255 ) / 255.0f,
+	glm::vec4( 72, 160, 72, 255 ) / 255.0f,
+	glm::vec4( 162, 162, 42, 255 ) / 255.0f,
+	glm::vec4( 198, 108, 58, 255 ) / 255.0f,
+};
+
+static const u32 ENDLESS_MAX_HIT_POINTS = sizeof( ENDLESS_PALETTE ) / sizeof( ENDLESS_PALETTE[0] );
+
+/*
+========================
+ChunkSeed
+========================
+*/
+static u32 ChunkSeed( const u32 seed, const u32 chunkIndex ) {
+	// murmur3's finaliser so that neighbouring chunks don't get similar looking seeds
+	u32 hash = seed ^ ( ( chunkIndex + 1 ) * 0x9E3779B9 );
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+
+	// xorshift can't start at 0
+	return ( hash != 0 ) ? hash : 1;
+}
+
+/*
+========================
+ChunkRandom
+========================
+*/
+static u32 ChunkRandom( u32& state ) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+/*
+========================
+LevelStreamer::LevelStreamer
+========================
+*/
+LevelStreamer::LevelStreamer() {
+	mSeed = 0;
+	mJobSystem = nullptr;
+
+	mScroll = 0.0f;
+	mFirstChunk = 0;
+	mBlockTableVersion = 0;
+
+	for ( chunkSlot_t& slot : mSlots ) {
+		slot.mState = CHUNK_SLOT_STATE_FREE;
+		slot.mChunkIndex = 0;
+	}
+
+	mBlockTable.mPalette = ENDLESS_PALETTE;
+	mBlockTable.mNumColors = ENDLESS_MAX_HIT_POINTS;
+	mBlockTable.mPositions = mPositions;
+	mBlockTable.mHalfSizes = mHalfSizes;
+	mBlockTable.mColorIndices = mColorIndices;
+	mBlockTable.mScoreValues = mScoreValues;
+	mBlockTable.mHitPoints = mHitPoints;
+	mBlockTable.mNumBlocks = MAX_BLOCKS;
+
+	// empty slots are 0 hit point blocks so ResetLevel() leaves them with nothing in
+	for ( u32 blockIndex = 0; blockIndex < MAX_BLOCKS; blockIndex++ ) {
+		mPositions[blockIndex] = glm::vec2( 0.0f );
+		mHalfSizes[blockIndex] = BLOCK_HALF_SIZE;
+		mColorIndices[blockIndex] = 0;
+		mScoreValues[blockIndex] = 0;
+		mHitPoints[blockIndex] = 0;
+	}
+
+	memset( &mStats, 0, sizeof( streamerStats_t ) );
+
+	mInitialised = false;
+}
+
+/*
+========================
+LevelStreamer::~LevelStreamer
+========================
+*/
+LevelStreamer::~LevelStreamer() {
+	Shutdown();
+}
+
+/*
+========================
+LevelStreamer::Init
+========================
+*/
+void LevelStreamer::Init( const u32 seed, JobSystem* jobSystem ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call LevelStreamer::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mSeed = seed;
+	mJobSystem = jobSystem;
+
+	mInitialised = true;
+}
+
+/*
+========================
+LevelStreamer::Shutdown
+========================
+*/
+void LevelStreamer::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	// jobs write into the slots so they have to finish before this goes away
+	Flush();
+
+	mJobSystem = nullptr;
+
+	mInitialised = false;
+}
+
+/*
+========================
+LevelStreamer::Reset
+========================
+*/
+void LevelStreamer::Reset( GameWorld& world ) {
+	assertf( IsInitialised(), "LevelStreamer::Reset() called before Init()!\n" );
+	assertf( ( world.GetBlockTable() == &mBlockTable ), "LevelStreamer::Reset() called with a world that isn't using its block table!\n" );
+
+	Flush();
+
+	for ( chunkSlot_t& slot : mSlots ) {
+		if ( slot.mState != CHUNK_SLOT_STATE_FREE ) {
+			EvictChunk( world, slot );
+		}
+	}
+
+	mScroll = 0.0f;
+	mFirstChunk = 0;
+
+	// nothing has been hit yet
+	world.GetState().GetHeader().mHitBlocks = 0;
+
+	for ( u32 chunkIndex = 0; chunkIndex < ENDLESS_NUM_CHUNKS; chunkIndex++ ) {
+		RequestChunk( chunkIndex );
+	}
+
+	// this is a load not a hitch, so none of these count as stalls
+	Flush();
+
+	for ( chunkSlot_t& slot : mSlots ) {
+		CommitChunk( world, slot, false );
+	}
+
+	UpdatePositions();
+	world.RebuildBlockGrid();
+
+	mBlockTableVersion++;
+}
+
+/*
+========================
+LevelStreamer::Update
+========================
+*/
+void LevelStreamer::Update( GameWorld& world ) {
+	gameStateHeader_t& state = world.GetState().GetHeader();
+
+	float32 climb = 0.0f;
+
+	if ( state.mCurrentState == GAME_STATE_PLAYING && state.mBallPosition.y > CLIMB_LINE ) {
+		climb = state.mBallPosition.y - CLIMB_LINE;
+
+		// the ball stays where it is and everything else moves, like a camera following it up
+		state.mBallPosition.y = CLIMB_LINE;
+
+		ballPool_t balls = world.GetState().GetBalls();
+		for ( u32 ballIndex = 0; ballIndex < state.mNumBalls; ballIndex++ ) {
+			balls.mPositionsY[ballIndex] -= climb;
+		}
+	}
+
+	Advance( world, climb );
+}
+
+/*
+========================
+LevelStreamer::Advance
+========================
+*/
+void LevelStreamer::Advance( GameWorld& world, const float32 distance ) {
+	bool32 changed = distance > 0.0f;
+
+	mScroll += distance;
+
+	// anything fully below the screen is gone for good, hand its slot to the chunk that's next in line
+	while ( GetChunkTop( mFirstChunk ) < -GameWorld::SCREEN_BOUND_TOP ) {
+		chunkSlot_t& slot = GetSlot( mFirstChunk );
+
+		// the chunk might have scrolled past without ever being needed
+		if ( slot.mState == CHUNK_SLOT_STATE_GENERATING && mJobSystem ) {
+			mJobSystem->Wait( &slot.mCounter );
+		}
+
+		EvictChunk( world, slot );
+		RequestChunk( mFirstChunk + ENDLESS_NUM_CHUNKS );
+
+		mFirstChunk++;
+		changed = true;
+	}
+
+	for ( u32 chunkIndex = mFirstChunk; chunkIndex < mFirstChunk + ENDLESS_NUM_CHUNKS; chunkIndex++ ) {
+		chunkSlot_t& slot = GetSlot( chunkIndex );
+
+		if ( slot.mState != CHUNK_SLOT_STATE_GENERATING ) {
+			continue;
+		}
+
+		if ( slot.mCounter.mPending.load() == 0 ) {
+			CommitChunk( world, slot, false );
+			changed = true;
+			continue;
+		}
+
+		// still generating, which is only a problem if it's already on screen
+		if ( GetChunkBottom( chunkIndex ) >= GameWorld::SCREEN_BOUND_TOP ) {
+			continue;
+		}
+
+		timestamp_t stallStart = timeNow();
+		mJobSystem->Wait( &slot.mCounter );
+		timestamp_t stallEnd = timeNow();
+
+		mStats.mStalls++;
+		mStats.mMaxStallMilliseconds = max( mStats.mMaxStallMilliseconds, static_cast<float32>( deltaMilliseconds( stallStart, stallEnd ) ) );
+
+		CommitChunk( world, slot, true );
+		changed = true;
+	}
+
+	if ( changed ) {
+		UpdatePositions();
+		world.RebuildBlockGrid();
+
+		mBlockTableVersion++;
+	}
+}
+
+/*
+========================
+LevelStreamer::RequestChunk
+========================
+*/
+void LevelStreamer::RequestChunk( const u32 chunkIndex ) {
+	chunkSlot_t& slot = GetSlot( chunkIndex );
+
+	assertf( ( slot.mState == CHUNK_SLOT_STATE_FREE ), "Requested a chunk into a slot that's still in use!\n" );
+
+	slot.mState = CHUNK_SLOT_STATE_GENERATING;
+	slot.mChunkIndex = chunkIndex;
+	slot.mRequestTime = timeNow();
+
+	u32 slotIndex = GetSlotIndex( slot );
+
+	if ( mJobSystem ) {
+		mJobSystem->Submit( GenerateChunkJob, this, slotIndex, slotIndex + 1, &slot.mCounter );
+	} else {
+		GenerateChunkJob( this, slotIndex, slotIndex + 1, 0 );
+	}
+}
+
+/*
+========================
+LevelStreamer::CommitChunk
+========================
+*/
+void LevelStreamer::CommitChunk( GameWorld& world, chunkSlot_t& slot, const bool32 stalled ) {
+	GameState& state = world.GetState();
+
+	u32 firstBlock = GetSlotIndex( slot ) * BLOCKS_PER_CHUNK;
+
+	for ( u32 i = 0; i < BLOCKS_PER_CHUNK; i++ ) {
+		u32 blockIndex = firstBlock + i;
+
+		mColorIndices[blockIndex] = slot.mColorIndices[i];
+		mScoreValues[blockIndex] = slot.mScoreValues[i];
+		mHitPoints[blockIndex] = slot.mHitPoints[i];
+
+		state.SetBlockHitPoints( blockIndex, slot.mHitPoints[i] );
+		state.SetBlockActive( blockIndex, slot.mHitPoints[i] > 0 );
+	}
+
+	slot.mState = CHUNK_SLOT_STATE_RESIDENT;
+
+	chunkTiming_t& timing = mStats.mHistory[mStats.mHistoryHead];
+	timing.mChunkIndex = slot.mChunkIndex;
+	timing.mGenerateMilliseconds = slot.mGenerateMilliseconds;
+	timing.mLatencyMilliseconds = static_cast<float32>( deltaMilliseconds( slot.mRequestTime, timeNow() ) );
+	timing.mStalled = stalled;
+
+	mStats.mHistoryHead = ( mStats.mHistoryHead + 1 ) % streamerStats_t::HISTORY_LENGTH;
+
+	mStats.mChunksGenerated++;
+	mStats.mTotalGenerateMilliseconds += timing.mGenerateMilliseconds;
+	mStats.mMaxGenerateMilliseconds = max( mStats.mMaxGenerateMilliseconds, timing.mGenerateMilliseconds );
+	mStats.mMaxLatencyMilliseconds = max( mStats.mMaxLatencyMilliseconds, timing.mLatencyMilliseconds );
+}
+
+/*
+========================
+LevelStreamer::EvictChunk
+========================
+*/
+void LevelStreamer::EvictChunk( GameWorld& world, chunkSlot_t& slot ) {
+	GameState& state = world.GetState();
+	gameStateHeader_t& header = state.GetHeader();
+
+	u32 firstBlock = GetSlotIndex( slot ) * BLOCKS_PER_CHUNK;
+
+	for ( u32 i = 0; i < BLOCKS_PER_CHUNK; i++ ) {
+		u32 blockIndex = firstBlock + i;
+
+		// the world ends the game once every block has been hit, so only count the hits that are still resident
+		if ( slot.mState == CHUNK_SLOT_STATE_RESIDENT && mHitPoints[blockIndex] > 0 && !state.IsBlockActive( blockIndex ) && header.mHitBlocks > 0 ) {
+			header.mHitBlocks--;
+		}
+
+		mHitPoints[blockIndex] = 0;
+
+		state.SetBlockHitPoints( blockIndex, 0 );
+		state.SetBlockActive( blockIndex, false );
+	}
+
+	if ( slot.mState == CHUNK_SLOT_STATE_RESIDENT ) {
+		mStats.mChunksEvicted++;
+	}
+
+	slot.mState = CHUNK_SLOT_STATE_FREE;
+}
+
+/*
+========================
+LevelStreamer::Flush
+========================
+*/
+void LevelStreamer::Flush() {
+	if ( !mJobSystem ) {
+		return;
+	}
+
+	for ( chunkSlot_t& slot : mSlots ) {
+		mJobSystem->Wait( &slot.mCounter );
+	}
+}
+
+/*
+========================
+LevelStreamer::UpdatePositions
+========================
+*/
+void LevelStreamer::UpdatePositions() {
+	for ( u32 chunkIndex = mFirstChunk; chunkIndex < mFirstChunk + ENDLESS_NUM_CHUNKS; chunkIndex++ ) {
+		u32 firstBlock = GetSlotIndex( GetSlot( chunkIndex ) ) * BLOCKS_PER_CHUNK;
+
+		for ( u32 row = 0; row < ENDLESS_CHUNK_ROWS; row++ ) {
+			float32 blockY = FIELD_BOTTOM + ( ( chunkIndex * ENDLESS_CHUNK_ROWS + row ) * ROW_HEIGHT ) - mScroll;
+
+			for ( u32 column = 0; column < NUM_BLOCKS_COLUMNS; column++ ) {
+				float32 blockX = -5.0f + column;
+
+				mPositions[firstBlock + column + ( row * NUM_BLOCKS_COLUMNS )] = glm::vec2( blockX, blockY );
+			}
+		}
+	}
+}
+
+/*
+========================
+LevelStreamer::GetChunkBottom
+========================
+*/
+float32 LevelStreamer::GetChunkBottom( const u32 chunkIndex ) const {
+	return FIELD_BOTTOM + ( chunkIndex * ENDLESS_CHUNK_ROWS * ROW_HEIGHT ) - mScroll - BLOCK_HALF_SIZE.y;
+}
+
+/*
+========================
+LevelStreamer::GetChunkTop
+========================
+*/
+float32 LevelStreamer::GetChunkTop( const u32 chunkIndex ) const {
+	return GetChunkBottom( chunkIndex ) + ( ENDLESS_CHUNK_ROWS * ROW_HEIGHT );
+}
+
+/*
+========================
+LevelStreamer::GenerateChunkJob
+========================
+*/
+void LevelStreamer::GenerateChunkJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	LevelStreamer* streamer = static_cast<LevelStreamer*>( data );
+
+	for ( u32 slotIndex = start; slotIndex < end; slotIndex++ ) {
+		chunkSlot_t& slot = streamer->mSlots[slotIndex];
+
+		timestamp_t generateStart = timeNow();
+
+		u32 random = ChunkSeed( streamer->mSeed, slot.mChunkIndex );
+
+		// gets harder the higher up you go: more blocks, and tougher ones
+		u32 difficulty = min( slot.mChunkIndex, 32u );
+		u32 gapChance = 96 - ( difficulty * 2 );
+		u32 maxHitPoints = min( 1 + ( difficulty / 8 ), ENDLESS_MAX_HIT_POINTS );
+
+		// only generate the left half and mirror it, symmetric rows look a lot more like someone designed them
+		const u32 halfColumns = ( NUM_BLOCKS_COLUMNS + 1 ) / 2;
+
+		for ( u32 row = 0; row < ENDLESS_CHUNK_ROWS; row++ ) {
+			for ( u32 column = 0; column < halfColumns; column++ ) {
+				u32 value = ChunkRandom( random );
+
+				u8 hitPoints = 0;
+				if ( ( value & 0xFF ) >= gapChance ) {
+					hitPoints = static_cast<u8>( 1 + ( ( value >> 8 ) % maxHitPoints ) );
+				}
+
+				u32 left = column + ( row * NUM_BLOCKS_COLUMNS );
+				u32 right = ( NUM_BLOCKS_COLUMNS - 1 - column ) + ( row * NUM_BLOCKS_COLUMNS );
+
+				for ( u32 blockIndex : { left, right } ) {
+					slot.mHitPoints[blockIndex] = hitPoints;
+					slot.mColorIndices[blockIndex] = ( hitPoints > 0 ) ? hitPoints - 1u : 0u;
+					slot.mScoreValues[blockIndex] = hitPoints * ( 1 + ( difficulty / 4 ) );
+				}
+			}
+		}
+
+		timestamp_t generateEnd = timeNow();
+		slot.mGenerateMilliseconds = static_cast<float32>( deltaMilliseconds( generateStart, generateEnd ) );
+	}
+}
\ No newline at end of file
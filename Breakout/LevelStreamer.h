@@ -0,0 +1,166 @@
+#ifndef __LEVEL_STREAMER_H__
+#define __LEVEL_STREAMER_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+#include "Defines.h"
+#include "GameState.h"
+#include "JobSystem.h"
+
+class GameWorld;
+
+struct chunkTiming_t {
+	u32						mChunkIndex;
+	float32					mGenerateMilliseconds;	// time spent generating it on the worker
+	float32					mLatencyMilliseconds;	// from being requested to being committed to the world
+	bool32					mStalled;				// the main thread had to wait for it
+};
+
+struct streamerStats_t {
+	static const u32		HISTORY_LENGTH = 64;
+
+	u32						mChunksGenerated;
+	u32						mChunksEvicted;
+
+	// a stall is a chunk that came on screen before its job had finished, those are hitches
+	u32						mStalls;
+	float32					mMaxStallMilliseconds;
+
+	float64					mTotalGenerateMilliseconds;
+	float32					mMaxGenerateMilliseconds;
+	float32					mMaxLatencyMilliseconds;
+
+	// the last HISTORY_LENGTH chunks that got committed, oldest first once it wraps
+	chunkTiming_t			mHistory[HISTORY_LENGTH];
+	u32						mHistoryHead;
+
+	inline float32			GetAverageGenerateMilliseconds() const { return mChunksGenerated ? static_cast<float32>( mTotalGenerateMilliseconds / mChunksGenerated ) : 0.0f; }
+};
+
+/*
+================================================================================================
+
+	Breakout Level Streamer
+
+	Endless mode. The level is an infinite column of chunks, each one ENDLESS_CHUNK_ROWS rows of
+	blocks generated from the seed and the chunk's index, so the same seed always gives the same
+	level no matter when or where a chunk gets generated.
+
+	Only ENDLESS_NUM_CHUNKS chunks are ever resident. Each one owns a fixed slot in the block
+	table, so memory never grows no matter how far the player gets, and nothing is allocated
+	after construction. When a chunk scrolls off the bottom of the screen its slot is handed
+	straight to a job to generate the chunk that will need it next, which will be well above
+	the top of the screen by the time it's wanted.
+
+	Workers only ever write into the slot's own staging data. The main thread copies a chunk
+	into the block table and the world's state once its job has finished, so the world never
+	sees a half generated chunk and nothing needs a lock.
+
+	Whenever the ball climbs past CLIMB_LINE the field scrolls down by however far it went.
+
+================================================================================================
+*/
+
+class LevelStreamer {
+public:
+	static const u32		BLOCKS_PER_CHUNK = NUM_BLOCKS_COLUMNS * ENDLESS_CHUNK_ROWS;
+	static const u32		MAX_BLOCKS = BLOCKS_PER_CHUNK * ENDLESS_NUM_CHUNKS;
+
+	static const float32	ROW_HEIGHT;
+	static const float32	FIELD_BOTTOM;
+	static const float32	CLIMB_LINE;
+
+public:
+							LevelStreamer();
+							~LevelStreamer();
+
+	// null job system means generate chunks on the calling thread
+	void					Init( const u32 seed, JobSystem* jobSystem );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	// the world MUST be initialised with this block table
+	inline const blockTable_t&	GetBlockTable() const { return mBlockTable; }
+
+	// call after every GameWorld::ResetLevel(), blocks until the first screen of chunks is ready
+	void					Reset( GameWorld& world );
+
+	// scrolls the field if the ball has climbed and streams chunks in and out, call once per tick after the world ticks
+	void					Update( GameWorld& world );
+
+	// scrolls the whole field down by distance world units
+	void					Advance( GameWorld& world, const float32 distance );
+
+	inline float32			GetScroll() const { return mScroll; }
+
+	// goes up every time blocks move, arrive, or leave, so anything mirroring the block table knows when to look at it again
+	inline u32				GetBlockTableVersion() const { return mBlockTableVersion; }
+	inline const streamerStats_t&	GetStats() const { return mStats; }
+
+private:
+	enum chunkSlotState_t {
+		CHUNK_SLOT_STATE_FREE		= 0,
+		CHUNK_SLOT_STATE_GENERATING,
+		CHUNK_SLOT_STATE_RESIDENT,
+	};
+
+	struct chunkSlot_t {
+		chunkSlotState_t	mState;
+		u32					mChunkIndex;
+
+		jobCounter_t		mCounter;
+		timestamp_t			mRequestTime;
+
+		// only written by the job, only read once it's done
+		float32				mGenerateMilliseconds;
+		u8					mHitPoints[BLOCKS_PER_CHUNK];	// 0 means there's no block there
+		u32					mColorIndices[BLOCKS_PER_CHUNK];
+		u32					mScoreValues[BLOCKS_PER_CHUNK];
+	};
+
+	u32						mSeed;
+	JobSystem*				mJobSystem;
+
+	float32					mScroll;
+	u32						mFirstChunk;	// the lowest chunk that's still resident
+	u32						mBlockTableVersion;
+
+	chunkSlot_t				mSlots[ENDLESS_NUM_CHUNKS];
+
+	// chunk i lives in blocks [( i % ENDLESS_NUM_CHUNKS ) * BLOCKS_PER_CHUNK, + BLOCKS_PER_CHUNK)
+	glm::vec2				mPositions[MAX_BLOCKS];
+	glm::vec2				mHalfSizes[MAX_BLOCKS];
+	u32						mColorIndices[MAX_BLOCKS];
+	u32						mScoreValues[MAX_BLOCKS];
+	u8						mHitPoints[MAX_BLOCKS];
+
+	blockTable_t			mBlockTable;
+
+	streamerStats_t			mStats;
+
+	bool32					mInitialised;
+
+private:
+	void					RequestChunk( const u32 chunkIndex );
+	void					CommitChunk( GameWorld& world, chunkSlot_t& slot, const bool32 stalled );
+	void					EvictChunk( GameWorld& world, chunkSlot_t& slot );
+
+	// waits for every job that's still going
+	void					Flush();
+
+	void					UpdatePositions();
+
+	inline chunkSlot_t&		GetSlot( const u32 chunkIndex ) { return mSlots[chunkIndex % ENDLESS_NUM_CHUNKS]; }
+	inline u32				GetSlotIndex( const chunkSlot_t& slot ) const { return static_cast<u32>( &slot - mSlots ); }
+
+	float32					GetChunkBottom( const u32 chunkIndex ) const;
+	float32					GetChunkTop( const u32 chunkIndex ) const;
+
+	static void				GenerateChunkJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+#endif // __LEVEL_STREAMER_H__
\ No newline at end of file
@@ -1,4 +1,8 @@
 #include "Game.h"
+#include "Benchmark.h"
+#include "RenderTest.h"
+
+#include "gl/VulkanStandIn.h"
 
 // SDL moans what main define gets used between debug/release builds, which is very annoying
 // so I've done this to get around the issue, though not sure what the real problem is
@@ -6,12 +10,58 @@
 #define main SDL_main
 
 int main( int argc, char** argv ) {
-	UNUSED( argc );
-	UNUSED( argv );
+	if ( argc > 1 && strcmp( argv[1], "-benchmark" ) == 0 ) {
+		bool32 result = RunBenchmarks( argc > 2 ? argv[2] : nullptr );
+		return result ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if ( argc > 1 && strcmp( argv[1], "-rendertest" ) == 0 ) {
+		bool32 updateGoldens = false;
+		bool32 software = false;
+
+		for ( s32 i = 2; i < argc; i++ ) {
+			if ( strcmp( argv[i], "-update" ) == 0 ) {
+				updateGoldens = true;
+			} else if ( strcmp( argv[i], "-software" ) == 0 ) {
+				software = true;
+			}
+		}
+
+		bool32 result = RunRenderTest( updateGoldens, software );
+		return result ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	bool32 endless = false;
+	bool32 usePipelineCache = true;
+	bool32 useDynamicRendering = true;
+	bool32 useBindless = false;
+	bool32 useSoftware = false;
+	bool32 recordVulkan = false;
+
+	for ( s32 i = 1; i < argc; i++ ) {
+		if ( strcmp( argv[i], "-endless" ) == 0 ) {
+			endless = true;
+		} else if ( strcmp( argv[i], "-nopipelinecache" ) == 0 ) {
+			usePipelineCache = false;
+		} else if ( strcmp( argv[i], "-nodynamicrendering" ) == 0 ) {
+			useDynamicRendering = false;
+		} else if ( strcmp( argv[i], "-bindless" ) == 0 ) {
+			useBindless = true;
+		} else if ( strcmp( argv[i], "-software" ) == 0 ) {
+			useSoftware = true;
+		} else if ( strcmp( argv[i], "-vkrecord" ) == 0 ) {
+			recordVulkan = true;
+		}
+	}
+
+	// counts everything sent to the GPU while the game still runs as normal on top of the driver
+	if ( recordVulkan ) {
+		VulkanStandIn::Install( true );
+	}
 
 	gGame = new Game();
 
-	bool32 result = gGame->Init();
+	bool32 result = gGame->Init( endless, usePipelineCache, useDynamicRendering, useBindless, useSoftware );
 	if ( !result ) {
 		fatalError( "Game failed to initialise!\n" );
 		return EXIT_FAILURE;
@@ -24,5 +74,10 @@ int main( int argc, char** argv ) {
 	delete gGame;
 	gGame = nullptr;
 
+	if ( recordVulkan ) {
+		VulkanStandIn::PrintStats();
+		VulkanStandIn::Uninstall();
+	}
+
 	return 0;
 }
\ No newline at end of file
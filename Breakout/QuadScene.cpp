@@ -0,0 +1,144 @@
+#include "QuadScene.h"
+
+/*
+================================================================================================
+
+	QuadScene
+
+================================================================================================
+*/
+
+/*
+========================
+QuadScene::QuadScene
+========================
+*/
+QuadScene::QuadScene() {
+	mInstances = nullptr;
+	mDirtyBits = nullptr;
+
+	mNumQuads = 0;
+	mMaxQuads = 0;
+
+	mDirtyFirst = U32_MAX;
+	mDirtyLast = 0;
+}
+
+/*
+========================
+QuadScene::~QuadScene
+========================
+*/
+QuadScene::~QuadScene() {
+	Shutdown();
+}
+
+/*
+========================
+QuadScene::Init
+========================
+*/
+void QuadScene::Init( const u32 maxQuads ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call QuadScene::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( maxQuads > 0 ), "QuadScene needs room for at least one quad!\n" );
+
+	u32 numDirtyWords = ( maxQuads + 63 ) / 64;
+
+	mInstances = new quadInstance_t[maxQuads];
+	mDirtyBits = new u64[numDirtyWords];
+
+	memset( mInstances, 0, maxQuads * sizeof( quadInstance_t ) );
+	memset( mDirtyBits, 0, numDirtyWords * sizeof( u64 ) );
+
+	mNumQuads = 0;
+	mMaxQuads = maxQuads;
+
+	MarkAllDirty();
+}
+
+/*
+========================
+QuadScene::Shutdown
+========================
+*/
+void QuadScene::Shutdown() {
+	delete[] mDirtyBits;
+	mDirtyBits = nullptr;
+
+	delete[] mInstances;
+	mInstances = nullptr;
+
+	mNumQuads = 0;
+	mMaxQuads = 0;
+
+	mDirtyFirst = U32_MAX;
+	mDirtyLast = 0;
+}
+
+/*
+========================
+QuadScene::MarkAllDirty
+========================
+*/
+void QuadScene::MarkAllDirty() {
+	for ( u32 i = 0; i < mMaxQuads; i++ ) {
+		MarkDirty( i );
+	}
+}
+
+/*
+========================
+QuadScene::BuildDirtyRanges
+========================
+*/
+u32 QuadScene::BuildDirtyRanges( quadRange_t* outRanges, const u32 maxRanges ) {
+	assertf( ( maxRanges > 0 ), "QuadScene::BuildDirtyRanges() needs room for at least one range!\n" );
+
+	if ( !IsDirty() ) {
+		return 0;
+	}
+
+	u32 numRanges = 0;
+
+	for ( u32 word = mDirtyFirst / 64; word <= mDirtyLast / 64; word++ ) {
+		u64 bits = mDirtyBits[word];
+
+		if ( bits == 0 ) {
+			continue;
+		}
+
+		mDirtyBits[word] = 0;
+
+		for ( u32 bit = 0; bits != 0; bit++, bits >>= 1 ) {
+			if ( ( bits & 1 ) == 0 ) {
+				continue;
+			}
+
+			u32 index = word * 64 + bit;
+
+			if ( numRanges > 0 ) {
+				quadRange_t& last = outRanges[numRanges - 1];
+				u32 gap = index - ( last.mFirst + last.mCount );
+
+				// close enough to the last run to join it, or out of ranges so the last one has to take it
+				if ( gap <= MERGE_GAP || numRanges == maxRanges ) {
+					last.mCount = index - last.mFirst + 1;
+					continue;
+				}
+			}
+
+			outRanges[numRanges].mFirst = index;
+			outRanges[numRanges].mCount = 1;
+			numRanges++;
+		}
+	}
+
+	mDirtyFirst = U32_MAX;
+	mDirtyLast = 0;
+
+	return numRanges;
+}
\ No newline at end of file
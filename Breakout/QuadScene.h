@@ -0,0 +1,162 @@
+#ifndef __QUAD_SCENE_H__
+#define __QUAD_SCENE_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+// one per quad in the quad shader's instance storage buffer, MUST match quad_instance_t in unlit_3d.vert and unlit_bindless.vert
+// 16 bytes so four fit in a cache line, the shader builds the transform from these
+struct quadInstance_t {
+	glm::vec2							mPosition;		// centre
+	u32									mHalfSize;		// x and y as halfs, see glm::packHalf2x16()
+	u32									mMaterial;		// see packQuadMaterial()
+};
+
+// the palette index in the low 16 bits and the bindless texture index in the high 16
+// without the bindless table the texture is ignored and every quad is a flat color
+inline u32 packQuadMaterial( const u32 colorIndex, const u32 textureIndex ) {
+	return ( colorIndex & 0xFFFF ) | ( textureIndex << 16 );
+}
+
+// a run of quads [mFirst, mFirst + mCount) that needs to go to the GPU
+struct quadRange_t {
+	u32									mFirst;
+	u32									mCount;
+};
+
+/*
+================================================================================================
+
+	Breakout Quad Scene
+
+	A retained set of quad instances. Every quad owns a fixed slot for as long as it exists, so
+	something that never changes (most of the blocks) gets written once and then left alone.
+
+	Set() only marks a slot dirty when what's in it actually changes, so it's fine to call it
+	for something every frame. Whoever owns the GPU copy of the instances calls
+	BuildDirtyRanges() once a frame and uploads just those, so the upload scales with how much
+	changed and not with how many quads there are.
+
+	Hidden quads stay in their slot with a size of zero, which the GPU throws away before it
+	rasterises anything.
+
+	Doesn't touch Vulkan at all so it can be used and measured without a device.
+
+================================================================================================
+*/
+
+class QuadScene {
+public:
+	// two dirty runs with this many clean quads or fewer between them get uploaded as one range
+	// re-sending a few clean quads is cheaper than another copy region
+	static const u32					MERGE_GAP = 4;
+
+public:
+										QuadScene();
+										~QuadScene();
+
+	// every slot starts out dirty because nothing's been uploaded yet
+	void								Init( const u32 maxQuads );
+	void								Shutdown();
+	inline bool32						IsInitialised() const { return mInstances != nullptr; }
+
+	// only slots [0, numQuads) get drawn
+	inline void							SetNumQuads( const u32 numQuads ) { mNumQuads = min( numQuads, mMaxQuads ); }
+	inline u32							GetNumQuads() const { return mNumQuads; }
+	inline u32							GetMaxQuads() const { return mMaxQuads; }
+
+	// textureIndex is a slot in the context's BindlessTable, 0 is plain white
+	inline void							Set( const u32 index, const glm::vec2& position, const glm::vec2& halfSize, const u32 colorIndex, const u32 textureIndex = 0 );
+	inline void							Hide( const u32 index );
+
+	void								MarkAllDirty();
+	inline bool32						IsDirty() const { return mDirtyFirst <= mDirtyLast; }
+
+	// writes out the dirty slots as merged ranges in order and marks everything clean
+	// if there are more than maxRanges the last one gets stretched to cover the rest
+	// returns how many ranges were written
+	u32									BuildDirtyRanges( quadRange_t* outRanges, const u32 maxRanges );
+
+	inline const quadInstance_t*		GetInstances() const { return mInstances; }
+
+private:
+	quadInstance_t*						mInstances;
+	u64*								mDirtyBits;
+
+	u32									mNumQuads;
+	u32									mMaxQuads;
+
+	// bounds of the dirty slots so a frame where only a few things moved doesn't scan every bit
+	u32									mDirtyFirst;
+	u32									mDirtyLast;
+
+private:
+	inline void							MarkDirty( const u32 index );
+};
+
+/*
+========================
+QuadScene::Set
+========================
+*/
+void QuadScene::Set( const u32 index, const glm::vec2& position, const glm::vec2& halfSize, const u32 colorIndex, const u32 textureIndex ) {
+	// dropped in release builds too, a missing quad is a lot better than writing past the end
+	if ( index >= mMaxQuads ) {
+		assertf( false, "QuadScene::Set() index is out of range!\n" );
+		return;
+	}
+
+	quadInstance_t& instance = mInstances[index];
+	u32 packedHalfSize = glm::packHalf2x16( halfSize );
+	u32 material = packQuadMaterial( colorIndex, textureIndex );
+
+	if ( instance.mPosition == position && instance.mHalfSize == packedHalfSize && instance.mMaterial == material ) {
+		return;
+	}
+
+	instance.mPosition = position;
+	instance.mHalfSize = packedHalfSize;
+	instance.mMaterial = material;
+
+	MarkDirty( index );
+}
+
+/*
+========================
+QuadScene::Hide
+========================
+*/
+void QuadScene::Hide( const u32 index ) {
+	if ( index >= mMaxQuads ) {
+		assertf( false, "QuadScene::Hide() index is out of range!\n" );
+		return;
+	}
+
+	quadInstance_t& instance = mInstances[index];
+
+	// both halfs being +0 packs down to 0
+	if ( instance.mHalfSize == 0 ) {
+		return;
+	}
+
+	instance.mHalfSize = 0;
+
+	MarkDirty( index );
+}
+
+/*
+========================
+QuadScene::MarkDirty
+========================
+*/
+void QuadScene::MarkDirty( const u32 index ) {
+	mDirtyBits[index / 64] |= 1ull << ( index % 64 );
+
+	mDirtyFirst = min( mDirtyFirst, index );
+	mDirtyLast = max( mDirtyLast, index );
+}
+
+#endif // __QUAD_SCENE_H__
\ No newline at end of file
@@ -0,0 +1,510 @@
+#include "RenderTest.h"
+
+#include "Defines.h"
+#include "GameWorld.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include "Renderer.h"
+#include "UI.h"
+
+// mstd already pulls in Windows.h
+#if !MSTD_OS_WINDOWS
+#include <errno.h>
+#include <sys/stat.h>
+#endif
+
+/*
+================================================================================================
+
+	Render Test
+
+================================================================================================
+*/
+
+#define RENDER_TEST_GOLDEN_DIRECTORY	BASE_PATH "golden"
+#define RENDER_TEST_GOLDEN_PATH		BASE_PATH "golden/frame_%04u.tga"
+#define RENDER_TEST_FAILED_PATH		BASE_PATH "golden/frame_%04u_failed.tga"
+#define RENDER_TEST_TIMINGS_PATH	"render_test_timings.csv"
+
+static const u32 RENDER_TEST_SEED = 0x1234ABCD;
+static const u32 RENDER_TEST_NUM_FRAMES = 60 * 10;
+static const u32 RENDER_TEST_CAPTURE_INTERVAL = 60;		// every this many frames gets compared against a golden image
+static const float32 RENDER_TEST_TICK_DELTA = 1.0f / 60.0f;
+static const float32 RENDER_TEST_BOT_DEAD_ZONE = 0.1f;
+
+// drivers are allowed to rasterise and blend a little differently, so this is per channel
+static const u32 RENDER_TEST_CHANNEL_TOLERANCE = 8;
+
+// how many pixels can be past the tolerance before the frame is wrong, it's mostly the edges of the text
+static const float64 RENDER_TEST_MAX_BAD_PIXEL_FRACTION = 0.001;
+
+// the same as the game's, which it keeps to itself
+static const glm::vec4 RENDER_TEST_PLAYER_COLOR = glm::vec4( 200, 72, 72, 255 ) / 255.0f;
+
+static const u32 TGA_HEADER_SIZE = 18;
+
+struct renderTest_t {
+	bool32				mUpdateGoldens;
+
+	u32					mNumRequested;		// every capture has to come back as one of the below, or the readback lost it
+	u32					mNumCompared;
+	u32					mNumFailed;
+	u32					mNumMissing;		// no golden image to compare against, which fails the test unless it's updating them
+	u32					mNumWritten;
+	u32					mNumWriteFailures;
+};
+
+struct renderTestTiming_t {
+	float32				mCPUMilliseconds;
+	float32				mGPUMilliseconds[GPUProfiler::MAX_SCOPES];	// whatever the scopes read back most recently, so a few frames old
+};
+
+/*
+========================
+CreateGoldenDirectory
+========================
+*/
+static bool32 CreateGoldenDirectory() {
+	// already being there is fine, it's only ever made once
+#if MSTD_OS_WINDOWS
+	bool32 result = CreateDirectoryA( RENDER_TEST_GOLDEN_DIRECTORY, nullptr ) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+	bool32 result = mkdir( RENDER_TEST_GOLDEN_DIRECTORY, 0755 ) == 0 || errno == EEXIST;
+#endif
+
+	if ( !result ) {
+		error( "Failed to create %s, nothing could be written to it!\n", RENDER_TEST_GOLDEN_DIRECTORY );
+	}
+
+	return result;
+}
+
+/*
+========================
+WriteTGA
+========================
+*/
+static bool32 WriteTGA( const char* filename, const u8* pixels, const u32 width, const u32 height ) {
+	// uncompressed true color, 32 bits with 8 of them alpha, and the first row is the top
+	u8 header[TGA_HEADER_SIZE] = {};
+	header[2] = 2;
+	header[12] = static_cast<u8>( width & 0xFF );
+	header[13] = static_cast<u8>( width >> 8 );
+	header[14] = static_cast<u8>( height & 0xFF );
+	header[15] = static_cast<u8>( height >> 8 );
+	header[16] = 32;
+	header[17] = 0x28;
+
+	// the mstd file functions can't truncate an existing file
+	FILE* file = fopen( filename, "wb" );
+	bool32 result = file && fwrite( header, TGA_HEADER_SIZE, 1, file ) == 1 && fwrite( pixels, width * height * 4, 1, file ) == 1;
+
+	if ( file ) {
+		fclose( file );
+	}
+
+	if ( !result ) {
+		error( "Failed to write %s!\n", filename );
+	}
+
+	return result;
+}
+
+/*
+========================
+ReadTGA
+========================
+*/
+static bool32 ReadTGA( const char* filename, array<u8>& outPixels, u32& outWidth, u32& outHeight ) {
+	char* buffer = nullptr;
+	size_t bytes = readEntireFile( filename, &buffer );
+
+	if ( bytes == 0 ) {
+		YETI_FREE_ARRAY( buffer );
+		return false;
+	}
+
+	const u8* header = reinterpret_cast<const u8*>( buffer );
+
+	if ( bytes < TGA_HEADER_SIZE ) {
+		error( "%s is too small to be a TGA!\n", filename );
+		YETI_FREE_ARRAY( buffer );
+		return false;
+	}
+
+	u32 width = static_cast<u32>( header[12] | ( header[13] << 8 ) );
+	u32 height = static_cast<u32>( header[14] | ( header[15] << 8 ) );
+	size_t sizeBytes = static_cast<size_t>( width ) * height * 4;
+
+	// only ever reads what WriteTGA() wrote
+	if ( header[2] != 2 || header[16] != 32 || ( header[17] & 0x20 ) == 0 || bytes < TGA_HEADER_SIZE + header[0] + sizeBytes ) {
+		error( "%s isn't an uncompressed 32 bit top-down TGA!\n", filename );
+		YETI_FREE_ARRAY( buffer );
+		return false;
+	}
+
+	outPixels.resize( sizeBytes );
+	memcpy( outPixels.data(), header + TGA_HEADER_SIZE + header[0], sizeBytes );
+	outWidth = width;
+	outHeight = height;
+
+	YETI_FREE_ARRAY( buffer );
+
+	return true;
+}
+
+/*
+========================
+OnFrameReadBack
+========================
+*/
+static void OnFrameReadBack( const u8* pixels, const u32 width, const u32 height, const u32 tag, void* data ) {
+	renderTest_t* test = static_cast<renderTest_t*>( data );
+
+	char goldenFilename[256];
+	snprintf( goldenFilename, sizeof( goldenFilename ), RENDER_TEST_GOLDEN_PATH, tag );
+
+	array<u8> golden;
+	u32 goldenWidth = 0;
+	u32 goldenHeight = 0;
+
+	bool32 missing = !test->mUpdateGoldens && !ReadTGA( goldenFilename, golden, goldenWidth, goldenHeight );
+
+	if ( test->mUpdateGoldens || missing ) {
+		// written either way so it can be looked at, but a missing one isn't a pass until someone has
+		if ( missing ) {
+			error( "Frame %u: %s doesn't exist, writing it from this frame to be checked\n", tag, goldenFilename );
+			test->mNumMissing++;
+		}
+
+		if ( WriteTGA( goldenFilename, pixels, width, height ) ) {
+			printf( "Frame %u: wrote %s\n", tag, goldenFilename );
+			test->mNumWritten++;
+		} else {
+			test->mNumWriteFailures++;
+		}
+
+		return;
+	}
+
+	test->mNumCompared++;
+
+	u32 numBadPixels = 0;
+	u32 maxDifference = 0;
+
+	if ( goldenWidth != width || goldenHeight != height ) {
+		error( "Frame %u is %ux%u but %s is %ux%u!\n", tag, width, height, goldenFilename, goldenWidth, goldenHeight );
+		numBadPixels = width * height;
+	} else {
+		for ( u32 i = 0; i < width * height; i++ ) {
+			const u8* pixel = pixels + i * 4;
+			const u8* goldenPixel = golden.data() + i * 4;
+
+			// alpha is whatever the driver leaves after blending, nothing ever sees it
+			u32 difference = 0;
+			for ( u32 channel = 0; channel < 3; channel++ ) {
+				difference = max( difference, static_cast<u32>( abs( pixel[channel] - goldenPixel[channel] ) ) );
+			}
+
+			maxDifference = max( maxDifference, difference );
+
+			if ( difference > RENDER_TEST_CHANNEL_TOLERANCE ) {
+				numBadPixels++;
+			}
+		}
+	}
+
+	float64 badPixelFraction = static_cast<float64>( numBadPixels ) / ( width * height );
+
+	if ( badPixelFraction <= RENDER_TEST_MAX_BAD_PIXEL_FRACTION ) {
+		printf( "Frame %u: matches, %u pixels past the tolerance, max difference %u\n", tag, numBadPixels, maxDifference );
+		return;
+	}
+
+	char failedFilename[256];
+	snprintf( failedFilename, sizeof( failedFilename ), RENDER_TEST_FAILED_PATH, tag );
+
+	error( "Frame %u: %u pixels (%.3f%%) differ from %s, max difference %u, see %s\n", tag, numBadPixels, badPixelFraction * 100.0, goldenFilename, maxDifference, failedFilename );
+	if ( !WriteTGA( failedFilename, pixels, width, height ) ) {
+		test->mNumWriteFailures++;
+	}
+
+	test->mNumFailed++;
+}
+
+/*
+========================
+SetQuads
+========================
+*/
+static void SetQuads( const GameWorld& world, const u32 numBlockColors, const bool32 syncBlocks ) {
+	const GameState& worldState = world.GetState();
+	const gameStateHeader_t& state = worldState.GetHeader();
+	const blockTable_t& blockTable = *world.GetBlockTable();
+
+	// block i is quad i like in the game, there's no multi-ball so only the ball and the paddle come after them
+	if ( syncBlocks ) {
+		for ( u32 blockIndex = 0; blockIndex < blockTable.GetNumBlocks(); blockIndex++ ) {
+			if ( !worldState.IsBlockActive( blockIndex ) ) {
+				gRenderer->HideQuad( blockIndex );
+				continue;
+			}
+
+			u32 colorIndex = min( blockTable.mColorIndices[blockIndex], numBlockColors - 1 );
+			gRenderer->SetQuad( blockIndex, blockTable.mPositions[blockIndex], blockTable.mHalfSizes[blockIndex], colorIndex );
+		}
+	}
+
+	u32 quadIndex = blockTable.GetNumBlocks();
+
+	gRenderer->SetQuad( quadIndex++, state.mBallPosition, state.mBallHalfSize, numBlockColors );
+	gRenderer->SetQuad( quadIndex++, state.mPlayerPosition, state.mPlayerHalfSize, numBlockColors );
+
+	gRenderer->SetNumQuads( quadIndex );
+}
+
+/*
+========================
+WriteTimings
+========================
+*/
+static void WriteTimings( const array<renderTestTiming_t>& timings, const GPUProfiler* profiler ) {
+	FILE* file = fopen( RENDER_TEST_TIMINGS_PATH, "w" );
+	if ( !file ) {
+		error( "Failed to write %s\n", RENDER_TEST_TIMINGS_PATH );
+		return;
+	}
+
+	// there's no profiler in software mode
+	u32 numScopes = profiler ? profiler->GetNumScopes() : 0;
+
+	fprintf( file, "frame,cpu_ms" );
+	for ( u32 scope = 0; scope < numScopes; scope++ ) {
+		fprintf( file, ",gpu_%s_ms", profiler->GetScope( scope ).mName );
+	}
+	fprintf( file, "\n" );
+
+	for ( u32 frame = 0; frame < timings.length(); frame++ ) {
+		const renderTestTiming_t& timing = timings[frame];
+
+		fprintf( file, "%u,%.4f", frame, timing.mCPUMilliseconds );
+		for ( u32 scope = 0; scope < numScopes; scope++ ) {
+			fprintf( file, ",%.4f", timing.mGPUMilliseconds[scope] );
+		}
+		fprintf( file, "\n" );
+	}
+
+	fclose( file );
+}
+
+/*
+========================
+PrintTimings
+========================
+*/
+static void PrintTimings( const array<renderTestTiming_t>& timings, const GPUProfiler* profiler ) {
+	printf( "%-16s %-12s %-12s %-10s\n", "TIMING", "AVG (ms)", "MAX (ms)", "MAX FRAME" );
+
+	u32 numScopes = profiler ? profiler->GetNumScopes() : 0;
+
+	// the cpu first and then every gpu scope, scopes are only in there once they've been read back
+	for ( u32 column = 0; column <= numScopes; column++ ) {
+		float64 total = 0.0;
+		float32 worst = 0.0f;
+		u32 worstFrame = 0;
+		u32 numFrames = 0;
+
+		for ( u32 frame = 0; frame < timings.length(); frame++ ) {
+			float32 milliseconds = ( column == 0 ) ? timings[frame].mCPUMilliseconds : timings[frame].mGPUMilliseconds[column - 1];
+
+			// gpu scopes haven't got anything until the first few frames are read back
+			if ( column > 0 && milliseconds == 0.0f ) {
+				continue;
+			}
+
+			total += milliseconds;
+			numFrames++;
+
+			if ( milliseconds > worst ) {
+				worst = milliseconds;
+				worstFrame = frame;
+			}
+		}
+
+		const char* name = ( column == 0 ) ? "CPU" : profiler->GetScope( column - 1 ).mName;
+		printf( "%-16s %-12.4f %-12.4f %-10u\n", name, numFrames ? total / numFrames : 0.0, worst, worstFrame );
+	}
+}
+
+/*
+========================
+RunRenderTest
+========================
+*/
+bool32 RunRenderTest( const bool32 updateGoldens, const bool32 software ) {
+	printf( "------- Render Test -------\n" );
+
+	if ( !CreateGoldenDirectory() ) {
+		return false;
+	}
+
+	// not the level file, so editing the level doesn't break every golden image
+	Level level;
+	level.CreateDefault();
+	const blockTable_t& blockTable = level.GetBlockTable();
+
+	GameWorld world;
+	world.Init( &blockTable, RENDER_TEST_SEED );
+
+	gJobSystem = new JobSystem();
+	gRenderer = new Renderer();
+	gUI = new UI();
+
+	gJobSystem->Init();
+	// a stale pipeline cache can't change anything, and the render pass path is the one every driver has
+	gRenderer->Init( false, false, false, true, software );
+	gUI->Init( GAME_WIDTH, GAME_HEIGHT );
+
+	// both null in software mode
+	VulkanContext* context = gRenderer->GetContext();
+	GPUProfiler* profiler = context ? context->GetGPUProfiler() : nullptr;
+
+	// frames drawn while the pipelines were still compiling would be missing things
+	if ( context ) {
+		context->GetRenderStateManager()->WaitForBackgroundPipelines();
+	}
+
+	// block color indices go straight through, the paddle and the ball get the one after the last
+	u32 numBlockColors = min( blockTable.mNumColors, static_cast<u32>( RENDERER_PALETTE_SIZE - 1 ) );
+
+	glm::vec4 palette[RENDERER_PALETTE_SIZE];
+	memcpy( palette, blockTable.mPalette, numBlockColors * sizeof( glm::vec4 ) );
+	palette[numBlockColors] = RENDER_TEST_PLAYER_COLOR;
+	gRenderer->SetPalette( palette, numBlockColors + 1 );
+
+	renderTest_t test = {};
+	test.mUpdateGoldens = updateGoldens;
+
+	if ( context ) {
+		context->GetFrameReadback()->SetCallback( OnFrameReadBack, &test );
+	}
+
+	array<renderTestTiming_t> timings;
+	timings.resize( RENDER_TEST_NUM_FRAMES );
+	memset( timings.data(), 0, RENDER_TEST_NUM_FRAMES * sizeof( renderTestTiming_t ) );
+
+	const gameStateHeader_t& state = world.GetState().GetHeader();
+
+	worldInput_t input = {};
+	input.mStartPressed = true;
+
+	bool32 syncBlocks = true;
+
+	for ( u32 frame = 0; frame < RENDER_TEST_NUM_FRAMES; frame++ ) {
+		// the batch runner's bot without any aim error, so it plays out the same every run
+		float32 distance = state.mBallPosition.x - state.mPlayerPosition.x;
+
+		if ( distance > RENDER_TEST_BOT_DEAD_ZONE ) {
+			input.mMoveDirection = 1.0f;
+		} else if ( distance < -RENDER_TEST_BOT_DEAD_ZONE ) {
+			input.mMoveDirection = -1.0f;
+		} else {
+			input.mMoveDirection = 0.0f;
+		}
+
+		u32 events = world.Tick( input, RENDER_TEST_TICK_DELTA );
+
+		// a hit block can change color or go, either way they all get set again
+		syncBlocks |= ( events & GAME_EVENT_BIT( GAME_EVENT_HIT_BLOCK ) ) != 0;
+
+		SetQuads( world, numBlockColors, syncBlocks );
+		syncBlocks = false;
+
+		// fixed text so imgui gets drawn without anything that changes run to run
+		gUI->Begin();
+		gUI->PushWindow( ImVec2( 0, 0 ), ImVec4( 0, 0, 0, 0 ) );
+		ImGui::Text( "FRAME: %u", frame );
+		ImGui::Text( "SCORE: %u", state.mPlayerScore );
+		ImGui::Text( "LIVES: %u", state.mPlayerLives );
+		gUI->PopWindow();
+		gUI->End();
+
+		timestamp_t start = timeNow();
+
+		bool32 capture = ( frame % RENDER_TEST_CAPTURE_INTERVAL ) == 0;
+
+		gRenderer->StartFrame();
+
+		if ( capture ) {
+			test.mNumRequested++;
+		}
+
+		if ( capture && context ) {
+			context->GetFrameReadback()->Request( frame );
+		}
+
+		gRenderer->DrawElements();
+		gUI->Render();
+		gRenderer->EndFrame();
+
+		timestamp_t end = timeNow();
+
+		// the rasteriser has finished by the time EndFrame() returns, so there's nothing to wait for
+		if ( capture && !context ) {
+			const SoftwareRasteriser* rasteriser = gRenderer->GetRasteriser();
+			OnFrameReadBack( reinterpret_cast<const u8*>( rasteriser->GetPixels() ), rasteriser->GetWidth(), rasteriser->GetHeight(), frame, &test );
+		}
+
+		renderTestTiming_t& timing = timings[frame];
+		timing.mCPUMilliseconds = static_cast<float32>( deltaMilliseconds( start, end ) );
+
+		for ( u32 scope = 0; profiler && scope < profiler->GetNumScopes(); scope++ ) {
+			timing.mGPUMilliseconds[scope] = profiler->GetScope( scope ).mMilliseconds;
+		}
+	}
+
+	// the last few frames are still in flight
+	if ( context ) {
+		context->GetFrameReadback()->Flush();
+	}
+
+	printf( "\n" );
+	PrintTimings( timings, profiler );
+	WriteTimings( timings, profiler );
+
+	printf( "\n%u of %u captures compared, %u failed, %u golden images missing, %u written, %u writes failed\n", test.mNumCompared, test.mNumRequested, test.mNumFailed, test.mNumMissing, test.mNumWritten, test.mNumWriteFailures );
+
+	bool32 passed = test.mNumFailed == 0 && test.mNumWriteFailures == 0;
+
+	if ( updateGoldens ) {
+		// a readback that never came back would otherwise look like a successful update
+		if ( test.mNumWritten != test.mNumRequested ) {
+			error( "Only %u of %u golden images were written!\n", test.mNumWritten, test.mNumRequested );
+			passed = false;
+		}
+	} else {
+		if ( test.mNumMissing > 0 ) {
+			error( "%u golden images were missing, check the ones written to %s and commit them, or make them all with -update\n", test.mNumMissing, RENDER_TEST_GOLDEN_DIRECTORY );
+			passed = false;
+		}
+
+		// a capture that never came back can't fail, which isn't the same as passing
+		if ( test.mNumCompared + test.mNumMissing != test.mNumRequested ) {
+			error( "Only %u of %u captures came back to be compared, the rest were never tested!\n", test.mNumCompared + test.mNumMissing, test.mNumRequested );
+			passed = false;
+		}
+	}
+
+	delete gUI;
+	gUI = nullptr;
+
+	delete gRenderer;
+	gRenderer = nullptr;
+
+	delete gJobSystem;
+	gJobSystem = nullptr;
+
+	world.Shutdown();
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef __RENDER_TEST_H__
+#define __RENDER_TEST_H__
+
+#include <mstd/mstd.h>
+
+/*
+================================================================================================
+
+	Breakout Render Test
+
+	Plays the default level headless with a fixed seed and a bot that doesn't miss, so every
+	run draws exactly the same frames, and compares every so often one against a golden image
+	in res/golden/. Run it instead of the game via the command line:
+
+		Breakout.exe -rendertest [-update] [-software]
+
+	Frames that differ by more than a small tolerance fail the test and get written next to
+	their golden image to look at. A golden image that doesn't exist yet fails the test too,
+	and is written from what was drawn so it can be checked and committed, -update rewrites
+	all of them. Every frame that was captured has to come back and be compared (or written,
+	with -update), so a readback that went missing is never a pass.
+
+	The context is headless so it only needs a Vulkan driver and not a window, which means it
+	runs on lavapipe on machines without a GPU. The CPU time of every frame and the GPU time
+	of every profiler scope get written to render_test_timings.csv, with the averages and the
+	worst frames printed at the end.
+
+	-software draws with the SoftwareRasteriser instead and checks it against the same golden
+	images, so it runs without any driver at all. The golden images should come from the GPU
+	so that the rasteriser gets checked against them and not the other way round.
+
+================================================================================================
+*/
+
+// returns false if any frame didn't match its golden image or didn't have one, a file couldn't be written, or a capture never came back
+bool32	RunRenderTest( const bool32 updateGoldens, const bool32 software );
+
+#endif // __RENDER_TEST_H__
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Defines.h"
 
 #include "Window.h"
+#include "JobSystem.h"
 
 /*
 ================================================================================================
@@ -30,9 +31,13 @@ Renderer::Renderer
 */
 Renderer::Renderer() {
 	mContext = nullptr;
+	mRasteriser = nullptr;
 
-	mBufferVertex = nullptr;
-	mBufferIndex = nullptr;
+	mBufferUniformStatic = nullptr;
+	mBufferUniformPalette = nullptr;
+	mBufferInstance = nullptr;
+
+	mPaletteBufferIndex = BindlessTable::INVALID_INDEX;
 
 	mShaderVertex = nullptr;
 	mShaderFragment = nullptr;
@@ -40,13 +45,15 @@ Renderer::Renderer() {
 	mRenderState = nullptr;
 	mUniformLayout = nullptr;
 
+	mUploadStats = {};
+	mNumUploadCopies = 0;
+	mUploadSource = VK_NULL_HANDLE;
 	mUniformDataStatic = {};
-
-	mDescriptorPool = VK_NULL_HANDLE;
+	mUniformDataPalette = {};
 
 	mAspectRatio = 0.0f;
 
-	mDynamicAlignment = 0;
+	mDrawPerQuad = false;
 
 	mInitialised = false;
 }
@@ -65,7 +72,7 @@ Renderer::~Renderer() {
 Renderer::Init
 ========================
 */
-void Renderer::Init() {
+void Renderer::Init( const bool32 usePipelineCache, const bool32 useDynamicRendering, const bool32 useBindless, const bool32 headless, const bool32 software, const u32 maxQuads ) {
 	if ( IsInitialised() ) {
 		return;
 	}
@@ -74,6 +81,22 @@ void Renderer::Init() {
 
 	mAspectRatio = static_cast<float32>( GAME_WIDTH ) / static_cast<float32>( GAME_HEIGHT );
 
+	assertf( ( maxQuads <= MAX_QUADS ), "Renderer can't have room for more than MAX_QUADS quads!\n" );
+	mQuads.Init( min( maxQuads, MAX_QUADS ) );
+
+	InitCamera();
+
+	if ( software ) {
+		mRasteriser = new SoftwareRasteriser();
+		mRasteriser->Init( GAME_WIDTH, GAME_HEIGHT, gJobSystem );
+
+		mInitialised = true;
+
+		printf( "Rendering in software with %u workers.\n", gJobSystem->GetNumWorkers() );
+		printf( "------- Renderer initialised -------\n\n" );
+		return;
+	}
+
 	mContext = new VulkanContext();
 
 	contextInitInfo_t initInfo = {};
@@ -81,33 +104,24 @@ void Renderer::Init() {
 	initInfo.mWidth = GAME_WIDTH;
 	initInfo.mHeight = GAME_HEIGHT;
 	initInfo.mNumBuffers = RENDERER_NUM_BUFFERS;
+	initInfo.mNumFramesInFlight = RENDERER_NUM_FRAMES_IN_FLIGHT;
+	initInfo.mNumRecordingThreads = gJobSystem->GetNumWorkers();
+	initInfo.mPipelineCacheFilename = usePipelineCache ? PIPELINE_CACHE_FILE_PATH : nullptr;
+	initInfo.mAllowDynamicRendering = useDynamicRendering;
+	initInfo.mAllowBindless = useBindless;
+	initInfo.mHeadless = headless;
+	// room for every quad at once on top of everything else, since that's what the first frame uploads
+	initInfo.mFrameAllocatorSizeKB = FrameAllocator::DEFAULT_REGION_SIZE_KB + static_cast<u32>( ( mQuads.GetMaxQuads() * sizeof( quadInstance_t ) + 1023 ) / 1024 );
 #if MSTD_OS_WINDOWS
-	initInfo.mHInstance = gWindow->GetHInstance();
-	initInfo.mHwnd = gWindow->GetHwnd();
+	// there's no window when benchmarking on the Vulkan stand-in
+	initInfo.mHInstance = gWindow ? gWindow->GetHInstance() : nullptr;
+	initInfo.mHwnd = gWindow ? gWindow->GetHwnd() : nullptr;
 #endif
 
 	mContext->Init( initInfo );
 
-	// calculate dynamic uniform buffer alignment stride
-	size_t alignMod = static_cast<size_t>( mContext->GetActiveGPU().mProperties.limits.minUniformBufferOffsetAlignment );
-	mDynamicAlignment = ( sizeof( uniformDataQuad_t ) / alignMod ) * alignMod;
-	if ( sizeof( uniformDataQuad_t ) % alignMod > 0 ) {
-		mDynamicAlignment += alignMod;
-	}
-
-	mJobs.reserve( NUM_BLOCKS_MAX );
-
-	mVertices = {
-		{ glm::vec3( -1.0f, 1.0f, 0.0f ) },
-		{ glm::vec3( 1.0f, 1.0f, 0.0f ) },
-		{ glm::vec3( 1.0f, -1.0f, 0.0f ) },
-		{ glm::vec3( -1.0f, -1.0f, 0.0f ) },
-	};
-
-	mIndices = {
-		0, 1, 2,
-		0, 2, 3
-	};
+	// lets the quad pipeline compile while the rest of the game loads
+	mContext->GetRenderStateManager()->SetJobSystem( gJobSystem );
 
 	CreateBuffers();
 
@@ -115,20 +129,6 @@ void Renderer::Init() {
 
 	CreateRenderState();
 
-	// init camera
-	{
-		mMatrixView = glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) );
-
-		float32 left = -mAspectRatio * ORTHO_SIZE;
-		float32 right = mAspectRatio * ORTHO_SIZE;
-		float32 top = -ORTHO_SIZE;
-		float32 bottom = ORTHO_SIZE;
-		mMatrixProjection = glm::ortho( left, right, top, bottom, -1.0f, 100.0f );
-
-		mUniformDataStatic.mViewProjection = CLIP_MATRIX * mMatrixProjection * mMatrixView;
-		mBufferUniformStatic->UploadData( &mUniformDataStatic, sizeof( uniformDataStatic_t ) );
-	}
-
 	mInitialised = true;
 
 	printf( "------- Renderer initialised -------\n\n" );
@@ -144,8 +144,14 @@ void Renderer::Shutdown() {
 		return;
 	}
 
-	vkDestroyDescriptorPool( mContext->GetLogicalDevice(), mDescriptorPool, nullptr );
-	mDescriptorPool = VK_NULL_HANDLE;
+	mQuads.Shutdown();
+
+	if ( mRasteriser ) {
+		YETI_FREE( mRasteriser );
+
+		mInitialised = false;
+		return;
+	}
 
 	DestroyRenderState();
 
@@ -167,20 +173,37 @@ void Renderer::Resize( const u32 width, const u32 height ) {
 	assertf( width > 0, "Specified resize width was 0!" );
 	assertf( height > 0, "Specified resize height was 0!" );
 
-	DestroyRenderState();
+	if ( mRasteriser ) {
+		mRasteriser->Resize( width, height );
+		return;
+	}
 
+	// viewport and scissor are dynamic and the render pass doesn't change, so the pipeline can stay
 	mContext->Resize( width, height );
-
-	CreateRenderState();
 }
 
 /*
 ========================
-Renderer::AddRenderJob
+Renderer::SetPalette
 ========================
 */
-void Renderer::AddRenderJob( const uniformDataQuad_t& jobData ) {
-	mJobs.add( jobData );
+void Renderer::SetPalette( const glm::vec4* colors, const u32 numColors ) {
+	if ( numColors > RENDERER_PALETTE_SIZE ) {
+		warning( "Palette has %u colors but the renderer only has room for %u, the rest will be dropped!\n", numColors, RENDERER_PALETTE_SIZE );
+	}
+
+	memset( &mUniformDataPalette, 0, sizeof( uniformDataPalette_t ) );
+	memcpy( mUniformDataPalette.mColors, colors, min( numColors, static_cast<u32>( RENDERER_PALETTE_SIZE ) ) * sizeof( glm::vec4 ) );
+
+	// the rasteriser reads it straight out of here
+	if ( mRasteriser ) {
+		return;
+	}
+
+	// there's only one palette buffer, so nothing can still be drawing with it
+	mContext->WaitDeviceIdle();
+
+	mBufferUniformPalette->UploadData( &mUniformDataPalette, sizeof( uniformDataPalette_t ) );
 }
 
 /*
@@ -189,7 +212,11 @@ Renderer::StartFrame
 ========================
 */
 void Renderer::StartFrame() {
-	mJobs.clear();
+	if ( mRasteriser ) {
+		// the same as the swap chain pass's clear
+		mRasteriser->Begin( glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f ) );
+		return;
+	}
 
 	mContext->Clear();
 }
@@ -200,6 +227,15 @@ Renderer::EndFrame
 ========================
 */
 void Renderer::EndFrame() {
+	if ( mRasteriser ) {
+		mRasteriser->End();
+
+		if ( gWindow ) {
+			gWindow->Blit( mRasteriser->GetPixels(), mRasteriser->GetWidth(), mRasteriser->GetHeight() );
+		}
+		return;
+	}
+
 	mContext->Present();
 }
 
@@ -209,37 +245,75 @@ Renderer::DrawElements
 ========================
 */
 void Renderer::DrawElements() {
-	size_t numJobs = mJobs.length();
+	// nothing to upload, the rasteriser reads the instances where they are
+	if ( mRasteriser ) {
+		mRasteriser->DrawQuads( mQuads.GetInstances(), mQuads.GetNumQuads(), mUniformDataPalette.mColors, RENDERER_PALETTE_SIZE, mUniformDataStatic.mViewProjection );
+		return;
+	}
 
-	if ( numJobs == 0 ) {
+	// minimised, the dirty quads stay dirty until there's a frame to upload them in
+	if ( mContext->IsFrameSkipped() ) {
 		return;
 	}
 
-	// copy all uniform data from jobs into the dynamic uniform buffer
-	u8* mappedUniform = reinterpret_cast<u8*>( mBufferUniformQuad->GetMappedData() );
-	for ( size_t i = 0; i < numJobs; i++ ) {
-		memcpy( &mappedUniform[i * mDynamicAlignment], &mJobs[i], sizeof( uniformDataQuad_t ) );
+	RenderGraph* graph = mContext->GetRenderGraph();
+
+	renderGraphHandle_t instances = graph->ImportBuffer( "QuadInstances", mBufferInstance->GetAPIHandle() );
+
+	UploadDirtyQuads( instances );
+
+	u32 numQuads = mQuads.GetNumQuads();
+
+	if ( numQuads == 0 ) {
+		return;
 	}
 
-	VkDeviceSize offsetsVertex[1] = { 0 };
+	graph->Read( mContext->GetSwapChainPass(), instances, YETI_RENDER_GRAPH_ACCESS_STORAGE_BUFFER );
 
-	VkCommandBuffer commandBuffer = mContext->GetCurrentCommandBuffer();
+	CommandRecorder* recorder = mContext->GetCommandRecorder();
+	GPUProfiler* profiler = mContext->GetGPUProfiler();
 
-	VkBuffer vertexBuffer = mBufferVertex->GetAPIHandle();
-	VkDescriptorSet descriptorSet = mUniformLayout->GetDescriptorSet();
+	// the slices, with a slot either side for the profiler scope since that has to stay on this thread
+	u32 quadsPerSlice = CalcQuadsPerSlice( numQuads );
+	u32 numSlices = CalcNumQuadSlices( numQuads );
+	u32 firstSlot = recorder->ReserveSlots( numSlices + 2 );
+	u32 lastSlot = firstSlot + numSlices + 1;
 
-	// don't re-bind vertex/index buffers and render states
-	// because we know all surfaces in this game are using the same render state data everywhere
-	vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mRenderState->GetPipeline() );
-	vkCmdBindVertexBuffers( commandBuffer, 0, 1, &vertexBuffer, offsetsVertex );
-	vkCmdBindIndexBuffer( commandBuffer, mBufferIndex->GetAPIHandle(), 0, VK_INDEX_TYPE_UINT32 );
+	u32 workerIndex = JobSystem::GetWorkerIndex();
 
-	for ( size_t i = 0; i < numJobs; i++ ) {
-		u32 uniformDataQuadOffset = static_cast<u32>( i * mDynamicAlignment );
+	VkCommandBuffer commandBuffer = recorder->BeginSlot( firstSlot, workerIndex );
+	u32 scope = profiler->BeginScope( commandBuffer, "QUADS" );
+	recorder->EndSlot( firstSlot );
 
-		vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mUniformLayout->GetPipelineLayout(), 0, 1, &descriptorSet, 1, &uniformDataQuadOffset );
-		vkCmdDrawIndexed( commandBuffer, static_cast<u32>( mIndices.length() ), 1, 0, 0, 0 );
-	}
+	// fetched here so if the pipeline is still compiling it's only waited on once
+	quadRecordJob_t job = {};
+	job.mRenderer = this;
+	job.mPipeline = mRenderState->GetPipeline();
+	job.mFirstSlot = firstSlot + 1;
+	job.mQuadsPerSlice = quadsPerSlice;
+	gJobSystem->ParallelFor( numQuads, quadsPerSlice, RecordQuadsJob, &job );
+
+	commandBuffer = recorder->BeginSlot( lastSlot, workerIndex );
+	profiler->EndScope( commandBuffer, scope );
+	recorder->EndSlot( lastSlot );
+}
+
+/*
+========================
+Renderer::InitCamera
+========================
+*/
+void Renderer::InitCamera() {
+	mMatrixView = glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) );
+
+	float32 left = -mAspectRatio * ORTHO_SIZE;
+	float32 right = mAspectRatio * ORTHO_SIZE;
+	float32 top = -ORTHO_SIZE;
+	float32 bottom = ORTHO_SIZE;
+	mMatrixProjection = glm::ortho( left, right, top, bottom, -1.0f, 100.0f );
+
+	// CreateBuffers() uploads it from here
+	mUniformDataStatic.mViewProjection = CLIP_MATRIX * mMatrixProjection * mMatrixView;
 }
 
 /*
@@ -248,26 +322,9 @@ Renderer::CreateBuffers
 ========================
 */
 void Renderer::CreateBuffers() {
-	size_t bufferSizeVertex = mVertices.length() * sizeof( vertex_t );
-	size_t bufferSizeIndex = mIndices.length() * sizeof( u32 );
 	size_t bufferSizeUniformStatic = sizeof( uniformDataStatic_t );
-	size_t bufferSizeUniformQuad = ( NUM_BLOCKS_MAX + 2 ) * mDynamicAlignment;	// + 2 for paddle and ball
-
-	bufferDesc_t bufferDescVertex = {};
-	bufferDescVertex.mBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-	bufferDescVertex.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-	bufferDescVertex.mData = mVertices.data();
-	bufferDescVertex.mDataSizeBytes = bufferSizeVertex;
-	mBufferVertex = new Buffer( mContext );
-	mBufferVertex->AllocBuffer( bufferDescVertex );
-
-	bufferDesc_t bufferDescIndex = {};
-	bufferDescIndex.mBufferUsage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-	bufferDescIndex.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-	bufferDescIndex.mData = mIndices.data();
-	bufferDescIndex.mDataSizeBytes = bufferSizeIndex;
-	mBufferIndex = new Buffer( mContext );
-	mBufferIndex->AllocBuffer( bufferDescIndex );
+	size_t bufferSizeUniformPalette = sizeof( uniformDataPalette_t );
+	size_t bufferSizeInstance = mQuads.GetMaxQuads() * sizeof( quadInstance_t );
 
 	bufferDesc_t bufferDescUniformStatic = {};
 	bufferDescUniformStatic.mBufferUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
@@ -277,13 +334,32 @@ void Renderer::CreateBuffers() {
 	mBufferUniformStatic = new Buffer( mContext );
 	mBufferUniformStatic->AllocBuffer( bufferDescUniformStatic );
 
-	bufferDesc_t bufferDescUniformQuad = {};
-	bufferDescUniformQuad.mBufferUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-	bufferDescUniformQuad.mMemoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
-	bufferDescUniformQuad.mData = mJobs.data();
-	bufferDescUniformQuad.mDataSizeBytes = bufferSizeUniformQuad;
-	mBufferUniformQuad = new Buffer( mContext );
-	mBufferUniformQuad->AllocBuffer( bufferDescUniformQuad );
+	// the bindless shaders read it out of the table as a storage buffer
+	VkBufferUsageFlags paletteUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+	if ( mContext->UsesBindless() ) {
+		paletteUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	}
+
+	bufferDesc_t bufferDescUniformPalette = {};
+	bufferDescUniformPalette.mBufferUsage = static_cast<VkBufferUsageFlagBits>( paletteUsage );
+	bufferDescUniformPalette.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	bufferDescUniformPalette.mData = &mUniformDataPalette;
+	bufferDescUniformPalette.mDataSizeBytes = bufferSizeUniformPalette;
+	mBufferUniformPalette = new Buffer( mContext );
+	mBufferUniformPalette->AllocBuffer( bufferDescUniformPalette );
+
+	if ( mContext->UsesBindless() ) {
+		mPaletteBufferIndex = mContext->GetBindlessTable()->AddBuffer( mBufferUniformPalette );
+	}
+
+	// the vertex shader pulls the instances out of it itself
+	bufferDesc_t bufferDescInstance = {};
+	bufferDescInstance.mBufferUsage = static_cast<VkBufferUsageFlagBits>( VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT );
+	bufferDescInstance.mMemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+	bufferDescInstance.mData = nullptr;
+	bufferDescInstance.mDataSizeBytes = bufferSizeInstance;
+	mBufferInstance = new Buffer( mContext );
+	mBufferInstance->AllocBuffer( bufferDescInstance );
 }
 
 /*
@@ -292,17 +368,19 @@ Renderer::DestroyBuffers
 ========================
 */
 void Renderer::DestroyBuffers() {
-	mBufferUniformQuad->UnallocBuffer();
-	YETI_FREE( mBufferUniformQuad );
+	mBufferInstance->UnallocBuffer();
+	YETI_FREE( mBufferInstance );
 
-	mBufferUniformStatic->UnallocBuffer();
-	YETI_FREE( mBufferUniformStatic );
+	if ( mPaletteBufferIndex != BindlessTable::INVALID_INDEX ) {
+		mContext->GetBindlessTable()->RemoveBuffer( mPaletteBufferIndex );
+		mPaletteBufferIndex = BindlessTable::INVALID_INDEX;
+	}
 
-	mBufferIndex->UnallocBuffer();
-	YETI_FREE( mBufferIndex );
+	mBufferUniformPalette->UnallocBuffer();
+	YETI_FREE( mBufferUniformPalette );
 
-	mBufferVertex->UnallocBuffer();
-	YETI_FREE( mBufferVertex );
+	mBufferUniformStatic->UnallocBuffer();
+	YETI_FREE( mBufferUniformStatic );
 }
 
 /*
@@ -311,14 +389,16 @@ Renderer::CreateShaders
 ========================
 */
 void Renderer::CreateShaders() {
+	bool32 bindless = mContext->UsesBindless();
+
 	shaderDesc_t shaderDesc = {};
 	shaderDesc.mShaderStage = VK_SHADER_STAGE_VERTEX_BIT;
-	shaderDesc.mFilename = BASE_PATH "shader_binaries/unlit_3d.vert.spv";
+	shaderDesc.mFilename = bindless ? BASE_PATH "shader_binaries/unlit_bindless.vert.spv" : BASE_PATH "shader_binaries/unlit_3d.vert.spv";
 	mShaderVertex = new Shader( mContext );
 	mShaderVertex->AllocShader( shaderDesc );
 
 	shaderDesc.mShaderStage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	shaderDesc.mFilename = BASE_PATH "shader_binaries/unlit_3d.frag.spv";
+	shaderDesc.mFilename = bindless ? BASE_PATH "shader_binaries/unlit_bindless.frag.spv" : BASE_PATH "shader_binaries/unlit_3d.frag.spv";
 	mShaderFragment = new Shader( mContext );
 	mShaderFragment->AllocShader( shaderDesc );
 }
@@ -342,44 +422,34 @@ Renderer::CreateRenderState
 ========================
 */
 void Renderer::CreateRenderState() {
-	VkVertexInputBindingDescription vertexBinding = {};
-	vertexBinding.binding = 0;
-	vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-	vertexBinding.stride = sizeof( glm::vec3 );
-
-	array<VkVertexInputAttributeDescription> vertexAttribs = {
-		{ 0, vertexBinding.binding, VK_FORMAT_R32G32B32_SFLOAT, offsetof( vertex_t, mPos ) },
-	};
-
-	array<VkDescriptorSetLayoutBinding> uniformBindings = {
-		{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
-		{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
-	};
-
-	array<Buffer*> uniformBuffers = {
-		mBufferUniformStatic,
-		mBufferUniformQuad,
-	};
-
-	array<VkDescriptorPoolSize> poolSizes = {
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
-	};
-
-	VkDescriptorPoolCreateInfo descPoolInfo = {};
-	descPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descPoolInfo.maxSets = 1;
-	descPoolInfo.poolSizeCount = static_cast<u32>( poolSizes.length() );
-	descPoolInfo.pPoolSizes = poolSizes.data();
-	YETI_VK_CHECK( vkCreateDescriptorPool( mContext->GetLogicalDevice(), &descPoolInfo, nullptr, &mDescriptorPool ) );
+	// no vertex inputs at all, the vertex shader makes the corners and reads the instances out of binding 2
+	array<VkDescriptorSetLayoutBinding> uniformBindings;
+	array<Buffer*> uniformBuffers;
+
+	uniformBindings.add( { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr } );
+	uniformBuffers.add( mBufferUniformStatic );
+
+	// which of the table's buffers is the palette
+	VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( u32 ) };
+
+	bool32 bindless = mContext->UsesBindless();
+
+	// the palette comes out of the bindless table instead
+	if ( !bindless ) {
+		uniformBindings.add( { 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr } );
+		uniformBuffers.add( mBufferUniformPalette );
+	}
+
+	uniformBindings.add( { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr } );
+	uniformBuffers.add( mBufferInstance );
 
 	uniformLayoutDesc_t uniformLayoutDesc = {};
-	uniformLayoutDesc.mDescriptorPool = mDescriptorPool;
 	uniformLayoutDesc.mBindings = uniformBindings.data();
 	uniformLayoutDesc.mNumBindings = static_cast<u32>( uniformBindings.length() );
 	uniformLayoutDesc.mUniformBuffers = uniformBuffers;
-	uniformLayoutDesc.mPushConstants = nullptr;
-	uniformLayoutDesc.mNumPushConstants = 0;
+	uniformLayoutDesc.mPushConstants = bindless ? &pushConstantRange : nullptr;
+	uniformLayoutDesc.mNumPushConstants = bindless ? 1 : 0;
+	uniformLayoutDesc.mBindless = bindless;
 	mUniformLayout = new UniformLayout( mContext );
 	mUniformLayout->AllocUniformLayout( uniformLayoutDesc );
 
@@ -395,14 +465,14 @@ void Renderer::CreateRenderState() {
 	renderStateQuad.mPolygonMode = VK_POLYGON_MODE_FILL;
 	renderStateQuad.mTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 	renderStateQuad.mUniformLayout = mUniformLayout;
-	renderStateQuad.mVertexAttribs = vertexAttribs.data();
-	renderStateQuad.mNumVertexAttribs = static_cast<u32>( vertexAttribs.length() );
-	renderStateQuad.mVertexBindings = &vertexBinding;
-	renderStateQuad.mNumVertexBindings = 1;
+	renderStateQuad.mVertexAttribs = nullptr;
+	renderStateQuad.mNumVertexAttribs = 0;
+	renderStateQuad.mVertexBindings = nullptr;
+	renderStateQuad.mNumVertexBindings = 0;
 	renderStateQuad.mVertexShader = mShaderVertex;
 	renderStateQuad.mFragmentShader = mShaderFragment;
 	mRenderState = new RenderState( mContext );
-	mRenderState->AllocRenderState( renderStateQuad );
+	mRenderState->AllocRenderState( renderStateQuad, YETI_RENDER_STATE_CREATE_BACKGROUND );
 }
 
 /*
@@ -416,4 +486,120 @@ void Renderer::DestroyRenderState() {
 
 	mRenderState->UnallocRenderState();
 	YETI_FREE( mRenderState );
+}
+
+/*
+========================
+Renderer::UploadDirtyQuads
+========================
+*/
+void Renderer::UploadDirtyQuads( const renderGraphHandle_t instances ) {
+	mUploadStats = {};
+	mNumUploadCopies = 0;
+
+	if ( !mQuads.IsDirty() ) {
+		return;
+	}
+
+	quadRange_t ranges[MAX_UPLOAD_RANGES];
+	u32 numRanges = mQuads.BuildDirtyRanges( ranges, MAX_UPLOAD_RANGES );
+
+	u32 numQuads = 0;
+
+	for ( u32 i = 0; i < numRanges; i++ ) {
+		numQuads += ranges[i].mCount;
+	}
+
+	size_t sizeBytes = numQuads * sizeof( quadInstance_t );
+
+	frameAllocation_t allocation = mContext->GetFrameAllocator()->Alloc( sizeBytes, YETI_DEFAULT_BYTE_ALIGNMENT );
+
+	// the ranges have already been taken off the dirty list, so send everything next frame instead
+	if ( allocation.mData == nullptr ) {
+		mQuads.MarkAllDirty();
+		return;
+	}
+
+	VkDeviceSize rangeOffset = 0;
+
+	for ( u32 i = 0; i < numRanges; i++ ) {
+		VkDeviceSize rangeSizeBytes = ranges[i].mCount * sizeof( quadInstance_t );
+
+		memcpy( allocation.mData + rangeOffset, mQuads.GetInstances() + ranges[i].mFirst, rangeSizeBytes );
+
+		mUploadCopies[i].srcOffset = allocation.mOffset + rangeOffset;
+		mUploadCopies[i].dstOffset = ranges[i].mFirst * sizeof( quadInstance_t );
+		mUploadCopies[i].size = rangeSizeBytes;
+
+		rangeOffset += rangeSizeBytes;
+	}
+
+	mNumUploadCopies = numRanges;
+	mUploadSource = allocation.mBuffer;
+
+	mUploadStats.mNumQuads = numQuads;
+	mUploadStats.mNumRanges = numRanges;
+	mUploadStats.mSizeBytes = sizeBytes;
+
+	// the graph makes it wait for the last frame's draws and makes the copies visible to this one's
+	RenderGraph* graph = mContext->GetRenderGraph();
+	u32 pass = graph->AddPass( "UploadQuads", RecordUploadPass, this );
+	graph->Write( pass, instances, YETI_RENDER_GRAPH_ACCESS_TRANSFER_DST );
+}
+
+/*
+========================
+Renderer::RecordUploadPass
+========================
+*/
+void Renderer::RecordUploadPass( VkCommandBuffer commandBuffer, void* data ) {
+	const Renderer* renderer = reinterpret_cast<const Renderer*>( data );
+
+	vkCmdCopyBuffer( commandBuffer, renderer->mUploadSource, renderer->mBufferInstance->GetAPIHandle(), renderer->mNumUploadCopies, renderer->mUploadCopies );
+}
+
+/*
+========================
+Renderer::RecordQuadsJob
+========================
+*/
+void Renderer::RecordQuadsJob( void* data, const u32 start, const u32 end, const u32 workerIndex ) {
+	const quadRecordJob_t* job = reinterpret_cast<const quadRecordJob_t*>( data );
+	const Renderer* renderer = job->mRenderer;
+
+	// ParallelFor() splits on multiples of the granularity, so this is the slice index
+	u32 slot = job->mFirstSlot + start / job->mQuadsPerSlice;
+
+	CommandRecorder* recorder = renderer->mContext->GetCommandRecorder();
+	VkCommandBuffer commandBuffer = recorder->BeginSlot( slot, workerIndex );
+
+	VkPipelineLayout pipelineLayout = renderer->mUniformLayout->GetPipelineLayout();
+
+	VkDescriptorSet descriptorSets[2] = { renderer->mUniformLayout->GetDescriptorSet(), VK_NULL_HANDLE };
+	u32 numDescriptorSets = 1;
+
+	// every texture any quad could pick, in the same bind
+	const BindlessTable* bindlessTable = renderer->mContext->GetBindlessTable();
+	if ( bindlessTable ) {
+		descriptorSets[BindlessTable::BINDLESS_SET] = bindlessTable->GetDescriptorSet();
+		numDescriptorSets = 2;
+	}
+
+	vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, job->mPipeline );
+	vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, numDescriptorSets, descriptorSets, 0, nullptr );
+
+	if ( bindlessTable ) {
+		vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( u32 ), &renderer->mPaletteBufferIndex );
+	}
+
+	// gl_InstanceIndex starts at the first instance, so that's which quad the shader reads first
+	if ( renderer->mDrawPerQuad ) {
+		for ( u32 i = start; i < end; i++ ) {
+			vkCmdDraw( commandBuffer, QUAD_VERTICES, 1, 0, i );
+		}
+	} else {
+		vkCmdDraw( commandBuffer, QUAD_VERTICES, end - start, 0, start );
+	}
+
+	recorder->EndSlot( slot );
 }
\ No newline at end of file
@@ -7,18 +7,24 @@
 
 #include "gl/gl_main.h"
 
-struct vertex_t {
-	glm::vec3							mPos;
+#include "Defines.h"
+#include "QuadScene.h"
+#include "SoftwareRasteriser.h"
+
+// what the last frame had to copy up to the GPU
+struct quadUploadStats_t {
+	u32									mNumQuads;
+	u32									mNumRanges;
+	size_t								mSizeBytes;
 };
 
 struct uniformDataStatic_t {
 	glm::mat4							mViewProjection;
 };
 
-struct uniformDataQuad_t {
-	glm::mat4							mModel;
-	glm::vec4							mColor;
-	glm::vec2							mScale;
+// every color a quad can be, quads only carry an index into this
+struct uniformDataPalette_t {
+	glm::vec4							mColors[RENDERER_PALETTE_SIZE];
 };
 
 /*
@@ -26,8 +32,29 @@ struct uniformDataQuad_t {
 
 	Breakout Renderer
 
-	Built to render quads only. Contains all the mesh data for a quad due there only being a
-	need for one quad mesh. Also responsible for initialising camera.
+	Built to render quads only, so there's no mesh at all. The vertex shader makes each quad's
+	six corners out of the vertex index and reads the quad itself out of the instance buffer,
+	which is a storage buffer, so nothing gets bound for the fixed-function vertex fetch.
+	Also responsible for initialising camera.
+
+	Quads are retained. Each one owns a slot in a device local instance buffer and stays there
+	until it's changed, and every frame only the slots that did change get copied up out of the
+	frame allocator, in a render graph pass that the swap chain pass reads the instances after.
+	They get drawn with one instanced, non-indexed draw call per slice of at least
+	RENDERER_QUADS_PER_SLICE quads, each slice recorded into its own secondary command buffer on
+	the job system. There are never more than MAX_QUAD_SLICES slices, past that they just get
+	bigger, so however many quads there are they fit in the CommandRecorder's slots.
+
+	How many quads there's room for is decided in Init(), from however many blocks the level
+	has. Quads past that are dropped.
+
+	With the bindless table every quad can have its own texture out of it, picked by an index
+	in the instance, so they're still one draw per slice and one descriptor bind. The palette
+	is read through the table too. Without it textures are ignored and quads are flat colors.
+
+	In software mode there's no VulkanContext at all, GetContext() is null, and the quads and
+	the UI get drawn by a SoftwareRasteriser instead. EndFrame() copies the result into the
+	window if there is one.
 
 ================================================================================================
 */
@@ -37,35 +64,94 @@ public:
 	// corrects vulkan's upside-down clip space
 	static const glm::mat4				CLIP_MATRIX;
 
+	// the most Init() will make room for, maxStorageBufferRange is only guaranteed to be 2^27 bytes
+	static const u32					MAX_QUADS = ( 1u << 27 ) / sizeof( quadInstance_t );
+
+	// enough for endless mode, which has the most blocks of anything built in
+	static const u32					DEFAULT_MAX_QUADS = NUM_ENDLESS_BLOCKS_MAX + 2 + NUM_BALLS_MAX;
+
+	// most recorder slots the quads take up in a frame, not counting the profiler scope's
+	static const u32					MAX_QUAD_SLICES = 32;
+
+	// most copy regions one frame's upload gets split into
+	static const u32					MAX_UPLOAD_RANGES = 64;
+
+	// two triangles, MUST match the corners in unlit_3d.vert and unlit_bindless.vert
+	static const u32					QUAD_VERTICES = 6;
+
 public:
 										Renderer();
 	virtual								~Renderer();
 
-	void								Init();
+	// without the pipeline cache every pipeline gets compiled from scratch, which is only useful for comparing startup times
+	// turning dynamic rendering off forces the render pass path even on drivers that support it
+	// bindless is opt in and falls back to flat colored quads if the driver doesn't support it
+	// headless draws offscreen without a window, frames only come back out through the context's FrameReadback
+	// software doesn't use Vulkan at all, the other flags are ignored
+	// maxQuads is clamped to MAX_QUADS, see CalcNumQuads()
+	void								Init( const bool32 usePipelineCache = true, const bool32 useDynamicRendering = true, const bool32 useBindless = false, const bool32 headless = false, const bool32 software = false, const u32 maxQuads = DEFAULT_MAX_QUADS );
 	void								Shutdown();
 	inline bool32						IsInitialised() const { return mInitialised; }
 
 	inline VulkanContext*				GetContext() { return mContext; }
 	inline const VulkanContext*			GetContext() const { return mContext; }
 
+	// null unless the renderer is in software mode
+	inline SoftwareRasteriser*			GetRasteriser() { return mRasteriser; }
+	inline const SoftwareRasteriser*	GetRasteriser() const { return mRasteriser; }
+
 	inline glm::mat4					GetWorldToClip() const { return mMatrixProjection * mMatrixView; }
 	inline glm::mat4					GetClipToWorld() const { return glm::inverse( GetWorldToClip() ); }
 
 	void								Resize( const u32 width, const u32 height );
 
-	void								AddRenderJob( const uniformDataQuad_t& jobData );
+	// quads keep whatever they were last set to until they're set again
+	// textureIndex is a slot in the context's BindlessTable, 0 being plain white
+	inline void							SetQuad( const u32 index, const glm::vec2& position, const glm::vec2& halfSize, const u32 colorIndex, const u32 textureIndex = 0 ) {
+											mQuads.Set( index, position, halfSize, colorIndex, textureIndex ); }
+	inline void							HideQuad( const u32 index ) { mQuads.Hide( index ); }
+
+	// waits for the GPU to go idle so only call it when loading, colors past RENDERER_PALETTE_SIZE get dropped
+	void								SetPalette( const glm::vec4* colors, const u32 numColors );
+
+	// only quads [0, numQuads) get drawn
+	inline void							SetNumQuads( const u32 numQuads ) { mQuads.SetNumQuads( numQuads ); }
+	inline u32							GetMaxQuads() const { return mQuads.GetMaxQuads(); }
+
+	// every block, the paddle, the main ball, and all the multi-ball balls
+	static inline u32					CalcNumQuads( const u32 numBlocks ) { return numBlocks + 2 + NUM_BALLS_MAX; }
+
+	// how many quads each draw call gets, and how many draw calls that makes
+	static inline u32					CalcQuadsPerSlice( const u32 numQuads ) { return max( static_cast<u32>( RENDERER_QUADS_PER_SLICE ), ( numQuads + MAX_QUAD_SLICES - 1 ) / MAX_QUAD_SLICES ); }
+	static inline u32					CalcNumQuadSlices( const u32 numQuads ) { u32 quadsPerSlice = CalcQuadsPerSlice( numQuads ); return ( numQuads + quadsPerSlice - 1 ) / quadsPerSlice; }
+
+	inline const quadUploadStats_t&		GetUploadStats() const { return mUploadStats; }
+
+	// one draw per quad instead of one per slice, only useful for measuring what instancing saves
+	inline void							SetDrawPerQuad( const bool32 drawPerQuad ) { mDrawPerQuad = drawPerQuad; }
 
 	void								StartFrame();
 	void								EndFrame();
 	void								DrawElements();
 
 private:
+	// what every slice's recording job needs, everything else is read straight off the renderer
+	struct quadRecordJob_t {
+		Renderer*						mRenderer;
+		VkPipeline						mPipeline;
+		u32								mFirstSlot;
+		u32								mQuadsPerSlice;
+	};
+
 	VulkanContext*						mContext;
+	SoftwareRasteriser*					mRasteriser;
 
-	Buffer*								mBufferVertex;
-	Buffer*								mBufferIndex;
 	Buffer*								mBufferUniformStatic;
-	Buffer*								mBufferUniformQuad;
+	Buffer*								mBufferUniformPalette;
+	Buffer*								mBufferInstance;
+
+	// the palette's slot in the bindless table, if there is one
+	u32									mPaletteBufferIndex;
 
 	Shader*								mShaderVertex;
 	Shader*								mShaderFragment;
@@ -73,23 +159,26 @@ private:
 	RenderState*						mRenderState;
 	UniformLayout*						mUniformLayout;
 
-	array<uniformDataQuad_t>			mJobs;
+	QuadScene							mQuads;
+	quadUploadStats_t					mUploadStats;
 	uniformDataStatic_t					mUniformDataStatic;
+	uniformDataPalette_t				mUniformDataPalette;
 
-	array<vertex_t>						mVertices;
-	array<u32>							mIndices;
+	// this frame's upload, recorded when the render graph gets to it
+	VkBufferCopy						mUploadCopies[MAX_UPLOAD_RANGES];
+	u32									mNumUploadCopies;
+	VkBuffer							mUploadSource;
 
 	glm::mat4							mMatrixView, mMatrixProjection;
 
-	VkDescriptorPool					mDescriptorPool;
-
-	size_t								mDynamicAlignment;
-
 	float32								mAspectRatio;
 
+	bool32								mDrawPerQuad;
 	bool32								mInitialised;
 
 private:
+	void								InitCamera();
+
 	void								CreateBuffers();
 	void								DestroyBuffers();
 
@@ -98,6 +187,14 @@ private:
 
 	void								CreateRenderState();
 	void								DestroyRenderState();
+
+	void								UploadDirtyQuads( const renderGraphHandle_t instances );
+
+	// data is the renderer
+	static void							RecordUploadPass( VkCommandBuffer commandBuffer, void* data );
+
+	// [start, end) are quads
+	static void							RecordQuadsJob( void* data, const u32 start, const u32 end, const u32 workerIndex );
 };
 
 extern Renderer* gRenderer;
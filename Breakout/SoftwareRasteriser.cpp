@@ -0,0 +1,745 @@
+#include <emmintrin.h>
+
+#include <imgui/imgui.h>
+
+#include "SoftwareRasteriser.h"
+
+#include "JobSystem.h"
+
+/*
+================================================================================================
+
+	SoftwareRasteriser
+
+================================================================================================
+*/
+
+static const u32 TGA_HEADER_SIZE = 18;
+
+/*
+========================
+PackColor
+========================
+*/
+static inline u32 PackColor( const glm::vec4& color ) {
+	glm::vec4 scaled = glm::clamp( color, 0.0f, 1.0f ) * 255.0f + 0.5f;
+
+	return ( static_cast<u32>( scaled.a ) << 24 ) | ( static_cast<u32>( scaled.r ) << 16 ) | ( static_cast<u32>( scaled.g ) << 8 ) | static_cast<u32>( scaled.b );
+}
+
+/*
+========================
+UnpackColor
+========================
+*/
+static inline glm::vec4 UnpackColor( const u32 color ) {
+	return glm::vec4(
+		static_cast<float32>( ( color >> 16 ) & 0xFF ),
+		static_cast<float32>( ( color >> 8 ) & 0xFF ),
+		static_cast<float32>( color & 0xFF ),
+		static_cast<float32>( color >> 24 )
+	) / 255.0f;
+}
+
+/*
+========================
+UnpackImGuiColor
+========================
+*/
+static inline glm::vec4 UnpackImGuiColor( const ImU32 color ) {
+	return glm::vec4(
+		static_cast<float32>( ( color >> IM_COL32_R_SHIFT ) & 0xFF ),
+		static_cast<float32>( ( color >> IM_COL32_G_SHIFT ) & 0xFF ),
+		static_cast<float32>( ( color >> IM_COL32_B_SHIFT ) & 0xFF ),
+		static_cast<float32>( ( color >> IM_COL32_A_SHIFT ) & 0xFF )
+	) / 255.0f;
+}
+
+/*
+========================
+FillSpan
+========================
+*/
+static void FillSpan( u32* pixels, const s32 count, const u32 color ) {
+	__m128i color4 = _mm_set1_epi32( static_cast<s32>( color ) );
+
+	s32 i = 0;
+
+	for ( ; i + 4 <= count; i += 4 ) {
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( pixels + i ), color4 );
+	}
+
+	for ( ; i < count; i++ ) {
+		pixels[i] = color;
+	}
+}
+
+/*
+========================
+BlendLanes
+========================
+*/
+static inline __m128i BlendLanes( const __m128i dst, const __m128i src, const __m128i invAlpha ) {
+	// src is already multiplied by its factor and scaled up by 255, so this is ( src + dst * ( 255 - alpha ) ) / 255 rounded
+	__m128i x = _mm_add_epi16( _mm_add_epi16( src, _mm_mullo_epi16( dst, invAlpha ) ), _mm_set1_epi16( 128 ) );
+
+	return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+/*
+========================
+BlendSpan
+========================
+*/
+static void BlendSpan( u32* pixels, const s32 count, const u32 color ) {
+	// the same as RenderStateManager's blend: SRC_ALPHA and ONE for the source, ONE_MINUS_SRC_ALPHA for the destination
+	u32 alpha = color >> 24;
+	u32 invAlpha = 255 - alpha;
+
+	u32 src[4] = {
+		( color & 0xFF ) * alpha,
+		( ( color >> 8 ) & 0xFF ) * alpha,
+		( ( color >> 16 ) & 0xFF ) * alpha,
+		alpha * 255,
+	};
+
+	// two pixels of b, g, r, a per register, highest lane first
+	__m128i src8 = _mm_set_epi16(
+		static_cast<s16>( src[3] ), static_cast<s16>( src[2] ), static_cast<s16>( src[1] ), static_cast<s16>( src[0] ),
+		static_cast<s16>( src[3] ), static_cast<s16>( src[2] ), static_cast<s16>( src[1] ), static_cast<s16>( src[0] )
+	);
+	__m128i invAlpha8 = _mm_set1_epi16( static_cast<s16>( invAlpha ) );
+	__m128i zero = _mm_setzero_si128();
+
+	s32 i = 0;
+
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128i* dst = reinterpret_cast<__m128i*>( pixels + i );
+		__m128i dst4 = _mm_loadu_si128( dst );
+
+		__m128i lo = BlendLanes( _mm_unpacklo_epi8( dst4, zero ), src8, invAlpha8 );
+		__m128i hi = BlendLanes( _mm_unpackhi_epi8( dst4, zero ), src8, invAlpha8 );
+
+		_mm_storeu_si128( dst, _mm_packus_epi16( lo, hi ) );
+	}
+
+	// the same sums one pixel at a time, so a quad's edge comes out the same as its middle
+	for ( ; i < count; i++ ) {
+		u32 result = 0;
+
+		for ( u32 channel = 0; channel < 4; channel++ ) {
+			u32 shift = channel * 8;
+			u32 x = src[channel] + ( ( pixels[i] >> shift ) & 0xFF ) * invAlpha + 128;
+
+			result |= ( ( x + ( x >> 8 ) ) >> 8 ) << shift;
+		}
+
+		pixels[i] = result;
+	}
+}
+
+/*
+========================
+FetchTexel
+========================
+*/
+static inline glm::vec4 FetchTexel( const u8* pixels, const u32 width, const u32 height, const s32 x, const s32 y ) {
+	s32 clampedX = glm::clamp( x, 0, static_cast<s32>( width ) - 1 );
+	s32 clampedY = glm::clamp( y, 0, static_cast<s32>( height ) - 1 );
+
+	const u8* texel = pixels + ( clampedY * width + clampedX ) * 4;
+
+	return glm::vec4(
+		static_cast<float32>( texel[0] ),
+		static_cast<float32>( texel[1] ),
+		static_cast<float32>( texel[2] ),
+		static_cast<float32>( texel[3] )
+	) / 255.0f;
+}
+
+/*
+========================
+SoftwareRasteriser::SoftwareRasteriser
+========================
+*/
+SoftwareRasteriser::SoftwareRasteriser() {
+	mJobSystem = nullptr;
+
+	mPixels = nullptr;
+	mWidth = mHeight = 0;
+	mNumTilesX = mNumTilesY = 0;
+
+	mClearColor = 0;
+
+	mFontWidth = mFontHeight = 0;
+
+	mStats = {};
+
+	mInitialised = false;
+}
+
+/*
+========================
+SoftwareRasteriser::~SoftwareRasteriser
+========================
+*/
+SoftwareRasteriser::~SoftwareRasteriser() {
+	Shutdown();
+}
+
+/*
+========================
+SoftwareRasteriser::Init
+========================
+*/
+void SoftwareRasteriser::Init( const u32 width, const u32 height, JobSystem* jobSystem ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call SoftwareRasteriser::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( jobSystem != nullptr ), "SoftwareRasteriser needs a job system to draw the tiles on!\n" );
+
+	mJobSystem = jobSystem;
+
+	// one white texel until the UI hands over its font, so textured triangles still come out their vertex color
+	const u8 white[4] = { 255, 255, 255, 255 };
+	SetFontTexture( white, 1, 1 );
+
+	mInitialised = true;
+
+	Resize( width, height );
+}
+
+/*
+========================
+SoftwareRasteriser::Shutdown
+========================
+*/
+void SoftwareRasteriser::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	delete[] mPixels;
+	mPixels = nullptr;
+	mWidth = mHeight = 0;
+	mNumTilesX = mNumTilesY = 0;
+
+	mQuads.clear();
+	mTriangles.clear();
+	mPrimitives.clear();
+
+	mTileOffsets.clear();
+	mTileCursors.clear();
+	mBinEntries.clear();
+
+	mFontPixels.clear();
+	mFontWidth = mFontHeight = 0;
+
+	mJobSystem = nullptr;
+
+	mInitialised = false;
+}
+
+/*
+========================
+SoftwareRasteriser::Resize
+========================
+*/
+void SoftwareRasteriser::Resize( const u32 width, const u32 height ) {
+	assertf( width > 0, "Specified resize width was 0!" );
+	assertf( height > 0, "Specified resize height was 0!" );
+
+	delete[] mPixels;
+
+	mWidth = width;
+	mHeight = height;
+
+	mPixels = new u32[mWidth * mHeight];
+	memset( mPixels, 0, mWidth * mHeight * sizeof( u32 ) );
+
+	mNumTilesX = ( mWidth + TILE_SIZE - 1 ) / TILE_SIZE;
+	mNumTilesY = ( mHeight + TILE_SIZE - 1 ) / TILE_SIZE;
+
+	u32 numTiles = mNumTilesX * mNumTilesY;
+	mTileOffsets.resize( numTiles + 1 );
+	mTileCursors.resize( numTiles );
+}
+
+/*
+========================
+SoftwareRasteriser::SetFontTexture
+========================
+*/
+void SoftwareRasteriser::SetFontTexture( const u8* pixels, const u32 width, const u32 height ) {
+	size_t sizeBytes = static_cast<size_t>( width ) * height * 4;
+
+	mFontPixels.resize( sizeBytes );
+	memcpy( mFontPixels.data(), pixels, sizeBytes );
+
+	mFontWidth = width;
+	mFontHeight = height;
+}
+
+/*
+========================
+SoftwareRasteriser::Begin
+========================
+*/
+void SoftwareRasteriser::Begin( const glm::vec4& clearColor ) {
+	mClearColor = PackColor( clearColor );
+
+	// resize() keeps the memory, so after the first frame nothing here allocates
+	mQuads.resize( 0 );
+	mTriangles.resize( 0 );
+	mPrimitives.resize( 0 );
+
+	mStats = {};
+}
+
+/*
+========================
+SoftwareRasteriser::DrawQuads
+========================
+*/
+void SoftwareRasteriser::DrawQuads( const quadInstance_t* instances, const u32 numQuads, const glm::vec4* palette, const u32 paletteSize, const glm::mat4& worldToClip ) {
+	glm::vec2 halfScreen = glm::vec2( static_cast<float32>( mWidth ), static_cast<float32>( mHeight ) ) * 0.5f;
+	glm::vec2 screenMax = glm::vec2( static_cast<float32>( mWidth ), static_cast<float32>( mHeight ) );
+
+	for ( u32 i = 0; i < numQuads; i++ ) {
+		const quadInstance_t& instance = instances[i];
+
+		// the high 16 bits are a bindless texture, which the quad shader ignores too
+		u32 colorIndex = instance.mMaterial & 0xFFFF;
+
+		if ( colorIndex >= paletteSize || palette[colorIndex].a <= 0.0f ) {
+			continue;
+		}
+
+		glm::vec2 halfSize = glm::unpackHalf2x16( instance.mHalfSize );
+
+		glm::vec4 clip0 = worldToClip * glm::vec4( instance.mPosition - halfSize, 1.0f, 1.0f );
+		glm::vec4 clip1 = worldToClip * glm::vec4( instance.mPosition + halfSize, 1.0f, 1.0f );
+
+		// the viewport transform, the clip matrix has already flipped y so the top row is 0
+		glm::vec2 screen0 = ( glm::vec2( clip0 ) / clip0.w + 1.0f ) * halfScreen;
+		glm::vec2 screen1 = ( glm::vec2( clip1 ) / clip1.w + 1.0f ) * halfScreen;
+
+		// a pixel is covered when its centre is, with the top and left edges in and the bottom and right out
+		glm::vec2 coverMin = glm::clamp( glm::min( screen0, screen1 ) - 0.5f, glm::vec2( 0.0f ), screenMax );
+		glm::vec2 coverMax = glm::clamp( glm::max( screen0, screen1 ) - 0.5f, glm::vec2( 0.0f ), screenMax );
+
+		rasterQuad_t quad = {};
+		quad.mMinX = static_cast<s32>( ceilf( coverMin.x ) );
+		quad.mMinY = static_cast<s32>( ceilf( coverMin.y ) );
+		quad.mMaxX = static_cast<s32>( ceilf( coverMax.x ) );
+		quad.mMaxY = static_cast<s32>( ceilf( coverMax.y ) );
+		quad.mColor = PackColor( palette[colorIndex] );
+
+		// hidden quads have no size so they go here
+		if ( quad.mMinX >= quad.mMaxX || quad.mMinY >= quad.mMaxY ) {
+			continue;
+		}
+
+		AddPrimitive( static_cast<u32>( mQuads.length() ), quad.mMinX, quad.mMinY, quad.mMaxX, quad.mMaxY );
+		mQuads.add( quad );
+	}
+
+	mStats.mNumQuads = static_cast<u32>( mQuads.length() );
+}
+
+/*
+========================
+SoftwareRasteriser::DrawImGui
+========================
+*/
+void SoftwareRasteriser::DrawImGui( const ImDrawData* drawData ) {
+	if ( !drawData || drawData->TotalVtxCount == 0 ) {
+		return;
+	}
+
+	for ( s32 drawListIndex = 0; drawListIndex < drawData->CmdListsCount; drawListIndex++ ) {
+		const ImDrawList* drawList = drawData->CmdLists[drawListIndex];
+
+		const ImDrawVert* vertices = drawList->VtxBuffer.Data;
+		const ImDrawIdx* indices = drawList->IdxBuffer.Data;
+
+		for ( s32 renderJobIndex = 0; renderJobIndex < drawList->CmdBuffer.size(); renderJobIndex++ ) {
+			const ImDrawCmd& renderJob = drawList->CmdBuffer[renderJobIndex];
+			const ImVec4& clipRect = renderJob.ClipRect;
+
+			// the same scissor the Vulkan path sets
+			s32 scissor[4] = {};
+			scissor[0] = static_cast<s32>( clipRect.x );
+			scissor[1] = static_cast<s32>( clipRect.y );
+			scissor[2] = scissor[0] + static_cast<s32>( clipRect.z - clipRect.x );
+			scissor[3] = scissor[1] + static_cast<s32>( clipRect.w - clipRect.y );
+
+			for ( u32 index = 0; index + 2 < renderJob.ElemCount; index += 3 ) {
+				glm::vec2 positions[3];
+				glm::vec2 uvs[3];
+				glm::vec4 colors[3];
+
+				for ( u32 corner = 0; corner < 3; corner++ ) {
+					const ImDrawVert& vertex = vertices[indices[index + corner]];
+
+					// the UI's projection and viewport cancel out, so its positions are already in pixels
+					positions[corner] = glm::vec2( vertex.pos.x, vertex.pos.y );
+					uvs[corner] = glm::vec2( vertex.uv.x, vertex.uv.y );
+					colors[corner] = UnpackImGuiColor( vertex.col );
+				}
+
+				AddTriangle( positions, uvs, colors, scissor );
+			}
+
+			indices += renderJob.ElemCount;
+		}
+	}
+
+	mStats.mNumTriangles = static_cast<u32>( mTriangles.length() );
+}
+
+/*
+========================
+SoftwareRasteriser::End
+========================
+*/
+void SoftwareRasteriser::End() {
+	timestamp_t start = timeNow();
+
+	BinPrimitives();
+
+	timestamp_t binned = timeNow();
+
+	mJobSystem->ParallelFor( mNumTilesX * mNumTilesY, 1, RasteriseTilesJob, this );
+
+	mStats.mNumBinEntries = static_cast<u32>( mBinEntries.length() );
+	mStats.mBinMilliseconds = static_cast<float32>( deltaMilliseconds( start, binned ) );
+	mStats.mRasteriseMilliseconds = static_cast<float32>( deltaMilliseconds( binned, timeNow() ) );
+}
+
+/*
+========================
+SoftwareRasteriser::Dump
+========================
+*/
+bool32 SoftwareRasteriser::Dump( const char* filename ) const {
+	// uncompressed true color, 32 bits with 8 of them alpha, and the first row is the top
+	u8 header[TGA_HEADER_SIZE] = {};
+	header[2] = 2;
+	header[12] = static_cast<u8>( mWidth & 0xFF );
+	header[13] = static_cast<u8>( mWidth >> 8 );
+	header[14] = static_cast<u8>( mHeight & 0xFF );
+	header[15] = static_cast<u8>( mHeight >> 8 );
+	header[16] = 32;
+	header[17] = 0x28;
+
+	// the mstd file functions can't truncate an existing file
+	FILE* file = fopen( filename, "wb" );
+	bool32 result = file && fwrite( header, TGA_HEADER_SIZE, 1, file ) == 1 && fwrite( mPixels, mWidth * mHeight * sizeof( u32 ), 1, file ) == 1;
+
+	if ( file ) {
+		fclose( file );
+	}
+
+	if ( !result ) {
+		error( "Failed to write %s, does the directory exist?\n", filename );
+	}
+
+	return result;
+}
+
+/*
+========================
+SoftwareRasteriser::AddPrimitive
+========================
+*/
+void SoftwareRasteriser::AddPrimitive( const u32 entry, const s32 minX, const s32 minY, const s32 maxX, const s32 maxY ) {
+	rasterPrimitive_t primitive = {};
+	primitive.mEntry = entry;
+	primitive.mMinTileX = static_cast<u16>( minX / TILE_SIZE );
+	primitive.mMinTileY = static_cast<u16>( minY / TILE_SIZE );
+	primitive.mMaxTileX = static_cast<u16>( ( maxX - 1 ) / TILE_SIZE );
+	primitive.mMaxTileY = static_cast<u16>( ( maxY - 1 ) / TILE_SIZE );
+
+	mPrimitives.add( primitive );
+}
+
+/*
+========================
+SoftwareRasteriser::AddTriangle
+========================
+*/
+void SoftwareRasteriser::AddTriangle( const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4* colors, const s32* clipRect ) {
+	float32 area = ( positions[1].x - positions[0].x ) * ( positions[2].y - positions[0].y ) - ( positions[1].y - positions[0].y ) * ( positions[2].x - positions[0].x );
+
+	if ( area == 0.0f ) {
+		return;
+	}
+
+	// the UI doesn't cull, so the other winding just gets turned round
+	u32 order[3] = { 0, 1, 2 };
+
+	if ( area < 0.0f ) {
+		order[1] = 2;
+		order[2] = 1;
+		area = -area;
+	}
+
+	rasterTriangle_t triangle = {};
+
+	for ( u32 corner = 0; corner < 3; corner++ ) {
+		triangle.mPositions[corner] = positions[order[corner]];
+		triangle.mUVs[corner] = uvs[order[corner]];
+		triangle.mColors[corner] = colors[order[corner]];
+	}
+
+	triangle.mInvArea = 1.0f / area;
+
+	// the pixels whose centres could be inside, clamped before the cast so far off positions can't overflow it
+	glm::vec2 screenMax = glm::vec2( static_cast<float32>( mWidth ), static_cast<float32>( mHeight ) );
+	glm::vec2 boundsMin = glm::min( glm::min( positions[0], positions[1] ), positions[2] ) - 0.5f;
+	glm::vec2 boundsMax = glm::max( glm::max( positions[0], positions[1] ), positions[2] ) - 0.5f;
+	boundsMin = glm::clamp( boundsMin, glm::vec2( 0.0f ), screenMax );
+	boundsMax = glm::clamp( boundsMax, glm::vec2( -1.0f ), screenMax );
+
+	triangle.mMinX = max( static_cast<s32>( ceilf( boundsMin.x ) ), max( clipRect[0], 0 ) );
+	triangle.mMinY = max( static_cast<s32>( ceilf( boundsMin.y ) ), max( clipRect[1], 0 ) );
+	triangle.mMaxX = min( static_cast<s32>( floorf( boundsMax.x ) ) + 1, min( clipRect[2], static_cast<s32>( mWidth ) ) );
+	triangle.mMaxY = min( static_cast<s32>( floorf( boundsMax.y ) ) + 1, min( clipRect[3], static_cast<s32>( mHeight ) ) );
+
+	if ( triangle.mMinX >= triangle.mMaxX || triangle.mMinY >= triangle.mMaxY ) {
+		return;
+	}
+
+	AddPrimitive( static_cast<u32>( mTriangles.length() ) | TRIANGLE_BIT, triangle.mMinX, triangle.mMinY, triangle.mMaxX, triangle.mMaxY );
+	mTriangles.add( triangle );
+}
+
+/*
+========================
+SoftwareRasteriser::BinPrimitives
+========================
+*/
+void SoftwareRasteriser::BinPrimitives() {
+	u32 numTiles = mNumTilesX * mNumTilesY;
+
+	// count what lands in each tile first, so every tile's run can be laid out in one array
+	memset( mTileOffsets.data(), 0, ( numTiles + 1 ) * sizeof( u32 ) );
+
+	for ( u32 i = 0; i < mPrimitives.length(); i++ ) {
+		const rasterPrimitive_t& primitive = mPrimitives[i];
+
+		for ( u32 tileY = primitive.mMinTileY; tileY <= primitive.mMaxTileY; tileY++ ) {
+			for ( u32 tileX = primitive.mMinTileX; tileX <= primitive.mMaxTileX; tileX++ ) {
+				mTileOffsets[tileY * mNumTilesX + tileX + 1]++;
+			}
+		}
+	}
+
+	for ( u32 i = 0; i < numTiles; i++ ) {
+		mTileOffsets[i + 1] += mTileOffsets[i];
+		mTileCursors[i] = mTileOffsets[i];
+	}
+
+	mBinEntries.resize( mTileOffsets[numTiles] );
+
+	// in the order they were drawn, so a tile blends them in the same order the GPU would
+	for ( u32 i = 0; i < mPrimitives.length(); i++ ) {
+		const rasterPrimitive_t& primitive = mPrimitives[i];
+
+		for ( u32 tileY = primitive.mMinTileY; tileY <= primitive.mMaxTileY; tileY++ ) {
+			for ( u32 tileX = primitive.mMinTileX; tileX <= primitive.mMaxTileX; tileX++ ) {
+				mBinEntries[mTileCursors[tileY * mNumTilesX + tileX]++] = primitive.mEntry;
+			}
+		}
+	}
+}
+
+/*
+========================
+SoftwareRasteriser::RasteriseTile
+========================
+*/
+void SoftwareRasteriser::RasteriseTile( const u32 tileIndex ) {
+	s32 tileMinX = static_cast<s32>( ( tileIndex % mNumTilesX ) * TILE_SIZE );
+	s32 tileMinY = static_cast<s32>( ( tileIndex / mNumTilesX ) * TILE_SIZE );
+	s32 tileMaxX = min( tileMinX + static_cast<s32>( TILE_SIZE ), static_cast<s32>( mWidth ) );
+	s32 tileMaxY = min( tileMinY + static_cast<s32>( TILE_SIZE ), static_cast<s32>( mHeight ) );
+
+	for ( s32 y = tileMinY; y < tileMaxY; y++ ) {
+		FillSpan( mPixels + y * mWidth + tileMinX, tileMaxX - tileMinX, mClearColor );
+	}
+
+	for ( u32 i = mTileOffsets[tileIndex]; i < mTileOffsets[tileIndex + 1]; i++ ) {
+		u32 entry = mBinEntries[i];
+
+		if ( entry & TRIANGLE_BIT ) {
+			RasteriseTriangle( mTriangles[entry & ~TRIANGLE_BIT], tileMinX, tileMinY, tileMaxX, tileMaxY );
+		} else {
+			RasteriseQuad( mQuads[entry], tileMinX, tileMinY, tileMaxX, tileMaxY );
+		}
+	}
+}
+
+/*
+========================
+SoftwareRasteriser::RasteriseQuad
+========================
+*/
+void SoftwareRasteriser::RasteriseQuad( const rasterQuad_t& quad, const s32 tileMinX, const s32 tileMinY, const s32 tileMaxX, const s32 tileMaxY ) {
+	s32 minX = max( quad.mMinX, tileMinX );
+	s32 minY = max( quad.mMinY, tileMinY );
+	s32 maxX = min( quad.mMaxX, tileMaxX );
+	s32 maxY = min( quad.mMaxY, tileMaxY );
+
+	bool32 opaque = ( quad.mColor >> 24 ) == 255;
+
+	for ( s32 y = minY; y < maxY; y++ ) {
+		u32* row = mPixels + y * mWidth + minX;
+
+		if ( opaque ) {
+			FillSpan( row, maxX - minX, quad.mColor );
+		} else {
+			BlendSpan( row, maxX - minX, quad.mColor );
+		}
+	}
+}
+
+/*
+========================
+SoftwareRasteriser::RasteriseTriangle
+========================
+*/
+void SoftwareRasteriser::RasteriseTriangle( const rasterTriangle_t& triangle, const s32 tileMinX, const s32 tileMinY, const s32 tileMaxX, const s32 tileMaxY ) {
+	s32 minX = max( triangle.mMinX, tileMinX );
+	s32 minY = max( triangle.mMinY, tileMinY );
+	s32 maxX = min( triangle.mMaxX, tileMaxX );
+	s32 maxY = min( triangle.mMaxY, tileMaxY );
+
+	if ( minX >= maxX || minY >= maxY ) {
+		return;
+	}
+
+	// edge i is the one opposite corner i, so its value over the area is that corner's weight
+	// each one is a * x + b * y + c, and positive inside
+	__m128 edgeA[3];
+	float32 edgeB[3], edgeC[3];
+	bool32 edgeTopLeft[3];
+
+	for ( u32 i = 0; i < 3; i++ ) {
+		const glm::vec2& from = triangle.mPositions[( i + 1 ) % 3];
+		const glm::vec2& to = triangle.mPositions[( i + 2 ) % 3];
+
+		float32 dx = to.x - from.x;
+		float32 dy = to.y - from.y;
+
+		edgeA[i] = _mm_set1_ps( -dy );
+		edgeB[i] = dx;
+		edgeC[i] = dy * from.x - dx * from.y;
+
+		// a centre exactly on a top or left edge is inside, on any other edge it's outside, so shared edges only get drawn once
+		edgeTopLeft[i] = ( dy < 0.0f ) || ( dy == 0.0f && dx > 0.0f );
+	}
+
+	const __m128 laneCentres = _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f );
+	const __m128 zero = _mm_setzero_ps();
+
+	for ( s32 y = minY; y < maxY; y++ ) {
+		u32* row = mPixels + y * mWidth;
+		float32 centreY = static_cast<float32>( y ) + 0.5f;
+
+		__m128 edgeRow[3];
+		for ( u32 i = 0; i < 3; i++ ) {
+			edgeRow[i] = _mm_set1_ps( edgeB[i] * centreY + edgeC[i] );
+		}
+
+		// four pixel centres at a time, and only the ones inside every edge get shaded
+		for ( s32 x = minX; x < maxX; x += 4 ) {
+			__m128 centreX = _mm_add_ps( _mm_set1_ps( static_cast<float32>( x ) ), laneCentres );
+
+			s32 mask = ( maxX - x < 4 ) ? ( 1 << ( maxX - x ) ) - 1 : 0xF;
+
+			alignas( 16 ) float32 edges[3][4];
+
+			for ( u32 i = 0; i < 3; i++ ) {
+				__m128 edge = _mm_add_ps( _mm_mul_ps( edgeA[i], centreX ), edgeRow[i] );
+				__m128 inside = edgeTopLeft[i] ? _mm_cmpge_ps( edge, zero ) : _mm_cmpgt_ps( edge, zero );
+
+				mask &= _mm_movemask_ps( inside );
+
+				_mm_store_ps( edges[i], edge );
+			}
+
+			for ( s32 lane = 0; mask != 0; lane++, mask >>= 1 ) {
+				if ( ( mask & 1 ) == 0 ) {
+					continue;
+				}
+
+				float32 weight0 = edges[0][lane] * triangle.mInvArea;
+				float32 weight1 = edges[1][lane] * triangle.mInvArea;
+				float32 weight2 = edges[2][lane] * triangle.mInvArea;
+
+				glm::vec2 uv = triangle.mUVs[0] * weight0 + triangle.mUVs[1] * weight1 + triangle.mUVs[2] * weight2;
+				glm::vec4 color = triangle.mColors[0] * weight0 + triangle.mColors[1] * weight1 + triangle.mColors[2] * weight2;
+
+				// the same as ui.frag
+				glm::vec4 src = SampleFont( uv ) * color;
+
+				if ( src.a <= 0.0f ) {
+					continue;
+				}
+
+				u32& pixel = row[x + lane];
+				glm::vec4 dst = UnpackColor( pixel );
+
+				float32 invAlpha = 1.0f - src.a;
+				pixel = PackColor( glm::vec4( glm::vec3( src ) * src.a + glm::vec3( dst ) * invAlpha, src.a + dst.a * invAlpha ) );
+			}
+		}
+	}
+}
+
+/*
+========================
+SoftwareRasteriser::SampleFont
+========================
+*/
+glm::vec4 SoftwareRasteriser::SampleFont( const glm::vec2& uv ) const {
+	const u8* pixels = mFontPixels.data();
+
+	// texel centres are on the halves, and the clamp keeps far off coordinates from overflowing the cast
+	float32 x = glm::clamp( uv.x * mFontWidth - 0.5f, -1.0f, static_cast<float32>( mFontWidth ) );
+	float32 y = glm::clamp( uv.y * mFontHeight - 0.5f, -1.0f, static_cast<float32>( mFontHeight ) );
+
+	float32 floorX = floorf( x );
+	float32 floorY = floorf( y );
+
+	s32 x0 = static_cast<s32>( floorX );
+	s32 y0 = static_cast<s32>( floorY );
+
+	float32 fracX = x - floorX;
+	float32 fracY = y - floorY;
+
+	glm::vec4 top = glm::mix( FetchTexel( pixels, mFontWidth, mFontHeight, x0, y0 ), FetchTexel( pixels, mFontWidth, mFontHeight, x0 + 1, y0 ), fracX );
+	glm::vec4 bottom = glm::mix( FetchTexel( pixels, mFontWidth, mFontHeight, x0, y0 + 1 ), FetchTexel( pixels, mFontWidth, mFontHeight, x0 + 1, y0 + 1 ), fracX );
+
+	return glm::mix( top, bottom, fracY );
+}
+
+/*
+========================
+SoftwareRasteriser::RasteriseTilesJob
+========================
+*/
+void SoftwareRasteriser::RasteriseTilesJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	SoftwareRasteriser* rasteriser = reinterpret_cast<SoftwareRasteriser*>( data );
+
+	// every tile only writes its own pixels, so nothing here needs locking
+	for ( u32 tileIndex = start; tileIndex < end; tileIndex++ ) {
+		rasteriser->RasteriseTile( tileIndex );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#ifndef __SOFTWARE_RASTERISER_H__
+#define __SOFTWARE_RASTERISER_H__
+
+#include <mstd/mstd.h>
+
+#pragma warning( disable : 4201 )
+#include <glm/glm.hpp>
+#pragma warning( default : 4201 )
+
+#include "QuadScene.h"
+
+struct ImDrawData;
+class JobSystem;
+
+// what the last frame drew and how long it took
+struct rasteriserStats_t {
+	u32									mNumQuads;
+	u32									mNumTriangles;
+	u32									mNumBinEntries;		// primitives times the tiles they touch
+	float32								mBinMilliseconds;
+	float32								mRasteriseMilliseconds;
+};
+
+/*
+================================================================================================
+
+	Breakout Software Rasteriser
+
+	Draws what the renderer and the UI would send to Vulkan on the CPU instead, for machines
+	without a driver and as a reference to check the GPU against. The quads are always axis
+	aligned and flat colored, and ImGui only ever sends textured triangles, so that's all it
+	does.
+
+	Nothing gets drawn until End(). Every primitive is binned into the TILE_SIZE tiles its
+	bounds touch, in the order it was drawn in, and then each tile is drawn start to finish
+	by one job on the job system so no two threads ever write the same pixel. Quad spans get
+	filled and blended four pixels at a time with SSE2, and triangles test four pixels at a
+	time against their edges.
+
+	It follows Vulkan's rules wherever the GPU path relies on them: pixel centres, the
+	top-left fill rule, and the same blend as RenderStateManager. The framebuffer is packed
+	0xAARRGGBB, which is B8G8R8A8 in memory like the headless context's back buffer, so it
+	can go straight into the same golden images.
+
+	Doesn't touch Vulkan at all.
+
+================================================================================================
+*/
+
+class SoftwareRasteriser {
+public:
+	static const u32					TILE_SIZE = 64;
+
+public:
+										SoftwareRasteriser();
+										~SoftwareRasteriser();
+
+	void								Init( const u32 width, const u32 height, JobSystem* jobSystem );
+	void								Shutdown();
+	inline bool32						IsInitialised() const { return mInitialised; }
+
+	// MUST NOT be called between Begin() and End()
+	void								Resize( const u32 width, const u32 height );
+
+	// pixels are R8G8B8A8 and get copied, so they can be freed straight after
+	void								SetFontTexture( const u8* pixels, const u32 width, const u32 height );
+
+	void								Begin( const glm::vec4& clearColor );
+
+	// the same as the quad shader, worldToClip includes the clip space correction
+	void								DrawQuads( const quadInstance_t* instances, const u32 numQuads, const glm::vec4* palette, const u32 paletteSize, const glm::mat4& worldToClip );
+	void								DrawImGui( const ImDrawData* drawData );
+
+	// blocks until every tile is drawn
+	void								End();
+
+	inline const u32*					GetPixels() const { return mPixels; }
+	inline u32							GetWidth() const { return mWidth; }
+	inline u32							GetHeight() const { return mHeight; }
+
+	inline const rasteriserStats_t&		GetStats() const { return mStats; }
+
+	// writes the framebuffer out as an uncompressed TGA, only valid after End()
+	bool32								Dump( const char* filename ) const;
+
+private:
+	// pixels [mMinX, mMaxX) and [mMinY, mMaxY)
+	struct rasterQuad_t {
+		s32								mMinX, mMinY;
+		s32								mMaxX, mMaxY;
+		u32								mColor;
+	};
+
+	// wound so the area is positive, positions are in pixels
+	// the bounds are the pixels it could cover, already clipped to the scissor and the screen
+	struct rasterTriangle_t {
+		glm::vec2						mPositions[3];
+		glm::vec2						mUVs[3];
+		glm::vec4						mColors[3];
+		float32							mInvArea;
+		s32								mMinX, mMinY;
+		s32								mMaxX, mMaxY;
+	};
+
+	// a primitive and the tiles it touches, inclusive
+	struct rasterPrimitive_t {
+		u32								mEntry;				// index into mQuads, or into mTriangles with TRIANGLE_BIT set
+		u16								mMinTileX, mMinTileY;
+		u16								mMaxTileX, mMaxTileY;
+	};
+
+	static const u32					TRIANGLE_BIT = 0x80000000;
+
+	JobSystem*							mJobSystem;
+
+	u32*								mPixels;
+	u32									mWidth, mHeight;
+	u32									mNumTilesX, mNumTilesY;
+
+	u32									mClearColor;
+
+	// filled in between Begin() and End()
+	array<rasterQuad_t>					mQuads;
+	array<rasterTriangle_t>				mTriangles;
+	array<rasterPrimitive_t>			mPrimitives;
+
+	// every tile's entries are [mTileOffsets[i], mTileOffsets[i + 1]) in mBinEntries
+	array<u32>							mTileOffsets;
+	array<u32>							mTileCursors;
+	array<u32>							mBinEntries;
+
+	array<u8>							mFontPixels;
+	u32									mFontWidth, mFontHeight;
+
+	rasteriserStats_t					mStats;
+
+	bool32								mInitialised;
+
+private:
+	void								AddPrimitive( const u32 entry, const s32 minX, const s32 minY, const s32 maxX, const s32 maxY );
+	void								AddTriangle( const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4* colors, const s32* clipRect );
+
+	void								BinPrimitives();
+
+	void								RasteriseTile( const u32 tileIndex );
+	void								RasteriseQuad( const rasterQuad_t& quad, const s32 tileMinX, const s32 tileMinY, const s32 tileMaxX, const s32 tileMaxY );
+	void								RasteriseTriangle( const rasterTriangle_t& triangle, const s32 tileMinX, const s32 tileMinY, const s32 tileMaxX, const s32 tileMaxY );
+
+	// bilinear and clamped to the edge, like the UI's sampler
+	glm::vec4							SampleFont( const glm::vec2& uv ) const;
+
+	// [start, end) are tiles
+	static void							RasteriseTilesJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+#endif // __SOFTWARE_RASTERISER_H__
\ No newline at end of file
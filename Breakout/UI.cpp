@@ -7,6 +7,7 @@
 #include "Renderer.h"
 #include "Window.h"
 #include "Game.h"
+#include "JobSystem.h"
 
 #include "gl/gl_main.h"
 
@@ -27,9 +28,7 @@ UI::UI
 */
 UI::UI() {
 	mContext = nullptr;
-
-	mBufferVertex = nullptr;
-	mBufferIndex = nullptr;
+	mRasteriser = nullptr;
 
 	mShaderVertex = nullptr;
 	mShaderFragment = nullptr;
@@ -37,13 +36,6 @@ UI::UI() {
 	mRenderState = nullptr;
 	mUniformLayout = nullptr;
 
-	mDescriptorPool = VK_NULL_HANDLE;
-
-	mBufferSizeVertex = 0;
-	mBufferSizeIndex = 0;
-
-	mNumVertices = mNumIndices = 0;
-
 	mWidth = mHeight = 0;
 	mWindowCounter = 0;
 
@@ -84,7 +76,7 @@ void UI::Init( const u32 screenWidth, const u32 screenHeight ) {
 	ImGuiIO& io = ImGui::GetIO();
 	io.DisplaySize = ImVec2( static_cast<float32>( screenWidth ), static_cast<float32>( screenHeight ) );
 	io.FontGlobalScale = 1.0f;
-	io.ImeWindowHandle = gWindow->GetHwnd();
+	io.ImeWindowHandle = gWindow ? gWindow->GetHwnd() : nullptr;
 	io.IniFilename = nullptr;	// disable the imgui.ini file
 
 	io.KeyMap[ImGuiKey_Enter] = SDL_SCANCODE_RETURN;
@@ -95,7 +87,16 @@ void UI::Init( const u32 screenWidth, const u32 screenHeight ) {
 	io.Fonts->GetTexDataAsRGBA32( &fontData, &textureWidth, &textureHeight );
 
 	mContext = gRenderer->GetContext();
-	VkDevice device = mContext->GetLogicalDevice();
+	mRasteriser = gRenderer->GetRasteriser();
+
+	if ( mRasteriser ) {
+		mRasteriser->SetFontTexture( fontData, textureWidth, textureHeight );
+
+		mInitialised = true;
+
+		printf( "------- UI initialised -------\n\n" );
+		return;
+	}
 
 	// init shaders
 	shaderDesc_t shaderDesc = {};
@@ -129,22 +130,8 @@ void UI::Init( const u32 screenWidth, const u32 screenHeight ) {
 	mFontTexture->AllocTexture( fontTextureDesc, fontSamplerDesc );
 	mFontTexture->SubImageUpload2D( fontData, 0, 0, 0, textureWidth, textureHeight );
 
-	mBufferVertex = new Buffer( mContext );
-	mBufferIndex = new Buffer( mContext );
-
 	// init uniform resource data
 	{
-		array<VkDescriptorPoolSize> poolSizes = {
-			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 }
-		};
-
-		VkDescriptorPoolCreateInfo descriptorPoolInfo = {};
-		descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		descriptorPoolInfo.maxSets = 1;
-		descriptorPoolInfo.poolSizeCount = static_cast<u32>( poolSizes.length() );
-		descriptorPoolInfo.pPoolSizes = poolSizes.data();
-		YETI_VK_CHECK( vkCreateDescriptorPool( device, &descriptorPoolInfo, nullptr, &mDescriptorPool ) );
-
 		array<VkDescriptorSetLayoutBinding> descSetBindings = {
 			{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr }
 		};
@@ -158,7 +145,6 @@ void UI::Init( const u32 screenWidth, const u32 screenHeight ) {
 		};
 
 		uniformLayoutDesc_t uniformLayoutDesc = {};
-		uniformLayoutDesc.mDescriptorPool = mDescriptorPool;
 		uniformLayoutDesc.mBindings = descSetBindings.data();
 		uniformLayoutDesc.mNumBindings = static_cast<u32>( descSetBindings.length() );
 		uniformLayoutDesc.mTextures = textures;
@@ -196,7 +182,7 @@ void UI::Init( const u32 screenWidth, const u32 screenHeight ) {
 		renderStateDesc.mTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		renderStateDesc.mUniformLayout = mUniformLayout;
 		mRenderState = new RenderState( mContext );
-		mRenderState->AllocRenderState( renderStateDesc );
+		mRenderState->AllocRenderState( renderStateDesc, YETI_RENDER_STATE_CREATE_BACKGROUND );
 	}
 
 	mInitialised = true;
@@ -217,12 +203,17 @@ void UI::Shutdown() {
 
 	printf( "------- UI shutting down -------\n" );
 
-	mContext->WaitDeviceIdle();
+	// the rasteriser kept its own copy of the font
+	if ( mRasteriser ) {
+		mRasteriser = nullptr;
 
-	VkDevice device = mContext->GetLogicalDevice();
+		mInitialised = false;
 
-	vkDestroyDescriptorPool( device, mDescriptorPool, nullptr );
-	mDescriptorPool = VK_NULL_HANDLE;
+		printf( "------- UI shutdown -------\n\n" );
+		return;
+	}
+
+	mContext->WaitDeviceIdle();
 
 	mUniformLayout->UnallocUniformLayout();
 	YETI_FREE( mUniformLayout );
@@ -239,12 +230,6 @@ void UI::Shutdown() {
 	mShaderVertex->UnallocShader();
 	YETI_FREE( mShaderVertex );
 
-	mBufferIndex->UnallocBuffer();
-	YETI_FREE( mBufferIndex );
-
-	mBufferVertex->UnallocBuffer();
-	YETI_FREE( mBufferVertex );
-
 	mInitialised = false;
 
 	printf( "------- UI shutdown -------\n\n" );
@@ -301,48 +286,35 @@ UI::Render
 */
 void UI::Render() {
 	ImDrawData* drawData = ImGui::GetDrawData();
-	if ( !drawData ) {
+	if ( !drawData || drawData->TotalVtxCount == 0 ) {
 		return;
 	}
 
-	bufferDesc_t bufferDesc = {};
-
-	size_t bufferSizeVertex = drawData->TotalVtxCount * sizeof( ImDrawVert );
-	if ( mBufferSizeVertex != bufferSizeVertex ) {
-		mContext->WaitDeviceIdle();
-
-		mBufferVertex->UnallocBuffer();
-
-		bufferDesc.mBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-		bufferDesc.mData = nullptr;
-		bufferDesc.mDataSizeBytes = bufferSizeVertex;
-		bufferDesc.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-
-		mBufferVertex->AllocBuffer( bufferDesc );
-
-		mBufferSizeVertex = bufferSizeVertex;
-		mNumVertices = drawData->TotalVtxCount;
+	if ( mRasteriser ) {
+		mRasteriser->DrawImGui( drawData );
+		return;
 	}
 
-	size_t bufferSizeIndex = drawData->TotalIdxCount * sizeof( ImDrawIdx );
-	if ( mBufferSizeIndex != bufferSizeIndex ) {
-		mContext->WaitDeviceIdle();
+	if ( mContext->IsFrameSkipped() ) {
+		return;
+	}
 
-		mBufferIndex->UnallocBuffer();
+	// only needs to live for this frame, so no resizing buffers and waiting on the GPU when the text changes
+	FrameAllocator* frameAllocator = mContext->GetFrameAllocator();
+	frameAllocation_t allocVertices = frameAllocator->Alloc( drawData->TotalVtxCount * sizeof( ImDrawVert ), YETI_DEFAULT_BYTE_ALIGNMENT );
+	frameAllocation_t allocIndices = frameAllocator->Alloc( drawData->TotalIdxCount * sizeof( ImDrawIdx ), YETI_DEFAULT_BYTE_ALIGNMENT );
 
-		bufferDesc.mBufferUsage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-		bufferDesc.mData = nullptr;
-		bufferDesc.mDataSizeBytes = bufferSizeIndex;
-		bufferDesc.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	if ( !allocVertices.mData || !allocIndices.mData ) {
+		return;
+	}
 
-		mBufferIndex->AllocBuffer( bufferDesc );
+	ImDrawVert* vertices = reinterpret_cast<ImDrawVert*>( allocVertices.mData );
+	ImDrawIdx* indices = reinterpret_cast<ImDrawIdx*>( allocIndices.mData );
 
-		mBufferSizeIndex = bufferSizeIndex;
-		mNumIndices = drawData->TotalIdxCount;
-	}
+	mDrawListOffsets.resize( drawData->CmdListsCount );
 
-	ImDrawVert* vertices = (ImDrawVert*) mBufferVertex->GetMappedData();
-	ImDrawIdx* indices = (ImDrawIdx*) mBufferIndex->GetMappedData();
+	s32 vertexOffset = 0;
+	s32 indexOffset = 0;
 
 	for ( s32 i = 0; i < drawData->CmdListsCount; i++ ) {
 		const ImDrawList* jobs = drawData->CmdLists[i];
@@ -355,61 +327,101 @@ void UI::Render() {
 
 		vertices += strideVertices;
 		indices += strideIndices;
+
+		mDrawListOffsets[i].mVertexOffset = vertexOffset;
+		mDrawListOffsets[i].mIndexOffset = indexOffset;
+
+		vertexOffset += jobs->VtxBuffer.Size;
+		indexOffset += jobs->IdxBuffer.Size;
 	}
 
-	mBufferVertex->Flush();
-	mBufferIndex->Flush();
+	ImGuiIO& io = ImGui::GetIO();
+	ImVec2 displaySize = io.DisplaySize;
 
-	VkCommandBuffer commandBuffer = mContext->GetCurrentCommandBuffer();
+	mPushConstantBlock.mPosition = glm::vec2( -1.0f );
+	mPushConstantBlock.mScale = glm::vec2( 2.0f / displaySize.x, 2.0f / displaySize.y );
 
-	s32 indexOffset = 0;
-	s32 vertexOffset = 0;
+	CommandRecorder* recorder = mContext->GetCommandRecorder();
+	GPUProfiler* profiler = mContext->GetGPUProfiler();
+
+	// one slot per draw list, with a slot either side for the profiler scope
+	u32 numDrawLists = static_cast<u32>( drawData->CmdListsCount );
+	u32 firstSlot = recorder->ReserveSlots( numDrawLists + 2 );
+	u32 lastSlot = firstSlot + numDrawLists + 1;
+
+	u32 workerIndex = JobSystem::GetWorkerIndex();
+
+	VkCommandBuffer commandBuffer = recorder->BeginSlot( firstSlot, workerIndex );
+	u32 scope = profiler->BeginScope( commandBuffer, "UI" );
+	recorder->EndSlot( firstSlot );
+
+	recordJob_t job = {};
+	job.mUI = this;
+	job.mDrawData = drawData;
+	job.mDisplaySize = displaySize;
+	job.mPipeline = mRenderState->GetPipeline();
+	job.mVertexBuffer = allocVertices.mBuffer;
+	job.mIndexBuffer = allocIndices.mBuffer;
+	job.mVertexBufferOffset = allocVertices.mOffset;
+	job.mIndexBufferOffset = allocIndices.mOffset;
+	job.mFirstSlot = firstSlot + 1;
+	gJobSystem->ParallelFor( numDrawLists, 1, RecordDrawListsJob, &job );
+
+	commandBuffer = recorder->BeginSlot( lastSlot, workerIndex );
+	profiler->EndScope( commandBuffer, scope );
+	recorder->EndSlot( lastSlot );
+}
+
+/*
+========================
+UI::RecordDrawListsJob
+========================
+*/
+void UI::RecordDrawListsJob( void* data, const u32 start, const u32 end, const u32 workerIndex ) {
+	const recordJob_t* job = reinterpret_cast<const recordJob_t*>( data );
+	const UI* ui = job->mUI;
 
-	array<VkClearValue> clearValues( 2 );
-	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
-	clearValues[1].depthStencil = { 1.0f, 0 };
+	CommandRecorder* recorder = ui->mContext->GetCommandRecorder();
 
-	ImGuiIO& io = ImGui::GetIO();
-	ImVec2 displaySize = io.DisplaySize;
+	VkPipelineLayout pipelineLayout = ui->mUniformLayout->GetPipelineLayout();
+	VkDescriptorSet descriptorSet = ui->mUniformLayout->GetDescriptorSet();
 
-	VkPipelineLayout pipelineLayout = mUniformLayout->GetPipelineLayout();
-	VkDescriptorSet descriptorSet = mUniformLayout->GetDescriptorSet();
+	for ( u32 drawListIndex = start; drawListIndex < end; drawListIndex++ ) {
+		const ImDrawList* drawList = job->mDrawData->CmdLists[drawListIndex];
+		const drawListOffsets_t& offsets = ui->mDrawListOffsets[drawListIndex];
 
-	VkBuffer vertexBuffer = mBufferVertex->GetAPIHandle();
+		u32 slot = job->mFirstSlot + drawListIndex;
+		VkCommandBuffer commandBuffer = recorder->BeginSlot( slot, workerIndex );
 
-	vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mRenderState->GetPipeline() );
-	vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr );
+		vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, job->mPipeline );
+		vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr );
 
-	VkDeviceSize offsets[1] = { 0 };
-	vkCmdBindVertexBuffers( commandBuffer, 0, 1, &vertexBuffer, offsets );
-	vkCmdBindIndexBuffer( commandBuffer, mBufferIndex->GetAPIHandle(), 0, VK_INDEX_TYPE_UINT16 );
+		vkCmdBindVertexBuffers( commandBuffer, 0, 1, &job->mVertexBuffer, &job->mVertexBufferOffset );
+		vkCmdBindIndexBuffer( commandBuffer, job->mIndexBuffer, job->mIndexBufferOffset, VK_INDEX_TYPE_UINT16 );
 
-	VkViewport viewport = { 0.0f, 0.0f, displaySize.x, displaySize.y, 0.0f, 1.0f };
-	vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
+		VkViewport viewport = { 0.0f, 0.0f, job->mDisplaySize.x, job->mDisplaySize.y, 0.0f, 1.0f };
+		vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
 
-	mPushConstantBlock.mPosition = glm::vec2( -1.0f );
-	mPushConstantBlock.mScale = glm::vec2( 2.0f / displaySize.x, 2.0f / displaySize.y );
-	vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( pushConstantBlock_t ), &mPushConstantBlock );
+		vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( pushConstantBlock_t ), &ui->mPushConstantBlock );
 
-	for ( s32 drawListIndex = 0; drawListIndex < drawData->CmdListsCount; drawListIndex++ ) {
-		ImDrawList* drawList = drawData->CmdLists[drawListIndex];
+		s32 indexOffset = offsets.mIndexOffset;
 
 		for ( s32 renderJobIndex = 0; renderJobIndex < drawList->CmdBuffer.size(); renderJobIndex++ ) {
-			ImDrawCmd& renderJob = drawList->CmdBuffer[renderJobIndex];
+			const ImDrawCmd& renderJob = drawList->CmdBuffer[renderJobIndex];
 			u32 numIndices = renderJob.ElemCount;
 
-			ImVec4& clipRect = renderJob.ClipRect;
+			const ImVec4& clipRect = renderJob.ClipRect;
 
 			VkRect2D scissorRect = {};
 			scissorRect.offset = { static_cast<s32>( clipRect.x ), static_cast<s32>( clipRect.y ) };
 			scissorRect.extent = { static_cast<u32>( clipRect.z - clipRect.x ), static_cast<u32>( clipRect.w - clipRect.y ) };
 			vkCmdSetScissor( commandBuffer, 0, 1, &scissorRect );
 
-			vkCmdDrawIndexed( commandBuffer, numIndices, 1, indexOffset, vertexOffset, 0 );
+			vkCmdDrawIndexed( commandBuffer, numIndices, 1, indexOffset, offsets.mVertexOffset, 0 );
 
 			indexOffset += numIndices;
 		}
 
-		vertexOffset += drawList->VtxBuffer.Size;
+		recorder->EndSlot( slot );
 	}
 }
\ No newline at end of file
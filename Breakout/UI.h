@@ -3,7 +3,7 @@
 
 #include <mstd/mstd.h>
 
-#include <vulkan/vulkan.h>
+#include "gl/VulkanDispatch.h"
 
 #pragma warning( disable : 4201 )
 #include <glm/glm.hpp>
@@ -12,8 +12,8 @@
 #include <imgui/imgui.h>
 
 class VulkanContext;
+class SoftwareRasteriser;
 
-class Buffer;
 class Shader;
 class Texture;
 
@@ -27,7 +27,12 @@ class RenderState;
 
 	Only renders text. Handles text input when entering a high score and displays high scores.
 
-	Rendering code from the Imgui Vulkan example.
+	Rendering code from the Imgui Vulkan example. The vertices and indices get rebuilt every
+	frame so they live in the context's frame allocator. Each ImGui draw list is recorded into
+	its own secondary command buffer on the job system.
+
+	When the renderer is in software mode none of the Vulkan objects get made, the font goes to
+	the SoftwareRasteriser instead and Render() hands it the draw data.
 
 ================================================================================================
 */
@@ -55,15 +60,34 @@ private:
 		glm::vec2			mScale;
 	};
 
+	// everything a draw list's recording job needs, filled in on the main thread
+	struct recordJob_t {
+		UI*					mUI;
+		const ImDrawData*	mDrawData;
+		ImVec2				mDisplaySize;
+		VkPipeline			mPipeline;
+		VkBuffer			mVertexBuffer;
+		VkBuffer			mIndexBuffer;
+		VkDeviceSize		mVertexBufferOffset;
+		VkDeviceSize		mIndexBufferOffset;
+		u32					mFirstSlot;
+	};
+
+	// where each draw list's vertices and indices start in this frame's allocations
+	struct drawListOffsets_t {
+		s32					mVertexOffset;
+		s32					mIndexOffset;
+	};
+
 	pushConstantBlock_t		mPushConstantBlock;
 
+	array<drawListOffsets_t>	mDrawListOffsets;
+
 	VulkanContext*			mContext;
+	SoftwareRasteriser*		mRasteriser;
 
 	Texture*				mFontTexture;
 
-	Buffer*					mBufferVertex;
-	Buffer*					mBufferIndex;
-
 	Shader*					mShaderVertex;
 	Shader*					mShaderFragment;
 
@@ -73,17 +97,15 @@ private:
 	ImVec4					mBackgroundColor;
 	ImVec2					mIMPos;
 
-	VkDescriptorPool		mDescriptorPool;
-
-	size_t					mBufferSizeVertex, mBufferSizeIndex;
-
-	u32						mNumVertices, mNumIndices;
-
 	u32						mWidth, mHeight;
 
 	u32						mWindowCounter;
 
 	bool32					mInitialised;
+
+private:
+	// [start, end) are draw lists
+	static void				RecordDrawListsJob( void* data, const u32 start, const u32 end, const u32 workerIndex );
 };
 
 extern UI* gUI;
@@ -107,4 +107,26 @@ void Window::Shutdown() {
 	mSDLWindow = nullptr;
 
 	mInitialised = false;
+}
+
+/*
+========================
+Window::Blit
+========================
+*/
+void Window::Blit( const u32* pixels, const u32 width, const u32 height ) {
+	// SDL remakes the surface when the window gets resized, so it has to be fetched every time
+	SDL_Surface* surface = SDL_GetWindowSurface( mSDLWindow );
+	if ( !surface ) {
+		error( "Failed to get the window surface: %s\n", SDL_GetError() );
+		return;
+	}
+
+	// if the window's been resized and the pixels haven't caught up yet, only the part that fits gets copied
+	s32 copyWidth = min( static_cast<s32>( width ), surface->w );
+	s32 copyHeight = min( static_cast<s32>( height ), surface->h );
+
+	SDL_ConvertPixels( copyWidth, copyHeight, SDL_PIXELFORMAT_ARGB8888, pixels, static_cast<s32>( width * sizeof( u32 ) ), surface->format->format, surface->pixels, surface->pitch );
+
+	SDL_UpdateWindowSurface( mSDLWindow );
 }
\ No newline at end of file
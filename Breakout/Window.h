@@ -35,6 +35,9 @@ public:
 	inline u32					GetHeight() const { return mHeight; }
 	inline void					Resize( const u32 width, const u32 height );
 
+	// copies 0xAARRGGBB pixels into the window and shows them, only for windows nothing else presents to
+	void						Blit( const u32* pixels, const u32 width, const u32 height );
+
 	inline SDL_Window*			GetSDLWindow() { return mSDLWindow; }
 	inline const SDL_Window*	GetSDLWindow() const { return mSDLWindow; }
 
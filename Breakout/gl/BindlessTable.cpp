@@ -0,0 +1,334 @@
+#include "BindlessTable.h"
+#include "VulkanContext.h"
+
+/*
+================================================================================================
+
+	BindlessTable
+
+================================================================================================
+*/
+
+/*
+========================
+BindlessTable::BindlessTable
+========================
+*/
+BindlessTable::BindlessTable() {
+	mContext = nullptr;
+
+	mDescriptorSetLayout = VK_NULL_HANDLE;
+	mDescriptorPool = VK_NULL_HANDLE;
+	mDescriptorSet = VK_NULL_HANDLE;
+
+	mWhiteTexture = nullptr;
+
+	mNumTextures = 0;
+	mNumBuffers = 0;
+
+	mNumRetiredTextures = 0;
+	mNumRetiredBuffers = 0;
+
+	mNumFrames = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+BindlessTable::~BindlessTable
+========================
+*/
+BindlessTable::~BindlessTable() {
+	Shutdown();
+}
+
+/*
+========================
+BindlessTable::Init
+========================
+*/
+void BindlessTable::Init( VulkanContext* context, const u32 numFrames ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call BindlessTable::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+	mNumFrames = numFrames;
+
+#if YETI_VK_DESCRIPTOR_INDEXING
+	VkDevice device = mContext->GetLogicalDevice();
+
+	VkDescriptorSetLayoutBinding bindings[BINDING_COUNT] = {
+		{ BINDING_TEXTURES, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+		{ BINDING_BUFFERS, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_BUFFERS, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+	};
+
+	// most of either array is never written, and what is gets written while frames that bound the set are still in flight
+	const VkDescriptorBindingFlagsEXT bindingFlag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+		VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+	VkDescriptorBindingFlagsEXT bindingFlags[BINDING_COUNT] = { bindingFlag, bindingFlag };
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+	bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsInfo.bindingCount = BINDING_COUNT;
+	bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = &bindingFlagsInfo;
+	layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	layoutInfo.bindingCount = BINDING_COUNT;
+	layoutInfo.pBindings = bindings;
+	YETI_VK_CHECK( vkCreateDescriptorSetLayout( device, &layoutInfo, nullptr, &mDescriptorSetLayout ) );
+
+	VkDescriptorPoolSize poolSizes[BINDING_COUNT] = {
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_BUFFERS },
+	};
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = BINDING_COUNT;
+	poolInfo.pPoolSizes = poolSizes;
+	YETI_VK_CHECK( vkCreateDescriptorPool( device, &poolInfo, nullptr, &mDescriptorPool ) );
+
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = mDescriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &mDescriptorSetLayout;
+	YETI_VK_CHECK( vkAllocateDescriptorSets( device, &allocInfo, &mDescriptorSet ) );
+#else
+	fatalError( "BindlessTable needs VK_EXT_descriptor_indexing, which these Vulkan headers don't have!\n" );
+#endif
+
+	mNumTextures = 0;
+	mNumBuffers = 0;
+	mFreeTextures.clear();
+	mFreeBuffers.clear();
+
+	mRetiredSlots.clear();
+	mNumRetiredTextures = 0;
+	mNumRetiredBuffers = 0;
+
+	mInitialised = true;
+
+	CreateWhiteTexture();
+
+	printf( "Bindless table has room for %u textures and %u buffers.\n", MAX_TEXTURES, MAX_BUFFERS );
+}
+
+/*
+========================
+BindlessTable::Shutdown
+========================
+*/
+void BindlessTable::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	mWhiteTexture->UnallocTexture();
+	YETI_FREE( mWhiteTexture );
+
+	VkDevice device = mContext->GetLogicalDevice();
+
+	// frees the set with it
+	vkDestroyDescriptorPool( device, mDescriptorPool, nullptr );
+	mDescriptorPool = VK_NULL_HANDLE;
+	mDescriptorSet = VK_NULL_HANDLE;
+
+	vkDestroyDescriptorSetLayout( device, mDescriptorSetLayout, nullptr );
+	mDescriptorSetLayout = VK_NULL_HANDLE;
+
+	mFreeTextures.clear();
+	mFreeBuffers.clear();
+	mRetiredSlots.clear();
+
+	mInitialised = false;
+}
+
+/*
+========================
+BindlessTable::BeginFrame
+========================
+*/
+void BindlessTable::BeginFrame() {
+	for ( u32 i = static_cast<u32>( mRetiredSlots.length() ); i-- > 0; ) {
+		retiredSlot_t& slot = mRetiredSlots[i];
+
+		if ( --slot.mFramesLeft > 0 ) {
+			continue;
+		}
+
+		if ( slot.mBinding == BINDING_TEXTURES ) {
+			mFreeTextures.add( slot.mIndex );
+			mNumRetiredTextures--;
+		} else {
+			mFreeBuffers.add( slot.mIndex );
+			mNumRetiredBuffers--;
+		}
+
+		mRetiredSlots[i] = mRetiredSlots[mRetiredSlots.length() - 1];
+		mRetiredSlots.resize( mRetiredSlots.length() - 1 );
+	}
+}
+
+/*
+========================
+BindlessTable::AddTexture
+========================
+*/
+u32 BindlessTable::AddTexture( const Texture* texture ) {
+	assertf( ( texture && texture->IsAlloced() ), "Attempt to add a texture to the bindless table that hasn't been allocated!\n" );
+
+	u32 index = AllocSlot( BINDING_TEXTURES );
+
+	if ( index != INVALID_INDEX ) {
+		Write( BINDING_TEXTURES, index, &texture->GetDescriptorInfo(), nullptr );
+	}
+
+	return index;
+}
+
+/*
+========================
+BindlessTable::RemoveTexture
+========================
+*/
+void BindlessTable::RemoveTexture( const u32 index ) {
+	assertf( ( index != WHITE_TEXTURE ), "The bindless table's white texture can't be removed!\n" );
+
+	RetireSlot( index, BINDING_TEXTURES );
+}
+
+/*
+========================
+BindlessTable::AddBuffer
+========================
+*/
+u32 BindlessTable::AddBuffer( const Buffer* buffer ) {
+	assertf( ( buffer && buffer->IsAlloced() ), "Attempt to add a buffer to the bindless table that hasn't been allocated!\n" );
+
+	u32 index = AllocSlot( BINDING_BUFFERS );
+
+	if ( index != INVALID_INDEX ) {
+		Write( BINDING_BUFFERS, index, nullptr, &buffer->GetDescriptorInfo() );
+	}
+
+	return index;
+}
+
+/*
+========================
+BindlessTable::RemoveBuffer
+========================
+*/
+void BindlessTable::RemoveBuffer( const u32 index ) {
+	RetireSlot( index, BINDING_BUFFERS );
+}
+
+/*
+========================
+BindlessTable::CreateWhiteTexture
+========================
+*/
+void BindlessTable::CreateWhiteTexture() {
+	textureDesc_t textureDesc = {};
+	textureDesc.mWidth = 1;
+	textureDesc.mHeight = 1;
+	textureDesc.mDepth = 1;
+	textureDesc.mFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+	samplerDesc_t samplerDesc = {};
+	samplerDesc.mSampleCount = VK_SAMPLE_COUNT_1_BIT;
+	samplerDesc.mEnableAnisotropicFiltering = false;
+	samplerDesc.mFilterMode = YETI_SAMPLER_FILTER_MODE_NEAREST;
+	samplerDesc.mAddressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerDesc.mMipLevels = 1;
+	samplerDesc.mMinLod = 0;
+	samplerDesc.mMaxLod = 1;
+
+	mWhiteTexture = new Texture( mContext );
+	mWhiteTexture->AllocTexture( textureDesc, samplerDesc );
+
+	const u8 white[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+	mWhiteTexture->SubImageUpload2D( white, 0, 0, 0, 1, 1 );
+
+	u32 index = AddTexture( mWhiteTexture );
+	assertf( ( index == WHITE_TEXTURE ), "The bindless table's white texture has to be the first one added!\n" );
+}
+
+/*
+========================
+BindlessTable::AllocSlot
+========================
+*/
+u32 BindlessTable::AllocSlot( const binding_t binding ) {
+	array<u32>& freeSlots = ( binding == BINDING_TEXTURES ) ? mFreeTextures : mFreeBuffers;
+	u32& numSlots = ( binding == BINDING_TEXTURES ) ? mNumTextures : mNumBuffers;
+	u32 maxSlots = ( binding == BINDING_TEXTURES ) ? MAX_TEXTURES : MAX_BUFFERS;
+
+	if ( freeSlots.length() > 0 ) {
+		u32 index = freeSlots[freeSlots.length() - 1];
+		freeSlots.resize( freeSlots.length() - 1 );
+		return index;
+	}
+
+	if ( numSlots == maxSlots ) {
+		error( "The bindless table is full, MAX_TEXTURES (%u) or MAX_BUFFERS (%u) needs to be bigger!\n", MAX_TEXTURES, MAX_BUFFERS );
+		return INVALID_INDEX;
+	}
+
+	return numSlots++;
+}
+
+/*
+========================
+BindlessTable::RetireSlot
+========================
+*/
+void BindlessTable::RetireSlot( const u32 index, const binding_t binding ) {
+	if ( index == INVALID_INDEX ) {
+		return;
+	}
+
+	assertf( ( index < ( ( binding == BINDING_TEXTURES ) ? mNumTextures : mNumBuffers ) ), "Attempt to remove a bindless table slot that was never added!\n" );
+
+	// the frame being recorded could already be reading it, so it waits for that frame's fence as well as the ones in flight
+	retiredSlot_t slot = {};
+	slot.mIndex = index;
+	slot.mFramesLeft = mNumFrames;
+	slot.mBinding = binding;
+	mRetiredSlots.add( slot );
+
+	if ( binding == BINDING_TEXTURES ) {
+		mNumRetiredTextures++;
+	} else {
+		mNumRetiredBuffers++;
+	}
+}
+
+/*
+========================
+BindlessTable::Write
+========================
+*/
+void BindlessTable::Write( const binding_t binding, const u32 index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo ) {
+	VkWriteDescriptorSet write = {};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = mDescriptorSet;
+	write.dstBinding = binding;
+	write.dstArrayElement = index;
+	write.descriptorCount = 1;
+	write.descriptorType = ( binding == BINDING_TEXTURES ) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.pImageInfo = imageInfo;
+	write.pBufferInfo = bufferInfo;
+
+	// the slot isn't used by anything in flight, which update after bind and update unused while pending make legal
+	vkUpdateDescriptorSets( mContext->GetLogicalDevice(), 1, &write, 0, nullptr );
+}
\ No newline at end of file
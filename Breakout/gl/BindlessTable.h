@@ -0,0 +1,128 @@
+#ifndef __BINDLESS_TABLE_H__
+#define __BINDLESS_TABLE_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+// headers from before VK_EXT_descriptor_indexing existed never get the bindless table
+#ifdef VK_EXT_descriptor_indexing
+#define YETI_VK_DESCRIPTOR_INDEXING		1
+#else
+#define YETI_VK_DESCRIPTOR_INDEXING		0
+#endif
+
+class VulkanContext;
+class Texture;
+class Buffer;
+
+/*
+================================================================================================
+
+	Bindless Table
+
+	One descriptor set holding every texture and storage buffer that's been added to it, bound
+	once as set BINDLESS_SET and indexed from shaders with whatever index Add*() gave back, so
+	drawing with a different texture is a different number in an instance or push constant and
+	not another descriptor bind.
+
+	Binding 0 is a sampler2D array of MAX_TEXTURES and binding 1 a storage buffer array of
+	MAX_BUFFERS, both partially bound and update after bind, so slots nothing uses yet can be
+	written while frames that have the set bound are still in flight. Removed slots aren't
+	handed out again until every frame that could still be reading them is done.
+
+	Texture 0 is always a 1x1 white texture, so anything that never picks a texture samples
+	white and draws exactly as it would without one.
+
+	Only exists when the driver has VK_EXT_descriptor_indexing and the context was asked for it.
+	The set comes from its own pool, the DescriptorAllocator's pools aren't update after bind.
+
+	Main thread only.
+
+================================================================================================
+*/
+
+class BindlessTable {
+public:
+	static const u32					MAX_TEXTURES = 4096;
+	static const u32					MAX_BUFFERS = 256;
+
+	// MUST match the set the bindless shaders declare the table in
+	static const u32					BINDLESS_SET = 1;
+
+	static const u32					WHITE_TEXTURE = 0;
+
+	static const u32					INVALID_INDEX = U32_MAX;
+
+public:
+										BindlessTable();
+	virtual								~BindlessTable();
+
+	void								Init( VulkanContext* context, const u32 numFrames );
+	void								Shutdown();
+	inline bool32						IsInitialised() const { return mInitialised; }
+
+	// the current frame's fence MUST have been waited on, lets go of slots no frame can be reading any more
+	void								BeginFrame();
+
+	// the texture MUST stay alloced until it's removed, returns INVALID_INDEX if the table is full
+	u32									AddTexture( const Texture* texture );
+	void								RemoveTexture( const u32 index );
+
+	// the buffer MUST have been made with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+	u32									AddBuffer( const Buffer* buffer );
+	void								RemoveBuffer( const u32 index );
+
+	inline VkDescriptorSetLayout		GetDescriptorSetLayout() const { return mDescriptorSetLayout; }
+	inline VkDescriptorSet				GetDescriptorSet() const { return mDescriptorSet; }
+
+	inline u32							GetNumTextures() const { return mNumTextures - static_cast<u32>( mFreeTextures.length() ) - mNumRetiredTextures; }
+	inline u32							GetNumBuffers() const { return mNumBuffers - static_cast<u32>( mFreeBuffers.length() ) - mNumRetiredBuffers; }
+
+private:
+	enum binding_t {
+		BINDING_TEXTURES				= 0,
+		BINDING_BUFFERS,
+
+		BINDING_COUNT
+	};
+
+	// a removed slot and how many more frames have to begin before it can be reused
+	struct retiredSlot_t {
+		u32								mIndex;
+		u32								mFramesLeft;
+		binding_t						mBinding;
+	};
+
+	VulkanContext*						mContext;
+
+	VkDescriptorSetLayout				mDescriptorSetLayout;
+	VkDescriptorPool					mDescriptorPool;
+	VkDescriptorSet						mDescriptorSet;
+
+	Texture*							mWhiteTexture;
+
+	// slots [0, mNumTextures) have been handed out at some point, the free ones get reused first
+	u32									mNumTextures;
+	u32									mNumBuffers;
+	array<u32>							mFreeTextures;
+	array<u32>							mFreeBuffers;
+
+	array<retiredSlot_t>				mRetiredSlots;
+	u32									mNumRetiredTextures;
+	u32									mNumRetiredBuffers;
+
+	u32									mNumFrames;
+
+	bool32								mInitialised;
+
+private:
+	void								CreateWhiteTexture();
+
+	u32									AllocSlot( const binding_t binding );
+	void								RetireSlot( const u32 index, const binding_t binding );
+
+	void								Write( const binding_t binding, const u32 index, const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo );
+};
+
+#endif // __BINDLESS_TABLE_H__
\ No newline at end of file
@@ -112,4 +112,34 @@ void Buffer::Flush() {
 		memoryRange.size = mAllocInfo.size;
 		YETI_VK_CHECK( vkFlushMappedMemoryRanges( mContext->GetLogicalDevice(), 1, &memoryRange ) );
 	}
+}
+
+/*
+========================
+Buffer::Invalidate
+========================
+*/
+void Buffer::Invalidate() {
+	if ( mMemoryUsage != VMA_MEMORY_USAGE_GPU_TO_CPU ) {
+		return;
+	}
+
+	const gpuInfo_t& gpu = mContext->GetActiveGPU();
+
+	// invalidate to make changes by the GPU visible to host if memory is not host coherent
+	if ( gpu.mMemoryProperties.memoryTypes[mAllocInfo.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT ) {
+		return;
+	}
+
+	// the range has to be whole atoms, blocks are always much bigger than one so rounding out stays inside the memory
+	VkDeviceSize atomSize = max( gpu.mProperties.limits.nonCoherentAtomSize, static_cast<VkDeviceSize>( 1 ) );
+	VkDeviceSize start = ( mAllocInfo.offset / atomSize ) * atomSize;
+	VkDeviceSize end = ( ( mAllocInfo.offset + mAllocInfo.size + atomSize - 1 ) / atomSize ) * atomSize;
+
+	VkMappedMemoryRange memoryRange = {};
+	memoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	memoryRange.memory = mAllocInfo.deviceMemory;
+	memoryRange.offset = start;
+	memoryRange.size = end - start;
+	YETI_VK_CHECK( vkInvalidateMappedMemoryRanges( mContext->GetLogicalDevice(), 1, &memoryRange ) );
 }
\ No newline at end of file
@@ -34,6 +34,9 @@ public:
 	void									UploadData( const void* data, const size_t dataSizeBytes );
 	void									Flush();
 
+	// GPU_TO_CPU buffers only, MUST be called before reading anything the GPU wrote
+	void									Invalidate();
+
 	inline const VkDescriptorBufferInfo&	GetDescriptorInfo() const { return mBufferInfo; }
 	inline VkBuffer							GetAPIHandle() const { return mBufferInfo.buffer; }
 
@@ -0,0 +1,238 @@
+#include "CommandRecorder.h"
+#include "VulkanContext.h"
+
+/*
+================================================================================================
+
+	CommandRecorder
+
+================================================================================================
+*/
+
+/*
+========================
+CommandRecorder::CommandRecorder
+========================
+*/
+CommandRecorder::CommandRecorder() {
+	mContext = nullptr;
+
+	mNumWorkers = 0;
+	mFrameIndex = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+CommandRecorder::~CommandRecorder
+========================
+*/
+CommandRecorder::~CommandRecorder() {
+	Shutdown();
+}
+
+/*
+========================
+CommandRecorder::Init
+========================
+*/
+void CommandRecorder::Init( VulkanContext* context, const u32 numFrames, const u32 numWorkers ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call CommandRecorder::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( numWorkers > 0 && numWorkers <= MAX_WORKERS ), "CommandRecorder needs between 1 and MAX_WORKERS workers!\n" );
+
+	mContext = context;
+	mNumWorkers = numWorkers;
+
+	VkCommandPoolCreateInfo commandPoolInfo = {};
+	commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolInfo.queueFamilyIndex = mContext->GetQueueIndex( YETI_QUEUE_TYPE_GRAPHICS );
+	commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+	mFrames.resize( numFrames );
+	mPools.resize( numFrames * mNumWorkers );
+
+	for ( u32 i = 0; i < numFrames; i++ ) {
+		mFrames[i].mNumSlots = 0;
+	}
+
+	for ( u32 i = 0; i < mPools.length(); i++ ) {
+		workerPool_t& pool = mPools[i];
+
+		YETI_VK_CHECK( vkCreateCommandPool( mContext->GetLogicalDevice(), &commandPoolInfo, nullptr, &pool.mCommandPool ) );
+		pool.mNumAllocated = 0;
+		pool.mNumUsed = 0;
+	}
+
+	mFrameIndex = 0;
+
+	mInitialised = true;
+}
+
+/*
+========================
+CommandRecorder::Shutdown
+========================
+*/
+void CommandRecorder::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	for ( u32 i = 0; i < mPools.length(); i++ ) {
+		// frees its command buffers with it
+		vkDestroyCommandPool( mContext->GetLogicalDevice(), mPools[i].mCommandPool, nullptr );
+		mPools[i].mCommandPool = VK_NULL_HANDLE;
+	}
+	mPools.clear();
+
+	mFrames.clear();
+
+	mInitialised = false;
+}
+
+/*
+========================
+CommandRecorder::BeginFrame
+========================
+*/
+void CommandRecorder::BeginFrame( const u32 frameIndex ) {
+	assertf( ( frameIndex < mFrames.length() ), "CommandRecorder::BeginFrame() frame index is out of range!\n" );
+
+	mFrameIndex = frameIndex;
+
+	mFrames[mFrameIndex].mNumSlots = 0;
+
+	VkDevice logicalDevice = mContext->GetLogicalDevice();
+
+	for ( u32 i = 0; i < mNumWorkers; i++ ) {
+		workerPool_t& pool = mPools[mFrameIndex * mNumWorkers + i];
+
+		if ( pool.mNumUsed == 0 ) {
+			continue;
+		}
+
+		// the buffers stay allocated, they just go back to the initial state
+		YETI_VK_CHECK( vkResetCommandPool( logicalDevice, pool.mCommandPool, 0 ) );
+		pool.mNumUsed = 0;
+	}
+}
+
+/*
+========================
+CommandRecorder::ReserveSlots
+========================
+*/
+u32 CommandRecorder::ReserveSlots( const u32 count ) {
+	frameSlots_t& frame = mFrames[mFrameIndex];
+
+	assertf( ( frame.mNumSlots + count <= MAX_SLOTS ), "CommandRecorder ran out of slots this frame, increase MAX_SLOTS!\n" );
+
+	u32 first = frame.mNumSlots;
+
+	for ( u32 i = 0; i < count; i++ ) {
+		frame.mSlots[first + i] = VK_NULL_HANDLE;
+	}
+
+	frame.mNumSlots += count;
+
+	return first;
+}
+
+/*
+========================
+CommandRecorder::BeginSlot
+========================
+*/
+VkCommandBuffer CommandRecorder::BeginSlot( const u32 slot, const u32 workerIndex ) {
+	frameSlots_t& frame = mFrames[mFrameIndex];
+
+	assertf( ( slot < frame.mNumSlots ), "Attempt to record a CommandRecorder slot that was never reserved!\n" );
+	assertf( ( workerIndex < mNumWorkers ), "CommandRecorder::BeginSlot() worker index is out of range!\n" );
+
+	workerPool_t& pool = mPools[mFrameIndex * mNumWorkers + workerIndex];
+
+	if ( pool.mNumUsed == pool.mNumAllocated ) {
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandBufferCount = 1;
+		allocInfo.commandPool = pool.mCommandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		YETI_VK_CHECK( vkAllocateCommandBuffers( mContext->GetLogicalDevice(), &allocInfo, &pool.mCommandBuffers[pool.mNumAllocated] ) );
+
+		pool.mNumAllocated++;
+	}
+
+	VkCommandBuffer commandBuffer = pool.mCommandBuffers[pool.mNumUsed++];
+
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = mContext->GetRenderPass();
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = mContext->GetCurrentFramebuffer();
+
+#if YETI_VK_DYNAMIC_RENDERING
+	VkFormat colorFormat = mContext->GetColorFormat();
+
+	VkCommandBufferInheritanceRenderingInfoKHR inheritanceRenderingInfo = {};
+	inheritanceRenderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+	inheritanceRenderingInfo.colorAttachmentCount = 1;
+	inheritanceRenderingInfo.pColorAttachmentFormats = &colorFormat;
+	inheritanceRenderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	if ( mContext->UsesDynamicRendering() ) {
+		inheritanceInfo.pNext = &inheritanceRenderingInfo;
+	}
+#endif
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	YETI_VK_CHECK( vkBeginCommandBuffer( commandBuffer, &beginInfo ) );
+
+	u32 width = mContext->GetWidth();
+	u32 height = mContext->GetHeight();
+
+	VkViewport viewport = { 0.0f, 0.0f, static_cast<float32>( width ), static_cast<float32>( height ), 0.0f, 1.0f };
+	vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
+
+	VkRect2D scissor = { { 0, 0 }, { width, height } };
+	vkCmdSetScissor( commandBuffer, 0, 1, &scissor );
+
+	frame.mSlots[slot] = commandBuffer;
+
+	return commandBuffer;
+}
+
+/*
+========================
+CommandRecorder::EndSlot
+========================
+*/
+void CommandRecorder::EndSlot( const u32 slot ) {
+	YETI_VK_CHECK( vkEndCommandBuffer( mFrames[mFrameIndex].mSlots[slot] ) );
+}
+
+/*
+========================
+CommandRecorder::Execute
+========================
+*/
+void CommandRecorder::Execute( VkCommandBuffer commandBuffer ) {
+	const frameSlots_t& frame = mFrames[mFrameIndex];
+
+	if ( frame.mNumSlots == 0 ) {
+		return;
+	}
+
+	for ( u32 i = 0; i < frame.mNumSlots; i++ ) {
+		assertf( ( frame.mSlots[i] != VK_NULL_HANDLE ), "A CommandRecorder slot was reserved but never recorded!\n" );
+	}
+
+	vkCmdExecuteCommands( commandBuffer, frame.mNumSlots, frame.mSlots );
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef __COMMAND_RECORDER_H__
+#define __COMMAND_RECORDER_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+class VulkanContext;
+
+/*
+================================================================================================
+
+	Command Recorder
+
+	Hands out secondary command buffers for recording the swap chain pass from job system
+	workers. Every frame in flight has a transient command pool per worker, so a worker only
+	ever records from its own pool and nothing needs locking. The pools are reset in one go
+	when the context starts the frame, once its fence has been waited on.
+
+	Work is split into slots. The main thread reserves them in the order they have to run in,
+	then each slot is recorded exactly once by whichever worker gets to it, in any order. The
+	context executes every slot from the frame's primary buffer in slot order just before the
+	pass ends.
+
+	The pass is begun for secondary command buffers, so NOTHING can be recorded into it
+	directly anymore. Slot buffers come back already begun with the viewport and scissor set
+	to the whole window, since dynamic state doesn't carry over from the primary.
+
+	GPUProfiler scopes aren't thread safe, so they go in their own slots from the main thread.
+
+================================================================================================
+*/
+
+class CommandRecorder {
+public:
+	static const u32		MAX_WORKERS = 64;
+	static const u32		MAX_SLOTS = 64;		// per frame
+
+public:
+							CommandRecorder();
+	virtual					~CommandRecorder();
+
+	void					Init( VulkanContext* context, const u32 numFrames, const u32 numWorkers );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	inline u32				GetNumWorkers() const { return mNumWorkers; }
+
+	// frameIndex's fence MUST have been waited on
+	void					BeginFrame( const u32 frameIndex );
+
+	// main thread only, returns the first of count consecutive slots
+	u32						ReserveSlots( const u32 count );
+
+	// safe from any worker as long as no two workers record the same slot, workerIndex MUST be the caller's JobSystem::GetWorkerIndex()
+	VkCommandBuffer			BeginSlot( const u32 slot, const u32 workerIndex );
+	void					EndSlot( const u32 slot );
+
+	// every reserved slot MUST have been recorded, commandBuffer MUST be inside the swap chain pass
+	void					Execute( VkCommandBuffer commandBuffer );
+
+private:
+	struct workerPool_t {
+		VkCommandPool		mCommandPool;
+		VkCommandBuffer		mCommandBuffers[MAX_SLOTS];
+		u32					mNumAllocated;
+		u32					mNumUsed;		// reset every frame, buffers past this get allocated when they're needed
+	};
+
+	struct frameSlots_t {
+		VkCommandBuffer		mSlots[MAX_SLOTS];
+		u32					mNumSlots;
+	};
+
+	VulkanContext*			mContext;
+
+	array<frameSlots_t>		mFrames;
+	array<workerPool_t>		mPools;			// numFrames * numWorkers, a frame's pools are next to each other
+
+	u32						mNumWorkers;
+	u32						mFrameIndex;
+
+	bool32					mInitialised;
+};
+
+#endif // __COMMAND_RECORDER_H__
\ No newline at end of file
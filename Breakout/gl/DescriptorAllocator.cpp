@@ -0,0 +1,524 @@
+#include "DescriptorAllocator.h"
+#include "VulkanContext.h"
+#include "RenderStateManager.h"
+
+static_assert( DescriptorAllocator::MAX_LAYOUTS == RenderStateManager::MAX_LAYOUTS, "DescriptorAllocator::MAX_LAYOUTS has to match RenderStateManager::MAX_LAYOUTS!" );
+
+// update data is handed to the driver as is, so both have to take up the same space for arrays of either to line up
+static_assert( sizeof( descriptorData_t ) == sizeof( VkDescriptorBufferInfo ) && sizeof( descriptorData_t ) == sizeof( VkDescriptorImageInfo ), "descriptorData_t has to be the same size as the infos in it!" );
+
+// how many of each descriptor type a pool gets per set it can hold
+static const VkDescriptorPoolSize POOL_RATIOS[] = {
+	{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,			2 },
+	{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,	1 },
+	{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,	2 },
+	{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,			1 },
+};
+
+static const u32 NUM_POOL_RATIOS = sizeof( POOL_RATIOS ) / sizeof( POOL_RATIOS[0] );
+
+/*
+================================================================================================
+
+	DescriptorAllocator
+
+================================================================================================
+*/
+
+/*
+========================
+DescriptorAllocator::DescriptorAllocator
+========================
+*/
+DescriptorAllocator::DescriptorAllocator() {
+	mContext = nullptr;
+
+	mNumPages = 0;
+	mFrameIndex = 0;
+
+	mNumSetsAllocated = 0;
+	mNumSetsReused = 0;
+
+	mUseUpdateTemplates = false;
+
+	mInitialised = false;
+}
+
+/*
+========================
+DescriptorAllocator::~DescriptorAllocator
+========================
+*/
+DescriptorAllocator::~DescriptorAllocator() {
+	Shutdown();
+}
+
+/*
+========================
+DescriptorAllocator::Init
+========================
+*/
+void DescriptorAllocator::Init( VulkanContext* context, const u32 numFrames ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call DescriptorAllocator::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+
+	memset( mPages, 0, sizeof( mPages ) );
+	mNumPages = 0;
+
+	mFrames.resize( numFrames );
+	for ( u32 i = 0; i < numFrames; i++ ) {
+		memset( &mFrames[i], 0, sizeof( framePages_t ) );
+	}
+	mFrameIndex = 0;
+
+	memset( mLayouts, 0, sizeof( mLayouts ) );
+
+	mFreeSets.clear();
+	mRetiredSets.clear();
+
+	mNumSetsAllocated = 0;
+	mNumSetsReused = 0;
+
+	mUseUpdateTemplates = mContext->UsesDescriptorUpdateTemplates();
+
+	printf( "Writing descriptor sets with %s.\n", mContext->UsesDescriptorUpdateTemplates() ? "update templates" : "vkUpdateDescriptorSets()" );
+
+	mInitialised = true;
+}
+
+/*
+========================
+DescriptorAllocator::Shutdown
+========================
+*/
+void DescriptorAllocator::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	VkDevice device = mContext->GetLogicalDevice();
+
+	for ( u32 i = 0; i < MAX_LAYOUTS; i++ ) {
+		ForgetLayout( i );
+	}
+
+	// frees every set that came out of them too
+	for ( u32 i = 0; i < mNumPages; i++ ) {
+		vkDestroyDescriptorPool( device, mPages[i].mPool, nullptr );
+	}
+	mNumPages = 0;
+
+	for ( u32 i = 0; i < mFrames.length(); i++ ) {
+		for ( u32 j = 0; j < mFrames[i].mNumPools; j++ ) {
+			vkDestroyDescriptorPool( device, mFrames[i].mPools[j], nullptr );
+		}
+	}
+	mFrames.clear();
+
+	mFreeSets.clear();
+	mRetiredSets.clear();
+
+	mInitialised = false;
+}
+
+/*
+========================
+DescriptorAllocator::BeginFrame
+========================
+*/
+void DescriptorAllocator::BeginFrame( const u32 frameIndex ) {
+	assertf( ( frameIndex < mFrames.length() ), "DescriptorAllocator::BeginFrame() frame index is out of range!\n" );
+
+	mFrameIndex = frameIndex;
+
+	framePages_t& frame = mFrames[mFrameIndex];
+
+	VkDevice device = mContext->GetLogicalDevice();
+
+	// only the ones that were actually used, the pools past that are already reset
+	u32 numUsed = min( frame.mCurrent + 1, frame.mNumPools );
+	for ( u32 i = 0; i < numUsed; i++ ) {
+		YETI_VK_CHECK( vkResetDescriptorPool( device, frame.mPools[i], 0 ) );
+	}
+
+	frame.mCurrent = 0;
+
+	for ( u32 i = static_cast<u32>( mRetiredSets.length() ); i-- > 0; ) {
+		retiredSet_t& set = mRetiredSets[i];
+
+		if ( --set.mFramesLeft > 0 ) {
+			continue;
+		}
+
+		mFreeSets.add( set.mAllocation );
+
+		mRetiredSets[i] = mRetiredSets[mRetiredSets.length() - 1];
+		mRetiredSets.resize( mRetiredSets.length() - 1 );
+	}
+}
+
+/*
+========================
+DescriptorAllocator::Alloc
+========================
+*/
+descriptorAllocation_t DescriptorAllocator::Alloc( const u32 layoutID ) {
+	mNumSetsAllocated++;
+
+	for ( u32 i = static_cast<u32>( mFreeSets.length() ); i-- > 0; ) {
+		if ( mFreeSets[i].mLayoutID != layoutID ) {
+			continue;
+		}
+
+		descriptorAllocation_t allocation = mFreeSets[i];
+
+		mFreeSets[i] = mFreeSets[mFreeSets.length() - 1];
+		mFreeSets.resize( mFreeSets.length() - 1 );
+
+		mNumSetsReused++;
+
+		return allocation;
+	}
+
+	const layoutEntry_t& layout = GetLayout( layoutID );
+
+	descriptorAllocation_t allocation = {};
+	allocation.mLayoutID = layoutID;
+
+	for ( u32 i = 0; i < mNumPages; i++ ) {
+		page_t& page = mPages[i];
+
+		if ( page.mFull ) {
+			continue;
+		}
+
+		if ( TryAlloc( page.mPool, layout.mDescriptorSetLayout, allocation.mSet ) ) {
+			page.mNumSets++;
+			page.mFull = page.mNumSets == SETS_PER_PAGE;
+
+			allocation.mPage = i;
+			return allocation;
+		}
+
+		// ran out of one of the descriptor types before it ran out of sets
+		page.mFull = true;
+	}
+
+	if ( mNumPages == MAX_PAGES ) {
+		fatalError( "DescriptorAllocator ran out of pages, MAX_PAGES (%u) needs to be bigger!\n", MAX_PAGES );
+		return allocation;
+	}
+
+	page_t& page = mPages[mNumPages];
+	page.mPool = CreatePool( SETS_PER_PAGE, 0 );
+	page.mNumSets = 0;
+	page.mFull = false;
+
+	if ( !TryAlloc( page.mPool, layout.mDescriptorSetLayout, allocation.mSet ) ) {
+		fatalError( "A new descriptor pool page doesn't have room for uniform layout %u, POOL_RATIOS needs more of something!\n", layoutID );
+		return allocation;
+	}
+
+	page.mNumSets++;
+
+	allocation.mPage = mNumPages++;
+
+	return allocation;
+}
+
+/*
+========================
+DescriptorAllocator::Free
+========================
+*/
+void DescriptorAllocator::Free( const descriptorAllocation_t& allocation ) {
+	if ( allocation.mSet == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	// one frame per context, counting the one being recorded since it might have bound the set already
+	retiredSet_t set = {};
+	set.mAllocation = allocation;
+	set.mFramesLeft = static_cast<u32>( mFrames.length() );
+	mRetiredSets.add( set );
+}
+
+/*
+========================
+DescriptorAllocator::AllocTransient
+========================
+*/
+VkDescriptorSet DescriptorAllocator::AllocTransient( const u32 layoutID ) {
+	const layoutEntry_t& layout = GetLayout( layoutID );
+
+	framePages_t& frame = mFrames[mFrameIndex];
+
+	VkDescriptorSet set = VK_NULL_HANDLE;
+
+	while ( frame.mCurrent < MAX_FRAME_PAGES ) {
+		if ( frame.mCurrent == frame.mNumPools ) {
+			frame.mPools[frame.mNumPools++] = CreatePool( SETS_PER_PAGE, 0 );
+		}
+
+		if ( TryAlloc( frame.mPools[frame.mCurrent], layout.mDescriptorSetLayout, set ) ) {
+			return set;
+		}
+
+		frame.mCurrent++;
+	}
+
+	fatalError( "DescriptorAllocator ran out of transient pages this frame, MAX_FRAME_PAGES (%u) needs to be bigger!\n", MAX_FRAME_PAGES );
+
+	return VK_NULL_HANDLE;
+}
+
+/*
+========================
+DescriptorAllocator::Update
+========================
+*/
+void DescriptorAllocator::Update( VkDescriptorSet set, const u32 layoutID, const descriptorData_t* data ) {
+	const layoutEntry_t& layout = GetLayout( layoutID );
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	if ( mUseUpdateTemplates && layout.mTemplate != VK_NULL_HANDLE ) {
+		mContext->UpdateDescriptorSetWithTemplate( set, layout.mTemplate, data );
+		return;
+	}
+#endif
+
+	VkWriteDescriptorSet writes[MAX_DESCRIPTORS_PER_SET];
+
+	for ( u32 i = 0; i < layout.mNumEntries; i++ ) {
+		const entry_t& entry = layout.mEntries[i];
+
+		VkWriteDescriptorSet& write = writes[i];
+		write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = set;
+		write.dstBinding = entry.mBinding;
+		write.descriptorCount = entry.mCount;
+		write.descriptorType = entry.mType;
+
+		// the same size, so either one's array is just the data from the entry's index on
+		switch ( entry.mType ) {
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			write.pImageInfo = &data[entry.mDataIndex].mImage;
+			break;
+
+		default:
+			write.pBufferInfo = &data[entry.mDataIndex].mBuffer;
+			break;
+		}
+	}
+
+	vkUpdateDescriptorSets( mContext->GetLogicalDevice(), layout.mNumEntries, writes, 0, nullptr );
+}
+
+/*
+========================
+DescriptorAllocator::GetNumDescriptors
+========================
+*/
+u32 DescriptorAllocator::GetNumDescriptors( const u32 layoutID ) {
+	return GetLayout( layoutID ).mNumDescriptors;
+}
+
+/*
+========================
+DescriptorAllocator::GetDataIndex
+========================
+*/
+u32 DescriptorAllocator::GetDataIndex( const u32 layoutID, const u32 binding ) {
+	const layoutEntry_t& layout = GetLayout( layoutID );
+
+	for ( u32 i = 0; i < layout.mNumEntries; i++ ) {
+		if ( layout.mEntries[i].mBinding == binding ) {
+			return layout.mEntries[i].mDataIndex;
+		}
+	}
+
+	error( "Uniform layout %u doesn't have a binding %u!\n", layoutID, binding );
+
+	return 0;
+}
+
+/*
+========================
+DescriptorAllocator::ForgetLayout
+========================
+*/
+void DescriptorAllocator::ForgetLayout( const u32 layoutID ) {
+	layoutEntry_t& layout = mLayouts[layoutID];
+
+	if ( layout.mDescriptorSetLayout == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	// sets on the free and retired lists would never match anything again, pages can't take sets back so they stay allocated until the pages are destroyed
+	for ( u32 i = static_cast<u32>( mFreeSets.length() ); i-- > 0; ) {
+		if ( mFreeSets[i].mLayoutID != layoutID ) {
+			continue;
+		}
+
+		mFreeSets[i] = mFreeSets[mFreeSets.length() - 1];
+		mFreeSets.resize( mFreeSets.length() - 1 );
+	}
+
+	for ( u32 i = static_cast<u32>( mRetiredSets.length() ); i-- > 0; ) {
+		if ( mRetiredSets[i].mAllocation.mLayoutID != layoutID ) {
+			continue;
+		}
+
+		mRetiredSets[i] = mRetiredSets[mRetiredSets.length() - 1];
+		mRetiredSets.resize( mRetiredSets.length() - 1 );
+	}
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	if ( layout.mTemplate != VK_NULL_HANDLE ) {
+		mContext->DestroyDescriptorUpdateTemplate( layout.mTemplate );
+	}
+#endif
+
+	memset( &layout, 0, sizeof( layoutEntry_t ) );
+}
+
+/*
+========================
+DescriptorAllocator::PrintStats
+========================
+*/
+void DescriptorAllocator::PrintStats() const {
+	printf( "Descriptor sets: %u pages and %u transient pools, %u of %u allocations reused a freed set.\n", mNumPages, GetNumFramePools(), mNumSetsReused, mNumSetsAllocated );
+}
+
+/*
+========================
+DescriptorAllocator::GetNumFramePools
+========================
+*/
+u32 DescriptorAllocator::GetNumFramePools() const {
+	u32 numFramePools = 0;
+	for ( u32 i = 0; i < mFrames.length(); i++ ) {
+		numFramePools += mFrames[i].mNumPools;
+	}
+
+	return numFramePools;
+}
+
+/*
+========================
+DescriptorAllocator::GetLayout
+========================
+*/
+DescriptorAllocator::layoutEntry_t& DescriptorAllocator::GetLayout( const u32 layoutID ) {
+	assertf( ( layoutID < MAX_LAYOUTS ), "DescriptorAllocator was given a layout ID that's out of range!\n" );
+
+	layoutEntry_t& layout = mLayouts[layoutID];
+
+	if ( layout.mDescriptorSetLayout != VK_NULL_HANDLE ) {
+		return layout;
+	}
+
+	const RenderStateManager* renderStateManager = mContext->GetRenderStateManager();
+
+	u32 numBindings = 0;
+	const VkDescriptorSetLayoutBinding* bindings = renderStateManager->GetLayoutBindings( layoutID, numBindings );
+
+	layout.mDescriptorSetLayout = renderStateManager->GetDescriptorSetLayout( layoutID );
+	layout.mNumEntries = numBindings;
+	layout.mNumDescriptors = 0;
+
+	for ( u32 i = 0; i < numBindings; i++ ) {
+		entry_t& entry = layout.mEntries[i];
+		entry.mBinding = bindings[i].binding;
+		entry.mCount = bindings[i].descriptorCount;
+		entry.mType = bindings[i].descriptorType;
+		entry.mDataIndex = layout.mNumDescriptors;
+
+		layout.mNumDescriptors += entry.mCount;
+	}
+
+	assertf( ( layout.mNumDescriptors <= MAX_DESCRIPTORS_PER_SET ), "Uniform layout has too many descriptors, MAX_DESCRIPTORS_PER_SET needs to be bigger!\n" );
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	layout.mTemplate = VK_NULL_HANDLE;
+
+	if ( mContext->UsesDescriptorUpdateTemplates() && numBindings > 0 ) {
+		VkDescriptorUpdateTemplateEntryKHR templateEntries[MAX_DESCRIPTORS_PER_SET];
+
+		for ( u32 i = 0; i < numBindings; i++ ) {
+			const entry_t& entry = layout.mEntries[i];
+
+			templateEntries[i] = {};
+			templateEntries[i].dstBinding = entry.mBinding;
+			templateEntries[i].dstArrayElement = 0;
+			templateEntries[i].descriptorCount = entry.mCount;
+			templateEntries[i].descriptorType = entry.mType;
+			templateEntries[i].offset = entry.mDataIndex * sizeof( descriptorData_t );
+			templateEntries[i].stride = sizeof( descriptorData_t );
+		}
+
+		VkDescriptorUpdateTemplateCreateInfoKHR templateInfo = {};
+		templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+		templateInfo.descriptorUpdateEntryCount = numBindings;
+		templateInfo.pDescriptorUpdateEntries = templateEntries;
+		templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+		templateInfo.descriptorSetLayout = layout.mDescriptorSetLayout;
+		YETI_VK_CHECK( mContext->CreateDescriptorUpdateTemplate( &templateInfo, &layout.mTemplate ) );
+	}
+#endif
+
+	return layout;
+}
+
+/*
+========================
+DescriptorAllocator::CreatePool
+========================
+*/
+VkDescriptorPool DescriptorAllocator::CreatePool( const u32 maxSets, const VkDescriptorPoolCreateFlags flags ) const {
+	VkDescriptorPoolSize poolSizes[NUM_POOL_RATIOS];
+
+	for ( u32 i = 0; i < NUM_POOL_RATIOS; i++ ) {
+		poolSizes[i].type = POOL_RATIOS[i].type;
+		poolSizes[i].descriptorCount = POOL_RATIOS[i].descriptorCount * maxSets;
+	}
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = flags;
+	poolInfo.maxSets = maxSets;
+	poolInfo.poolSizeCount = NUM_POOL_RATIOS;
+	poolInfo.pPoolSizes = poolSizes;
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	YETI_VK_CHECK( vkCreateDescriptorPool( mContext->GetLogicalDevice(), &poolInfo, nullptr, &pool ) );
+
+	return pool;
+}
+
+/*
+========================
+DescriptorAllocator::TryAlloc
+========================
+*/
+bool32 DescriptorAllocator::TryAlloc( VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& outSet ) const {
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = pool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &layout;
+
+	// not checked, running out of room is expected and it's all the same whichever error the driver gives back
+	VkResult result = vkAllocateDescriptorSets( mContext->GetLogicalDevice(), &allocInfo, &outSet );
+
+	return result == VK_SUCCESS;
+}
\ No newline at end of file
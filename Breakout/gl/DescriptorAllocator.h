@@ -0,0 +1,175 @@
+#ifndef __DESCRIPTOR_ALLOCATOR_H__
+#define __DESCRIPTOR_ALLOCATOR_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+// headers from before VK_KHR_descriptor_update_template existed always write sets the old way
+#ifdef VK_KHR_descriptor_update_template
+#define YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE	1
+#else
+#define YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE	0
+#endif
+
+class VulkanContext;
+
+// one descriptor's worth of update data, a set's data is an array of these in the order GetDataIndex() says
+union descriptorData_t {
+	VkDescriptorBufferInfo				mBuffer;
+	VkDescriptorImageInfo				mImage;
+};
+
+// a set from the persistent pages, hand the whole thing back to Free()
+struct descriptorAllocation_t {
+	VkDescriptorSet						mSet;
+	u32									mLayoutID;
+	u32									mPage;
+};
+
+/*
+================================================================================================
+
+	Descriptor Allocator
+
+	Every descriptor set comes from here instead of a pool per user. Sets are allocated by the
+	RenderStateManager's layout ID, which is also what everything is cached on.
+
+	Persistent sets come out of pages of pools that are shared between every layout. When a
+	page runs out another one gets made, so nothing has to know up front how many sets of which
+	type it'll need. Freeing a set doesn't give it back to its pool. Frames in flight could still
+	be reading it, so it waits out one BeginFrame() per frame in flight and then goes on a free
+	list, and the next Alloc() for the same layout takes it straight back off again without
+	touching the driver. Nothing ever goes back to a page, so they're made without
+	VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT and the driver can hand sets out of them
+	linearly.
+
+	Transient sets come from the current frame's pools and are only valid until the same frame
+	comes round again, when the context resets them all in one go. Nothing frees them.
+
+	Sets are written with vkUpdateDescriptorSetWithTemplate() when the driver has
+	VK_KHR_descriptor_update_template, with a template made once per layout. Without it Update()
+	builds the writes from the same entries, so the data is laid out the same either way.
+
+	Main thread only.
+
+================================================================================================
+*/
+
+class DescriptorAllocator {
+public:
+	static const u32					SETS_PER_PAGE = 64;
+	static const u32					MAX_PAGES = 32;
+	static const u32					MAX_FRAME_PAGES = 8;			// per frame in flight
+	static const u32					MAX_DESCRIPTORS_PER_SET = 16;
+	static const u32					MAX_LAYOUTS = 32;				// MUST match RenderStateManager::MAX_LAYOUTS
+
+public:
+										DescriptorAllocator();
+	virtual								~DescriptorAllocator();
+
+	void								Init( VulkanContext* context, const u32 numFrames );
+	void								Shutdown();
+	inline bool32						IsInitialised() const { return mInitialised; }
+
+	// frameIndex's fence MUST have been waited on, resets the frame's pools
+	void								BeginFrame( const u32 frameIndex );
+
+	descriptorAllocation_t				Alloc( const u32 layoutID );
+	// only reused once every frame that could still be reading it has finished
+	void								Free( const descriptorAllocation_t& allocation );
+
+	// only valid until this frame comes round again
+	VkDescriptorSet						AllocTransient( const u32 layoutID );
+
+	// data MUST have GetNumDescriptors() entries, with the descriptors for each binding where GetDataIndex() says
+	void								Update( VkDescriptorSet set, const u32 layoutID, const descriptorData_t* data );
+
+	u32									GetNumDescriptors( const u32 layoutID );
+	u32									GetDataIndex( const u32 layoutID, const u32 binding );
+
+	// the RenderStateManager calls this before it destroys a layout, so its ID can be reused for something else
+	void								ForgetLayout( const u32 layoutID );
+
+	void								PrintStats() const;
+
+	inline u32							GetNumSetsAllocated() const { return mNumSetsAllocated; }
+	inline u32							GetNumSetsReused() const { return mNumSetsReused; }
+	inline u32							GetNumSetsRetired() const { return static_cast<u32>( mRetiredSets.length() ); }
+	inline u32							GetNumPages() const { return mNumPages; }
+	u32									GetNumFramePools() const;
+
+	// false writes sets with vkUpdateDescriptorSets() even when there are templates, only useful for measuring what they save
+	inline void							SetUseUpdateTemplates( const bool32 useUpdateTemplates ) { mUseUpdateTemplates = useUpdateTemplates; }
+
+private:
+	struct page_t {
+		VkDescriptorPool				mPool;
+		u32								mNumSets;
+		bool32							mFull;
+	};
+
+	// a freed set and how many more frames have to begin before it can be reused
+	struct retiredSet_t {
+		descriptorAllocation_t			mAllocation;
+		u32								mFramesLeft;
+	};
+
+	struct framePages_t {
+		VkDescriptorPool				mPools[MAX_FRAME_PAGES];
+		u32								mNumPools;
+		u32								mCurrent;
+	};
+
+	// one per binding, same as a VkDescriptorUpdateTemplateEntryKHR but there whatever the headers are
+	struct entry_t {
+		u32								mBinding;
+		u32								mCount;
+		VkDescriptorType				mType;
+		u32								mDataIndex;
+	};
+
+	struct layoutEntry_t {
+		VkDescriptorSetLayout			mDescriptorSetLayout;		// VK_NULL_HANDLE until the layout is first used
+
+		entry_t							mEntries[MAX_DESCRIPTORS_PER_SET];
+		u32								mNumEntries;
+		u32								mNumDescriptors;
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+		VkDescriptorUpdateTemplateKHR	mTemplate;
+#endif
+	};
+
+	VulkanContext*						mContext;
+
+	page_t								mPages[MAX_PAGES];
+	u32									mNumPages;
+
+	array<framePages_t>					mFrames;
+	u32									mFrameIndex;
+
+	layoutEntry_t						mLayouts[MAX_LAYOUTS];		// indexed by layout ID
+
+	// freed sets of every layout, Alloc() looks for one with the right layout ID before going to a pool
+	array<descriptorAllocation_t>		mFreeSets;
+	array<retiredSet_t>					mRetiredSets;		// moved to mFreeSets by BeginFrame()
+
+	// every Alloc() call, and how many of them came off the free list instead of a pool
+	u32									mNumSetsAllocated;
+	u32									mNumSetsReused;
+
+	bool32								mUseUpdateTemplates;
+
+	bool32								mInitialised;
+
+private:
+	layoutEntry_t&						GetLayout( const u32 layoutID );
+
+	VkDescriptorPool					CreatePool( const u32 maxSets, const VkDescriptorPoolCreateFlags flags ) const;
+
+	// false if the pool is out of room
+	bool32								TryAlloc( VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& outSet ) const;
+};
+
+#endif // __DESCRIPTOR_ALLOCATOR_H__
\ No newline at end of file
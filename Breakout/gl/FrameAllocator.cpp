@@ -0,0 +1,153 @@
+#include "FrameAllocator.h"
+#include "VulkanContext.h"
+
+/*
+================================================================================================
+
+	FrameAllocator
+
+================================================================================================
+*/
+
+/*
+========================
+FrameAllocator::FrameAllocator
+========================
+*/
+FrameAllocator::FrameAllocator() {
+	mContext = nullptr;
+
+	mBuffer = nullptr;
+
+	mRegionSizeBytes = 0;
+	mUniformAlignment = 0;
+
+	mNumFrames = 0;
+	mFrameIndex = 0;
+
+	mOffset = 0;
+	mPeakBytes = 0;
+
+	mWarnedFull = false;
+	mInitialised = false;
+}
+
+/*
+========================
+FrameAllocator::~FrameAllocator
+========================
+*/
+FrameAllocator::~FrameAllocator() {
+	Shutdown();
+}
+
+/*
+========================
+FrameAllocator::Init
+========================
+*/
+void FrameAllocator::Init( VulkanContext* context, const u32 numFrames, const u32 regionSizeKB ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call FrameAllocator::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	assertf( ( numFrames > 0 ), "FrameAllocator needs at least one frame!\n" );
+
+	mContext = context;
+
+	mNumFrames = numFrames;
+	mRegionSizeBytes = regionSizeKB * KB_TO_BYTES;
+	mUniformAlignment = static_cast<size_t>( mContext->GetActiveGPU().mProperties.limits.minUniformBufferOffsetAlignment );
+
+	printf( "Allocating %u frame regions with size %u KB each.\n", numFrames, regionSizeKB );
+
+	bufferDesc_t bufferDesc = {};
+	bufferDesc.mBufferUsage = static_cast<VkBufferUsageFlagBits>( VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT );
+	bufferDesc.mMemoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	bufferDesc.mData = nullptr;
+	bufferDesc.mDataSizeBytes = mRegionSizeBytes * mNumFrames;
+	mBuffer = new Buffer( mContext );
+	mBuffer->AllocBuffer( bufferDesc );
+
+	mFrameIndex = 0;
+	mOffset = 0;
+	mPeakBytes = 0;
+
+	mWarnedFull = false;
+	mInitialised = true;
+}
+
+/*
+========================
+FrameAllocator::Shutdown
+========================
+*/
+void FrameAllocator::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	mBuffer->UnallocBuffer();
+	YETI_FREE( mBuffer );
+
+	mInitialised = false;
+}
+
+/*
+========================
+FrameAllocator::BeginFrame
+========================
+*/
+void FrameAllocator::BeginFrame( const u32 frameIndex ) {
+	assertf( ( frameIndex < mNumFrames ), "FrameAllocator::BeginFrame() frame index is out of range!\n" );
+
+	mFrameIndex = frameIndex;
+	mOffset = 0;
+}
+
+/*
+========================
+FrameAllocator::EndFrame
+========================
+*/
+void FrameAllocator::EndFrame() {
+	if ( mOffset == 0 ) {
+		return;
+	}
+
+	mBuffer->Flush();
+}
+
+/*
+========================
+FrameAllocator::Alloc
+========================
+*/
+frameAllocation_t FrameAllocator::Alloc( const size_t sizeBytes, const size_t alignment ) {
+	assertf( ( alignment > 0 ), "FrameAllocator::Alloc() alignment MUST be > 0!\n" );
+
+	frameAllocation_t allocation = {};
+
+	size_t offset = ( ( mOffset + alignment - 1 ) / alignment ) * alignment;
+
+	if ( offset + sizeBytes > mRegionSizeBytes ) {
+		if ( !mWarnedFull ) {
+			warning( "FrameAllocator ran out of room trying to allocate %zu bytes (region is %zu bytes), the region needs to be bigger!\n", sizeBytes, mRegionSizeBytes );
+			mWarnedFull = true;
+		}
+
+		return allocation;
+	}
+
+	size_t regionStart = mFrameIndex * mRegionSizeBytes;
+
+	allocation.mData = static_cast<u8*>( mBuffer->GetMappedData() ) + regionStart + offset;
+	allocation.mBuffer = mBuffer->GetAPIHandle();
+	allocation.mOffset = regionStart + offset;
+
+	mOffset = offset + sizeBytes;
+	mPeakBytes = max( mPeakBytes, mOffset );
+
+	return allocation;
+}
\ No newline at end of file
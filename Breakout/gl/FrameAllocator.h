@@ -0,0 +1,85 @@
+#ifndef __FRAME_ALLOCATOR_H__
+#define __FRAME_ALLOCATOR_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+#include "vma/vma.h"
+
+class VulkanContext;
+class Buffer;
+
+// a piece of the current frame's region, only valid until the same frame comes round again
+struct frameAllocation_t {
+	u8*						mData;		// null if the region ran out
+	VkBuffer				mBuffer;
+	VkDeviceSize			mOffset;	// into mBuffer, for binding
+};
+
+/*
+================================================================================================
+
+	Frame Allocator
+
+	A ring of per-frame regions in one persistently mapped buffer for data that only lives for
+	a frame (vertices, indices, uniforms that get rewritten every frame, and the source of copies
+	recorded in a render graph pass). There's one region
+	per frame in flight and a frame only ever writes to its own region, so nothing can
+	be written over while an earlier frame's command buffer is still reading it.
+
+	The context calls BeginFrame() once it has waited on the fence of the frame that last used
+	the region, which is the only sync there is. Allocating is just bumping an offset.
+
+	Running out of room in a region doesn't grow anything, the allocation fails and says so
+	once, so pick the region size from GetPeakBytes().
+
+================================================================================================
+*/
+
+class FrameAllocator {
+public:
+	static const u32		DEFAULT_REGION_SIZE_KB = 1024;
+
+public:
+							FrameAllocator();
+	virtual					~FrameAllocator();
+
+	void					Init( VulkanContext* context, const u32 numFrames, const u32 regionSizeKB = DEFAULT_REGION_SIZE_KB );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	// frameIndex's fence MUST have been waited on
+	void					BeginFrame( const u32 frameIndex );
+
+	// call before submitting the frame so the writes are visible to the GPU
+	void					EndFrame();
+
+	frameAllocation_t		Alloc( const size_t sizeBytes, const size_t alignment );
+
+	// uniform buffer offsets have their own alignment rules
+	inline frameAllocation_t	AllocUniform( const size_t sizeBytes ) { return Alloc( sizeBytes, mUniformAlignment ); }
+
+	inline size_t			GetRegionSizeBytes() const { return mRegionSizeBytes; }
+	inline size_t			GetUsedBytes() const { return mOffset; }
+	inline size_t			GetPeakBytes() const { return mPeakBytes; }
+
+private:
+	VulkanContext*			mContext;
+
+	Buffer*					mBuffer;
+
+	size_t					mRegionSizeBytes;
+	size_t					mUniformAlignment;
+
+	u32						mNumFrames;
+	u32						mFrameIndex;
+
+	// into the current frame's region
+	size_t					mOffset;
+	size_t					mPeakBytes;
+
+	bool32					mWarnedFull;
+	bool32					mInitialised;
+};
+
+#endif // __FRAME_ALLOCATOR_H__
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "FrameReadback.h"
+#include "VulkanContext.h"
+#include "Buffer.h"
+
+/*
+================================================================================================
+
+	FrameReadback
+
+================================================================================================
+*/
+
+/*
+========================
+FrameReadback::FrameReadback
+========================
+*/
+FrameReadback::FrameReadback() {
+	mContext = nullptr;
+
+	mFrameIndex = 0;
+	mNumPending = 0;
+
+	mCallback = nullptr;
+	mCallbackData = nullptr;
+
+	mInitialised = false;
+}
+
+/*
+========================
+FrameReadback::~FrameReadback
+========================
+*/
+FrameReadback::~FrameReadback() {
+	Shutdown();
+}
+
+/*
+========================
+FrameReadback::Init
+========================
+*/
+void FrameReadback::Init( VulkanContext* context, const u32 numFrames ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call FrameReadback::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+
+	// the buffers are only made the first time a frame is asked for, most frames never are
+	mFrames.resize( numFrames );
+
+	for ( u32 i = 0; i < numFrames; i++ ) {
+		frameReadback_t& frame = mFrames[i];
+
+		frame.mBuffer = new Buffer( mContext );
+		frame.mSizeBytes = 0;
+		frame.mWidth = frame.mHeight = 0;
+		frame.mTag = 0;
+		frame.mPending = false;
+	}
+
+	mFrameIndex = 0;
+	mNumPending = 0;
+
+	mInitialised = true;
+}
+
+/*
+========================
+FrameReadback::Shutdown
+========================
+*/
+void FrameReadback::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	if ( mNumPending > 0 ) {
+		warning( "FrameReadback is shutting down with %u frames that were never handed back, call Flush() first to get them.\n", mNumPending );
+	}
+
+	for ( u32 i = 0; i < mFrames.length(); i++ ) {
+		frameReadback_t& frame = mFrames[i];
+
+		frame.mBuffer->UnallocBuffer();
+		YETI_FREE( frame.mBuffer );
+	}
+	mFrames.clear();
+
+	mNumPending = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+FrameReadback::SetCallback
+========================
+*/
+void FrameReadback::SetCallback( frameReadbackFunc_t func, void* data ) {
+	mCallback = func;
+	mCallbackData = data;
+}
+
+/*
+========================
+FrameReadback::Request
+========================
+*/
+void FrameReadback::Request( const u32 tag ) {
+	frameReadback_t& frame = mFrames[mFrameIndex];
+
+	if ( frame.mPending ) {
+		warning( "FrameReadback::Request() was called twice in one frame, only the first tag will be handed back.\n" );
+		return;
+	}
+
+	u32 width = mContext->GetWidth();
+	u32 height = mContext->GetHeight();
+	size_t sizeBytes = static_cast<size_t>( width ) * height * ( mContext->GetBitsPerPixelFromFormat( mContext->GetColorFormat() ) / 8 );
+
+	// this frame context's fence has been waited on, so nothing is still copying into the old one
+	if ( sizeBytes > frame.mSizeBytes ) {
+		frame.mBuffer->UnallocBuffer();
+
+		bufferDesc_t desc = {};
+		desc.mDataSizeBytes = sizeBytes;
+		desc.mBufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		desc.mMemoryUsage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+		frame.mBuffer->AllocBuffer( desc );
+
+		frame.mSizeBytes = sizeBytes;
+	}
+
+	frame.mWidth = width;
+	frame.mHeight = height;
+	frame.mTag = tag;
+	frame.mPending = true;
+
+	mNumPending++;
+
+	RenderGraph* renderGraph = mContext->GetRenderGraph();
+
+	// writing an imported buffer keeps the pass alive, and reading the back buffer puts it after the swap chain pass
+	renderGraphHandle_t buffer = renderGraph->ImportBuffer( "Readback", frame.mBuffer->GetAPIHandle() );
+
+	u32 pass = renderGraph->AddPass( "Readback", RecordReadbackPass, this );
+	renderGraph->Read( pass, mContext->GetBackBuffer(), YETI_RENDER_GRAPH_ACCESS_TRANSFER_SRC );
+	renderGraph->Write( pass, buffer, YETI_RENDER_GRAPH_ACCESS_TRANSFER_DST );
+}
+
+/*
+========================
+FrameReadback::BeginFrame
+========================
+*/
+void FrameReadback::BeginFrame( const u32 frameIndex ) {
+	assertf( ( frameIndex < mFrames.length() ), "FrameReadback::BeginFrame() frame index is out of range!\n" );
+
+	mFrameIndex = frameIndex;
+
+	frameReadback_t& frame = mFrames[mFrameIndex];
+
+	// the last time this frame was used has finished, so this never waits
+	if ( frame.mPending ) {
+		Deliver( frame );
+	}
+}
+
+/*
+========================
+FrameReadback::Flush
+========================
+*/
+void FrameReadback::Flush() {
+	if ( mNumPending == 0 ) {
+		return;
+	}
+
+	mContext->WaitDeviceIdle();
+
+	// oldest first, so the callback sees them in the order they were drawn
+	u32 numFrames = static_cast<u32>( mFrames.length() );
+
+	for ( u32 i = 0; i < numFrames; i++ ) {
+		frameReadback_t& frame = mFrames[( mContext->GetFrameIndex() + i ) % numFrames];
+
+		if ( frame.mPending ) {
+			Deliver( frame );
+		}
+	}
+}
+
+/*
+========================
+FrameReadback::Deliver
+========================
+*/
+void FrameReadback::Deliver( frameReadback_t& frame ) {
+	frame.mBuffer->Invalidate();
+
+	if ( mCallback ) {
+		mCallback( static_cast<const u8*>( frame.mBuffer->GetMappedData() ), frame.mWidth, frame.mHeight, frame.mTag, mCallbackData );
+	}
+
+	frame.mPending = false;
+	mNumPending--;
+}
+
+/*
+========================
+FrameReadback::RecordReadbackPass
+========================
+*/
+void FrameReadback::RecordReadbackPass( VkCommandBuffer commandBuffer, void* data ) {
+	FrameReadback* readback = static_cast<FrameReadback*>( data );
+	VulkanContext* context = readback->mContext;
+
+	const frameReadback_t& frame = readback->mFrames[readback->mFrameIndex];
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = frame.mWidth;
+	region.imageExtent.height = frame.mHeight;
+	region.imageExtent.depth = 1;
+
+	VkImage backBuffer = context->GetRenderGraph()->GetImage( context->GetBackBuffer() );
+	VkBuffer buffer = frame.mBuffer->GetAPIHandle();
+	vkCmdCopyImageToBuffer( commandBuffer, backBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region );
+
+	// the graph has no host access, and waiting on the fence alone doesn't make the copy visible to the CPU
+	VkBufferMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr );
+}
\ No newline at end of file
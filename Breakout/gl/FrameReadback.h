@@ -0,0 +1,78 @@
+#ifndef __FRAME_READBACK_H__
+#define __FRAME_READBACK_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+class VulkanContext;
+class Buffer;
+
+// pixels are tightly packed rows in the context's GetColorFormat(), and only valid until this returns
+typedef void ( *frameReadbackFunc_t )( const u8* pixels, const u32 width, const u32 height, const u32 tag, void* data );
+
+/*
+================================================================================================
+
+	Frame Readback
+
+	Copies the back buffer into a host visible buffer at the end of a frame, for a headless
+	context to get its frames out without a window. Each frame in flight gets its own buffer,
+	and the copy is its own render graph pass after the swap chain pass, so asking for one
+	never waits on the GPU. The pixels are handed to the callback once the same frame context
+	comes round again and the context has waited on its fence, so they arrive
+	RENDERER_NUM_FRAMES_IN_FLIGHT frames late with the tag they were asked for with.
+
+================================================================================================
+*/
+
+class FrameReadback {
+public:
+							FrameReadback();
+	virtual					~FrameReadback();
+
+	void					Init( VulkanContext* context, const u32 numFrames );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	void					SetCallback( frameReadbackFunc_t func, void* data );
+
+	// between Clear() and Present() only, reads back the current frame once it's drawn
+	void					Request( const u32 tag );
+
+	// frameIndex's fence MUST have been waited on, hands the last readback it made to the callback
+	void					BeginFrame( const u32 frameIndex );
+
+	// waits for the GPU and hands back everything still in flight, MUST NOT be called between Clear() and Present()
+	void					Flush();
+
+	inline u32				GetNumPending() const { return mNumPending; }
+
+private:
+	struct frameReadback_t {
+		Buffer*				mBuffer;
+		size_t				mSizeBytes;
+		u32					mWidth, mHeight;
+		u32					mTag;
+		bool32				mPending;
+	};
+
+	VulkanContext*			mContext;
+
+	array<frameReadback_t>	mFrames;
+	u32						mFrameIndex;
+	u32						mNumPending;
+
+	frameReadbackFunc_t		mCallback;
+	void*					mCallbackData;
+
+	bool32					mInitialised;
+
+private:
+	void					Deliver( frameReadback_t& frame );
+
+	// the render graph's pass func for the copy, data is the readback
+	static void				RecordReadbackPass( VkCommandBuffer commandBuffer, void* data );
+};
+
+#endif // __FRAME_READBACK_H__
\ No newline at end of file
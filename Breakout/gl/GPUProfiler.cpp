@@ -0,0 +1,224 @@
+#include "GPUProfiler.h"
+#include "VulkanContext.h"
+
+/*
+================================================================================================
+
+	GPUProfiler
+
+================================================================================================
+*/
+
+/*
+========================
+GPUProfiler::GPUProfiler
+========================
+*/
+GPUProfiler::GPUProfiler() {
+	mContext = nullptr;
+
+	mFrameIndex = 0;
+
+	memset( mResults, 0, sizeof( mResults ) );
+	mNumResults = 0;
+
+	mNanosecondsPerTick = 0.0;
+	mTimestampMask = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+GPUProfiler::~GPUProfiler
+========================
+*/
+GPUProfiler::~GPUProfiler() {
+	Shutdown();
+}
+
+/*
+========================
+GPUProfiler::Init
+========================
+*/
+void GPUProfiler::Init( VulkanContext* context, const u32 numFrames ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call GPUProfiler::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+
+	const gpuInfo_t& gpu = mContext->GetActiveGPU();
+	u32 validBits = gpu.mQueueFamilyProperties[mContext->GetQueueIndex( YETI_QUEUE_TYPE_GRAPHICS )].timestampValidBits;
+
+	if ( validBits == 0 ) {
+		warning( "The graphics queue doesn't support timestamps, GPU profiling is disabled.\n" );
+		mTimestampMask = 0;
+	} else {
+		mTimestampMask = ( validBits >= 64 ) ? U64_MAX : ( ( 1ull << validBits ) - 1 );
+	}
+
+	mNanosecondsPerTick = static_cast<float64>( gpu.mProperties.limits.timestampPeriod );
+
+	VkQueryPoolCreateInfo queryPoolInfo = {};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolInfo.queryCount = MAX_SCOPES * 2;
+
+	mFrames.resize( numFrames );
+
+	for ( u32 i = 0; i < numFrames; i++ ) {
+		frameQueries_t& frame = mFrames[i];
+
+		YETI_VK_CHECK( vkCreateQueryPool( mContext->GetLogicalDevice(), &queryPoolInfo, nullptr, &frame.mQueryPool ) );
+		frame.mNumScopes = 0;
+		frame.mRecorded = false;
+	}
+
+	mFrameIndex = 0;
+	mNumResults = 0;
+
+	mInitialised = true;
+}
+
+/*
+========================
+GPUProfiler::Shutdown
+========================
+*/
+void GPUProfiler::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	for ( u32 i = 0; i < mFrames.length(); i++ ) {
+		vkDestroyQueryPool( mContext->GetLogicalDevice(), mFrames[i].mQueryPool, nullptr );
+		mFrames[i].mQueryPool = VK_NULL_HANDLE;
+	}
+	mFrames.clear();
+
+	mInitialised = false;
+}
+
+/*
+========================
+GPUProfiler::BeginFrame
+========================
+*/
+void GPUProfiler::BeginFrame( VkCommandBuffer commandBuffer, const u32 frameIndex ) {
+	assertf( ( frameIndex < mFrames.length() ), "GPUProfiler::BeginFrame() frame index is out of range!\n" );
+
+	mFrameIndex = frameIndex;
+
+	frameQueries_t& frame = mFrames[mFrameIndex];
+
+	// the last time this frame was used has finished, so this never waits
+	if ( frame.mRecorded ) {
+		ReadResults( frame );
+	}
+
+	vkCmdResetQueryPool( commandBuffer, frame.mQueryPool, 0, MAX_SCOPES * 2 );
+
+	frame.mNumScopes = 0;
+	frame.mRecorded = true;
+}
+
+/*
+========================
+GPUProfiler::BeginScope
+========================
+*/
+u32 GPUProfiler::BeginScope( VkCommandBuffer commandBuffer, const char* name ) {
+	frameQueries_t& frame = mFrames[mFrameIndex];
+
+	if ( !IsSupported() || frame.mNumScopes >= MAX_SCOPES ) {
+		return INVALID_SCOPE;
+	}
+
+	u32 scope = frame.mNumScopes++;
+	frame.mScopeNames[scope] = name;
+
+	vkCmdWriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.mQueryPool, scope * 2 );
+
+	return scope;
+}
+
+/*
+========================
+GPUProfiler::EndScope
+========================
+*/
+void GPUProfiler::EndScope( VkCommandBuffer commandBuffer, const u32 scope ) {
+	if ( scope == INVALID_SCOPE ) {
+		return;
+	}
+
+	frameQueries_t& frame = mFrames[mFrameIndex];
+
+	vkCmdWriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.mQueryPool, scope * 2 + 1 );
+}
+
+/*
+========================
+GPUProfiler::ReadResults
+========================
+*/
+void GPUProfiler::ReadResults( frameQueries_t& frame ) {
+	if ( frame.mNumScopes == 0 ) {
+		return;
+	}
+
+	u64 timestamps[MAX_SCOPES * 2] = {};
+
+	// no wait bit, if they somehow aren't there yet this frame's numbers just get skipped
+	VkResult result = vkGetQueryPoolResults( mContext->GetLogicalDevice(), frame.mQueryPool, 0, frame.mNumScopes * 2,
+		sizeof( timestamps ), timestamps, sizeof( u64 ), VK_QUERY_RESULT_64_BIT );
+
+	if ( result != VK_SUCCESS ) {
+		return;
+	}
+
+	for ( u32 scope = 0; scope < frame.mNumScopes; scope++ ) {
+		gpuScopeTiming_t* timing = FindResult( frame.mScopeNames[scope] );
+		if ( !timing ) {
+			continue;
+		}
+
+		u64 ticks = ( timestamps[scope * 2 + 1] - timestamps[scope * 2] ) & mTimestampMask;
+		float32 milliseconds = static_cast<float32>( ticks * mNanosecondsPerTick / 1000000.0 );
+
+		timing->mMilliseconds = milliseconds;
+
+		if ( timing->mAverageMilliseconds == 0.0f ) {
+			timing->mAverageMilliseconds = milliseconds;
+		} else {
+			timing->mAverageMilliseconds += ( milliseconds - timing->mAverageMilliseconds ) * 0.05f;
+		}
+	}
+}
+
+/*
+========================
+GPUProfiler::FindResult
+========================
+*/
+gpuScopeTiming_t* GPUProfiler::FindResult( const char* name ) {
+	for ( u32 i = 0; i < mNumResults; i++ ) {
+		if ( strcmp( mResults[i].mName, name ) == 0 ) {
+			return &mResults[i];
+		}
+	}
+
+	if ( mNumResults >= MAX_SCOPES ) {
+		return nullptr;
+	}
+
+	gpuScopeTiming_t& timing = mResults[mNumResults++];
+	timing.mName = name;
+	timing.mMilliseconds = 0.0f;
+	timing.mAverageMilliseconds = 0.0f;
+
+	return &timing;
+}
\ No newline at end of file
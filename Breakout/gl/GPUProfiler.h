@@ -0,0 +1,84 @@
+#ifndef __GPU_PROFILER_H__
+#define __GPU_PROFILER_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+class VulkanContext;
+
+struct gpuScopeTiming_t {
+	const char*				mName;
+	float32					mMilliseconds;			// the most recent frame that's been read back
+	float32					mAverageMilliseconds;	// smoothed over the last few frames so it's readable
+};
+
+/*
+================================================================================================
+
+	GPU Profiler
+
+	Times named scopes of a frame's command buffer with timestamp queries. Each frame in flight
+	gets its own query pool, and a frame's results are only read once the same frame comes
+	round again and the context has waited on its fence. So the numbers are
+	RENDERER_NUM_FRAMES_IN_FLIGHT frames old, but reading them never waits on the GPU.
+
+	Scopes are looked up by name, so the names MUST be string literals or otherwise outlive the
+	profiler. Scopes don't nest.
+
+================================================================================================
+*/
+
+class GPUProfiler {
+public:
+	static const u32		MAX_SCOPES = 16;
+
+	// returned by BeginScope() when there's no room left or timestamps aren't supported
+	static const u32		INVALID_SCOPE = U32_MAX;
+
+public:
+							GPUProfiler();
+	virtual					~GPUProfiler();
+
+	void					Init( VulkanContext* context, const u32 numFrames );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	inline bool32			IsSupported() const { return mTimestampMask != 0; }
+
+	// frameIndex's fence MUST have been waited on, commandBuffer MUST be recording and outside a render pass
+	void					BeginFrame( VkCommandBuffer commandBuffer, const u32 frameIndex );
+
+	u32						BeginScope( VkCommandBuffer commandBuffer, const char* name );
+	void					EndScope( VkCommandBuffer commandBuffer, const u32 scope );
+
+	inline u32				GetNumScopes() const { return mNumResults; }
+	inline const gpuScopeTiming_t&	GetScope( const u32 index ) const { return mResults[index]; }
+
+private:
+	struct frameQueries_t {
+		VkQueryPool			mQueryPool;
+		const char*			mScopeNames[MAX_SCOPES];
+		u32					mNumScopes;
+		bool32				mRecorded;
+	};
+
+	VulkanContext*			mContext;
+
+	array<frameQueries_t>	mFrames;
+	u32						mFrameIndex;
+
+	gpuScopeTiming_t		mResults[MAX_SCOPES];
+	u32						mNumResults;
+
+	float64					mNanosecondsPerTick;
+	u64						mTimestampMask;
+
+	bool32					mInitialised;
+
+private:
+	void					ReadResults( frameQueries_t& frame );
+	gpuScopeTiming_t*		FindResult( const char* name );
+};
+
+#endif // __GPU_PROFILER_H__
\ No newline at end of file
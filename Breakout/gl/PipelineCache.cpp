@@ -0,0 +1,261 @@
+#include "PipelineCache.h"
+#include "VulkanContext.h"
+
+const u32 PipelineCache::FILE_MAGIC = 0x43504B42;	// "BKPC"
+const u32 PipelineCache::FILE_VERSION = 1;
+
+/*
+========================
+HashBytes
+========================
+*/
+static u32 HashBytes( const u8* data, const size_t sizeBytes ) {
+	// FNV-1a, only has to catch a truncated or scribbled file
+	u32 hash = 0x811C9DC5;
+
+	for ( size_t i = 0; i < sizeBytes; i++ ) {
+		hash ^= data[i];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+/*
+================================================================================================
+
+	PipelineCache
+
+================================================================================================
+*/
+
+/*
+========================
+PipelineCache::PipelineCache
+========================
+*/
+PipelineCache::PipelineCache() {
+	mContext = nullptr;
+
+	mPipelineCache = VK_NULL_HANDLE;
+
+	mSaveData = nullptr;
+	mSaveSizeBytes = 0;
+
+	mFilename = nullptr;
+
+	mLoadedSizeBytes = 0;
+
+	mNumPipelines = 0;
+	mPipelineMilliseconds = 0.0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+PipelineCache::~PipelineCache
+========================
+*/
+PipelineCache::~PipelineCache() {
+	Shutdown();
+}
+
+/*
+========================
+PipelineCache::Init
+========================
+*/
+void PipelineCache::Init( VulkanContext* context, const char* filename ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call PipelineCache::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+	mFilename = filename;
+
+	char* fileData = nullptr;
+	size_t fileSizeBytes = 0;
+
+	if ( mFilename ) {
+		fileSizeBytes = readEntireFile( mFilename, &fileData );
+	}
+
+	const u8* data = reinterpret_cast<const u8*>( fileData );
+
+	VkPipelineCacheCreateInfo pipelineCacheInfo = {};
+	pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+	if ( fileSizeBytes > 0 && IsValidFile( data, fileSizeBytes ) ) {
+		pipelineCacheInfo.initialDataSize = fileSizeBytes - sizeof( pipelineCacheFileHeader_t );
+		pipelineCacheInfo.pInitialData = data + sizeof( pipelineCacheFileHeader_t );
+	}
+
+	YETI_VK_CHECK( vkCreatePipelineCache( mContext->GetLogicalDevice(), &pipelineCacheInfo, nullptr, &mPipelineCache ) );
+
+	mLoadedSizeBytes = pipelineCacheInfo.initialDataSize;
+
+	// the driver copies the initial data
+	YETI_FREE_ARRAY( fileData );
+
+	mNumPipelines = 0;
+	mPipelineMilliseconds = 0.0;
+
+	mInitialised = true;
+}
+
+/*
+========================
+PipelineCache::Shutdown
+========================
+*/
+void PipelineCache::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	if ( mSaveThread.joinable() ) {
+		mSaveThread.join();
+	}
+
+	YETI_FREE_ARRAY( mSaveData );
+	mSaveSizeBytes = 0;
+
+	// only still here if SaveAsync() never got called
+	if ( mPipelineCache != VK_NULL_HANDLE ) {
+		vkDestroyPipelineCache( mContext->GetLogicalDevice(), mPipelineCache, nullptr );
+		mPipelineCache = VK_NULL_HANDLE;
+	}
+
+	mInitialised = false;
+}
+
+/*
+========================
+PipelineCache::SaveAsync
+========================
+*/
+void PipelineCache::SaveAsync() {
+	if ( mPipelineCache == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	VkDevice logicalDevice = mContext->GetLogicalDevice();
+
+	size_t dataSizeBytes = 0;
+
+	if ( mFilename ) {
+		YETI_VK_CHECK( vkGetPipelineCacheData( logicalDevice, mPipelineCache, &dataSizeBytes, nullptr ) );
+	}
+
+	if ( dataSizeBytes > 0 ) {
+		const VkPhysicalDeviceProperties& properties = mContext->GetActiveGPU().mProperties;
+
+		mSaveSizeBytes = sizeof( pipelineCacheFileHeader_t ) + dataSizeBytes;
+		mSaveData = new u8[mSaveSizeBytes];
+
+		u8* data = mSaveData + sizeof( pipelineCacheFileHeader_t );
+		YETI_VK_CHECK( vkGetPipelineCacheData( logicalDevice, mPipelineCache, &dataSizeBytes, data ) );
+
+		pipelineCacheFileHeader_t* header = reinterpret_cast<pipelineCacheFileHeader_t*>( mSaveData );
+		header->mMagic = FILE_MAGIC;
+		header->mVersion = FILE_VERSION;
+		header->mDataSizeBytes = static_cast<u32>( dataSizeBytes );
+		header->mDataHash = HashBytes( data, dataSizeBytes );
+		header->mVendorID = properties.vendorID;
+		header->mDeviceID = properties.deviceID;
+		header->mDriverVersion = properties.driverVersion;
+		memcpy( header->mPipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE );
+
+		// the second call can hand back less than it asked for
+		mSaveSizeBytes = sizeof( pipelineCacheFileHeader_t ) + dataSizeBytes;
+
+		mSaveThread = std::thread( WriteFile, this );
+	}
+
+	vkDestroyPipelineCache( logicalDevice, mPipelineCache, nullptr );
+	mPipelineCache = VK_NULL_HANDLE;
+}
+
+/*
+========================
+PipelineCache::AddPipelineTime
+========================
+*/
+void PipelineCache::AddPipelineTime( const float64 milliseconds ) {
+	mNumPipelines++;
+	mPipelineMilliseconds += milliseconds;
+}
+
+/*
+========================
+PipelineCache::PrintStats
+========================
+*/
+void PipelineCache::PrintStats() const {
+	if ( !mFilename ) {
+		printf( "Pipeline cache is off, %u pipelines took %f ms to create.\n", mNumPipelines, mPipelineMilliseconds );
+	} else if ( mLoadedSizeBytes == 0 ) {
+		printf( "Pipeline cache started empty, %u pipelines took %f ms to create.\n", mNumPipelines, mPipelineMilliseconds );
+	} else {
+		printf( "Pipeline cache loaded %zu KB from %s, %u pipelines took %f ms to create.\n", mLoadedSizeBytes / KB_TO_BYTES, mFilename, mNumPipelines, mPipelineMilliseconds );
+	}
+}
+
+/*
+========================
+PipelineCache::IsValidFile
+========================
+*/
+bool32 PipelineCache::IsValidFile( const u8* data, const size_t sizeBytes ) const {
+	if ( sizeBytes < sizeof( pipelineCacheFileHeader_t ) ) {
+		warning( "Pipeline cache %s is too small to be a pipeline cache, ignoring it.\n", mFilename );
+		return false;
+	}
+
+	const pipelineCacheFileHeader_t* header = reinterpret_cast<const pipelineCacheFileHeader_t*>( data );
+
+	if ( header->mMagic != FILE_MAGIC || header->mVersion != FILE_VERSION ) {
+		printf( "Pipeline cache %s is from a different version of the game, ignoring it.\n", mFilename );
+		return false;
+	}
+
+	const VkPhysicalDeviceProperties& properties = mContext->GetActiveGPU().mProperties;
+
+	// not an error, it just means the GPU or the driver changed since it was written
+	if ( header->mVendorID != properties.vendorID || header->mDeviceID != properties.deviceID || header->mDriverVersion != properties.driverVersion ||
+		memcmp( header->mPipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE ) != 0 ) {
+		printf( "Pipeline cache %s was written by a different GPU or driver, ignoring it.\n", mFilename );
+		return false;
+	}
+
+	const u8* blob = data + sizeof( pipelineCacheFileHeader_t );
+	size_t blobSizeBytes = sizeBytes - sizeof( pipelineCacheFileHeader_t );
+
+	if ( header->mDataSizeBytes != blobSizeBytes || header->mDataHash != HashBytes( blob, blobSizeBytes ) ) {
+		warning( "Pipeline cache %s is corrupt, ignoring it.\n", mFilename );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+========================
+PipelineCache::WriteFile
+========================
+*/
+void PipelineCache::WriteFile( PipelineCache* cache ) {
+	// the mstd file functions can't truncate an existing file
+	FILE* file = fopen( cache->mFilename, "wb" );
+	bool32 result = file && fwrite( cache->mSaveData, cache->mSaveSizeBytes, 1, file ) == 1;
+
+	if ( file ) {
+		fclose( file );
+	}
+
+	if ( !result ) {
+		warning( "Unable to write pipeline cache %s, pipelines will be built from scratch next time.\n", cache->mFilename );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef __PIPELINE_CACHE_H__
+#define __PIPELINE_CACHE_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+#include <thread>
+
+class VulkanContext;
+
+// goes in front of the driver's blob so a stale or foreign file gets thrown away before the driver sees it
+struct pipelineCacheFileHeader_t {
+	u32						mMagic;
+	u32						mVersion;
+	u32						mDataSizeBytes;
+	u32						mDataHash;
+
+	u32						mVendorID;
+	u32						mDeviceID;
+	u32						mDriverVersion;
+	u8						mPipelineCacheUUID[VK_UUID_SIZE];
+};
+
+/*
+================================================================================================
+
+	Pipeline Cache
+
+	Owns the VkPipelineCache every pipeline gets created through, and keeps it on disk between
+	runs so the driver doesn't have to compile the same pipelines from scratch every launch.
+
+	The file is only used if it was written by the same GPU and driver, going by the vendor,
+	device, driver version, and pipeline cache UUID in its header. Anything else just means
+	starting with an empty cache, it's never an error.
+
+	Saving pulls the data out of the driver on the calling thread and then writes the file on
+	another one, so the rest of shutdown doesn't wait on the disk. Shutdown() waits for it.
+
+================================================================================================
+*/
+
+class PipelineCache {
+public:
+	static const u32		FILE_MAGIC;
+	static const u32		FILE_VERSION;
+
+public:
+							PipelineCache();
+	virtual					~PipelineCache();
+
+	// filename MUST outlive the cache, null means pipelines still go through a cache but it never touches the disk
+	void					Init( VulkanContext* context, const char* filename );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	inline VkPipelineCache	GetAPIHandle() const { return mPipelineCache; }
+
+	// destroys the VkPipelineCache, so no pipelines can be created after this
+	void					SaveAsync();
+
+	// for the startup report
+	void					AddPipelineTime( const float64 milliseconds );
+	void					PrintStats() const;
+
+private:
+	VulkanContext*			mContext;
+
+	VkPipelineCache			mPipelineCache;
+
+	std::thread				mSaveThread;
+	u8*						mSaveData;			// header and blob, owned by the save thread until it's joined
+	size_t					mSaveSizeBytes;
+
+	const char*				mFilename;
+
+	size_t					mLoadedSizeBytes;	// 0 if the cache started empty
+
+	u32						mNumPipelines;
+	float64					mPipelineMilliseconds;
+
+	bool32					mInitialised;
+
+private:
+	bool32					IsValidFile( const u8* data, const size_t sizeBytes ) const;
+
+	static void				WriteFile( PipelineCache* cache );
+};
+
+#endif // __PIPELINE_CACHE_H__
\ No newline at end of file
@@ -0,0 +1,1093 @@
+#include "RenderGraph.h"
+#include "VulkanContext.h"
+
+// what the barriers need to know about each access
+struct accessInfo_t {
+	VkPipelineStageFlags	mStages;
+	VkAccessFlags			mAccess;
+	VkImageLayout			mLayout;		// VK_IMAGE_LAYOUT_UNDEFINED for buffer accesses
+	VkImageUsageFlags		mImageUsage;	// what a transient has to be created with to be used like this
+	bool32					mWrite;
+};
+
+static const accessInfo_t ACCESS_INFOS[YETI_RENDER_GRAPH_ACCESS_COUNT] = {
+	// YETI_RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT
+	{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true },
+
+	// YETI_RENDER_GRAPH_ACCESS_SAMPLED
+	{ VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false },
+
+	// YETI_RENDER_GRAPH_ACCESS_TRANSFER_SRC
+	{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false },
+
+	// YETI_RENDER_GRAPH_ACCESS_TRANSFER_DST
+	{ VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, true },
+
+	// YETI_RENDER_GRAPH_ACCESS_VERTEX_BUFFER
+	{ VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, false },
+
+	// YETI_RENDER_GRAPH_ACCESS_INDEX_BUFFER
+	{ VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, false },
+
+	// YETI_RENDER_GRAPH_ACCESS_UNIFORM_BUFFER
+	{ VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, false },
+
+	// YETI_RENDER_GRAPH_ACCESS_STORAGE_BUFFER
+	{ VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, false },
+};
+
+// only writes have to be made available, reads just need the execution dependency
+static const VkAccessFlags WRITE_ACCESS_MASK = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+static VkDeviceSize AlignUp( const VkDeviceSize offset, const VkDeviceSize alignment ) {
+	return ( offset + alignment - 1 ) & ~( alignment - 1 );
+}
+
+/*
+================================================================================================
+
+	RenderGraph
+
+================================================================================================
+*/
+
+/*
+========================
+RenderGraph::RenderGraph
+========================
+*/
+RenderGraph::RenderGraph() {
+	mContext = nullptr;
+
+	mNumPasses = 0;
+	mNumResources = 0;
+	mNumOrdered = 0;
+
+	memset( &mTransients, 0, sizeof( transientSet_t ) );
+	mNumRetiredTransients = 0;
+
+	mNumImportedBuffers = 0;
+	mNumRenderPasses = 0;
+
+	mStats = {};
+
+	mNumFrames = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+RenderGraph::~RenderGraph
+========================
+*/
+RenderGraph::~RenderGraph() {
+	Shutdown();
+}
+
+/*
+========================
+RenderGraph::Init
+========================
+*/
+void RenderGraph::Init( VulkanContext* context, const u32 numFrames ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call RenderGraph::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+	mNumFrames = numFrames;
+
+	mNumPasses = 0;
+	mNumResources = 0;
+	mNumOrdered = 0;
+
+	memset( &mTransients, 0, sizeof( transientSet_t ) );
+	mNumRetiredTransients = 0;
+
+	mNumImportedBuffers = 0;
+	mNumRenderPasses = 0;
+
+	mStats = {};
+
+	mInitialised = true;
+}
+
+/*
+========================
+RenderGraph::Shutdown
+========================
+*/
+void RenderGraph::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	// the context has already waited for the device to go idle
+	DestroyTransients( mTransients );
+
+	for ( u32 i = 0; i < mNumRetiredTransients; i++ ) {
+		DestroyTransients( mRetiredTransients[i] );
+	}
+	mNumRetiredTransients = 0;
+
+	for ( u32 i = 0; i < mNumRenderPasses; i++ ) {
+		vkDestroyRenderPass( mContext->GetLogicalDevice(), mRenderPasses[i].mRenderPass, nullptr );
+	}
+	mNumRenderPasses = 0;
+
+	mNumImportedBuffers = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+RenderGraph::BeginFrame
+========================
+*/
+void RenderGraph::BeginFrame() {
+	mNumPasses = 0;
+	mNumResources = 0;
+	mNumOrdered = 0;
+
+	// a retired set is only safe to destroy once every frame that could have used it has been waited on
+	u32 i = 0;
+	while ( i < mNumRetiredTransients ) {
+		transientSet_t& set = mRetiredTransients[i];
+
+		set.mFramesLeft--;
+
+		if ( set.mFramesLeft > 0 ) {
+			i++;
+			continue;
+		}
+
+		DestroyTransients( set );
+
+		mRetiredTransients[i] = mRetiredTransients[mNumRetiredTransients - 1];
+		mNumRetiredTransients--;
+	}
+}
+
+/*
+========================
+RenderGraph::ImportImage
+========================
+*/
+renderGraphHandle_t RenderGraph::ImportImage( const char* name, VkImage image, VkImageView imageView, const VkFormat format, const u32 width, const u32 height,
+	const VkImageLayout initialLayout, const VkImageLayout finalLayout ) {
+	renderGraphHandle_t handle = AddResource( name, RESOURCE_TYPE_IMPORTED_IMAGE );
+	resource_t& resource = mResources[handle];
+
+	resource.mImage = image;
+	resource.mImageView = imageView;
+	resource.mDesc.mFormat = format;
+	resource.mDesc.mWidth = width;
+	resource.mDesc.mHeight = height;
+	resource.mLayout = initialLayout;
+	resource.mFinalLayout = finalLayout;
+
+	// nothing's known about whoever put it in that layout, so the first access waits on everything
+	if ( initialLayout != VK_IMAGE_LAYOUT_UNDEFINED ) {
+		resource.mWriteStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		resource.mWriteAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+	}
+
+	return handle;
+}
+
+/*
+========================
+RenderGraph::ImportBuffer
+========================
+*/
+renderGraphHandle_t RenderGraph::ImportBuffer( const char* name, VkBuffer buffer ) {
+	renderGraphHandle_t handle = AddResource( name, RESOURCE_TYPE_IMPORTED_BUFFER );
+	resource_t& resource = mResources[handle];
+
+	resource.mBuffer = buffer;
+
+	const importedBufferState_t* history = FindImportedBuffer( buffer );
+
+	if ( history ) {
+		resource.mWriteStages = history->mWriteStages;
+		resource.mWriteAccess = history->mWriteAccess;
+		resource.mReadStages = history->mReadStages;
+		resource.mVisibleStages = history->mVisibleStages;
+		resource.mVisibleAccess = history->mVisibleAccess;
+	} else {
+		// never seen it before, so assume the worst
+		resource.mWriteStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		resource.mWriteAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+	}
+
+	return handle;
+}
+
+/*
+========================
+RenderGraph::CreateImage
+========================
+*/
+renderGraphHandle_t RenderGraph::CreateImage( const char* name, const renderGraphImageDesc_t& desc ) {
+	renderGraphHandle_t handle = AddResource( name, RESOURCE_TYPE_TRANSIENT_IMAGE );
+
+	// the usage its accesses need gets added to this as they're declared
+	mResources[handle].mDesc = desc;
+
+	return handle;
+}
+
+/*
+========================
+RenderGraph::AddPass
+========================
+*/
+u32 RenderGraph::AddPass( const char* name, renderGraphPassFunc_t func, void* data ) {
+	assertf( ( mNumPasses < MAX_PASSES ), "RenderGraph ran out of passes this frame, increase MAX_PASSES!\n" );
+
+	u32 index = mNumPasses++;
+
+	pass_t& pass = mPasses[index];
+	pass.mName = name;
+	pass.mFunc = func;
+	pass.mData = data;
+	pass.mNumAccesses = 0;
+	pass.mColorAttachment = INVALID_HANDLE;
+	pass.mClearValue = {};
+	pass.mClear = false;
+	pass.mLive = false;
+
+	return index;
+}
+
+/*
+========================
+RenderGraph::Read
+========================
+*/
+void RenderGraph::Read( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access ) {
+	assertf( ( !ACCESS_INFOS[access].mWrite ), "RenderGraph::Read() was given an access that writes!\n" );
+
+	AddAccess( pass, resource, access );
+}
+
+/*
+========================
+RenderGraph::Write
+========================
+*/
+void RenderGraph::Write( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access ) {
+	assertf( ( ACCESS_INFOS[access].mWrite ), "RenderGraph::Write() was given an access that only reads!\n" );
+
+	AddAccess( pass, resource, access );
+}
+
+/*
+========================
+RenderGraph::SetColorAttachment
+========================
+*/
+void RenderGraph::SetColorAttachment( const u32 pass, const renderGraphHandle_t resource, const VkClearValue* clearValue ) {
+	pass_t& p = mPasses[pass];
+
+	assertf( ( p.mColorAttachment == INVALID_HANDLE ), "RenderGraph passes can only have one color attachment!\n" );
+
+	AddAccess( pass, resource, YETI_RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT );
+
+	p.mColorAttachment = resource;
+	p.mClear = clearValue != nullptr;
+
+	if ( clearValue ) {
+		p.mClearValue = *clearValue;
+	}
+}
+
+/*
+========================
+RenderGraph::Execute
+========================
+*/
+void RenderGraph::Execute( VkCommandBuffer commandBuffer ) {
+	mStats = {};
+
+	SortPasses();
+	CullPasses();
+	PlaceTransients();
+
+	for ( u32 i = 0; i < mNumOrdered; i++ ) {
+		const pass_t& pass = mPasses[mOrder[i]];
+
+		RecordBarriers( commandBuffer, pass );
+		RecordPass( commandBuffer, pass );
+	}
+
+	RecordFinalBarriers( commandBuffer );
+
+	mStats.mTransientBytes = mTransients.mSizeBytes;
+	mStats.mTransientBytesUnaliased = mTransients.mSizeBytesUnaliased;
+}
+
+/*
+========================
+RenderGraph::AddResource
+========================
+*/
+renderGraphHandle_t RenderGraph::AddResource( const char* name, const resourceType_t type ) {
+	assertf( ( mNumResources < MAX_RESOURCES ), "RenderGraph ran out of resources this frame, increase MAX_RESOURCES!\n" );
+
+	renderGraphHandle_t handle = mNumResources++;
+
+	resource_t& resource = mResources[handle];
+	memset( &resource, 0, sizeof( resource_t ) );
+
+	resource.mName = name;
+	resource.mType = type;
+	resource.mLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	resource.mFinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	resource.mFirstPass = U32_MAX;
+	resource.mTransientIndex = U32_MAX;
+
+	return handle;
+}
+
+/*
+========================
+RenderGraph::AddAccess
+========================
+*/
+void RenderGraph::AddAccess( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access ) {
+	assertf( ( pass < mNumPasses ), "RenderGraph pass index is out of range!\n" );
+	assertf( ( resource < mNumResources ), "RenderGraph resource handle is out of range, it might be from last frame!\n" );
+
+	pass_t& p = mPasses[pass];
+	resource_t& r = mResources[resource];
+	const accessInfo_t& info = ACCESS_INFOS[access];
+
+	bool32 isImage = r.mType != RESOURCE_TYPE_IMPORTED_BUFFER;
+
+	assertf( ( isImage == ( info.mLayout != VK_IMAGE_LAYOUT_UNDEFINED ) ), "RenderGraph access doesn't match the resource, images and buffers have their own accesses!\n" );
+	assertf( ( p.mNumAccesses < MAX_PASS_ACCESSES ), "RenderGraph pass has too many accesses, increase MAX_PASS_ACCESSES!\n" );
+
+	// an image can only be in one layout for the whole pass
+	if ( isImage ) {
+		for ( u32 i = 0; i < p.mNumAccesses; i++ ) {
+			assertf( ( p.mAccesses[i].mResource != resource ), "RenderGraph passes can only access an image one way!\n" );
+		}
+	}
+
+	if ( r.mType == RESOURCE_TYPE_TRANSIENT_IMAGE ) {
+		r.mDesc.mUsage |= info.mImageUsage;
+	}
+
+	p.mAccesses[p.mNumAccesses].mResource = resource;
+	p.mAccesses[p.mNumAccesses].mAccess = access;
+	p.mNumAccesses++;
+}
+
+/*
+========================
+RenderGraph::SortPasses
+========================
+*/
+void RenderGraph::SortPasses() {
+	static_assert( MAX_PASSES <= 32, "RenderGraph pass dependencies are a u32 mask, so MAX_PASSES can't go over 32!" );
+
+	// bit j set means pass j has to run first
+	u32 dependencies[MAX_PASSES];
+
+	for ( u32 i = 0; i < mNumPasses; i++ ) {
+		const pass_t& pass = mPasses[i];
+
+		dependencies[i] = 0;
+
+		for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+			renderGraphHandle_t resource = pass.mAccesses[a].mResource;
+			bool32 writes = PassWrites( pass, resource );
+
+			for ( u32 j = 0; j < mNumPasses; j++ ) {
+				if ( j == i || !PassWrites( mPasses[j], resource ) ) {
+					continue;
+				}
+
+				// writers go in the order they were added, everything that only reads goes after all of them
+				if ( !writes || j < i ) {
+					dependencies[i] |= 1u << j;
+				}
+			}
+		}
+	}
+
+	u32 done = 0;
+	mNumOrdered = 0;
+
+	while ( mNumOrdered < mNumPasses ) {
+		u32 next = U32_MAX;
+
+		// lowest index first so independent passes keep the order they were added in
+		for ( u32 i = 0; i < mNumPasses; i++ ) {
+			if ( ( done & ( 1u << i ) ) == 0 && ( dependencies[i] & ~done ) == 0 ) {
+				next = i;
+				break;
+			}
+		}
+
+		if ( next == U32_MAX ) {
+			error( "RenderGraph passes depend on each other in a loop, the rest will run in the order they were added!\n" );
+
+			for ( u32 i = 0; i < mNumPasses; i++ ) {
+				if ( ( done & ( 1u << i ) ) == 0 ) {
+					mOrder[mNumOrdered++] = i;
+				}
+			}
+
+			break;
+		}
+
+		mOrder[mNumOrdered++] = next;
+		done |= 1u << next;
+	}
+}
+
+/*
+========================
+RenderGraph::CullPasses
+========================
+*/
+void RenderGraph::CullPasses() {
+	for ( u32 i = 0; i < mNumResources; i++ ) {
+		mResources[i].mNeeded = false;
+	}
+
+	// backwards, so by the time a pass is looked at everything after it has decided what it needs
+	for ( u32 k = mNumOrdered; k-- > 0; ) {
+		pass_t& pass = mPasses[mOrder[k]];
+
+		pass.mLive = false;
+
+		for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+			const resource_t& r = mResources[pass.mAccesses[a].mResource];
+
+			if ( !ACCESS_INFOS[pass.mAccesses[a].mAccess].mWrite ) {
+				continue;
+			}
+
+			if ( r.mType != RESOURCE_TYPE_TRANSIENT_IMAGE || r.mNeeded ) {
+				pass.mLive = true;
+				break;
+			}
+		}
+
+		if ( !pass.mLive ) {
+			continue;
+		}
+
+		// a clear throws away whatever was there, so earlier writes to it aren't needed anymore
+		if ( pass.mColorAttachment != INVALID_HANDLE && pass.mClear ) {
+			mResources[pass.mColorAttachment].mNeeded = false;
+		}
+
+		for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+			renderGraphHandle_t resource = pass.mAccesses[a].mResource;
+
+			if ( PassReads( pass, resource ) ) {
+				mResources[resource].mNeeded = true;
+			}
+		}
+	}
+
+	u32 numLive = 0;
+
+	for ( u32 k = 0; k < mNumOrdered; k++ ) {
+		if ( mPasses[mOrder[k]].mLive ) {
+			mOrder[numLive++] = mOrder[k];
+		}
+	}
+
+	mStats.mNumPasses = numLive;
+	mStats.mNumCulledPasses = mNumOrdered - numLive;
+
+	mNumOrdered = numLive;
+}
+
+/*
+========================
+RenderGraph::PlaceTransients
+========================
+*/
+void RenderGraph::PlaceTransients() {
+	for ( u32 k = 0; k < mNumOrdered; k++ ) {
+		const pass_t& pass = mPasses[mOrder[k]];
+
+		for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+			resource_t& r = mResources[pass.mAccesses[a].mResource];
+
+			r.mFirstPass = min( r.mFirstPass, k );
+			r.mLastPass = max( r.mLastPass, k );
+			r.mUsedStages |= ACCESS_INFOS[pass.mAccesses[a].mAccess].mStages;
+		}
+	}
+
+	// in the order they're first used, so the same passes every frame give the same keys
+	transientKey_t keys[MAX_RESOURCES];
+	memset( keys, 0, sizeof( keys ) );
+
+	u32 numKeys = 0;
+
+	for ( u32 k = 0; k < mNumOrdered; k++ ) {
+		const pass_t& pass = mPasses[mOrder[k]];
+
+		for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+			resource_t& r = mResources[pass.mAccesses[a].mResource];
+
+			if ( r.mType != RESOURCE_TYPE_TRANSIENT_IMAGE || r.mTransientIndex != U32_MAX ) {
+				continue;
+			}
+
+			r.mTransientIndex = numKeys;
+
+			keys[numKeys].mDesc = r.mDesc;
+			keys[numKeys].mFirstPass = r.mFirstPass;
+			keys[numKeys].mLastPass = r.mLastPass;
+			numKeys++;
+		}
+	}
+
+	bool32 reuse = numKeys == mTransients.mNumImages && memcmp( keys, mTransients.mKeys, numKeys * sizeof( transientKey_t ) ) == 0;
+
+	if ( !reuse ) {
+		if ( mTransients.mNumImages > 0 ) {
+			// frames in flight can still be using them
+			if ( mNumRetiredTransients == MAX_RETIRED_TRANSIENTS ) {
+				mContext->WaitDeviceIdle();
+
+				for ( u32 i = 0; i < mNumRetiredTransients; i++ ) {
+					DestroyTransients( mRetiredTransients[i] );
+				}
+				mNumRetiredTransients = 0;
+			}
+
+			mRetiredTransients[mNumRetiredTransients] = mTransients;
+			mRetiredTransients[mNumRetiredTransients].mFramesLeft = mNumFrames;
+			mNumRetiredTransients++;
+
+			memset( &mTransients, 0, sizeof( transientSet_t ) );
+		}
+
+		if ( numKeys > 0 ) {
+			CreateTransients( keys, numKeys );
+		}
+	}
+
+	for ( u32 i = 0; i < mNumResources; i++ ) {
+		resource_t& r = mResources[i];
+
+		if ( r.mTransientIndex == U32_MAX ) {
+			continue;
+		}
+
+		u32 index = r.mTransientIndex;
+
+		r.mImage = mTransients.mImages[index];
+		r.mImageView = mTransients.mImageViews[index];
+
+		VkDeviceSize start = mTransients.mOffsets[index];
+		VkDeviceSize end = start + mTransients.mSizes[index];
+
+		// whatever last used the same memory has to be finished with it first, last frame's use of this one included
+		for ( u32 j = 0; j < mNumResources; j++ ) {
+			const resource_t& other = mResources[j];
+
+			if ( other.mTransientIndex == U32_MAX ) {
+				continue;
+			}
+
+			VkDeviceSize otherStart = mTransients.mOffsets[other.mTransientIndex];
+			VkDeviceSize otherEnd = otherStart + mTransients.mSizes[other.mTransientIndex];
+
+			if ( start < otherEnd && otherStart < end ) {
+				r.mAliasStages |= other.mUsedStages;
+			}
+		}
+	}
+}
+
+/*
+========================
+RenderGraph::CreateTransients
+========================
+*/
+void RenderGraph::CreateTransients( const transientKey_t* keys, const u32 numKeys ) {
+	VkDevice logicalDevice = mContext->GetLogicalDevice();
+
+	transientSet_t& set = mTransients;
+	memset( &set, 0, sizeof( transientSet_t ) );
+
+	VkMemoryRequirements requirements[MAX_RESOURCES];
+	u32 memoryTypeBits = U32_MAX;
+
+	for ( u32 i = 0; i < numKeys; i++ ) {
+		const renderGraphImageDesc_t& desc = keys[i].mDesc;
+
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = desc.mFormat;
+		imageInfo.extent = { desc.mWidth, desc.mHeight, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = desc.mUsage;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		YETI_VK_CHECK( vkCreateImage( logicalDevice, &imageInfo, nullptr, &set.mImages[i] ) );
+
+		vkGetImageMemoryRequirements( logicalDevice, set.mImages[i], &requirements[i] );
+
+		memoryTypeBits &= requirements[i].memoryTypeBits;
+		set.mSizes[i] = requirements[i].size;
+	}
+
+	assertf( ( memoryTypeBits != 0 ), "RenderGraph transients have no memory type in common, they can't share an allocation!\n" );
+
+	// first fit, anything alive in the same pass as an image that's already placed has to go after it
+	for ( u32 i = 0; i < numKeys; i++ ) {
+		VkDeviceSize offset = 0;
+		bool32 moved = true;
+
+		while ( moved ) {
+			moved = false;
+
+			for ( u32 j = 0; j < i; j++ ) {
+				bool32 aliveTogether = keys[i].mFirstPass <= keys[j].mLastPass && keys[j].mFirstPass <= keys[i].mLastPass;
+				bool32 overlaps = offset < set.mOffsets[j] + set.mSizes[j] && set.mOffsets[j] < offset + set.mSizes[i];
+
+				if ( aliveTogether && overlaps ) {
+					offset = AlignUp( set.mOffsets[j] + set.mSizes[j], requirements[i].alignment );
+					moved = true;
+				}
+			}
+		}
+
+		set.mOffsets[i] = offset;
+
+		set.mSizeBytes = max( set.mSizeBytes, offset + set.mSizes[i] );
+		set.mSizeBytesUnaliased += set.mSizes[i];
+	}
+
+	VkMemoryRequirements allocRequirements = {};
+	allocRequirements.size = set.mSizeBytes;
+	allocRequirements.memoryTypeBits = memoryTypeBits;
+
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = set.mSizeBytes;
+	allocInfo.memoryTypeIndex = mContext->GetMemoryTypeIndex( VMA_MEMORY_USAGE_GPU_ONLY, allocRequirements );
+	YETI_VK_CHECK( vkAllocateMemory( logicalDevice, &allocInfo, nullptr, &set.mMemory ) );
+
+	for ( u32 i = 0; i < numKeys; i++ ) {
+		const renderGraphImageDesc_t& desc = keys[i].mDesc;
+
+		YETI_VK_CHECK( vkBindImageMemory( logicalDevice, set.mImages[i], set.mMemory, set.mOffsets[i] ) );
+
+		VkImageViewCreateInfo imageViewInfo = {};
+		imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewInfo.image = set.mImages[i];
+		imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewInfo.format = desc.mFormat;
+		imageViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		YETI_VK_CHECK( vkCreateImageView( logicalDevice, &imageViewInfo, nullptr, &set.mImageViews[i] ) );
+
+		if ( mContext->UsesDynamicRendering() || ( desc.mUsage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT ) == 0 ) {
+			continue;
+		}
+
+		// clearing and loading render passes are compatible, so either one will do
+		VkFramebufferCreateInfo framebufferInfo = {};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = GetRenderPass( desc.mFormat, true );
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &set.mImageViews[i];
+		framebufferInfo.width = desc.mWidth;
+		framebufferInfo.height = desc.mHeight;
+		framebufferInfo.layers = 1;
+		YETI_VK_CHECK( vkCreateFramebuffer( logicalDevice, &framebufferInfo, nullptr, &set.mFramebuffers[i] ) );
+	}
+
+	memcpy( set.mKeys, keys, numKeys * sizeof( transientKey_t ) );
+	set.mNumImages = numKeys;
+}
+
+/*
+========================
+RenderGraph::DestroyTransients
+========================
+*/
+void RenderGraph::DestroyTransients( transientSet_t& set ) {
+	VkDevice logicalDevice = mContext->GetLogicalDevice();
+
+	for ( u32 i = 0; i < set.mNumImages; i++ ) {
+		if ( set.mFramebuffers[i] != VK_NULL_HANDLE ) {
+			vkDestroyFramebuffer( logicalDevice, set.mFramebuffers[i], nullptr );
+		}
+
+		vkDestroyImageView( logicalDevice, set.mImageViews[i], nullptr );
+		vkDestroyImage( logicalDevice, set.mImages[i], nullptr );
+	}
+
+	if ( set.mMemory != VK_NULL_HANDLE ) {
+		vkFreeMemory( logicalDevice, set.mMemory, nullptr );
+	}
+
+	memset( &set, 0, sizeof( transientSet_t ) );
+}
+
+/*
+========================
+RenderGraph::GetRenderPass
+========================
+*/
+VkRenderPass RenderGraph::GetRenderPass( const VkFormat format, const bool32 clear ) {
+	for ( u32 i = 0; i < mNumRenderPasses; i++ ) {
+		if ( mRenderPasses[i].mFormat == format && mRenderPasses[i].mClear == clear ) {
+			return mRenderPasses[i].mRenderPass;
+		}
+	}
+
+	assertf( ( mNumRenderPasses < MAX_RENDER_PASSES ), "RenderGraph ran out of render passes, increase MAX_RENDER_PASSES!\n" );
+
+	// the graph's barriers do the layout transitions and the syncing, so there's no dependencies
+	VkAttachmentDescription attachmentDesc = {};
+	attachmentDesc.format = format;
+	attachmentDesc.samples = VK_SAMPLE_COUNT_1_BIT;
+	attachmentDesc.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	attachmentDesc.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	attachmentDesc.loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+	attachmentDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachmentDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachmentDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+	VkAttachmentReference attachmentColor = {};
+	attachmentColor.attachment = 0;
+	attachmentColor.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpassDesc = {};
+	subpassDesc.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDesc.colorAttachmentCount = 1;
+	subpassDesc.pColorAttachments = &attachmentColor;
+
+	VkRenderPassCreateInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &attachmentDesc;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpassDesc;
+
+	renderPassEntry_t& entry = mRenderPasses[mNumRenderPasses++];
+	entry.mFormat = format;
+	entry.mClear = clear;
+	YETI_VK_CHECK( vkCreateRenderPass( mContext->GetLogicalDevice(), &renderPassInfo, nullptr, &entry.mRenderPass ) );
+
+	return entry.mRenderPass;
+}
+
+/*
+========================
+RenderGraph::RecordBarriers
+========================
+*/
+void RenderGraph::RecordBarriers( VkCommandBuffer commandBuffer, const pass_t& pass ) {
+	VkImageMemoryBarrier imageBarriers[MAX_PASS_ACCESSES];
+	u32 numImageBarriers = 0;
+
+	// buffers don't need anything per resource, so they all share one global barrier
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+
+	VkPipelineStageFlags srcStages = 0;
+	VkPipelineStageFlags dstStages = 0;
+
+	for ( u32 a = 0; a < pass.mNumAccesses; a++ ) {
+		resource_t& r = mResources[pass.mAccesses[a].mResource];
+		const accessInfo_t& info = ACCESS_INFOS[pass.mAccesses[a].mAccess];
+
+		bool32 isImage = r.mType != RESOURCE_TYPE_IMPORTED_BUFFER;
+		bool32 layoutChange = isImage && r.mLayout != info.mLayout;
+
+		VkPipelineStageFlags waitStages = 0;
+		VkAccessFlags waitAccess = 0;
+
+		if ( info.mWrite || layoutChange ) {
+			// after a read only the execution has to wait, after a write it has to be made available too
+			waitStages = r.mWriteStages | r.mReadStages;
+			waitAccess = r.mWriteAccess;
+		} else if ( r.mWriteStages != 0 && ( ( r.mVisibleStages & info.mStages ) != info.mStages || ( r.mVisibleAccess & info.mAccess ) != info.mAccess ) ) {
+			waitStages = r.mWriteStages;
+			waitAccess = r.mWriteAccess;
+		}
+
+		// the memory might have been something else earlier this frame or last frame
+		if ( r.mType == RESOURCE_TYPE_TRANSIENT_IMAGE && !r.mAccessed ) {
+			waitStages |= r.mAliasStages;
+			waitAccess |= VK_ACCESS_MEMORY_WRITE_BIT;
+		}
+
+		// nothing to wait on, but the transition still has to happen before this access, for the back buffer this is the acquire semaphore's wait stage
+		if ( layoutChange && waitStages == 0 ) {
+			waitStages = info.mStages;
+		}
+
+		if ( waitStages != 0 ) {
+			srcStages |= waitStages;
+			dstStages |= info.mStages;
+
+			if ( isImage ) {
+				VkImageMemoryBarrier& barrier = imageBarriers[numImageBarriers++];
+				barrier = {};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.srcAccessMask = waitAccess;
+				barrier.dstAccessMask = info.mAccess;
+				barrier.oldLayout = r.mLayout;
+				barrier.newLayout = info.mLayout;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = r.mImage;
+				barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			} else {
+				memoryBarrier.srcAccessMask |= waitAccess;
+				memoryBarrier.dstAccessMask |= info.mAccess;
+			}
+		}
+
+		if ( info.mWrite ) {
+			r.mWriteStages = info.mStages;
+			r.mWriteAccess = info.mAccess & WRITE_ACCESS_MASK;
+			r.mReadStages = 0;
+			r.mVisibleStages = 0;
+			r.mVisibleAccess = 0;
+		} else if ( layoutChange ) {
+			// the transition counts as a write, later reads at other stages have to wait for it
+			r.mWriteStages = info.mStages;
+			r.mWriteAccess = 0;
+			r.mReadStages = info.mStages;
+			r.mVisibleStages = info.mStages;
+			r.mVisibleAccess = info.mAccess;
+		} else {
+			r.mReadStages |= info.mStages;
+
+			if ( waitStages != 0 ) {
+				r.mVisibleStages |= info.mStages;
+				r.mVisibleAccess |= info.mAccess;
+			}
+		}
+
+		if ( isImage ) {
+			r.mLayout = info.mLayout;
+		}
+
+		r.mAccessed = true;
+	}
+
+	if ( srcStages == 0 ) {
+		return;
+	}
+
+	u32 numMemoryBarriers = memoryBarrier.srcAccessMask != 0 ? 1 : 0;
+
+	vkCmdPipelineBarrier( commandBuffer, srcStages, dstStages, 0, numMemoryBarriers, &memoryBarrier, 0, nullptr, numImageBarriers, imageBarriers );
+
+	mStats.mNumBarriers++;
+	mStats.mNumImageBarriers += numImageBarriers;
+}
+
+/*
+========================
+RenderGraph::RecordFinalBarriers
+========================
+*/
+void RenderGraph::RecordFinalBarriers( VkCommandBuffer commandBuffer ) {
+	VkImageMemoryBarrier imageBarriers[MAX_RESOURCES];
+	u32 numImageBarriers = 0;
+
+	VkPipelineStageFlags srcStages = 0;
+
+	for ( u32 i = 0; i < mNumResources; i++ ) {
+		resource_t& r = mResources[i];
+
+		if ( r.mType == RESOURCE_TYPE_IMPORTED_BUFFER ) {
+			importedBufferState_t* history = FindImportedBuffer( r.mBuffer );
+
+			if ( !history && mNumImportedBuffers < MAX_IMPORTED_BUFFERS ) {
+				history = &mImportedBuffers[mNumImportedBuffers++];
+				history->mBuffer = r.mBuffer;
+			}
+
+			// if there's no room it just gets the worst case next frame
+			if ( history ) {
+				history->mWriteStages = r.mWriteStages;
+				history->mWriteAccess = r.mWriteAccess;
+				history->mReadStages = r.mReadStages;
+				history->mVisibleStages = r.mVisibleStages;
+				history->mVisibleAccess = r.mVisibleAccess;
+			}
+
+			continue;
+		}
+
+		if ( r.mType != RESOURCE_TYPE_IMPORTED_IMAGE || r.mFinalLayout == VK_IMAGE_LAYOUT_UNDEFINED || r.mFinalLayout == r.mLayout ) {
+			continue;
+		}
+
+		srcStages |= r.mWriteStages | r.mReadStages;
+
+		VkImageMemoryBarrier& barrier = imageBarriers[numImageBarriers++];
+		barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = r.mWriteAccess;
+		barrier.dstAccessMask = 0;
+		barrier.oldLayout = r.mLayout;
+		barrier.newLayout = r.mFinalLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = r.mImage;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+		r.mLayout = r.mFinalLayout;
+	}
+
+	if ( numImageBarriers == 0 ) {
+		return;
+	}
+
+	// never touched this frame, there's nothing to wait on
+	if ( srcStages == 0 ) {
+		srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	}
+
+	// whatever uses them next syncs through its own semaphore, like presenting does
+	vkCmdPipelineBarrier( commandBuffer, srcStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, numImageBarriers, imageBarriers );
+
+	mStats.mNumBarriers++;
+	mStats.mNumImageBarriers += numImageBarriers;
+}
+
+/*
+========================
+RenderGraph::RecordPass
+========================
+*/
+void RenderGraph::RecordPass( VkCommandBuffer commandBuffer, const pass_t& pass ) {
+	if ( pass.mColorAttachment == INVALID_HANDLE ) {
+		pass.mFunc( commandBuffer, pass.mData );
+		return;
+	}
+
+	const resource_t& attachment = mResources[pass.mColorAttachment];
+
+	VkRect2D renderArea = {};
+	renderArea.offset = { 0, 0 };
+	renderArea.extent = { attachment.mDesc.mWidth, attachment.mDesc.mHeight };
+
+	VkViewport viewport = { 0.0f, 0.0f, static_cast<float32>( attachment.mDesc.mWidth ), static_cast<float32>( attachment.mDesc.mHeight ), 0.0f, 1.0f };
+
+#if YETI_VK_DYNAMIC_RENDERING
+	if ( mContext->UsesDynamicRendering() ) {
+		VkRenderingAttachmentInfoKHR colorAttachment = {};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		colorAttachment.imageView = attachment.mImageView;
+		colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachment.loadOp = pass.mClear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.clearValue = pass.mClearValue;
+
+		VkRenderingInfoKHR renderingInfo = {};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea = renderArea;
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachments = &colorAttachment;
+		mContext->CmdBeginRendering( commandBuffer, &renderingInfo );
+
+		vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
+		vkCmdSetScissor( commandBuffer, 0, 1, &renderArea );
+
+		pass.mFunc( commandBuffer, pass.mData );
+
+		mContext->CmdEndRendering( commandBuffer );
+
+		return;
+	}
+#endif
+
+	// imported images don't have a framebuffer, the swap chain pass begins its own
+	assertf( ( attachment.mType == RESOURCE_TYPE_TRANSIENT_IMAGE ), "RenderGraph color attachments MUST be transient without dynamic rendering!\n" );
+
+	VkRenderPassBeginInfo renderPassBeginInfo = {};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.renderPass = GetRenderPass( attachment.mDesc.mFormat, pass.mClear );
+	renderPassBeginInfo.framebuffer = mTransients.mFramebuffers[attachment.mTransientIndex];
+	renderPassBeginInfo.renderArea = renderArea;
+	renderPassBeginInfo.clearValueCount = pass.mClear ? 1 : 0;
+	renderPassBeginInfo.pClearValues = &pass.mClearValue;
+	vkCmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+
+	vkCmdSetViewport( commandBuffer, 0, 1, &viewport );
+	vkCmdSetScissor( commandBuffer, 0, 1, &renderArea );
+
+	pass.mFunc( commandBuffer, pass.mData );
+
+	vkCmdEndRenderPass( commandBuffer );
+}
+
+/*
+========================
+RenderGraph::FindImportedBuffer
+========================
+*/
+RenderGraph::importedBufferState_t* RenderGraph::FindImportedBuffer( VkBuffer buffer ) {
+	for ( u32 i = 0; i < mNumImportedBuffers; i++ ) {
+		if ( mImportedBuffers[i].mBuffer == buffer ) {
+			return &mImportedBuffers[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/*
+========================
+RenderGraph::PassWrites
+========================
+*/
+bool32 RenderGraph::PassWrites( const pass_t& pass, const renderGraphHandle_t resource ) const {
+	for ( u32 i = 0; i < pass.mNumAccesses; i++ ) {
+		if ( pass.mAccesses[i].mResource == resource && ACCESS_INFOS[pass.mAccesses[i].mAccess].mWrite ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+========================
+RenderGraph::PassReads
+========================
+*/
+bool32 RenderGraph::PassReads( const pass_t& pass, const renderGraphHandle_t resource ) const {
+	// loading an attachment reads what was there before
+	if ( pass.mColorAttachment == resource && !pass.mClear ) {
+		return true;
+	}
+
+	for ( u32 i = 0; i < pass.mNumAccesses; i++ ) {
+		if ( pass.mAccesses[i].mResource == resource && !ACCESS_INFOS[pass.mAccesses[i].mAccess].mWrite ) {
+			return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,261 @@
+#ifndef __RENDER_GRAPH_H__
+#define __RENDER_GRAPH_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+class VulkanContext;
+
+typedef u32 renderGraphHandle_t;
+
+// how a pass uses a resource, each one maps to the stages, access and layout the barriers need
+enum renderGraphAccess_t {
+	YETI_RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT	= 0,
+	YETI_RENDER_GRAPH_ACCESS_SAMPLED,				// read in a fragment shader
+	YETI_RENDER_GRAPH_ACCESS_TRANSFER_SRC,
+	YETI_RENDER_GRAPH_ACCESS_TRANSFER_DST,
+	YETI_RENDER_GRAPH_ACCESS_VERTEX_BUFFER,
+	YETI_RENDER_GRAPH_ACCESS_INDEX_BUFFER,
+	YETI_RENDER_GRAPH_ACCESS_UNIFORM_BUFFER,
+	YETI_RENDER_GRAPH_ACCESS_STORAGE_BUFFER,		// only ever read, in a vertex or fragment shader
+
+	YETI_RENDER_GRAPH_ACCESS_COUNT
+};
+
+struct renderGraphImageDesc_t {
+	VkFormat							mFormat;
+	u32									mWidth, mHeight;
+	VkImageUsageFlags					mUsage;
+};
+
+struct renderGraphStats_t {
+	u32									mNumPasses;
+	u32									mNumCulledPasses;
+	u32									mNumBarriers;			// vkCmdPipelineBarrier calls
+	u32									mNumImageBarriers;
+	VkDeviceSize						mTransientBytes;		// what the transient images actually take up
+	VkDeviceSize						mTransientBytesUnaliased;	// what they would without sharing memory
+};
+
+// commandBuffer is the frame's primary, already inside the pass's rendering if it has a color attachment
+typedef void ( *renderGraphPassFunc_t )( VkCommandBuffer commandBuffer, void* data );
+
+/*
+================================================================================================
+
+	Render Graph
+
+	Rebuilt every frame. Passes say which resources they read and write and how, and when the
+	context executes the graph it sorts the passes so everything that writes a resource runs
+	before everything that reads it, drops any pass whose writes nobody reads, and puts in
+	only the barriers the accesses need, merged into one vkCmdPipelineBarrier per pass.
+
+	Resources are either imported or transient. Imported ones (the back buffer, the quad
+	instance buffer) belong to someone else and outlive the frame, so writing to one always
+	keeps a pass alive. The graph remembers how imported buffers were last used so the next
+	frame's first write waits on the last frame's reads. Imported images start the frame in
+	whatever layout they're imported with and get left in their final layout.
+
+	Transient images belong to the graph. Ones that are never alive in the same pass share
+	memory out of one allocation, and they're only recreated when the set of transients or
+	their lifetimes change, with the old ones retired like swap chains so a resize doesn't
+	wait for the GPU.
+
+	A pass given a color attachment gets its rendering begun and ended by the graph, with
+	dynamic rendering or a graph owned render pass. With a render pass the attachment MUST be
+	transient, and pipelines drawn with it are created against the context's render pass, so
+	its format has to match the swap chain's.
+
+	Handles and pass indices are only valid until the next BeginFrame().
+
+================================================================================================
+*/
+
+class RenderGraph {
+public:
+	static const u32					MAX_PASSES = 32;
+	static const u32					MAX_RESOURCES = 32;
+	static const u32					MAX_PASS_ACCESSES = 8;
+	static const u32					MAX_IMPORTED_BUFFERS = 16;	// buffers whose last use is remembered between frames
+	static const u32					MAX_RENDER_PASSES = 8;
+	static const u32					MAX_RETIRED_TRANSIENTS = 4;
+
+	static const renderGraphHandle_t	INVALID_HANDLE = U32_MAX;
+
+public:
+										RenderGraph();
+	virtual								~RenderGraph();
+
+	void								Init( VulkanContext* context, const u32 numFrames );
+	void								Shutdown();
+	inline bool32						IsInitialised() const { return mInitialised; }
+
+	// the current frame's fence MUST have been waited on, throws away last frame's passes and resources
+	void								BeginFrame();
+
+	renderGraphHandle_t					ImportImage( const char* name, VkImage image, VkImageView imageView, const VkFormat format, const u32 width, const u32 height,
+											const VkImageLayout initialLayout, const VkImageLayout finalLayout );
+	renderGraphHandle_t					ImportBuffer( const char* name, VkBuffer buffer );
+
+	renderGraphHandle_t					CreateImage( const char* name, const renderGraphImageDesc_t& desc );
+
+	// name MUST be a string literal or otherwise outlive the frame, data MUST still be valid when the graph executes
+	u32									AddPass( const char* name, renderGraphPassFunc_t func, void* data );
+
+	void								Read( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access );
+	void								Write( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access );
+
+	// the graph begins rendering to the image around the pass, clearValue null loads what's already there
+	void								SetColorAttachment( const u32 pass, const renderGraphHandle_t resource, const VkClearValue* clearValue );
+
+	// transient images don't have one until the graph executes, so only call this from a pass
+	inline VkImageView					GetImageView( const renderGraphHandle_t resource ) const { return mResources[resource].mImageView; }
+	inline VkImage						GetImage( const renderGraphHandle_t resource ) const { return mResources[resource].mImage; }
+
+	// sorts, culls, places transients, then records every live pass into commandBuffer
+	void								Execute( VkCommandBuffer commandBuffer );
+
+	// from the last time the graph executed
+	inline const renderGraphStats_t&	GetStats() const { return mStats; }
+
+private:
+	enum resourceType_t {
+		RESOURCE_TYPE_IMPORTED_IMAGE	= 0,
+		RESOURCE_TYPE_IMPORTED_BUFFER,
+		RESOURCE_TYPE_TRANSIENT_IMAGE,
+	};
+
+	struct resource_t {
+		const char*						mName;
+		resourceType_t					mType;
+
+		VkImage							mImage;
+		VkImageView						mImageView;
+		VkBuffer						mBuffer;
+		renderGraphImageDesc_t			mDesc;
+		VkImageLayout					mFinalLayout;
+
+		// worked out when the graph executes
+		u32								mFirstPass, mLastPass;		// positions in the execution order
+		VkPipelineStageFlags			mUsedStages;				// every stage any live pass touches it at
+		VkPipelineStageFlags			mAliasStages;				// same but for everything sharing its memory, including itself
+		u32								mTransientIndex;
+		bool32							mNeeded;
+
+		// sync state as the passes get recorded
+		VkImageLayout					mLayout;
+		VkPipelineStageFlags			mWriteStages;
+		VkAccessFlags					mWriteAccess;
+		VkPipelineStageFlags			mReadStages;				// reads since the last write
+		VkPipelineStageFlags			mVisibleStages;				// stages the last write has been made visible to
+		VkAccessFlags					mVisibleAccess;
+		bool32							mAccessed;
+	};
+
+	struct passAccess_t {
+		renderGraphHandle_t				mResource;
+		renderGraphAccess_t				mAccess;
+	};
+
+	struct pass_t {
+		const char*						mName;
+		renderGraphPassFunc_t			mFunc;
+		void*							mData;
+
+		passAccess_t					mAccesses[MAX_PASS_ACCESSES];
+		u32								mNumAccesses;
+
+		renderGraphHandle_t				mColorAttachment;
+		VkClearValue					mClearValue;
+		bool32							mClear;
+
+		bool32							mLive;
+	};
+
+	// what ties a transient to a slot in a transient set, if it all matches the set can be reused
+	struct transientKey_t {
+		renderGraphImageDesc_t			mDesc;
+		u32								mFirstPass, mLastPass;
+	};
+
+	struct transientSet_t {
+		VkDeviceMemory					mMemory;
+		VkImage							mImages[MAX_RESOURCES];
+		VkImageView						mImageViews[MAX_RESOURCES];
+		VkFramebuffer					mFramebuffers[MAX_RESOURCES];		// only without dynamic rendering
+		VkDeviceSize					mOffsets[MAX_RESOURCES];
+		VkDeviceSize					mSizes[MAX_RESOURCES];
+		transientKey_t					mKeys[MAX_RESOURCES];
+		u32								mNumImages;
+		VkDeviceSize					mSizeBytes;
+		VkDeviceSize					mSizeBytesUnaliased;
+		u32								mFramesLeft;						// once retired
+	};
+
+	struct importedBufferState_t {
+		VkBuffer						mBuffer;
+		VkPipelineStageFlags			mWriteStages;
+		VkAccessFlags					mWriteAccess;
+		VkPipelineStageFlags			mReadStages;
+		VkPipelineStageFlags			mVisibleStages;
+		VkAccessFlags					mVisibleAccess;
+	};
+
+	struct renderPassEntry_t {
+		VkFormat						mFormat;
+		bool32							mClear;
+		VkRenderPass					mRenderPass;
+	};
+
+	VulkanContext*						mContext;
+
+	pass_t								mPasses[MAX_PASSES];
+	u32									mNumPasses;
+
+	resource_t							mResources[MAX_RESOURCES];
+	u32									mNumResources;
+
+	u32									mOrder[MAX_PASSES];				// execution order, only live passes
+	u32									mNumOrdered;
+
+	transientSet_t						mTransients;
+	transientSet_t						mRetiredTransients[MAX_RETIRED_TRANSIENTS];
+	u32									mNumRetiredTransients;
+
+	importedBufferState_t				mImportedBuffers[MAX_IMPORTED_BUFFERS];
+	u32									mNumImportedBuffers;
+
+	renderPassEntry_t					mRenderPasses[MAX_RENDER_PASSES];
+	u32									mNumRenderPasses;
+
+	renderGraphStats_t					mStats;
+
+	u32									mNumFrames;
+
+	bool32								mInitialised;
+
+private:
+	renderGraphHandle_t					AddResource( const char* name, const resourceType_t type );
+	void								AddAccess( const u32 pass, const renderGraphHandle_t resource, const renderGraphAccess_t access );
+
+	void								SortPasses();
+	void								CullPasses();
+	void								PlaceTransients();
+
+	void								CreateTransients( const transientKey_t* keys, const u32 numKeys );
+	void								DestroyTransients( transientSet_t& set );
+
+	VkRenderPass						GetRenderPass( const VkFormat format, const bool32 clear );
+
+	void								RecordBarriers( VkCommandBuffer commandBuffer, const pass_t& pass );
+	void								RecordFinalBarriers( VkCommandBuffer commandBuffer );
+	void								RecordPass( VkCommandBuffer commandBuffer, const pass_t& pass );
+
+	importedBufferState_t*				FindImportedBuffer( VkBuffer buffer );
+
+	bool32								PassWrites( const pass_t& pass, const renderGraphHandle_t resource ) const;
+	bool32								PassReads( const pass_t& pass, const renderGraphHandle_t resource ) const;
+};
+
+#endif // __RENDER_GRAPH_H__
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef __RENDER_STATE_H__
 #define __RENDER_STATE_H__
 
+#include "RenderStateManager.h"
+
 class Shader;
 class UniformLayout;
 
@@ -12,6 +14,9 @@ class UniformLayout;
 	Combination of Depth-Stencil, Raster, and Blend states. Also keeps track of its shaders and
 	vertex topology. Gets created via a renderStateDesc_t.
 
+	The pipeline itself belongs to the context's RenderStateManager, so render states that are
+	described the same way share one.
+
 ================================================================================================
 */
 
@@ -22,6 +27,7 @@ struct renderStateDesc_t {
 
 	UniformLayout*						mUniformLayout;
 	
+	// both can be empty for shaders that fetch their own vertices
 	VkVertexInputBindingDescription*	mVertexBindings;
 	VkVertexInputAttributeDescription*	mVertexAttribs;
 
@@ -47,17 +53,18 @@ public:
 										RenderState( VulkanContext* context );
 										~RenderState();
 
-	inline bool32						IsAlloced() const { return mPipeline != VK_NULL_HANDLE; }
+	inline bool32						IsAlloced() const { return mPipelineID != RenderStateManager::INVALID_ID; }
 
-	void								AllocRenderState( const renderStateDesc_t& desc );
+	void								AllocRenderState( const renderStateDesc_t& desc, const renderStateCreateMode_t mode = YETI_RENDER_STATE_CREATE_NOW );
 	void								UnallocRenderState();
 
-	VkPipeline							GetPipeline() const { return mPipeline; }
+	// waits for the pipeline if it was made in the background and isn't finished yet
+	VkPipeline							GetPipeline() const;
 
 private:
 	VulkanContext*						mContext;
 
-	VkPipeline							mPipeline;
+	u32									mPipelineID;
 };
 
 #endif // __RENDER_STATE_H__
\ No newline at end of file
@@ -0,0 +1,657 @@
+#include "gl_main.h"
+
+static const u32 SLOT_EMPTY = U32_MAX;
+static const u32 SLOT_REMOVED = U32_MAX - 1;
+
+/*
+========================
+HashKey
+========================
+*/
+template<typename key_t>
+static u32 HashKey( const key_t& key ) {
+	// FNV-1a over the whole key, which is why keys have to be zeroed before they're filled in
+	const u8* bytes = reinterpret_cast<const u8*>( &key );
+	u32 hash = 0x811C9DC5;
+
+	for ( size_t i = 0; i < sizeof( key_t ); i++ ) {
+		hash ^= bytes[i];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+/*
+========================
+FindSlot
+========================
+*/
+template<typename entry_t, typename key_t, u32 tableSize>
+static u32 FindSlot( const u32 ( &table )[tableSize], const entry_t* entries, const key_t& key, const u32 hash ) {
+	for ( u32 probe = 0; probe < tableSize; probe++ ) {
+		u32 index = table[( hash + probe ) & ( tableSize - 1 )];
+
+		if ( index == SLOT_EMPTY ) {
+			break;
+		}
+
+		if ( index != SLOT_REMOVED && entries[index].mHash == hash && memcmp( &entries[index].mKey, &key, sizeof( key_t ) ) == 0 ) {
+			return index;
+		}
+	}
+
+	return RenderStateManager::INVALID_ID;
+}
+
+/*
+========================
+InsertSlot
+========================
+*/
+template<u32 tableSize>
+static void InsertSlot( u32 ( &table )[tableSize], const u32 hash, const u32 index ) {
+	for ( u32 probe = 0; probe < tableSize; probe++ ) {
+		u32& slot = table[( hash + probe ) & ( tableSize - 1 )];
+
+		if ( slot == SLOT_EMPTY || slot == SLOT_REMOVED ) {
+			slot = index;
+			return;
+		}
+	}
+
+	// the table is twice the size of the entries so this can't happen
+	fatalError( "Render state hash table is full!\n" );
+}
+
+/*
+========================
+RemoveSlot
+========================
+*/
+template<u32 tableSize>
+static void RemoveSlot( u32 ( &table )[tableSize], const u32 hash, const u32 index ) {
+	for ( u32 probe = 0; probe < tableSize; probe++ ) {
+		u32& slot = table[( hash + probe ) & ( tableSize - 1 )];
+
+		// left as a tombstone so probes for anything inserted after it still get past
+		if ( slot == index ) {
+			slot = SLOT_REMOVED;
+			return;
+		}
+	}
+}
+
+/*
+================================================================================================
+
+	RenderStateManager
+
+================================================================================================
+*/
+
+/*
+========================
+RenderStateManager::RenderStateManager
+========================
+*/
+RenderStateManager::RenderStateManager() {
+	mContext = nullptr;
+	mJobSystem = nullptr;
+
+	mNumLayouts = 0;
+	mNumPipelines = 0;
+	mNumPipelinesShared = 0;
+
+	mInitialised = false;
+}
+
+/*
+========================
+RenderStateManager::~RenderStateManager
+========================
+*/
+RenderStateManager::~RenderStateManager() {
+	Shutdown();
+}
+
+/*
+========================
+RenderStateManager::Init
+========================
+*/
+void RenderStateManager::Init( VulkanContext* context ) {
+	if ( IsInitialised() ) {
+		error( "Attempt to call RenderStateManager::Init() when already initialised! Nothing will happen this time!\n" );
+		return;
+	}
+
+	mContext = context;
+
+	for ( u32 i = 0; i < MAX_LAYOUTS; i++ ) {
+		layoutEntry_t& entry = mLayouts[i];
+		memset( &entry.mKey, 0, sizeof( layoutKey_t ) );
+		entry.mHash = 0;
+		entry.mRefCount = 0;
+		entry.mDescriptorSetLayout = VK_NULL_HANDLE;
+		entry.mPipelineLayout = VK_NULL_HANDLE;
+	}
+
+	for ( u32 i = 0; i < MAX_PIPELINES; i++ ) {
+		pipelineEntry_t& entry = mPipelines[i];
+		memset( &entry.mKey, 0, sizeof( pipelineKey_t ) );
+		entry.mHash = 0;
+		entry.mRefCount = 0;
+		entry.mLayoutID = INVALID_ID;
+		entry.mPipeline = VK_NULL_HANDLE;
+		entry.mState = PIPELINE_STATE_FREE;
+	}
+
+	memset( mLayoutTable, 0xFF, sizeof( mLayoutTable ) );
+	memset( mPipelineTable, 0xFF, sizeof( mPipelineTable ) );
+
+	mNumLayouts = 0;
+	mNumPipelines = 0;
+	mNumPipelinesShared = 0;
+
+	mInitialised = true;
+}
+
+/*
+========================
+RenderStateManager::Shutdown
+========================
+*/
+void RenderStateManager::Shutdown() {
+	if ( !IsInitialised() ) {
+		return;
+	}
+
+	for ( u32 i = 0; i < MAX_PIPELINES; i++ ) {
+		if ( mPipelines[i].mRefCount > 0 ) {
+			error( "Pipeline %u still has %u references at shutdown! Something never called UnallocRenderState()!\n", i, mPipelines[i].mRefCount );
+
+			mPipelines[i].mRefCount = 1;
+			ReleasePipeline( i );
+		}
+	}
+
+	for ( u32 i = 0; i < MAX_LAYOUTS; i++ ) {
+		if ( mLayouts[i].mRefCount > 0 ) {
+			error( "Uniform layout %u still has %u references at shutdown! Something never called UnallocUniformLayout()!\n", i, mLayouts[i].mRefCount );
+
+			mLayouts[i].mRefCount = 1;
+			ReleaseLayout( i );
+		}
+	}
+
+	mJobSystem = nullptr;
+
+	mInitialised = false;
+}
+
+/*
+========================
+RenderStateManager::AcquireLayout
+========================
+*/
+u32 RenderStateManager::AcquireLayout( const uniformLayoutDesc_t& desc ) {
+	layoutKey_t key;
+	MakeLayoutKey( desc, key );
+
+	u32 hash = HashKey( key );
+
+	u32 layoutID = FindSlot( mLayoutTable, mLayouts, key, hash );
+	if ( layoutID != INVALID_ID ) {
+		mLayouts[layoutID].mRefCount++;
+		return layoutID;
+	}
+
+	for ( u32 i = 0; i < MAX_LAYOUTS; i++ ) {
+		if ( mLayouts[i].mRefCount == 0 ) {
+			layoutID = i;
+			break;
+		}
+	}
+
+	if ( layoutID == INVALID_ID ) {
+		fatalError( "Ran out of uniform layouts, MAX_LAYOUTS (%u) needs to be bigger!\n", MAX_LAYOUTS );
+		return INVALID_ID;
+	}
+
+	layoutEntry_t& entry = mLayouts[layoutID];
+	entry.mKey = key;
+	entry.mHash = hash;
+	entry.mRefCount = 1;
+
+	VkDevice device = mContext->GetLogicalDevice();
+
+	VkDescriptorSetLayoutCreateInfo descSetLayoutInfo = {};
+	descSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descSetLayoutInfo.bindingCount = key.mNumBindings;
+	descSetLayoutInfo.pBindings = entry.mKey.mBindings;
+	YETI_VK_CHECK( vkCreateDescriptorSetLayout( device, &descSetLayoutInfo, nullptr, &entry.mDescriptorSetLayout ) );
+
+	// the bindless table is the same set for every layout that uses it, so it goes after the layout's own
+	static_assert( BindlessTable::BINDLESS_SET == 1, "Bindless pipeline layouts only have room for the bindless table as set 1!" );
+
+	VkDescriptorSetLayout setLayouts[2] = { entry.mDescriptorSetLayout, VK_NULL_HANDLE };
+
+	if ( key.mBindless ) {
+		setLayouts[BindlessTable::BINDLESS_SET] = mContext->GetBindlessTable()->GetDescriptorSetLayout();
+	}
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.pushConstantRangeCount = key.mNumPushConstants;
+	pipelineLayoutInfo.pPushConstantRanges = entry.mKey.mPushConstants;
+	pipelineLayoutInfo.pSetLayouts = setLayouts;
+	pipelineLayoutInfo.setLayoutCount = key.mBindless ? 2 : 1;
+	YETI_VK_CHECK( vkCreatePipelineLayout( device, &pipelineLayoutInfo, nullptr, &entry.mPipelineLayout ) );
+
+	InsertSlot( mLayoutTable, hash, layoutID );
+	mNumLayouts++;
+
+	return layoutID;
+}
+
+/*
+========================
+RenderStateManager::ReleaseLayout
+========================
+*/
+void RenderStateManager::ReleaseLayout( const u32 layoutID ) {
+	layoutEntry_t& entry = mLayouts[layoutID];
+
+	assertf( ( entry.mRefCount > 0 ), "Attempt to release a uniform layout that has no references left!\n" );
+
+	if ( --entry.mRefCount > 0 ) {
+		return;
+	}
+
+	// its template and any freed sets made against it go, since the ID can be handed out again
+	mContext->GetDescriptorAllocator()->ForgetLayout( layoutID );
+
+	VkDevice device = mContext->GetLogicalDevice();
+
+	vkDestroyPipelineLayout( device, entry.mPipelineLayout, nullptr );
+	entry.mPipelineLayout = VK_NULL_HANDLE;
+
+	vkDestroyDescriptorSetLayout( device, entry.mDescriptorSetLayout, nullptr );
+	entry.mDescriptorSetLayout = VK_NULL_HANDLE;
+
+	RemoveSlot( mLayoutTable, entry.mHash, layoutID );
+	mNumLayouts--;
+}
+
+/*
+========================
+RenderStateManager::AcquirePipeline
+========================
+*/
+u32 RenderStateManager::AcquirePipeline( const renderStateDesc_t& desc, const renderStateCreateMode_t mode ) {
+	pipelineKey_t key;
+	MakePipelineKey( desc, key );
+
+	u32 hash = HashKey( key );
+
+	u32 pipelineID = FindSlot( mPipelineTable, mPipelines, key, hash );
+	if ( pipelineID != INVALID_ID ) {
+		mPipelines[pipelineID].mRefCount++;
+		mNumPipelinesShared++;
+		return pipelineID;
+	}
+
+	for ( u32 i = 0; i < MAX_PIPELINES; i++ ) {
+		if ( mPipelines[i].mState == PIPELINE_STATE_FREE ) {
+			pipelineID = i;
+			break;
+		}
+	}
+
+	if ( pipelineID == INVALID_ID ) {
+		fatalError( "Ran out of pipelines, MAX_PIPELINES (%u) needs to be bigger!\n", MAX_PIPELINES );
+		return INVALID_ID;
+	}
+
+	pipelineEntry_t& entry = mPipelines[pipelineID];
+	entry.mKey = key;
+	entry.mHash = hash;
+	entry.mRefCount = 1;
+	entry.mLayoutID = desc.mUniformLayout->GetLayoutID();
+	entry.mPipeline = VK_NULL_HANDLE;
+
+	mLayouts[entry.mLayoutID].mRefCount++;
+
+	InsertSlot( mPipelineTable, hash, pipelineID );
+	mNumPipelines++;
+
+	if ( mode == YETI_RENDER_STATE_CREATE_LAZY ) {
+		entry.mState = PIPELINE_STATE_LAZY;
+	} else if ( mode == YETI_RENDER_STATE_CREATE_BACKGROUND && mJobSystem ) {
+		entry.mState = PIPELINE_STATE_COMPILING;
+		mJobSystem->Submit( CompilePipelineJob, this, pipelineID, pipelineID + 1, &entry.mCounter );
+	} else {
+		CreatePipeline( entry );
+		entry.mState = PIPELINE_STATE_READY;
+	}
+
+	return pipelineID;
+}
+
+/*
+========================
+RenderStateManager::ReleasePipeline
+========================
+*/
+void RenderStateManager::ReleasePipeline( const u32 pipelineID ) {
+	pipelineEntry_t& entry = mPipelines[pipelineID];
+
+	assertf( ( entry.mRefCount > 0 ), "Attempt to release a pipeline that has no references left!\n" );
+
+	if ( --entry.mRefCount > 0 ) {
+		return;
+	}
+
+	if ( entry.mState == PIPELINE_STATE_COMPILING ) {
+		mJobSystem->Wait( &entry.mCounter );
+	}
+
+	if ( entry.mPipeline != VK_NULL_HANDLE ) {
+		vkDestroyPipeline( mContext->GetLogicalDevice(), entry.mPipeline, nullptr );
+		entry.mPipeline = VK_NULL_HANDLE;
+	}
+
+	entry.mState = PIPELINE_STATE_FREE;
+
+	ReleaseLayout( entry.mLayoutID );
+	entry.mLayoutID = INVALID_ID;
+
+	RemoveSlot( mPipelineTable, entry.mHash, pipelineID );
+	mNumPipelines--;
+}
+
+/*
+========================
+RenderStateManager::WaitForBackgroundPipelines
+========================
+*/
+void RenderStateManager::WaitForBackgroundPipelines() {
+	for ( u32 i = 0; i < MAX_PIPELINES; i++ ) {
+		if ( mPipelines[i].mState == PIPELINE_STATE_COMPILING ) {
+			FinishPipeline( i );
+		}
+	}
+}
+
+/*
+========================
+RenderStateManager::PrintStats
+========================
+*/
+void RenderStateManager::PrintStats() const {
+	printf( "Render states: %u pipelines and %u uniform layouts, %u requests shared an existing pipeline.\n", mNumPipelines, mNumLayouts, mNumPipelinesShared );
+}
+
+/*
+========================
+RenderStateManager::MakeLayoutKey
+========================
+*/
+void RenderStateManager::MakeLayoutKey( const uniformLayoutDesc_t& desc, layoutKey_t& outKey ) const {
+	assertf( ( desc.mNumBindings <= MAX_LAYOUT_BINDINGS ), "Uniform layout has too many bindings, MAX_LAYOUT_BINDINGS needs to be bigger!\n" );
+	assertf( ( desc.mNumPushConstants <= MAX_PUSH_CONSTANT_RANGES ), "Uniform layout has too many push constant ranges, MAX_PUSH_CONSTANT_RANGES needs to be bigger!\n" );
+
+	memset( &outKey, 0, sizeof( layoutKey_t ) );
+
+	assertf( ( !desc.mBindless || mContext->UsesBindless() ), "Attempt to make a bindless uniform layout when the context has no bindless table!\n" );
+
+	outKey.mNumBindings = desc.mNumBindings;
+	outKey.mNumPushConstants = desc.mNumPushConstants;
+	outKey.mBindless = desc.mBindless ? 1 : 0;
+
+	for ( u32 i = 0; i < desc.mNumBindings; i++ ) {
+		assertf( ( desc.mBindings[i].pImmutableSamplers == nullptr ), "Immutable samplers aren't supported by the render state manager!\n" );
+
+		// sorted by binding
+		u32 j = i;
+		for ( ; j > 0 && outKey.mBindings[j - 1].binding > desc.mBindings[i].binding; j-- ) {
+			outKey.mBindings[j] = outKey.mBindings[j - 1];
+		}
+
+		outKey.mBindings[j] = desc.mBindings[i];
+	}
+
+	for ( u32 i = 0; i < desc.mNumPushConstants; i++ ) {
+		outKey.mPushConstants[i] = desc.mPushConstants[i];
+	}
+}
+
+/*
+========================
+RenderStateManager::MakePipelineKey
+========================
+*/
+void RenderStateManager::MakePipelineKey( const renderStateDesc_t& desc, pipelineKey_t& outKey ) const {
+	assertf( desc.mVertexShader, "Null vertex shader specified when trying to create RenderState! Please provide a valid Shader!\n" );
+	assertf( desc.mFragmentShader, "Null fragment shader specified when trying to create RenderState! Please provide a valid Shader!\n" );
+	assertf( ( desc.mUniformLayout && desc.mUniformLayout->IsAlloced() ), "Attempt to create a RenderState with a UniformLayout that hasn't been allocated!\n" );
+
+	// none at all is fine, the vertex shader pulls everything itself
+	assertf( ( desc.mNumVertexAttribs == 0 || desc.mVertexAttribs != nullptr ), "Attempt to create a RenderState was made but specified VkVertexInputAttributeDescription was null!\n" );
+	assertf( ( desc.mNumVertexAttribs <= MAX_VERTEX_ATTRIBS ),
+		"Attempt to create a RenderState was made but specified number of VkVertexInputAttributeDescriptions was more than MAX_VERTEX_ATTRIBS!\n" );
+
+	assertf( ( desc.mNumVertexBindings == 0 || desc.mVertexBindings != nullptr ), "Attempt to create a RenderState was made but specified VkVertexInputBindingDescription was null!\n" );
+	assertf( ( desc.mNumVertexBindings <= MAX_VERTEX_BINDINGS ),
+		"Attempt to create a RenderState was made but specified number of VkVertexInputBindingDescriptions was more than MAX_VERTEX_BINDINGS!\n" );
+
+	memset( &outKey, 0, sizeof( pipelineKey_t ) );
+
+	outKey.mNumVertexBindings = desc.mNumVertexBindings;
+	outKey.mNumVertexAttribs = desc.mNumVertexAttribs;
+
+	// sorted so that listing the same inputs in a different order is still the same pipeline
+	for ( u32 i = 0; i < desc.mNumVertexBindings; i++ ) {
+		u32 j = i;
+		for ( ; j > 0 && outKey.mVertexBindings[j - 1].binding > desc.mVertexBindings[i].binding; j-- ) {
+			outKey.mVertexBindings[j] = outKey.mVertexBindings[j - 1];
+		}
+
+		outKey.mVertexBindings[j] = desc.mVertexBindings[i];
+	}
+
+	for ( u32 i = 0; i < desc.mNumVertexAttribs; i++ ) {
+		u32 j = i;
+		for ( ; j > 0 && outKey.mVertexAttribs[j - 1].location > desc.mVertexAttribs[i].location; j-- ) {
+			outKey.mVertexAttribs[j] = outKey.mVertexAttribs[j - 1];
+		}
+
+		outKey.mVertexAttribs[j] = desc.mVertexAttribs[i];
+	}
+
+	outKey.mVertexShader = desc.mVertexShader->GetShaderCreateInfo().module;
+	outKey.mFragmentShader = desc.mFragmentShader->GetShaderCreateInfo().module;
+	outKey.mPipelineLayout = desc.mUniformLayout->GetPipelineLayout();
+	outKey.mRenderPass = mContext->GetRenderPass();
+	outKey.mColorFormat = mContext->GetColorFormat();
+
+	outKey.mTopology = desc.mTopology;
+	outKey.mCullMode = desc.mCullMode;
+	outKey.mFrontFace = desc.mFrontFace;
+	outKey.mPolygonMode = desc.mPolygonMode;
+	outKey.mLineWidth = desc.mLineWidth;
+	outKey.mEnableDepthTest = desc.mEnableDepthTest ? 1 : 0;
+	outKey.mEnableDepthWrite = desc.mEnableDepthWrite ? 1 : 0;
+	outKey.mEnableStencil = desc.mEnableStencil ? 1 : 0;
+	outKey.mEnableAlpha = desc.mEnableAlpha ? 1 : 0;
+
+	// the compare op is ignored with depth testing off, so it shouldn't stop two states matching
+	outKey.mDepthTestOp = outKey.mEnableDepthTest ? desc.mDepthTestOp : VK_COMPARE_OP_NEVER;
+}
+
+/*
+========================
+RenderStateManager::CreatePipeline
+========================
+*/
+void RenderStateManager::CreatePipeline( pipelineEntry_t& entry ) {
+	const pipelineKey_t& key = entry.mKey;
+
+	VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+	vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInputState.pVertexAttributeDescriptions = key.mVertexAttribs;
+	vertexInputState.vertexAttributeDescriptionCount = key.mNumVertexAttribs;
+	vertexInputState.pVertexBindingDescriptions = key.mVertexBindings;
+	vertexInputState.vertexBindingDescriptionCount = key.mNumVertexBindings;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+	inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+	inputAssemblyState.topology = key.mTopology;
+
+	VkPipelineRasterizationStateCreateInfo rasterState = {};
+	rasterState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterState.cullMode = key.mCullMode;
+	rasterState.depthClampEnable = VK_FALSE;
+	rasterState.frontFace = key.mFrontFace;
+	rasterState.lineWidth = key.mLineWidth;
+	rasterState.polygonMode = key.mPolygonMode;
+
+	VkPipelineColorBlendAttachmentState blendAttachmentState = {};
+	blendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	blendAttachmentState.blendEnable = key.mEnableAlpha;
+	if ( key.mEnableAlpha ) {
+		blendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+		blendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		blendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	}
+
+	VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+	colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlendState.attachmentCount = 1;
+	colorBlendState.pAttachments = &blendAttachmentState;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+	depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencilState.depthTestEnable = key.mEnableDepthTest;
+	depthStencilState.depthCompareOp = key.mDepthTestOp;
+	depthStencilState.depthWriteEnable = key.mEnableDepthWrite;
+	depthStencilState.front = depthStencilState.back;
+
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.scissorCount = 1;
+	viewportState.viewportCount = 1;
+
+	// TODO: implement SamplerState
+	VkPipelineMultisampleStateCreateInfo multiSampleState = {};
+	multiSampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multiSampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkDynamicState dynamicStates[] = {
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR,
+	};
+
+	VkPipelineDynamicStateCreateInfo dynamicStateInfo = {};
+	dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicStateInfo.dynamicStateCount = 2;
+	dynamicStateInfo.pDynamicStates = dynamicStates;
+
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].module = key.mVertexShader;
+	shaderStages[0].pName = "main";
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].module = key.mFragmentShader;
+	shaderStages[1].pName = "main";
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+	pipelineInfo.basePipelineIndex = -1;
+	pipelineInfo.layout = key.mPipelineLayout;
+	pipelineInfo.pColorBlendState = &colorBlendState;
+	pipelineInfo.pDepthStencilState = &depthStencilState;
+	pipelineInfo.pDynamicState = &dynamicStateInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssemblyState;
+	pipelineInfo.pMultisampleState = &multiSampleState;
+	pipelineInfo.pRasterizationState = &rasterState;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputState;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.renderPass = key.mRenderPass;
+
+#if YETI_VK_DYNAMIC_RENDERING
+	// without a render pass the pipeline only knows what it draws to from the formats
+	VkPipelineRenderingCreateInfoKHR renderingInfo = {};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+	renderingInfo.colorAttachmentCount = 1;
+	renderingInfo.pColorAttachmentFormats = &key.mColorFormat;
+
+	if ( key.mRenderPass == VK_NULL_HANDLE ) {
+		pipelineInfo.pNext = &renderingInfo;
+	}
+#endif
+
+	PipelineCache* pipelineCache = mContext->GetPipelineCache();
+
+	// VkPipelineCache is internally synchronised, so this is safe from any thread
+	timestamp_t start = timeNow();
+
+	YETI_VK_CHECK( vkCreateGraphicsPipelines( mContext->GetLogicalDevice(), pipelineCache->GetAPIHandle(), 1, &pipelineInfo, nullptr, &entry.mPipeline ) );
+
+	float64 delta = deltaMilliseconds( start, timeNow() );
+
+	std::lock_guard<std::mutex> lock( mStatsMutex );
+	pipelineCache->AddPipelineTime( delta );
+}
+
+/*
+========================
+RenderStateManager::FinishPipeline
+========================
+*/
+VkPipeline RenderStateManager::FinishPipeline( const u32 pipelineID ) {
+	pipelineEntry_t& entry = mPipelines[pipelineID];
+
+	switch ( entry.mState ) {
+	case PIPELINE_STATE_LAZY:
+		CreatePipeline( entry );
+		break;
+
+	case PIPELINE_STATE_COMPILING:
+		mJobSystem->Wait( &entry.mCounter );
+		break;
+
+	default:
+		assertf( false, "Attempt to get a pipeline that was never acquired!\n" );
+		return VK_NULL_HANDLE;
+	}
+
+	entry.mState = PIPELINE_STATE_READY;
+
+	return entry.mPipeline;
+}
+
+/*
+========================
+RenderStateManager::CompilePipelineJob
+========================
+*/
+void RenderStateManager::CompilePipelineJob( void* data, const u32 start, const u32 end, u32 workerIndex ) {
+	UNUSED( workerIndex );
+
+	RenderStateManager* manager = static_cast<RenderStateManager*>( data );
+
+	// only the main thread changes mState, so the job only touches the handle
+	for ( u32 pipelineID = start; pipelineID < end; pipelineID++ ) {
+		manager->CreatePipeline( manager->mPipelines[pipelineID] );
+	}
+}
\ No newline at end of file
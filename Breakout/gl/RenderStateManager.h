@@ -0,0 +1,196 @@
+#ifndef __RENDER_STATE_MANAGER_H__
+#define __RENDER_STATE_MANAGER_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+#include <mutex>
+
+#include "../JobSystem.h"
+
+class VulkanContext;
+
+struct renderStateDesc_t;
+struct uniformLayoutDesc_t;
+
+enum renderStateCreateMode_t {
+	YETI_RENDER_STATE_CREATE_NOW		= 0,	// compiled before AcquirePipeline() returns
+	YETI_RENDER_STATE_CREATE_LAZY,				// compiled the first time GetPipeline() is called
+	YETI_RENDER_STATE_CREATE_BACKGROUND,		// compiled on the job system, the first GetPipeline() waits if it isn't done yet
+};
+
+/*
+================================================================================================
+
+	Render State Manager
+
+	Owns every VkPipeline, VkPipelineLayout and VkDescriptorSetLayout. RenderState and
+	UniformLayout ask for them by description, and anything described the same way gets the
+	same objects back with a reference added, so a new pass that reuses an existing state
+	doesn't compile anything. Objects are destroyed once the last reference is released.
+
+	Descriptions are copied into a fixed size key first with everything that doesn't change
+	the result zeroed and the vertex inputs and bindings sorted, so two descriptions that only
+	differ in order still match. Keys are found through an open addressed hash table, and
+	after that everything is looked up by ID, which is just an index.
+
+	Shaders are keyed on their VkShaderModule, so a Shader MUST outlive any render state that
+	uses it, at least until its pipeline has actually been compiled.
+
+================================================================================================
+*/
+
+class RenderStateManager {
+public:
+	static const u32		MAX_PIPELINES = 64;
+	static const u32		MAX_LAYOUTS = 32;
+
+	static const u32		MAX_VERTEX_BINDINGS = 4;
+	static const u32		MAX_VERTEX_ATTRIBS = 16;
+	static const u32		MAX_LAYOUT_BINDINGS = 8;
+	static const u32		MAX_PUSH_CONSTANT_RANGES = 4;
+
+	static const u32		INVALID_ID = U32_MAX;
+
+public:
+							RenderStateManager();
+	virtual					~RenderStateManager();
+
+	void					Init( VulkanContext* context );
+	void					Shutdown();
+	inline bool32			IsInitialised() const { return mInitialised; }
+
+	// without one YETI_RENDER_STATE_CREATE_BACKGROUND compiles straight away instead
+	inline void				SetJobSystem( JobSystem* jobSystem ) { mJobSystem = jobSystem; }
+
+	u32						AcquireLayout( const uniformLayoutDesc_t& desc );
+	void					ReleaseLayout( const u32 layoutID );
+
+	inline VkDescriptorSetLayout	GetDescriptorSetLayout( const u32 layoutID ) const { return mLayouts[layoutID].mDescriptorSetLayout; }
+	inline VkPipelineLayout	GetPipelineLayout( const u32 layoutID ) const { return mLayouts[layoutID].mPipelineLayout; }
+
+	// sorted by binding
+	inline const VkDescriptorSetLayoutBinding*	GetLayoutBindings( const u32 layoutID, u32& outNumBindings ) const { outNumBindings = mLayouts[layoutID].mKey.mNumBindings; return mLayouts[layoutID].mKey.mBindings; }
+
+	// desc.mUniformLayout MUST be allocated
+	u32						AcquirePipeline( const renderStateDesc_t& desc, const renderStateCreateMode_t mode );
+	void					ReleasePipeline( const u32 pipelineID );
+
+	// compiles or waits on the pipeline if it isn't ready yet, otherwise it's just an index
+	inline VkPipeline		GetPipeline( const u32 pipelineID );
+
+	// blocks until nothing is compiling on the job system
+	void					WaitForBackgroundPipelines();
+
+	void					PrintStats() const;
+
+private:
+	enum pipelineState_t {
+		PIPELINE_STATE_FREE		= 0,
+		PIPELINE_STATE_LAZY,
+		PIPELINE_STATE_COMPILING,
+		PIPELINE_STATE_READY,
+	};
+
+	// MUST be memset to 0 before being filled in so the padding hashes the same every time
+	struct layoutKey_t {
+		VkDescriptorSetLayoutBinding		mBindings[MAX_LAYOUT_BINDINGS];
+		VkPushConstantRange					mPushConstants[MAX_PUSH_CONSTANT_RANGES];
+		u32									mNumBindings;
+		u32									mNumPushConstants;
+		u32									mBindless;
+	};
+
+	struct pipelineKey_t {
+		VkVertexInputBindingDescription		mVertexBindings[MAX_VERTEX_BINDINGS];
+		VkVertexInputAttributeDescription	mVertexAttribs[MAX_VERTEX_ATTRIBS];
+		u32									mNumVertexBindings;
+		u32									mNumVertexAttribs;
+
+		VkShaderModule						mVertexShader;
+		VkShaderModule						mFragmentShader;
+		VkPipelineLayout					mPipelineLayout;
+		VkRenderPass						mRenderPass;		// VK_NULL_HANDLE with dynamic rendering
+		VkFormat							mColorFormat;
+
+		VkPrimitiveTopology					mTopology;
+		VkCullModeFlags						mCullMode;
+		VkFrontFace							mFrontFace;
+		VkPolygonMode						mPolygonMode;
+		float32								mLineWidth;
+		VkCompareOp							mDepthTestOp;
+		u32									mEnableDepthTest;
+		u32									mEnableDepthWrite;
+		u32									mEnableStencil;
+		u32									mEnableAlpha;
+	};
+
+	struct layoutEntry_t {
+		layoutKey_t				mKey;
+		u32						mHash;
+		u32						mRefCount;
+
+		VkDescriptorSetLayout	mDescriptorSetLayout;
+		VkPipelineLayout		mPipelineLayout;
+	};
+
+	struct pipelineEntry_t {
+		pipelineKey_t			mKey;
+		u32						mHash;
+		u32						mRefCount;
+		u32						mLayoutID;		// holds a reference so the layout is still there to compile against
+
+		VkPipeline				mPipeline;
+		pipelineState_t			mState;
+		jobCounter_t			mCounter;
+	};
+
+	VulkanContext*			mContext;
+	JobSystem*				mJobSystem;
+
+	layoutEntry_t			mLayouts[MAX_LAYOUTS];
+	pipelineEntry_t			mPipelines[MAX_PIPELINES];
+
+	// twice the entries so probes stay short, entries are found by hash & ( size - 1 )
+	u32						mLayoutTable[MAX_LAYOUTS * 2];
+	u32						mPipelineTable[MAX_PIPELINES * 2];
+
+	u32						mNumLayouts;
+	u32						mNumPipelines;
+
+	// how many times AcquirePipeline() found an existing pipeline instead of compiling
+	u32						mNumPipelinesShared;
+
+	// the pipeline cache's stats aren't thread safe
+	std::mutex				mStatsMutex;
+
+	bool32					mInitialised;
+
+private:
+	void					MakeLayoutKey( const uniformLayoutDesc_t& desc, layoutKey_t& outKey ) const;
+	void					MakePipelineKey( const renderStateDesc_t& desc, pipelineKey_t& outKey ) const;
+
+	void					CreatePipeline( pipelineEntry_t& entry );
+	VkPipeline				FinishPipeline( const u32 pipelineID );
+
+	// [start, end) are pipeline IDs
+	static void				CompilePipelineJob( void* data, const u32 start, const u32 end, u32 workerIndex );
+};
+
+/*
+========================
+RenderStateManager::GetPipeline
+========================
+*/
+VkPipeline RenderStateManager::GetPipeline( const u32 pipelineID ) {
+	const pipelineEntry_t& entry = mPipelines[pipelineID];
+
+	if ( entry.mState == PIPELINE_STATE_READY ) {
+		return entry.mPipeline;
+	}
+
+	return FinishPipeline( pipelineID );
+}
+
+#endif // __RENDER_STATE_MANAGER_H__
\ No newline at end of file
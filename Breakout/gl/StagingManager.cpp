@@ -19,9 +19,15 @@ StagingManager::StagingManager
 StagingManager::StagingManager() {
 	mMapped = nullptr;
 
+	mContext = nullptr;
+
 	mDeviceMemory = VK_NULL_HANDLE;
 	mCommandPool = VK_NULL_HANDLE;
 
+	mMaxBufferSizeBytes = 0;
+
+	mCurrentBufferIndex = 0;
+
 	mInitialised = false;
 }
 
@@ -58,6 +64,7 @@ void StagingManager::Init( VulkanContext* context, const u32 numBuffers, const u
 	VkDevice logicalDevice = mContext->GetLogicalDevice();
 
 	mStagingBuffers.resize( numBuffers );
+	mCurrentBufferIndex = 0;
 
 	mMaxBufferSizeBytes = maxBufferSizeMB * MB_TO_BYTES;
 
@@ -193,24 +200,26 @@ u8* StagingManager::Stage( const size_t sizeBytes, const s32 alignment, VkComman
 	assertf( sizeBytes <= mMaxBufferSizeBytes, "Stage() failed because specified size of data to stage was larger than the maximum allowed buffer size!\n" );
 	assertf( alignment > 0, "Stage() failed because specified alignment was < 0! Must be >= 0!\n" );
 
-	stagingBuffer_t& stagingBuffer = mStagingBuffers[mCurrentBufferIndex];
-	stagingBuffer.mOffset = GetAlignedSize( sizeBytes, alignment );
+	stagingBuffer_t* stagingBuffer = &mStagingBuffers[mCurrentBufferIndex];
 
-	if ( ( stagingBuffer.mOffset + sizeBytes >= mMaxBufferSizeBytes ) && !stagingBuffer.mSubmitted ) {
+	if ( ( GetAlignedSize( stagingBuffer->mOffset, alignment ) + sizeBytes >= mMaxBufferSizeBytes ) && !stagingBuffer->mSubmitted ) {
 		Flush();
 	}
 
-	stagingBuffer = mStagingBuffers[mCurrentBufferIndex];
-	if ( stagingBuffer.mSubmitted ) {
-		WaitForBuffer( stagingBuffer );
+	// flushing moves on to the next buffer, which might still be in flight
+	stagingBuffer = &mStagingBuffers[mCurrentBufferIndex];
+	if ( stagingBuffer->mSubmitted ) {
+		WaitForBuffer( *stagingBuffer );
 	}
 
-	commandBuffer = stagingBuffer.mCommandBuffer;
-	buffer = stagingBuffer.mBuffer;
-	bufferOffset = stagingBuffer.mOffset;
+	stagingBuffer->mOffset = GetAlignedSize( stagingBuffer->mOffset, alignment );
+
+	commandBuffer = stagingBuffer->mCommandBuffer;
+	buffer = stagingBuffer->mBuffer;
+	bufferOffset = stagingBuffer->mOffset;
 
-	u8* data = stagingBuffer.mData + stagingBuffer.mOffset;
-	stagingBuffer.mOffset += sizeBytes;
+	u8* data = stagingBuffer->mData + stagingBuffer->mOffset;
+	stagingBuffer->mOffset += sizeBytes;
 
 	return data;
 }
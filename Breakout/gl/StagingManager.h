@@ -3,7 +3,7 @@
 
 #include <mstd/mstd.h>
 
-#include <vulkan/vulkan.h>
+#include "VulkanDispatch.h"
 #include "vma/vma.h"
 
 class VulkanContext;
@@ -9,9 +9,11 @@ UniformLayout::UniformLayout
 UniformLayout::UniformLayout( VulkanContext* context ) {
 	mContext = context;
 
-	mDescriptorSet = VK_NULL_HANDLE;
+	mDescriptorSet = {};
 	mDescriptorSetLayout = VK_NULL_HANDLE;
 	mPipelineLayout = VK_NULL_HANDLE;
+
+	mLayoutID = RenderStateManager::INVALID_ID;
 }
 
 /*
@@ -37,81 +39,68 @@ void UniformLayout::AllocUniformLayout( const uniformLayoutDesc_t& desc ) {
 
 	bool32 hasUniformData = desc.mUniformBuffers.length() > 0 || desc.mTextures.length() > 0;
 	if ( hasUniformData ) {
-		assertf( desc.mDescriptorPool, "Cannot create a UniformLayout that has uniform buffers or textures specified without also specifying a VkDescriptorPool! Please make some!" );
 		assertf( desc.mBindings, "Cannot create a UniformLayout that has uniform buffers or textures specified without also specifying VkDescriptorSetLayoutBindings! Please make some!" );
 	}
 
-	VkDevice device = mContext->GetLogicalDevice();
-
-	VkDescriptorSetLayoutCreateInfo descSetLayoutInfo = {};
-	descSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	descSetLayoutInfo.bindingCount = desc.mNumBindings;
-	descSetLayoutInfo.pBindings = desc.mBindings;
-	YETI_VK_CHECK( vkCreateDescriptorSetLayout( device, &descSetLayoutInfo, nullptr, &mDescriptorSetLayout ) );
+	RenderStateManager* renderStateManager = mContext->GetRenderStateManager();
 
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.pushConstantRangeCount = desc.mNumPushConstants;
-	pipelineLayoutInfo.pPushConstantRanges = desc.mPushConstants;
-	pipelineLayoutInfo.pSetLayouts = &mDescriptorSetLayout;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	YETI_VK_CHECK( vkCreatePipelineLayout( device, &pipelineLayoutInfo, nullptr, &mPipelineLayout ) );
+	mLayoutID = renderStateManager->AcquireLayout( desc );
+	mDescriptorSetLayout = renderStateManager->GetDescriptorSetLayout( mLayoutID );
+	mPipelineLayout = renderStateManager->GetPipelineLayout( mLayoutID );
 
 	if ( hasUniformData ) {
-		VkDescriptorSetAllocateInfo descSetAllocInfo = {};
-		descSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		descSetAllocInfo.descriptorPool = desc.mDescriptorPool;
-		descSetAllocInfo.descriptorSetCount = 1;
-		descSetAllocInfo.pSetLayouts = &mDescriptorSetLayout;
-		YETI_VK_CHECK( vkAllocateDescriptorSets( device, &descSetAllocInfo, &mDescriptorSet ) );
-	}
+		DescriptorAllocator* descriptorAllocator = mContext->GetDescriptorAllocator();
+
+		mDescriptorSet = descriptorAllocator->Alloc( mLayoutID );
 
-	if ( hasUniformData ) {
 		u32 uniformIndex = 0;
 		u32 textureIndex = 0;
 
-		array<VkWriteDescriptorSet> writeDescs( desc.mNumBindings );
+		// in the template's order, which isn't necessarily the order the bindings were given in
+		descriptorData_t data[DescriptorAllocator::MAX_DESCRIPTORS_PER_SET] = {};
 
 		for ( u32 i = 0; i < desc.mNumBindings; i++ ) {
-			VkWriteDescriptorSet& writeDesc = writeDescs[i];
 			const VkDescriptorSetLayoutBinding& binding = desc.mBindings[i];
 
-			writeDesc = {};
-			writeDesc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			writeDesc.descriptorCount = binding.descriptorCount;
-			writeDesc.descriptorType = binding.descriptorType;
-			writeDesc.dstBinding = binding.binding;
-			writeDesc.dstSet = mDescriptorSet;
+			u32 dataIndex = descriptorAllocator->GetDataIndex( mLayoutID, binding.binding );
 
 			switch ( binding.descriptorType ) {
+			// storage buffers come out of mUniformBuffers too, in the same binding order
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-				writeDesc.pBufferInfo = &desc.mUniformBuffers[uniformIndex]->GetDescriptorInfo();
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				data[dataIndex].mBuffer = desc.mUniformBuffers[uniformIndex]->GetDescriptorInfo();
 				uniformIndex++;
 				break;
 
 			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-				writeDesc.pImageInfo = &desc.mTextures[textureIndex]->GetDescriptorInfo();
+				data[dataIndex].mImage = desc.mTextures[textureIndex]->GetDescriptorInfo();
 				textureIndex++;
 				break;
 			}
 		}
 
-		u32 numDescriptors = static_cast<u32>( writeDescs.length() );
-		vkUpdateDescriptorSets( device, numDescriptors, writeDescs.data(), 0, nullptr );
+		descriptorAllocator->Update( mDescriptorSet.mSet, mLayoutID, data );
 	}
 }
 
+/*
+========================
+UniformLayout::UnallocUniformLayout
+========================
+*/
 void UniformLayout::UnallocUniformLayout() {
 	if ( !IsAlloced() ) {
 		return;
 	}
 
-	VkDevice device = mContext->GetLogicalDevice();
+	// before the layout's released, the allocator forgets its free sets if this was the last reference
+	mContext->GetDescriptorAllocator()->Free( mDescriptorSet );
+	mDescriptorSet = {};
 
-	vkDestroyDescriptorSetLayout( device, mDescriptorSetLayout, nullptr );
-	mDescriptorSetLayout = VK_NULL_HANDLE;
+	mContext->GetRenderStateManager()->ReleaseLayout( mLayoutID );
+	mLayoutID = RenderStateManager::INVALID_ID;
 
-	vkDestroyPipelineLayout( device, mPipelineLayout, nullptr );
+	mDescriptorSetLayout = VK_NULL_HANDLE;
 	mPipelineLayout = VK_NULL_HANDLE;
 }
\ No newline at end of file
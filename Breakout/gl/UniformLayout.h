@@ -2,13 +2,12 @@
 #define __UNIFORM_H__
 
 #include "gl_main.h"
+#include "DescriptorAllocator.h"
 
 class Buffer;
 class Texture;
 
 struct uniformLayoutDesc_t {
-	VkDescriptorPool				mDescriptorPool;
-
 	array<Buffer*>					mUniformBuffers;
 	array<Texture*>					mTextures;
 	VkDescriptorSetLayoutBinding*	mBindings;
@@ -16,6 +15,9 @@ struct uniformLayoutDesc_t {
 
 	u32								mNumBindings;
 	u32								mNumPushConstants;
+
+	// the context's BindlessTable becomes set BindlessTable::BINDLESS_SET, MUST only be set when the context UsesBindless()
+	bool32							mBindless;
 };
 
 /*
@@ -25,8 +27,13 @@ struct uniformLayoutDesc_t {
 
 	Holds information about all Uniform data inside a Yeti RenderState.
 
-	It is still your job to allocate a VkDescriptorPool and pass this through to the
-	uniformLayoutDesc_t upon creating the uniform layout.
+	The descriptor set and pipeline layouts come from the context's RenderStateManager and are
+	shared with every other uniform layout that has the same bindings and push constants. The
+	descriptor set is always this uniform layout's own, allocated from the context's
+	DescriptorAllocator and written in one go with the layout's update template.
+
+	A bindless uniform layout's pipeline layout has the context's BindlessTable as a second set,
+	which whoever draws binds next to this one's, it isn't part of this uniform layout.
 
 ================================================================================================
 */
@@ -38,8 +45,9 @@ public:
 
 	inline bool32					IsAlloced() const { return mPipelineLayout != VK_NULL_HANDLE; }
 
-	inline VkDescriptorSet			GetDescriptorSet() const { return mDescriptorSet; }
+	inline VkDescriptorSet			GetDescriptorSet() const { return mDescriptorSet.mSet; }
 	inline VkPipelineLayout			GetPipelineLayout() const { return mPipelineLayout; }
+	inline u32						GetLayoutID() const { return mLayoutID; }
 
 	void							AllocUniformLayout( const uniformLayoutDesc_t& desc );
 	void							UnallocUniformLayout();
@@ -47,9 +55,11 @@ public:
 private:
 	VulkanContext*					mContext;
 
-	VkDescriptorSet					mDescriptorSet;
+	descriptorAllocation_t			mDescriptorSet;
 	VkDescriptorSetLayout			mDescriptorSetLayout;
 	VkPipelineLayout				mPipelineLayout;
+
+	u32								mLayoutID;
 };
 
 #endif // __UNIFORM_H__
\ No newline at end of file
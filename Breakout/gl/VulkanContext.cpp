@@ -20,6 +20,15 @@ VulkanContext::VulkanContext() {
 	mStagingManager = nullptr;
 
 	mStagingManager = nullptr;
+	mFrameAllocator = nullptr;
+	mGPUProfiler = nullptr;
+	mFrameReadback = nullptr;
+	mCommandRecorder = nullptr;
+	mRenderGraph = nullptr;
+	mDescriptorAllocator = nullptr;
+	mBindlessTable = nullptr;
+	mPipelineCache = nullptr;
+	mRenderStateManager = nullptr;
 
 	mSurfaceFormat = {};
 
@@ -29,10 +38,8 @@ VulkanContext::VulkanContext() {
 
 	mRenderPass = VK_NULL_HANDLE;
 
-	mCommandPool = VK_NULL_HANDLE;
-
-	mSemaphoreAcquireImage = VK_NULL_HANDLE;
-	mSemaphoreRenderComplete = VK_NULL_HANDLE;
+	mBackBuffer = RenderGraph::INVALID_HANDLE;
+	mSwapChainPass = 0;
 
 	mWindowSurface = VK_NULL_HANDLE;
 
@@ -43,6 +50,22 @@ VulkanContext::VulkanContext() {
 
 	mWidth = mHeight = 0;
 	mNumBuffers = 0;
+	mNumFramesInFlight = 0;
+	mCurrentImageIndex = 0;
+	mFrameIndex = 0;
+
+	mNumRetiredSwapChains = 0;
+
+	mAPIVersion = 0;
+
+	mUseDynamicRendering = false;
+	mUseDescriptorUpdateTemplates = false;
+	mUseBindless = false;
+
+	mHeadless = false;
+
+	mSwapChainSuspended = false;
+	mFrameSkipped = false;
 
 	mInitialised = false;
 }
@@ -64,56 +87,93 @@ VulkanContext::Clear
 void VulkanContext::Clear() {
 	mStagingManager->Flush();
 
-	VkResult result = vkAcquireNextImageKHR( mLogicalDevice, mSwapChain, U64_MAX, mSemaphoreAcquireImage, VK_NULL_HANDLE, &mCurrentImageIndex );
-	if ( result == VK_ERROR_OUT_OF_DATE_KHR ) {
-		RecreateSwapChain();
+	frameContext_t& frame = mFrames[mFrameIndex];
+
+	// only waits if the CPU has got mNumFramesInFlight frames ahead
+	YETI_VK_CHECK( vkWaitForFences( mLogicalDevice, 1, &frame.mFence, VK_TRUE, U64_MAX ) );
+
+	// a skipped frame waits on the same fence again next time, which is why these go by frame context and not by count
+	if ( mNumRetiredSwapChains > 0 ) {
+		DestroyRetiredSwapChains( mFrameIndex, false );
+	}
+
+	// whatever this frame context copied out last time has finished too
+	if ( mFrameReadback ) {
+		mFrameReadback->BeginFrame( mFrameIndex );
+	}
+
+	if ( mHeadless ) {
+		// nothing to acquire, every frame context has its own image and the fence says it's free
+		mCurrentImageIndex = mFrameIndex;
 	} else {
+		// see if the window has come back since the last frame
+		if ( mSwapChainSuspended ) {
+			RecreateSwapChain( mWidth, mHeight );
+		}
+
+		VkResult result = VK_ERROR_OUT_OF_DATE_KHR;
+		if ( !mSwapChainSuspended ) {
+			result = vkAcquireNextImageKHR( mLogicalDevice, mSwapChain, U64_MAX, frame.mSemaphoreAcquireImage, VK_NULL_HANDLE, &mCurrentImageIndex );
+			if ( result == VK_ERROR_OUT_OF_DATE_KHR ) {
+				// a failed acquire doesn't signal anything, so the same semaphore is fine to try again with
+				RecreateSwapChain( mWidth, mHeight );
+
+				if ( !mSwapChainSuspended ) {
+					result = vkAcquireNextImageKHR( mLogicalDevice, mSwapChain, U64_MAX, frame.mSemaphoreAcquireImage, VK_NULL_HANDLE, &mCurrentImageIndex );
+				}
+			}
+		}
+
+		// still minimised or still out of date, the fence is left signalled and nothing is begun so Present() has nothing to undo
+		mFrameSkipped = result == VK_ERROR_OUT_OF_DATE_KHR;
+		if ( mFrameSkipped ) {
+			return;
+		}
+
 		YETI_VK_CHECK( result );
 	}
 
-	VkRect2D renderArea = {};
-	renderArea.offset = { 0, 0 };
-	renderArea.extent = { mWidth, mHeight };
+	// not reset until there's definitely going to be a submit to signal it again
+	YETI_VK_CHECK( vkResetFences( mLogicalDevice, 1, &frame.mFence ) );
 
-	VkCommandBuffer& currentCommandBuffer = mCommandBuffers[mCurrentImageIndex];
+	// the last frame to use this region was this frame context's, which the fence says is done
+	mFrameAllocator->BeginFrame( mFrameIndex );
 
-	VkFence* fence = &mFences[mCurrentImageIndex];
-	if ( mCommandBuffersSubmitted[mCurrentImageIndex] ) {
-		YETI_VK_CHECK( vkWaitForFences( mLogicalDevice, 1, fence, VK_TRUE, U64_MAX ) );
+	// hands back everything the last recording allocated, instead of releasing each buffer's memory
+	YETI_VK_CHECK( vkResetCommandPool( mLogicalDevice, frame.mCommandPool, 0 ) );
+
+	// and the same for every worker's secondary buffers
+	mCommandRecorder->BeginFrame( mFrameIndex );
+
+	// and every transient descriptor set
+	mDescriptorAllocator->BeginFrame( mFrameIndex );
+
+	// and bindless slots that were removed get a frame closer to being reused
+	if ( mBindlessTable ) {
+		mBindlessTable->BeginFrame();
 	}
 
-	YETI_VK_CHECK( vkResetFences( mLogicalDevice, 1, fence ) );
+	VkCommandBuffer currentCommandBuffer = frame.mCommandBuffer;
 
 	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-	YETI_VK_CHECK( vkResetCommandBuffer( currentCommandBuffer, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT ) );
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 	YETI_VK_CHECK( vkBeginCommandBuffer( currentCommandBuffer, &commandBufferBeginInfo ) );
 
-	vkCmdResetQueryPool( currentCommandBuffer, mQueryPoolTimestamps, 0, NUM_GPU_QUERIES );
+	// reads back whatever this frame context last timed and resets its queries
+	mGPUProfiler->BeginFrame( currentCommandBuffer, mFrameIndex );
 
-	VkClearValue clearValue = {};
-	clearValue.color = { 0.0f, 0.0f, 0.0f, 1.0f };
+	mRenderGraph->BeginFrame();
 
-	VkRenderPassBeginInfo renderPassBeginInfo = {};
-	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassBeginInfo.pClearValues = &clearValue;
-	renderPassBeginInfo.clearValueCount = 1;
-	renderPassBeginInfo.framebuffer = mFramebuffers[mCurrentImageIndex];
-	renderPassBeginInfo.renderArea = renderArea;
-	renderPassBeginInfo.renderPass = mRenderPass;
-	vkCmdBeginRenderPass( currentCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
-
-	VkViewport viewport = {};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float32>( mWidth );
-	viewport.height = static_cast<float32>( mHeight );
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport( currentCommandBuffer, 0, 1, &viewport );
-
-	vkCmdSetScissor( currentCommandBuffer, 0, 1, &renderArea );
+	// the presentation engine doesn't keep the contents, so it starts undefined every frame
+	// headless nothing is kept either, and it's left ready for the readback to copy out of
+	VkImageLayout finalLayout = mHeadless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	mBackBuffer = mRenderGraph->ImportImage( "BackBuffer", mSwapChainImages[mCurrentImageIndex], mSwapChainImageViews[mCurrentImageIndex], mSurfaceFormat.format,
+		mWidth, mHeight, VK_IMAGE_LAYOUT_UNDEFINED, finalLayout );
+
+	// not a color attachment as far as the graph is concerned, it begins the pass itself for the secondary buffers
+	mSwapChainPass = mRenderGraph->AddPass( "SwapChain", RecordSwapChainPass, this );
+	mRenderGraph->Write( mSwapChainPass, mBackBuffer, YETI_RENDER_GRAPH_ACCESS_COLOR_ATTACHMENT );
 }
 
 /*
@@ -122,55 +182,61 @@ VulkanContext::Present
 ========================
 */
 void VulkanContext::Present() {
-	VkCommandBuffer& currentCommandBuffer = mCommandBuffers[mCurrentImageIndex];
+	if ( mFrameSkipped ) {
+		return;
+	}
+
+	frameContext_t& frame = mFrames[mFrameIndex];
+
+	VkCommandBuffer currentCommandBuffer = frame.mCommandBuffer;
 
-	vkCmdWriteTimestamp( currentCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mQueryPoolTimestamps, 0 );
-	vkCmdWriteTimestamp( currentCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mQueryPoolTimestamps, 1 );
+	// every worker's recording has finished by now, so the swap chain pass can go in with everything else
+	mRenderGraph->Execute( currentCommandBuffer );
 
-	vkCmdEndRenderPass( currentCommandBuffer );
 	YETI_VK_CHECK( vkEndCommandBuffer( currentCommandBuffer ) );
 
-	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	mFrameAllocator->EndFrame();
 
 	VkSubmitInfo submitInfo = {};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	submitInfo.pCommandBuffers = &currentCommandBuffer;
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pSignalSemaphores = &mSemaphoreRenderComplete;
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = &mSemaphoreAcquireImage;
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitDstStageMask = &waitStage;
-	YETI_VK_CHECK( vkQueueSubmit( mQueues[YETI_QUEUE_TYPE_GRAPHICS], 1, &submitInfo, mFences[mCurrentImageIndex] ) );
 
-	{
-		u32 stride = sizeof( u64 );
-		VkQueryResultFlags queryFlags = VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT;
-		float64 factor = 1000000.0 * mActiveGPU.mProperties.limits.timestampPeriod;
+	// no image to wait for and nobody to present to, the fence is the only thing anything waits on
+	if ( mHeadless ) {
+		YETI_VK_CHECK( vkQueueSubmit( mQueues[YETI_QUEUE_TYPE_GRAPHICS], 1, &submitInfo, frame.mFence ) );
 
-		u64 start = 0;
-		u64 end = 0;
-		YETI_VK_CHECK( vkGetQueryPoolResults( mLogicalDevice, mQueryPoolTimestamps, 0, 1, stride, &start, 0, queryFlags ) );
-		YETI_VK_CHECK( vkGetQueryPoolResults( mLogicalDevice, mQueryPoolTimestamps, 1, 1, stride, &end, 0, queryFlags ) );
+		mFrameIndex = ( mFrameIndex + 1 ) % mNumFramesInFlight;
 
-		mFrameDelta = ( end - start ) / factor;
+		return;
 	}
 
+	VkSemaphore semaphoreRenderComplete = mSemaphoresRenderComplete[mCurrentImageIndex];
+
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+	submitInfo.pSignalSemaphores = &semaphoreRenderComplete;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &frame.mSemaphoreAcquireImage;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	YETI_VK_CHECK( vkQueueSubmit( mQueues[YETI_QUEUE_TYPE_GRAPHICS], 1, &submitInfo, frame.mFence ) );
+
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	presentInfo.pImageIndices = &mCurrentImageIndex;
 	presentInfo.swapchainCount = 1;
 	presentInfo.pSwapchains = &mSwapChain;
 	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = &mSemaphoreRenderComplete;
+	presentInfo.pWaitSemaphores = &semaphoreRenderComplete;
 	VkResult result = vkQueuePresentKHR( mQueues[YETI_QUEUE_TYPE_PRESENT], &presentInfo );
 	if ( result == VK_ERROR_OUT_OF_DATE_KHR ) {
-		RecreateSwapChain();
+		RecreateSwapChain( mWidth, mHeight );
 	} else {
 		YETI_VK_CHECK( result );
 	}
 
-	mCommandBuffersSubmitted[mCurrentImageIndex] = true;
+	mFrameIndex = ( mFrameIndex + 1 ) % mNumFramesInFlight;
 }
 
 /*
@@ -182,10 +248,7 @@ void VulkanContext::Resize( const u32 width, const u32 height ) {
 	assertf( width > 0, "Specified resize width was 0!" );
 	assertf( height > 0, "Specified resize height was 0!" );
 
-	mWidth = width;
-	mHeight = height;
-
-	RecreateSwapChain();
+	RecreateSwapChain( width, height );
 }
 
 /*
@@ -195,4 +258,83 @@ VulkanContext::WaitDeviceIdle
 */
 void VulkanContext::WaitDeviceIdle() const {
 	YETI_VK_CHECK( vkDeviceWaitIdle( mLogicalDevice ) );
+}
+
+/*
+========================
+VulkanContext::BeginSwapChainPass
+========================
+*/
+void VulkanContext::BeginSwapChainPass( VkCommandBuffer commandBuffer, const VkRect2D& renderArea, const VkClearValue& clearValue ) {
+#if YETI_VK_DYNAMIC_RENDERING
+	if ( mUseDynamicRendering ) {
+		VkRenderingAttachmentInfoKHR colorAttachment = {};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		colorAttachment.imageView = mSwapChainImageViews[mCurrentImageIndex];
+		colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.clearValue = clearValue;
+
+		VkRenderingInfoKHR renderingInfo = {};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea = renderArea;
+		renderingInfo.layerCount = 1;
+		renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachments = &colorAttachment;
+		fpCmdBeginRenderingKHR( commandBuffer, &renderingInfo );
+
+		return;
+	}
+#endif
+
+	VkRenderPassBeginInfo renderPassBeginInfo = {};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pClearValues = &clearValue;
+	renderPassBeginInfo.clearValueCount = 1;
+	renderPassBeginInfo.framebuffer = mFramebuffers[mCurrentImageIndex];
+	renderPassBeginInfo.renderArea = renderArea;
+	renderPassBeginInfo.renderPass = mRenderPass;
+	vkCmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS );
+}
+
+/*
+========================
+VulkanContext::EndSwapChainPass
+========================
+*/
+void VulkanContext::EndSwapChainPass( VkCommandBuffer commandBuffer ) {
+#if YETI_VK_DYNAMIC_RENDERING
+	if ( mUseDynamicRendering ) {
+		fpCmdEndRenderingKHR( commandBuffer );
+		return;
+	}
+#endif
+
+	vkCmdEndRenderPass( commandBuffer );
+}
+
+/*
+========================
+VulkanContext::RecordSwapChainPass
+========================
+*/
+void VulkanContext::RecordSwapChainPass( VkCommandBuffer commandBuffer, void* data ) {
+	VulkanContext* context = reinterpret_cast<VulkanContext*>( data );
+
+	VkRect2D renderArea = {};
+	renderArea.offset = { 0, 0 };
+	renderArea.extent = { context->mWidth, context->mHeight };
+
+	VkClearValue clearValue = {};
+	clearValue.color = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+	// viewport and scissor get set by each secondary buffer, they can't be inherited
+	context->BeginSwapChainPass( commandBuffer, renderArea, clearValue );
+
+	// in the order their slots were reserved
+	context->mCommandRecorder->Execute( commandBuffer );
+
+	context->EndSwapChainPass( commandBuffer );
 }
\ No newline at end of file
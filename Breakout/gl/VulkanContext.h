@@ -3,17 +3,16 @@
 
 #include <mstd/mstd.h>
 
-#if MSTD_OS_WINDOWS
-#define VK_USE_PLATFORM_WIN32_KHR		1
-#endif
-
-#include <vulkan/vulkan.h>
+#include "VulkanDispatch.h"
 #include "vma/vma.h"
 
 #include "Buffer.h"
 #include "Texture.h"
 #include "UniformLayout.h"
 #include "RenderState.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+#include "BindlessTable.h"
 
 // these conversion constants aren't supposed to live here but idk where the correct place is yet
 #define GB_TO_MB						( 1024 )
@@ -43,6 +42,13 @@
 
 #define YETI_DEFAULT_BYTE_ALIGNMENT		16
 
+// headers from before VK_KHR_dynamic_rendering existed always get the render pass path
+#ifdef VK_KHR_dynamic_rendering
+#define YETI_VK_DYNAMIC_RENDERING		1
+#else
+#define YETI_VK_DYNAMIC_RENDERING		0
+#endif
+
 #define YETI_VK_GET_INSTANCE_PROC_ADDRESS( instance, procAddress )													\
 	fp##procAddress = reinterpret_cast<PFN_vk##procAddress>( vkGetInstanceProcAddr( instance, "vk"#procAddress ) );	\
 	if ( fp##procAddress == NULL ) {																				\
@@ -60,6 +66,12 @@
 #define YETI_FREE_ALIGNED( x )			if ( ( x ) ) { _aligned_free( ( x ) ); ( x ) = nullptr; }
 
 class StagingManager;
+class FrameAllocator;
+class GPUProfiler;
+class CommandRecorder;
+class PipelineCache;
+class RenderStateManager;
+class FrameReadback;
 
 // TODO: packing
 struct gpuInfo_t {
@@ -87,6 +99,25 @@ struct contextInitInfo_t {
 	string								mApplicationName;
 
 	u32									mWidth, mHeight, mNumBuffers;
+	u32									mNumFramesInFlight;
+
+	// how many threads record the swap chain pass, JobSystem::GetNumWorkers() to give every worker its own pools
+	u32									mNumRecordingThreads;
+
+	// null to build every pipeline from scratch each launch
+	const char*							mPipelineCacheFilename;
+
+	// only a request, falls back to the render pass if the driver doesn't support it
+	bool32								mAllowDynamicRendering;
+
+	// only a request, there's no bindless table without VK_EXT_descriptor_indexing
+	bool32								mAllowBindless;
+
+	// no window or swap chain, frames are drawn offscreen and only come back out through GetFrameReadback()
+	bool32								mHeadless;
+
+	// per frame in flight, 0 for FrameAllocator::DEFAULT_REGION_SIZE_KB
+	u32									mFrameAllocatorSizeKB;
 
 	// TODO: macOS, linux
 #if MSTD_OS_WINDOWS
@@ -95,6 +126,26 @@ struct contextInitInfo_t {
 #endif
 };
 
+// everything one frame in flight records and syncs with, only touched again once mFence says the GPU is done with it
+struct frameContext_t {
+	VkCommandPool						mCommandPool;		// transient, reset in one go at the start of the frame
+	VkCommandBuffer						mCommandBuffer;
+	VkSemaphore							mSemaphoreAcquireImage;
+	VkFence								mFence;				// created signalled so the first wait doesn't need special casing
+};
+
+// what's left of a swap chain after a resize, kept until no frame in flight can still be using it
+struct retiredSwapChain_t {
+	static const u32					MAX_IMAGES = 8;
+
+	VkSwapchainKHR						mSwapChain;
+	VkImageView							mImageViews[MAX_IMAGES];
+	VkFramebuffer						mFramebuffers[MAX_IMAGES];
+	VkSemaphore							mSemaphoresRenderComplete[MAX_IMAGES];
+	u32									mNumImages;
+	u32									mFramesToWait;		// a bit per frame context that still has to be waited on
+};
+
 /*
 ================================================================================================
 
@@ -103,10 +154,50 @@ struct contextInitInfo_t {
 	Responsible for initialising a basic Vulkan Context and handling graphics API specific
 	things. Also responsible for Swap-chain behaviour and data.
 
+	Frames are recorded into a small ring of frame contexts that's separate from the swap chain
+	images. The CPU only waits when it's about to reuse a frame context the GPU hasn't finished
+	with yet, so it can be up to mNumFramesInFlight frames ahead. Per-frame resources (the frame
+	allocator's regions, the GPU profiler's queries) are indexed by GetFrameIndex(), only the
+	framebuffers and render complete semaphores are indexed by the acquired image.
+
+	The swap chain pass only executes secondary command buffers, which get recorded through
+	GetCommandRecorder() and can come from any job system worker.
+
+	The primary buffer is recorded by the render graph when the frame is presented. Clear()
+	imports the acquired image as GetBackBuffer() and adds the swap chain pass, which writes it,
+	so anything else that has to happen in the frame (uploads, offscreen passes) adds its own
+	pass and the graph puts it in the right place with the barriers it needs. The back buffer's
+	transitions to and from COLOR_ATTACHMENT_OPTIMAL are the graph's too, so the render pass
+	starts and ends in that layout and has no dependencies of its own.
+
+	Resizing only rebuilds the swap chain, its image views and framebuffers, and the render
+	complete semaphores. The old swap chain gets handed to the new one and everything that
+	belonged to it is retired rather than destroyed. It's destroyed once every frame context
+	has been waited on again, so there's no device wait while the window is being dragged.
+
+	If the driver supports VK_KHR_dynamic_rendering there's no render pass or framebuffers at
+	all. The pass is begun straight on the acquired image's view and pipelines are created against
+	GetColorFormat() instead of GetRenderPass(). Resizing then doesn't create anything but the
+	swap chain itself, its image views and the semaphores.
+
+	Asking for bindless gets a BindlessTable if the driver has VK_EXT_descriptor_indexing, which
+	uniform layouts can add as a second set so draws pick textures and buffers by index.
+
+	A headless context has no surface and never asks for VK_KHR_swapchain, so it runs on
+	software drivers like lavapipe on machines without a GPU or a display. Each frame context
+	draws to an offscreen image of its own in place of a swap chain image, which its fence
+	already covers so there's nothing to acquire, and the submit has no semaphores and nothing
+	is presented. The back buffer is left in TRANSFER_SRC_OPTIMAL for the FrameReadback to copy
+	out of. Resizing waits for the GPU and recreates the images.
+
 ================================================================================================
 */
 
 class VulkanContext {
+public:
+	// resizing faster than frames finish waits for the GPU once this many are retired
+	static const u32					MAX_RETIRED_SWAP_CHAINS = 4;
+
 public:
 										VulkanContext();
 	virtual								~VulkanContext();
@@ -119,13 +210,82 @@ public:
 
 	inline StagingManager*				GetStagingManager() { return mStagingManager; }
 
+	// for anything that only needs to live until the end of the current frame
+	inline FrameAllocator*				GetFrameAllocator() { return mFrameAllocator; }
+
+	inline GPUProfiler*					GetGPUProfiler() { return mGPUProfiler; }
+
+	// null unless IsHeadless() is true
+	inline FrameReadback*				GetFrameReadback() { return mFrameReadback; }
+
+	// everything drawn in the swap chain pass MUST be recorded through this
+	inline CommandRecorder*				GetCommandRecorder() { return mCommandRecorder; }
+
+	// rebuilt every frame, anything recorded outside the swap chain pass MUST be a pass in this
+	inline RenderGraph*					GetRenderGraph() { return mRenderGraph; }
+
+	// the acquired image and the pass that draws to it, both only valid until the next Clear()
+	inline renderGraphHandle_t			GetBackBuffer() const { return mBackBuffer; }
+	inline u32							GetSwapChainPass() const { return mSwapChainPass; }
+
+	// every descriptor set MUST come from this
+	inline DescriptorAllocator*			GetDescriptorAllocator() { return mDescriptorAllocator; }
+
+	// null unless UsesBindless() is true
+	inline BindlessTable*				GetBindlessTable() { return mBindlessTable; }
+	inline const BindlessTable*			GetBindlessTable() const { return mBindlessTable; }
+
+	// every pipeline MUST be created through this
+	inline PipelineCache*				GetPipelineCache() { return mPipelineCache; }
+
+	// shares pipelines and layouts between everything that describes them the same way
+	inline RenderStateManager*			GetRenderStateManager() { return mRenderStateManager; }
+
 	inline VkDevice						GetLogicalDevice() const { return mLogicalDevice; }
 
 	inline VmaAllocator					GetAllocator() const { return mAllocator; }
 
+	// VK_NULL_HANDLE when dynamic rendering is being used
 	inline VkRenderPass					GetRenderPass() const { return mRenderPass; }
 
-	inline VkCommandBuffer				GetCurrentCommandBuffer() const { return mCommandBuffers[mCurrentImageIndex]; }
+	inline bool32						UsesDynamicRendering() const { return mUseDynamicRendering; }
+
+	inline bool32						UsesDescriptorUpdateTemplates() const { return mUseDescriptorUpdateTemplates; }
+
+	inline bool32						UsesBindless() const { return mUseBindless; }
+
+	inline bool32						IsHeadless() const { return mHeadless; }
+
+	// true between Clear() and Present() when there was no image to draw to, nothing should be recorded
+	inline bool32						IsFrameSkipped() const { return mFrameSkipped; }
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	// only valid when UsesDescriptorUpdateTemplates() is true
+	inline VkResult						CreateDescriptorUpdateTemplate( const VkDescriptorUpdateTemplateCreateInfoKHR* createInfo, VkDescriptorUpdateTemplateKHR* outTemplate ) const { return fpCreateDescriptorUpdateTemplateKHR( mLogicalDevice, createInfo, nullptr, outTemplate ); }
+	inline void							DestroyDescriptorUpdateTemplate( VkDescriptorUpdateTemplateKHR updateTemplate ) const { fpDestroyDescriptorUpdateTemplateKHR( mLogicalDevice, updateTemplate, nullptr ); }
+	inline void							UpdateDescriptorSetWithTemplate( VkDescriptorSet set, VkDescriptorUpdateTemplateKHR updateTemplate, const void* data ) const { fpUpdateDescriptorSetWithTemplateKHR( mLogicalDevice, set, updateTemplate, data ); }
+#endif
+
+#if YETI_VK_DYNAMIC_RENDERING
+	// only valid when UsesDynamicRendering() is true
+	inline void							CmdBeginRendering( VkCommandBuffer commandBuffer, const VkRenderingInfoKHR* renderingInfo ) const { fpCmdBeginRenderingKHR( commandBuffer, renderingInfo ); }
+	inline void							CmdEndRendering( VkCommandBuffer commandBuffer ) const { fpCmdEndRenderingKHR( commandBuffer ); }
+#endif
+
+	// the format pipelines get created against when there's no render pass
+	inline VkFormat						GetColorFormat() const { return mSurfaceFormat.format; }
+
+	// the primary buffer, everything in it gets recorded by the render graph
+	inline VkCommandBuffer				GetCurrentCommandBuffer() const { return mFrames[mFrameIndex].mCommandBuffer; }
+
+	// VK_NULL_HANDLE when dynamic rendering is being used
+	inline VkFramebuffer				GetCurrentFramebuffer() const { return mFramebuffers[mCurrentImageIndex]; }
+
+	inline u32							GetWidth() const { return mWidth; }
+	inline u32							GetHeight() const { return mHeight; }
+
+	inline u32							GetFrameIndex() const { return mFrameIndex; }
+	inline u32							GetNumFramesInFlight() const { return mNumFramesInFlight; }
 
 	inline VkQueue						GetQueue( const queueType_t queueType ) const { return mQueues[queueType]; }
 	inline u32							GetQueueIndex( const queueType_t queueType ) const { return mQueueFamilyIndices[queueType]; }
@@ -153,15 +313,29 @@ private:
 
 	array<VkFramebuffer>				mFramebuffers;
 
-	array<VkCommandBuffer>				mCommandBuffers;
+	// one per swap chain image, the presentation engine can still be waiting on one after its frame context is reused
+	array<VkSemaphore>					mSemaphoresRenderComplete;
+
+	array<frameContext_t>				mFrames;
 
-	array<VkFence>						mFences;
+	// headless only, the memory behind mSwapChainImages when they're offscreen images
+	array<VmaAllocation>				mOffscreenAllocations;
 
-	array<bool32>						mCommandBuffersSubmitted;
+	retiredSwapChain_t					mRetiredSwapChains[MAX_RETIRED_SWAP_CHAINS];
+	u32									mNumRetiredSwapChains;
 
 	gpuInfo_t							mActiveGPU;
 
 	StagingManager*						mStagingManager;
+	FrameAllocator*						mFrameAllocator;
+	GPUProfiler*						mGPUProfiler;
+	FrameReadback*						mFrameReadback;
+	CommandRecorder*					mCommandRecorder;
+	RenderGraph*						mRenderGraph;
+	DescriptorAllocator*				mDescriptorAllocator;
+	BindlessTable*						mBindlessTable;
+	PipelineCache*						mPipelineCache;
+	RenderStateManager*					mRenderStateManager;
 
 	VkInstance							mInstance;
 	VkDevice							mLogicalDevice;
@@ -176,13 +350,8 @@ private:
 
 	VkRenderPass						mRenderPass;
 
-	VkCommandPool						mCommandPool;
-
-	VkSemaphore							mSemaphoreAcquireImage, mSemaphoreRenderComplete;
-
-	VkQueryPool							mQueryPoolTimestamps;
-	float64								mFrameDelta;
-	const u32							NUM_GPU_QUERIES = 2;
+	renderGraphHandle_t					mBackBuffer;
+	u32									mSwapChainPass;
 
 #if MSTD_DEBUG
 	VkDebugReportCallbackEXT			mDebugReportCallback;
@@ -192,11 +361,36 @@ private:
 	PFN_vkDestroyDebugReportCallbackEXT	fpDestroyDebugReportCallbackEXT	= VK_NULL_HANDLE;
 #endif
 
+#if YETI_VK_DYNAMIC_RENDERING
+	PFN_vkCmdBeginRenderingKHR			fpCmdBeginRenderingKHR			= VK_NULL_HANDLE;
+	PFN_vkCmdEndRenderingKHR			fpCmdEndRenderingKHR			= VK_NULL_HANDLE;
+#endif
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	PFN_vkCreateDescriptorUpdateTemplateKHR		fpCreateDescriptorUpdateTemplateKHR		= VK_NULL_HANDLE;
+	PFN_vkDestroyDescriptorUpdateTemplateKHR	fpDestroyDescriptorUpdateTemplateKHR	= VK_NULL_HANDLE;
+	PFN_vkUpdateDescriptorSetWithTemplateKHR	fpUpdateDescriptorSetWithTemplateKHR	= VK_NULL_HANDLE;
+#endif
+
 	VkQueue								mQueues[YETI_QUEUE_TYPE_COUNT];
 	u32									mQueueFamilyIndices[YETI_QUEUE_TYPE_COUNT];
 
 	u32									mWidth, mHeight, mNumBuffers;
+	u32									mNumFramesInFlight;
 	u32									mCurrentImageIndex;
+	u32									mFrameIndex;
+
+	u32									mAPIVersion;
+
+	bool32								mUseDynamicRendering;
+	bool32								mUseDescriptorUpdateTemplates;
+	bool32								mUseBindless;
+
+	bool32								mHeadless;
+
+	// the window is minimised, there's no swap chain that size so frames get skipped until it comes back
+	bool32								mSwapChainSuspended;
+	bool32								mFrameSkipped;
 
 	bool32								mInitialised;
 
@@ -212,15 +406,28 @@ private:
 
 	void								SelectPhysicalDevice();
 
+	bool32								HasDeviceExtension( const char* name ) const;
+	bool32								SupportsDynamicRendering() const;
+	bool32								SupportsBindless() const;
+
 	void								CreateLogicalDevice();
 	void								DestroyLogicalDevice();
 
 	void								CreateAllocator();
 	void								DestroyAllocator();
 
-	void								CreateSwapChain();
+	void								CreateSwapChain( const VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE );
 	void								DestroySwapChain();
-	void								RecreateSwapChain();
+	// width and height are only used if the surface doesn't say what size it is
+	void								RecreateSwapChain( const u32 width, const u32 height );
+
+	// headless in place of the swap chain, one image per frame context
+	void								CreateOffscreenImages();
+	void								DestroyOffscreenImages();
+
+	void								RetireSwapChain();
+	// frameIndex is the frame context whose fence was just waited on, ignored if waitedIdle
+	void								DestroyRetiredSwapChains( const u32 frameIndex, const bool32 waitedIdle );
 
 	void								CreateRenderPass();
 	void								DestroyRenderPass();
@@ -228,17 +435,19 @@ private:
 	void								CreateFramebuffers();
 	void								DestroyFramebuffers();
 
-	void								CreateCommandBuffers();
-	void								DestroyCommandBuffers();
+	void								CreateFrameContexts();
+	void								DestroyFrameContexts();
 
 	void								CreateSemaphores();
 	void								DestroySemaphores();
 
-	void								CreateFences();
-	void								DestroyFences();
+	// render pass or dynamic rendering, whichever is being used
+	void								BeginSwapChainPass( VkCommandBuffer commandBuffer, const VkRect2D& renderArea, const VkClearValue& clearValue );
+	void								EndSwapChainPass( VkCommandBuffer commandBuffer );
+
+	// the render graph's pass func for the swap chain pass, data is the context
+	static void							RecordSwapChainPass( VkCommandBuffer commandBuffer, void* data );
 
-	void								CreateQueryPool();
-	void								DestroyQueryPool();
 };
 
 /*
@@ -306,6 +515,7 @@ s32 VulkanContext::GetBitsPerPixelFromFormat( const VkFormat format ) const {
 		case VK_FORMAT_R8G8B8A8_UINT:
 		case VK_FORMAT_R8G8B8A8_UNORM:
 		case VK_FORMAT_R8G8B8A8_USCALED:
+		case VK_FORMAT_B8G8R8A8_UNORM:
 			return 32;
 
 		default:
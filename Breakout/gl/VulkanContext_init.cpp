@@ -4,6 +4,14 @@
 
 #include "VulkanContext.h"
 #include "StagingManager.h"
+#include "FrameAllocator.h"
+#include "GPUProfiler.h"
+#include "CommandRecorder.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+#include "BindlessTable.h"
+#include "PipelineCache.h"
+#include "RenderStateManager.h"
 
 #include "../Window.h"
 
@@ -82,6 +90,16 @@ void VulkanContext::Init( const contextInitInfo_t& initInfo ) {
 	mWidth = initInfo.mWidth;
 	mHeight = initInfo.mHeight;
 	mNumBuffers = initInfo.mNumBuffers;
+	mNumFramesInFlight = initInfo.mNumFramesInFlight;
+	mHeadless = initInfo.mHeadless;
+
+	assertf( ( mNumFramesInFlight > 0 ), "VulkanContext needs at least one frame in flight!\n" );
+	assertf( ( mNumFramesInFlight <= 32 ), "VulkanContext can't have more than 32 frames in flight!\n" );
+
+	// the stand-in doesn't need a loader underneath it
+	if ( !OpenVulkanLoader() && !HasVulkanDispatchOverride() ) {
+		fatalError( "No Vulkan loader could be found! Make sure a Vulkan driver is installed.\n" );
+	}
 
 	CreateInstance( initInfo );
 
@@ -91,27 +109,72 @@ void VulkanContext::Init( const contextInitInfo_t& initInfo ) {
 
 	SelectPhysicalDevice();
 
+	// decided before the device is created, the extensions have to be enabled with it
+	mUseDynamicRendering = initInfo.mAllowDynamicRendering && SupportsDynamicRendering();
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	mUseDescriptorUpdateTemplates = HasDeviceExtension( VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME );
+#endif
+
+	mUseBindless = initInfo.mAllowBindless && SupportsBindless();
+
 	CreateLogicalDevice();
 
 	CreateAllocator();
 
-	CreateSwapChain();
+	mPipelineCache = new PipelineCache();
+	mPipelineCache->Init( this, initInfo.mPipelineCacheFilename );
 
-	CreateRenderPass();
+	if ( mHeadless ) {
+		CreateOffscreenImages();
+	} else {
+		CreateSwapChain();
+	}
+
+	if ( !mUseDynamicRendering ) {
+		CreateRenderPass();
+	}
 
 	CreateFramebuffers();
 
-	CreateCommandBuffers();
+	CreateFrameContexts();
 
 	CreateSemaphores();
 
-	CreateFences();
-
-	CreateQueryPool();
-
 	mStagingManager = new StagingManager();
 	mStagingManager->Init( this, mNumBuffers );
 
+	mFrameAllocator = new FrameAllocator();
+	mFrameAllocator->Init( this, mNumFramesInFlight, ( initInfo.mFrameAllocatorSizeKB > 0 ) ? initInfo.mFrameAllocatorSizeKB : FrameAllocator::DEFAULT_REGION_SIZE_KB );
+
+	mGPUProfiler = new GPUProfiler();
+	mGPUProfiler->Init( this, mNumFramesInFlight );
+
+	if ( mHeadless ) {
+		mFrameReadback = new FrameReadback();
+		mFrameReadback->Init( this, mNumFramesInFlight );
+	}
+
+	mCommandRecorder = new CommandRecorder();
+	mCommandRecorder->Init( this, mNumFramesInFlight, max( initInfo.mNumRecordingThreads, 1u ) );
+
+	mRenderGraph = new RenderGraph();
+	mRenderGraph->Init( this, mNumFramesInFlight );
+
+	printf( "Rendering %swith %s.\n", mHeadless ? "headless " : "", mUseDynamicRendering ? "VK_KHR_dynamic_rendering" : "a render pass" );
+
+	mDescriptorAllocator = new DescriptorAllocator();
+	mDescriptorAllocator->Init( this, mNumFramesInFlight );
+
+	// before the render state manager, bindless pipeline layouts are made with its set layout
+	if ( mUseBindless ) {
+		mBindlessTable = new BindlessTable();
+		mBindlessTable->Init( this, mNumFramesInFlight );
+	}
+
+	mRenderStateManager = new RenderStateManager();
+	mRenderStateManager->Init( this );
+
 	mInitialised = true;
 
 #if MSTD_DEBUG
@@ -139,19 +202,42 @@ void VulkanContext::Shutdown() {
 
 	YETI_VK_CHECK( vkDeviceWaitIdle( mLogicalDevice ) );
 
-	YETI_FREE( mStagingManager );
+	// complains about anything that never released its render states
+	YETI_FREE( mRenderStateManager );
+
+	// after the render state manager, releasing the layouts it still has tells this to forget them
+	YETI_FREE( mDescriptorAllocator );
+
+	YETI_FREE( mBindlessTable );
+
+	// the file gets written while everything else is torn down
+	mPipelineCache->SaveAsync();
+
+	YETI_FREE( mRenderGraph );
+
+	YETI_FREE( mCommandRecorder );
+
+	YETI_FREE( mFrameReadback );
 
-	DestroyQueryPool();
+	YETI_FREE( mGPUProfiler );
 
-	DestroyFences();
+	YETI_FREE( mFrameAllocator );
+
+	YETI_FREE( mStagingManager );
+
+	DestroyRetiredSwapChains( 0, true );
 
 	DestroySemaphores();
 
-	DestroyCommandBuffers();
+	DestroyFrameContexts();
 
 	DestroyFramebuffers();
 
-	DestroySwapChain();
+	if ( mHeadless ) {
+		DestroyOffscreenImages();
+	} else {
+		DestroySwapChain();
+	}
 
 	DestroyRenderPass();
 
@@ -159,6 +245,9 @@ void VulkanContext::Shutdown() {
 
 	DestroyDebugLayer();
 
+	// waits for the file to finish writing
+	YETI_FREE( mPipelineCache );
+
 	DestroyLogicalDevice();
 
 	DestroySurface();
@@ -188,17 +277,34 @@ void VulkanContext::CreateInstance( const contextInitInfo_t& initInfo ) {
 #if YETI_VK_STANDARD_VALIDATION
 		VK_EXT_DEBUG_REPORT_EXTENSION_NAME,
 #endif
+	};
 
+	// a machine without a display might not have these at all, and headless never makes a surface anyway
+	if ( !initInfo.mHeadless ) {
 #if MSTD_OS_WINDOWS
-		VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+		instanceExtensions.add( VK_KHR_WIN32_SURFACE_EXTENSION_NAME );
 #endif
 
-		VK_KHR_SURFACE_EXTENSION_NAME,
-	};
+		instanceExtensions.add( VK_KHR_SURFACE_EXTENSION_NAME );
+	}
+
+	mAPIVersion = VK_MAKE_VERSION( 1, 0, VK_HEADER_VERSION );
+
+#if YETI_VK_DYNAMIC_RENDERING || YETI_VK_DESCRIPTOR_INDEXING
+	// dynamic rendering and descriptor indexing need 1.1, but a 1.0 loader doesn't have vkEnumerateInstanceVersion and fails on anything newer than 1.0
+	if ( initInfo.mAllowDynamicRendering || initInfo.mAllowBindless ) {
+		PFN_vkEnumerateInstanceVersion enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>( vkGetInstanceProcAddr( VK_NULL_HANDLE, "vkEnumerateInstanceVersion" ) );
+
+		u32 loaderVersion = 0;
+		if ( enumerateInstanceVersion && enumerateInstanceVersion( &loaderVersion ) == VK_SUCCESS && loaderVersion >= VK_API_VERSION_1_1 ) {
+			mAPIVersion = VK_MAKE_VERSION( 1, 1, VK_HEADER_VERSION );
+		}
+	}
+#endif
 
 	VkApplicationInfo appInfo = {};
 	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-	appInfo.apiVersion = VK_MAKE_VERSION( 1, 0, VK_HEADER_VERSION );
+	appInfo.apiVersion = mAPIVersion;
 	appInfo.pApplicationName = initInfo.mApplicationName.c_str();
 	appInfo.pEngineName = "yeti1";
 	appInfo.engineVersion = 1;
@@ -211,6 +317,8 @@ void VulkanContext::CreateInstance( const contextInitInfo_t& initInfo ) {
 	instanceInfo.enabledExtensionCount = static_cast<u32>( instanceExtensions.length() );
 	instanceInfo.ppEnabledExtensionNames = instanceExtensions.data();
 	YETI_VK_CHECK( vkCreateInstance( &instanceInfo, nullptr, &mInstance ) );
+
+	LoadVulkanInstanceFunctions( mInstance );
 }
 
 /*
@@ -221,6 +329,8 @@ VulkanContext::DestroyInstance
 void VulkanContext::DestroyInstance() {
 	vkDestroyInstance( mInstance, nullptr );
 	mInstance = VK_NULL_HANDLE;
+
+	CloseVulkanLoader();
 }
 
 /*
@@ -260,6 +370,10 @@ VulkanContext::CreateSurface
 ========================
 */
 void VulkanContext::CreateSurface( const contextInitInfo_t& initInfo ) {
+	if ( mHeadless ) {
+		return;
+	}
+
 	// TODO: mac OS, linux
 #if MSTD_OS_WINDOWS
 	VkWin32SurfaceCreateInfoKHR createInfo = {};
@@ -276,6 +390,10 @@ VulkanContext::DestroySurface
 ========================
 */
 void VulkanContext::DestroySurface() {
+	if ( mHeadless ) {
+		return;
+	}
+
 	vkDestroySurfaceKHR( mInstance, mWindowSurface, nullptr );
 	mWindowSurface = VK_NULL_HANDLE;
 }
@@ -312,10 +430,13 @@ void VulkanContext::SelectPhysicalDevice() {
 				YETI_VK_CHECK( vkEnumerateDeviceExtensionProperties( gpu.mGPUHandle, nullptr, &numDeviceExtensions, gpu.mDeviceExtensionProperties.data() ) );
 			}
 
-			YETI_VK_CHECK( vkGetPhysicalDeviceSurfaceCapabilitiesKHR( gpu.mGPUHandle, mWindowSurface, &gpu.mWindowSurfaceCapabilities ) );
+			// headless there's no surface to ask about, the offscreen images pick their own format
+			if ( !mHeadless ) {
+				YETI_VK_CHECK( vkGetPhysicalDeviceSurfaceCapabilitiesKHR( gpu.mGPUHandle, mWindowSurface, &gpu.mWindowSurfaceCapabilities ) );
+			}
 
 			// surface formats
-			{
+			if ( !mHeadless ) {
 				u32 numSurfaceFormats = 0;
 				YETI_VK_CHECK( vkGetPhysicalDeviceSurfaceFormatsKHR( gpu.mGPUHandle, mWindowSurface, &numSurfaceFormats, nullptr ) );
 				assertf( numSurfaceFormats > 0, "VulkanContext::SelectPhysicalDevice() failed to find the surface formats of your GPU!\n" );
@@ -324,7 +445,7 @@ void VulkanContext::SelectPhysicalDevice() {
 			}
 
 			// present modes
-			{
+			if ( !mHeadless ) {
 				u32 numPresentModes = 0;
 				YETI_VK_CHECK( vkGetPhysicalDeviceSurfacePresentModesKHR( gpu.mGPUHandle, mWindowSurface, &numPresentModes, nullptr ) );
 				assertf( numPresentModes > 0, "VulkanContext::SelectPhysicalDevice() failed to find the surface present modes of your GPU!\n" );
@@ -385,7 +506,12 @@ void VulkanContext::SelectPhysicalDevice() {
 				}
 			}
 
-			// present queue
+			// present queue, headless nothing gets presented so it's just the graphics queue again
+			if ( mHeadless ) {
+				mQueueFamilyIndices[YETI_QUEUE_TYPE_PRESENT] = mQueueFamilyIndices[YETI_QUEUE_TYPE_GRAPHICS];
+				continue;
+			}
+
 			for ( u32 j = 0; j < gpu.mQueueFamilyProperties.length(); j++ ) {
 				if ( gpu.mQueueFamilyProperties[j].queueCount == 0 ) {
 					continue;
@@ -418,15 +544,120 @@ void VulkanContext::SelectPhysicalDevice() {
 	}
 }
 
+/*
+========================
+VulkanContext::HasDeviceExtension
+========================
+*/
+bool32 VulkanContext::HasDeviceExtension( const char* name ) const {
+	for ( size_t i = 0; i < mActiveGPU.mDeviceExtensionProperties.length(); i++ ) {
+		if ( strcmp( mActiveGPU.mDeviceExtensionProperties[i].extensionName, name ) == 0 ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+========================
+VulkanContext::SupportsDynamicRendering
+========================
+*/
+bool32 VulkanContext::SupportsDynamicRendering() const {
+#if YETI_VK_DYNAMIC_RENDERING
+	if ( mAPIVersion < VK_API_VERSION_1_1 || mActiveGPU.mProperties.apiVersion < VK_API_VERSION_1_1 ) {
+		return false;
+	}
+
+	// on 1.1 these are the only dependencies that aren't already core
+	if ( !HasDeviceExtension( VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME ) ||
+		!HasDeviceExtension( VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME ) ||
+		!HasDeviceExtension( VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME ) ) {
+		return false;
+	}
+
+	VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+	dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+	VkPhysicalDeviceFeatures2 features = {};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features.pNext = &dynamicRenderingFeatures;
+	vkGetPhysicalDeviceFeatures2( mActiveGPU.mGPUHandle, &features );
+
+	return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+#else
+	return false;
+#endif
+}
+
+/*
+========================
+VulkanContext::SupportsBindless
+========================
+*/
+bool32 VulkanContext::SupportsBindless() const {
+#if YETI_VK_DESCRIPTOR_INDEXING
+	// its dependencies are all core in 1.1
+	if ( mAPIVersion < VK_API_VERSION_1_1 || mActiveGPU.mProperties.apiVersion < VK_API_VERSION_1_1 ) {
+		return false;
+	}
+
+	if ( !HasDeviceExtension( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME ) ) {
+		return false;
+	}
+
+	// indexing the arrays at all is core, and every supported core feature gets enabled with the device
+	if ( !mActiveGPU.mFeatures.shaderSampledImageArrayDynamicIndexing || !mActiveGPU.mFeatures.shaderStorageBufferArrayDynamicIndexing ) {
+		return false;
+	}
+
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+	descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	VkPhysicalDeviceFeatures2 features = {};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features.pNext = &descriptorIndexingFeatures;
+	vkGetPhysicalDeviceFeatures2( mActiveGPU.mGPUHandle, &features );
+
+	if ( !descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing ||
+		!descriptorIndexingFeatures.descriptorBindingPartiallyBound ||
+		!descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind ||
+		!descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind ||
+		!descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending ) {
+		return false;
+	}
+
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties = {};
+	descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 properties = {};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties.pNext = &descriptorIndexingProperties;
+	vkGetPhysicalDeviceProperties2( mActiveGPU.mGPUHandle, &properties );
+
+	// the table is one fixed size everywhere, so a driver that can't hold all of it doesn't get it at all
+	return descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages >= BindlessTable::MAX_TEXTURES &&
+		descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages >= BindlessTable::MAX_TEXTURES &&
+		descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers >= BindlessTable::MAX_BUFFERS &&
+		descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers >= BindlessTable::MAX_BUFFERS;
+#else
+	return false;
+#endif
+}
+
 /*
 ========================
 VulkanContext::CreateLogicalDevice
 ========================
 */
 void VulkanContext::CreateLogicalDevice() {
-	array<const char*> deviceExtensions {
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME
-	};
+	array<const char*> deviceExtensions;
+
+	// software drivers don't always have it, and headless doesn't need it
+	if ( !mHeadless ) {
+		deviceExtensions.add( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+	}
 
 	float32 queuePriorities[1] = { 1.0f };
 
@@ -449,6 +680,46 @@ void VulkanContext::CreateLogicalDevice() {
 
 	VkDeviceCreateInfo deviceInfo = {};
 	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+
+#if YETI_VK_DYNAMIC_RENDERING
+	VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+	dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+	dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+	if ( mUseDynamicRendering ) {
+		deviceExtensions.add( VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME );
+		deviceExtensions.add( VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME );
+		deviceExtensions.add( VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME );
+
+		deviceInfo.pNext = &dynamicRenderingFeatures;
+	}
+#endif
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	if ( mUseDescriptorUpdateTemplates ) {
+		deviceExtensions.add( VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME );
+	}
+#endif
+
+#if YETI_VK_DESCRIPTOR_INDEXING
+	// only what the bindless table and shaders use, the arrays are sized so there's no runtimeDescriptorArray
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+	descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+	descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+	descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+	if ( mUseBindless ) {
+		deviceExtensions.add( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+
+		// goes on the front of whatever's already chained
+		descriptorIndexingFeatures.pNext = const_cast<void*>( deviceInfo.pNext );
+		deviceInfo.pNext = &descriptorIndexingFeatures;
+	}
+#endif
+
 	deviceInfo.queueCreateInfoCount = static_cast<u32>( deviceQueueInfos.length() );
 	deviceInfo.pQueueCreateInfos = deviceQueueInfos.data();
 	deviceInfo.pEnabledFeatures = &mActiveGPU.mFeatures;
@@ -456,9 +727,26 @@ void VulkanContext::CreateLogicalDevice() {
 	deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	YETI_VK_CHECK( vkCreateDevice( mActiveGPU.mGPUHandle, &deviceInfo, nullptr, &mLogicalDevice ) );
 
+	LoadVulkanDeviceFunctions( mLogicalDevice );
+
 	for ( size_t i = 0; i < YETI_QUEUE_TYPE_COUNT; i++ ) {
 		vkGetDeviceQueue( mLogicalDevice, mQueueFamilyIndices[i], 0, &mQueues[i] );
 	}
+
+#if YETI_VK_DYNAMIC_RENDERING
+	if ( mUseDynamicRendering ) {
+		YETI_VK_GET_DEVICE_PROC_ADDRESS( mLogicalDevice, CmdBeginRenderingKHR );
+		YETI_VK_GET_DEVICE_PROC_ADDRESS( mLogicalDevice, CmdEndRenderingKHR );
+	}
+#endif
+
+#if YETI_VK_DESCRIPTOR_UPDATE_TEMPLATE
+	if ( mUseDescriptorUpdateTemplates ) {
+		YETI_VK_GET_DEVICE_PROC_ADDRESS( mLogicalDevice, CreateDescriptorUpdateTemplateKHR );
+		YETI_VK_GET_DEVICE_PROC_ADDRESS( mLogicalDevice, DestroyDescriptorUpdateTemplateKHR );
+		YETI_VK_GET_DEVICE_PROC_ADDRESS( mLogicalDevice, UpdateDescriptorSetWithTemplateKHR );
+	}
+#endif
 }
 
 /*
@@ -477,9 +765,27 @@ VulkanContext::CreateAllocator
 ========================
 */
 void VulkanContext::CreateAllocator() {
+	// VMA isn't linked against the loader either, it gets whatever the dispatch is pointing at now
+	VmaVulkanFunctions vulkanFunctions = {};
+	vulkanFunctions.vkGetPhysicalDeviceProperties = vkGetPhysicalDeviceProperties;
+	vulkanFunctions.vkGetPhysicalDeviceMemoryProperties = vkGetPhysicalDeviceMemoryProperties;
+	vulkanFunctions.vkAllocateMemory = vkAllocateMemory;
+	vulkanFunctions.vkFreeMemory = vkFreeMemory;
+	vulkanFunctions.vkMapMemory = vkMapMemory;
+	vulkanFunctions.vkUnmapMemory = vkUnmapMemory;
+	vulkanFunctions.vkBindBufferMemory = vkBindBufferMemory;
+	vulkanFunctions.vkBindImageMemory = vkBindImageMemory;
+	vulkanFunctions.vkGetBufferMemoryRequirements = vkGetBufferMemoryRequirements;
+	vulkanFunctions.vkGetImageMemoryRequirements = vkGetImageMemoryRequirements;
+	vulkanFunctions.vkCreateBuffer = vkCreateBuffer;
+	vulkanFunctions.vkDestroyBuffer = vkDestroyBuffer;
+	vulkanFunctions.vkCreateImage = vkCreateImage;
+	vulkanFunctions.vkDestroyImage = vkDestroyImage;
+
 	VmaAllocatorCreateInfo allocatorInfo = {};
 	allocatorInfo.device = mLogicalDevice;
 	allocatorInfo.physicalDevice = mActiveGPU.mGPUHandle;
+	allocatorInfo.pVulkanFunctions = &vulkanFunctions;
 	YETI_VK_CHECK( vmaCreateAllocator( &allocatorInfo, &mAllocator ) );
 }
 
@@ -498,7 +804,7 @@ void VulkanContext::DestroyAllocator() {
 VulkanContext::CreateSwapChain
 ========================
 */
-void VulkanContext::CreateSwapChain() {
+void VulkanContext::CreateSwapChain( const VkSwapchainKHR oldSwapChain ) {
 	VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;	// FIFO is default
 
 	// swap chain
@@ -571,6 +877,7 @@ void VulkanContext::CreateSwapChain() {
 		swapChainInfo.queueFamilyIndexCount = queueFamilyIndexCount;
 		swapChainInfo.preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
 		swapChainInfo.surface = mWindowSurface;
+		swapChainInfo.oldSwapchain = oldSwapChain;
 		YETI_VK_CHECK( vkCreateSwapchainKHR( mLogicalDevice, &swapChainInfo, nullptr, &mSwapChain ) );
 	}
 
@@ -579,13 +886,11 @@ void VulkanContext::CreateSwapChain() {
 		u32 numImages = 0;
 		YETI_VK_CHECK( vkGetSwapchainImagesKHR( mLogicalDevice, mSwapChain, &numImages, nullptr ) );
 		assert( numImages > 0 );
+		assertf( ( numImages <= retiredSwapChain_t::MAX_IMAGES ), "Swap chain has more images than retiredSwapChain_t::MAX_IMAGES!\n" );
 		mSwapChainImages.resize( numImages );
 		mSwapChainImageViews.resize( numImages );
 		mFramebuffers.resize( numImages );
-		mCommandBuffers.resize( numImages );
-		mFences.resize( numImages );
-		mCommandBuffersSubmitted.resize( numImages );
-		memset( mCommandBuffersSubmitted.data(), 0, sizeof( bool32 ) * mCommandBuffersSubmitted.length() );
+		mSemaphoresRenderComplete.resize( numImages );
 		YETI_VK_CHECK( vkGetSwapchainImagesKHR( mLogicalDevice, mSwapChain, &numImages, mSwapChainImages.data() ) );
 
 		for ( size_t i = 0; i < numImages; i++ ) {
@@ -622,25 +927,187 @@ void VulkanContext::DestroySwapChain() {
 	mSwapChain = VK_NULL_HANDLE;
 }
 
+/*
+========================
+VulkanContext::CreateOffscreenImages
+========================
+*/
+void VulkanContext::CreateOffscreenImages() {
+	// the format the swap chain prefers, so pipelines and what gets read back are the same as with a window
+	mSurfaceFormat = { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+
+	// one per frame context, the image index is always the frame index
+	u32 numImages = mNumFramesInFlight;
+	mSwapChainImages.resize( numImages );
+	mSwapChainImageViews.resize( numImages );
+	mFramebuffers.resize( numImages );
+	mOffscreenAllocations.resize( numImages );
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = mSurfaceFormat.format;
+	imageInfo.extent.width = mWidth;
+	imageInfo.extent.height = mHeight;
+	imageInfo.extent.depth = 1;
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VmaAllocationCreateInfo allocCreateInfo = {};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	for ( u32 i = 0; i < numImages; i++ ) {
+		YETI_VK_CHECK( vmaCreateImage( mAllocator, &imageInfo, &allocCreateInfo, &mSwapChainImages[i], &mOffscreenAllocations[i], nullptr ) );
+
+		VkImageViewCreateInfo imageViewInfo = {};
+		imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewInfo.components = {};
+		imageViewInfo.format = mSurfaceFormat.format;
+		imageViewInfo.image = mSwapChainImages[i];
+		imageViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageViewInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewInfo.subresourceRange.baseMipLevel = 0;
+		imageViewInfo.subresourceRange.layerCount = 1;
+		imageViewInfo.subresourceRange.levelCount = 1;
+		imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		YETI_VK_CHECK( vkCreateImageView( mLogicalDevice, &imageViewInfo, nullptr, &mSwapChainImageViews[i] ) );
+	}
+}
+
+/*
+========================
+VulkanContext::DestroyOffscreenImages
+========================
+*/
+void VulkanContext::DestroyOffscreenImages() {
+	for ( size_t i = 0; i < mSwapChainImages.length(); i++ ) {
+		vkDestroyImageView( mLogicalDevice, mSwapChainImageViews[i], nullptr );
+		mSwapChainImageViews[i] = VK_NULL_HANDLE;
+
+		vmaDestroyImage( mAllocator, mSwapChainImages[i], mOffscreenAllocations[i] );
+		mSwapChainImages[i] = VK_NULL_HANDLE;
+		mOffscreenAllocations[i] = VK_NULL_HANDLE;
+	}
+}
+
 /*
 ========================
 VulkanContext::RecreateSwapChain
 ========================
 */
-void VulkanContext::RecreateSwapChain() {
-	WaitDeviceIdle();
+void VulkanContext::RecreateSwapChain( const u32 width, const u32 height ) {
+	// there's no swap chain to hand the old images to, so they have to be finished with before they go
+	if ( mHeadless ) {
+		WaitDeviceIdle();
 
-	DestroyCommandBuffers();
+		mWidth = width;
+		mHeight = height;
 
-	DestroyFramebuffers();
+		DestroyFramebuffers();
+		DestroyOffscreenImages();
 
-	DestroySwapChain();
+		CreateOffscreenImages();
+		CreateFramebuffers();
 
-	CreateSwapChain();
+		return;
+	}
+
+	// the window might not be the size we were told it is
+	YETI_VK_CHECK( vkGetPhysicalDeviceSurfaceCapabilitiesKHR( mActiveGPU.mGPUHandle, mWindowSurface, &mActiveGPU.mWindowSurfaceCapabilities ) );
+
+	u32 newWidth = width;
+	u32 newHeight = height;
+
+	const VkExtent2D& currentExtent = mActiveGPU.mWindowSurfaceCapabilities.currentExtent;
+	if ( currentExtent.width != U32_MAX ) {
+		newWidth = currentExtent.width;
+		newHeight = currentExtent.height;
+	}
+
+	// minimised, a swap chain can't be 0 sized so keep the old one and its size until there's something to draw to
+	if ( newWidth == 0 || newHeight == 0 ) {
+		mSwapChainSuspended = true;
+		return;
+	}
+
+	mSwapChainSuspended = false;
+
+	mWidth = newWidth;
+	mHeight = newHeight;
+
+	// nothing has been waited on, frames in flight can still be using the old one
+	RetireSwapChain();
+
+	CreateSwapChain( mRetiredSwapChains[mNumRetiredSwapChains - 1].mSwapChain );
 
 	CreateFramebuffers();
 
-	CreateCommandBuffers();
+	CreateSemaphores();
+}
+
+/*
+========================
+VulkanContext::RetireSwapChain
+========================
+*/
+void VulkanContext::RetireSwapChain() {
+	if ( mNumRetiredSwapChains == MAX_RETIRED_SWAP_CHAINS ) {
+		WaitDeviceIdle();
+		DestroyRetiredSwapChains( 0, true );
+	}
+
+	retiredSwapChain_t& retired = mRetiredSwapChains[mNumRetiredSwapChains++];
+	retired.mSwapChain = mSwapChain;
+	retired.mNumImages = static_cast<u32>( mSwapChainImageViews.length() );
+	retired.mFramesToWait = ( mNumFramesInFlight == 32 ) ? U32_MAX : ( 1u << mNumFramesInFlight ) - 1;
+
+	for ( u32 i = 0; i < retired.mNumImages; i++ ) {
+		retired.mImageViews[i] = mSwapChainImageViews[i];
+		retired.mFramebuffers[i] = mFramebuffers[i];
+		retired.mSemaphoresRenderComplete[i] = mSemaphoresRenderComplete[i];
+
+		mSwapChainImageViews[i] = VK_NULL_HANDLE;
+		mFramebuffers[i] = VK_NULL_HANDLE;
+		mSemaphoresRenderComplete[i] = VK_NULL_HANDLE;
+	}
+
+	mSwapChain = VK_NULL_HANDLE;
+}
+
+/*
+========================
+VulkanContext::DestroyRetiredSwapChains
+========================
+*/
+void VulkanContext::DestroyRetiredSwapChains( const u32 frameIndex, const bool32 waitedIdle ) {
+	u32 numKept = 0;
+
+	for ( u32 i = 0; i < mNumRetiredSwapChains; i++ ) {
+		retiredSwapChain_t& retired = mRetiredSwapChains[i];
+
+		// waiting on the same frame context twice doesn't count twice, only once every one of them has been waited on is it free
+		retired.mFramesToWait &= ~( 1u << frameIndex );
+
+		if ( !waitedIdle && retired.mFramesToWait != 0 ) {
+			mRetiredSwapChains[numKept++] = retired;
+			continue;
+		}
+
+		for ( u32 j = 0; j < retired.mNumImages; j++ ) {
+			vkDestroySemaphore( mLogicalDevice, retired.mSemaphoresRenderComplete[j], nullptr );
+			vkDestroyFramebuffer( mLogicalDevice, retired.mFramebuffers[j], nullptr );
+			vkDestroyImageView( mLogicalDevice, retired.mImageViews[j], nullptr );
+		}
+
+		vkDestroySwapchainKHR( mLogicalDevice, retired.mSwapChain, nullptr );
+	}
+
+	mNumRetiredSwapChains = numKept;
 }
 
 /*
@@ -652,21 +1119,14 @@ void VulkanContext::CreateRenderPass() {
 	VkAttachmentDescription attachmentDesc = {};
 	attachmentDesc.format = mSurfaceFormat.format;
 	attachmentDesc.samples = VK_SAMPLE_COUNT_1_BIT;
-	attachmentDesc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	attachmentDesc.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	// the render graph transitions the back buffer either side of the pass
+	attachmentDesc.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	attachmentDesc.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 	attachmentDesc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	attachmentDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 	attachmentDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	attachmentDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
-	VkSubpassDependency subpassDependency = {};
-	subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	subpassDependency.dstSubpass = 0;
-	subpassDependency.srcAccessMask = 0;
-	subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
 	VkAttachmentReference attachmentColor = {};
 	attachmentColor.attachment = 0;
 	attachmentColor.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -680,8 +1140,6 @@ void VulkanContext::CreateRenderPass() {
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 	renderPassInfo.attachmentCount = 1;
 	renderPassInfo.pAttachments = &attachmentDesc;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &subpassDependency;
 	renderPassInfo.subpassCount = 1;
 	renderPassInfo.pSubpasses = &subpassDesc;
 	YETI_VK_CHECK( vkCreateRenderPass( mLogicalDevice, &renderPassInfo, nullptr, &mRenderPass ) );
@@ -703,6 +1161,15 @@ VulkanContext::CreateFramebuffers
 ========================
 */
 void VulkanContext::CreateFramebuffers() {
+	// passes begin straight on the image views instead, nulled so retiring and destroying them is still fine
+	if ( mUseDynamicRendering ) {
+		for ( size_t i = 0; i < mFramebuffers.length(); i++ ) {
+			mFramebuffers[i] = VK_NULL_HANDLE;
+		}
+
+		return;
+	}
+
 	for ( size_t i = 0; i < mFramebuffers.length(); i++ ) {
 		VkFramebufferCreateInfo framebufferInfo = {};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -732,106 +1199,92 @@ void VulkanContext::DestroyFramebuffers() {
 
 /*
 ========================
-VulkanContext::CreateCommandBuffers
+VulkanContext::CreateFrameContexts
 ========================
 */
-void VulkanContext::CreateCommandBuffers() {
+void VulkanContext::CreateFrameContexts() {
 	VkCommandPoolCreateInfo commandPoolInfo = {};
 	commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	commandPoolInfo.queueFamilyIndex = mQueueFamilyIndices[YETI_QUEUE_TYPE_GRAPHICS];
-	commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	YETI_VK_CHECK( vkCreateCommandPool( mLogicalDevice, &commandPoolInfo, nullptr, &mCommandPool ) );
-
-	VkCommandBufferAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocInfo.commandBufferCount = static_cast<u32>( mCommandBuffers.length() );
-	allocInfo.commandPool = mCommandPool;
-	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	YETI_VK_CHECK( vkAllocateCommandBuffers( mLogicalDevice, &allocInfo, mCommandBuffers.data() ) );
-}
+	commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 
-/*
-========================
-VulkanContext::DestroyCommandBuffers
-========================
-*/
-void VulkanContext::DestroyCommandBuffers() {
-	vkFreeCommandBuffers( mLogicalDevice, mCommandPool, static_cast<u32>( mCommandBuffers.length() ), mCommandBuffers.data() );
-
-	vkDestroyCommandPool( mLogicalDevice, mCommandPool, nullptr );
-	mCommandPool = VK_NULL_HANDLE;
-}
-
-/*
-========================
-VulkanContext::CreateSemaphores
-========================
-*/
-void VulkanContext::CreateSemaphores() {
 	VkSemaphoreCreateInfo semaphoreInfo = {};
 	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-	YETI_VK_CHECK( vkCreateSemaphore( mLogicalDevice, &semaphoreInfo, nullptr, &mSemaphoreAcquireImage ) );
-	YETI_VK_CHECK( vkCreateSemaphore( mLogicalDevice, &semaphoreInfo, nullptr, &mSemaphoreRenderComplete ) );
-}
-
-/*
-========================
-VulkanContext::DestroySemaphores
-========================
-*/
-void VulkanContext::DestroySemaphores() {
-	vkDestroySemaphore( mLogicalDevice, mSemaphoreRenderComplete, nullptr );
-	vkDestroySemaphore( mLogicalDevice, mSemaphoreAcquireImage, nullptr );
-}
-
-/*
-========================
-VulkanContext::CreateFences
-========================
-*/
-void VulkanContext::CreateFences() {
 	VkFenceCreateInfo fenceInfo = {};
 	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+	mFrames.resize( mNumFramesInFlight );
+
+	for ( u32 i = 0; i < mNumFramesInFlight; i++ ) {
+		frameContext_t& frame = mFrames[i];
+
+		YETI_VK_CHECK( vkCreateCommandPool( mLogicalDevice, &commandPoolInfo, nullptr, &frame.mCommandPool ) );
+
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandBufferCount = 1;
+		allocInfo.commandPool = frame.mCommandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		YETI_VK_CHECK( vkAllocateCommandBuffers( mLogicalDevice, &allocInfo, &frame.mCommandBuffer ) );
+
+		YETI_VK_CHECK( vkCreateSemaphore( mLogicalDevice, &semaphoreInfo, nullptr, &frame.mSemaphoreAcquireImage ) );
 
-	for ( size_t i = 0; i < mFences.length(); i++ ) {
-		YETI_VK_CHECK( vkCreateFence( mLogicalDevice, &fenceInfo, nullptr, &mFences[i] ) );
+		YETI_VK_CHECK( vkCreateFence( mLogicalDevice, &fenceInfo, nullptr, &frame.mFence ) );
 	}
+
+	mFrameIndex = 0;
 }
 
 /*
 ========================
-VulkanContext::DestroyFences
+VulkanContext::DestroyFrameContexts
 ========================
 */
-void VulkanContext::DestroyFences() {
-	for ( size_t i = 0; i < mFences.length(); i++ ) {
-		VkFence& fence = mFences[i];
+void VulkanContext::DestroyFrameContexts() {
+	for ( u32 i = 0; i < mFrames.length(); i++ ) {
+		frameContext_t& frame = mFrames[i];
+
+		vkDestroyFence( mLogicalDevice, frame.mFence, nullptr );
+		frame.mFence = VK_NULL_HANDLE;
 
-		vkDestroyFence( mLogicalDevice, fence, nullptr );
-		fence = VK_NULL_HANDLE;
+		vkDestroySemaphore( mLogicalDevice, frame.mSemaphoreAcquireImage, nullptr );
+		frame.mSemaphoreAcquireImage = VK_NULL_HANDLE;
+
+		// frees the command buffer with it
+		vkDestroyCommandPool( mLogicalDevice, frame.mCommandPool, nullptr );
+		frame.mCommandPool = VK_NULL_HANDLE;
+		frame.mCommandBuffer = VK_NULL_HANDLE;
 	}
+
+	mFrames.clear();
 }
 
 /*
 ========================
-VulkanContext::CreateQueryPool
+VulkanContext::CreateSemaphores
 ========================
 */
-void VulkanContext::CreateQueryPool() {
-	VkQueryPoolCreateInfo queryPoolInfo = {};
-	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-	queryPoolInfo.queryCount = 2;
-	YETI_VK_CHECK( vkCreateQueryPool( mLogicalDevice, &queryPoolInfo, nullptr, &mQueryPoolTimestamps ) );
+void VulkanContext::CreateSemaphores() {
+	VkSemaphoreCreateInfo semaphoreInfo = {};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	for ( size_t i = 0; i < mSemaphoresRenderComplete.length(); i++ ) {
+		YETI_VK_CHECK( vkCreateSemaphore( mLogicalDevice, &semaphoreInfo, nullptr, &mSemaphoresRenderComplete[i] ) );
+	}
 }
 
 /*
 ========================
-VulkanContext::DestroyQueryPool
+VulkanContext::DestroySemaphores
 ========================
 */
-void VulkanContext::DestroyQueryPool() {
-	vkDestroyQueryPool( mLogicalDevice, mQueryPoolTimestamps, nullptr );
-	mQueryPoolTimestamps = VK_NULL_HANDLE;
+void VulkanContext::DestroySemaphores() {
+	for ( size_t i = 0; i < mSemaphoresRenderComplete.length(); i++ ) {
+		VkSemaphore& semaphore = mSemaphoresRenderComplete[i];
+
+		vkDestroySemaphore( mLogicalDevice, semaphore, nullptr );
+		semaphore = VK_NULL_HANDLE;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "VulkanDispatch.h"
+
+#if !MSTD_OS_WINDOWS
+#include <dlfcn.h>
+#endif
+
+/*
+================================================================================================
+
+	Vulkan Dispatch
+
+================================================================================================
+*/
+
+#define YETI_VK_DEFINE_FUNCTION( name )		PFN_##name name = nullptr;
+
+YETI_VK_FUNCTIONS( YETI_VK_DEFINE_FUNCTION )
+
+#if MSTD_OS_WINDOWS
+static HMODULE						gVulkanLoader = nullptr;
+#else
+static void*						gVulkanLoader = nullptr;
+#endif
+
+// whatever the loader gave back, still filled in underneath an override that wants it
+static vulkanFunctions_t			gVulkanDriverFunctions = {};
+
+static const vulkanFunctions_t*		gVulkanOverrideFunctions = nullptr;
+static bool32						gVulkanOverrideWantsDriver = false;
+
+/*
+========================
+InstallVulkanFunctions
+========================
+*/
+static void InstallVulkanFunctions() {
+	// the override takes every call when there is one, even the ones the driver table has loaded
+	const vulkanFunctions_t& functions = gVulkanOverrideFunctions ? *gVulkanOverrideFunctions : gVulkanDriverFunctions;
+
+#define YETI_VK_INSTALL_FUNCTION( name )		name = functions.name;
+	YETI_VK_FUNCTIONS( YETI_VK_INSTALL_FUNCTION )
+#undef YETI_VK_INSTALL_FUNCTION
+}
+
+/*
+========================
+OpenVulkanLoader
+========================
+*/
+bool32 OpenVulkanLoader() {
+	if ( gVulkanOverrideFunctions && !gVulkanOverrideWantsDriver ) {
+		InstallVulkanFunctions();
+		return false;
+	}
+
+	if ( !gVulkanLoader ) {
+#if MSTD_OS_WINDOWS
+		gVulkanLoader = LoadLibraryA( "vulkan-1.dll" );
+#elif MSTD_OS_MAC_OS
+		gVulkanLoader = dlopen( "libvulkan.1.dylib", RTLD_NOW | RTLD_LOCAL );
+		if ( !gVulkanLoader ) {
+			gVulkanLoader = dlopen( "libMoltenVK.dylib", RTLD_NOW | RTLD_LOCAL );
+		}
+#else
+		gVulkanLoader = dlopen( "libvulkan.so.1", RTLD_NOW | RTLD_LOCAL );
+#endif
+	}
+
+	if ( !gVulkanLoader ) {
+		InstallVulkanFunctions();
+		return false;
+	}
+
+#if MSTD_OS_WINDOWS
+	gVulkanDriverFunctions.vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>( GetProcAddress( gVulkanLoader, "vkGetInstanceProcAddr" ) );
+#else
+	gVulkanDriverFunctions.vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>( dlsym( gVulkanLoader, "vkGetInstanceProcAddr" ) );
+#endif
+
+	if ( !gVulkanDriverFunctions.vkGetInstanceProcAddr ) {
+		error( "The Vulkan loader doesn't have vkGetInstanceProcAddr()!\n" );
+		CloseVulkanLoader();
+		return false;
+	}
+
+#define YETI_VK_LOAD_GLOBAL_FUNCTION( name )																			\
+	gVulkanDriverFunctions.name = reinterpret_cast<PFN_##name>( gVulkanDriverFunctions.vkGetInstanceProcAddr( VK_NULL_HANDLE, #name ) );	\
+	if ( !gVulkanDriverFunctions.name ) {																				\
+		fatalError( "Vulkan global function \"%s\" could not be loaded!\n", #name );									\
+	}
+	YETI_VK_GLOBAL_FUNCTIONS( YETI_VK_LOAD_GLOBAL_FUNCTION )
+#undef YETI_VK_LOAD_GLOBAL_FUNCTION
+
+	InstallVulkanFunctions();
+
+	return true;
+}
+
+/*
+========================
+CloseVulkanLoader
+========================
+*/
+void CloseVulkanLoader() {
+	if ( gVulkanLoader ) {
+#if MSTD_OS_WINDOWS
+		FreeLibrary( gVulkanLoader );
+#else
+		dlclose( gVulkanLoader );
+#endif
+		gVulkanLoader = nullptr;
+	}
+
+	gVulkanDriverFunctions = {};
+
+	InstallVulkanFunctions();
+}
+
+/*
+========================
+LoadVulkanInstanceFunctions
+========================
+*/
+void LoadVulkanInstanceFunctions( VkInstance instance ) {
+	// the instance came from the override, the loader has never heard of it
+	if ( !gVulkanLoader ) {
+		return;
+	}
+
+#define YETI_VK_LOAD_INSTANCE_FUNCTION( name )																			\
+	gVulkanDriverFunctions.name = reinterpret_cast<PFN_##name>( gVulkanDriverFunctions.vkGetInstanceProcAddr( instance, #name ) );	\
+	if ( !gVulkanDriverFunctions.name ) {																				\
+		fatalError( "Vulkan instance function \"%s\" could not be loaded!\n", #name );									\
+	}
+	YETI_VK_INSTANCE_FUNCTIONS( YETI_VK_LOAD_INSTANCE_FUNCTION )
+	YETI_VK_PLATFORM_FUNCTIONS( YETI_VK_LOAD_INSTANCE_FUNCTION )
+#undef YETI_VK_LOAD_INSTANCE_FUNCTION
+
+#define YETI_VK_LOAD_OPTIONAL_INSTANCE_FUNCTION( name )																	\
+	gVulkanDriverFunctions.name = reinterpret_cast<PFN_##name>( gVulkanDriverFunctions.vkGetInstanceProcAddr( instance, #name ) );
+	YETI_VK_INSTANCE_FUNCTIONS_1_1( YETI_VK_LOAD_OPTIONAL_INSTANCE_FUNCTION )
+#undef YETI_VK_LOAD_OPTIONAL_INSTANCE_FUNCTION
+
+	InstallVulkanFunctions();
+}
+
+/*
+========================
+LoadVulkanDeviceFunctions
+========================
+*/
+void LoadVulkanDeviceFunctions( VkDevice device ) {
+	if ( !gVulkanLoader ) {
+		return;
+	}
+
+#define YETI_VK_LOAD_DEVICE_FUNCTION( name )																			\
+	gVulkanDriverFunctions.name = reinterpret_cast<PFN_##name>( gVulkanDriverFunctions.vkGetDeviceProcAddr( device, #name ) );	\
+	if ( !gVulkanDriverFunctions.name ) {																				\
+		fatalError( "Vulkan device function \"%s\" could not be loaded!\n", #name );									\
+	}
+	YETI_VK_DEVICE_FUNCTIONS( YETI_VK_LOAD_DEVICE_FUNCTION )
+#undef YETI_VK_LOAD_DEVICE_FUNCTION
+
+	InstallVulkanFunctions();
+}
+
+/*
+========================
+GetVulkanDriverFunctions
+========================
+*/
+const vulkanFunctions_t& GetVulkanDriverFunctions() {
+	return gVulkanDriverFunctions;
+}
+
+/*
+========================
+SetVulkanDispatchOverride
+========================
+*/
+void SetVulkanDispatchOverride( const vulkanFunctions_t* functions, const bool32 wantsDriver ) {
+	gVulkanOverrideFunctions = functions;
+	gVulkanOverrideWantsDriver = wantsDriver;
+
+	InstallVulkanFunctions();
+}
+
+/*
+========================
+HasVulkanDispatchOverride
+========================
+*/
+bool32 HasVulkanDispatchOverride() {
+	return gVulkanOverrideFunctions != nullptr;
+}
\ No newline at end of file
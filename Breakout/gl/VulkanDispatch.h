@@ -0,0 +1,199 @@
+#ifndef __VULKAN_DISPATCH_H__
+#define __VULKAN_DISPATCH_H__
+
+#include <mstd/mstd.h>
+
+#if MSTD_OS_WINDOWS
+#define VK_USE_PLATFORM_WIN32_KHR		1
+#endif
+
+// the prototypes would clash with the pointers below, and linking against them would mean nothing can stand in for the driver
+#ifndef VK_NO_PROTOTYPES
+#error "VK_NO_PROTOTYPES has to be defined for the whole project, every vk* call goes through the pointers in VulkanDispatch.h!"
+#endif
+
+#include <vulkan/vulkan.h>
+
+/*
+================================================================================================
+
+	Vulkan Dispatch
+
+	Every vk* function the engine calls is a pointer declared here with the same name as the
+	prototype it replaces, so calling code looks exactly the same as it would linking straight
+	against the loader. Nothing links against vulkan-1.lib, the loader is opened at runtime and
+	the pointers get filled in as the context gets far enough to load them:
+
+		OpenVulkanLoader()				before anything else, vkGetInstanceProcAddr() and the global functions
+		LoadVulkanInstanceFunctions()	after vkCreateInstance()
+		LoadVulkanDeviceFunctions()		after vkCreateDevice(), these go straight to the driver without
+										going through the loader's trampolines first
+		CloseVulkanLoader()				after vkDestroyInstance()
+
+	Something else can take the driver's place by setting an override table, every pointer then
+	goes to the override instead. The driver's own functions still get loaded into a table of
+	their own if the override asks for them, so it can pass calls on. The VulkanStandIn is the
+	only thing that does this.
+
+	Extension functions aren't in here, the context loads those itself with vkGet*ProcAddr().
+
+	Adding a call to a vk* function that isn't in one of the lists below won't link, add it to
+	whichever list matches what it gets loaded with.
+
+================================================================================================
+*/
+
+// loaded from the loader itself, before there's an instance
+#define YETI_VK_GLOBAL_FUNCTIONS( X )						\
+	X( vkCreateInstance )									\
+	X( vkEnumerateInstanceLayerProperties )
+
+#define YETI_VK_INSTANCE_FUNCTIONS( X )						\
+	X( vkDestroyInstance )									\
+	X( vkEnumeratePhysicalDevices )							\
+	X( vkEnumerateDeviceExtensionProperties )				\
+	X( vkEnumerateDeviceLayerProperties )					\
+	X( vkGetPhysicalDeviceProperties )						\
+	X( vkGetPhysicalDeviceFeatures )						\
+	X( vkGetPhysicalDeviceMemoryProperties )				\
+	X( vkGetPhysicalDeviceQueueFamilyProperties )			\
+	X( vkGetPhysicalDeviceSurfaceSupportKHR )				\
+	X( vkGetPhysicalDeviceSurfaceCapabilitiesKHR )			\
+	X( vkGetPhysicalDeviceSurfaceFormatsKHR )				\
+	X( vkGetPhysicalDeviceSurfacePresentModesKHR )			\
+	X( vkDestroySurfaceKHR )								\
+	X( vkCreateDevice )										\
+	X( vkGetDeviceProcAddr )
+
+// 1.1 and up, these stay null on a 1.0 instance so only call them once the API version says they're there
+#ifdef VK_VERSION_1_1
+#define YETI_VK_INSTANCE_FUNCTIONS_1_1( X )					\
+	X( vkGetPhysicalDeviceProperties2 )						\
+	X( vkGetPhysicalDeviceFeatures2 )
+#else
+#define YETI_VK_INSTANCE_FUNCTIONS_1_1( X )
+#endif
+
+#if MSTD_OS_WINDOWS
+#define YETI_VK_PLATFORM_FUNCTIONS( X )						\
+	X( vkCreateWin32SurfaceKHR )
+#else
+#define YETI_VK_PLATFORM_FUNCTIONS( X )
+#endif
+
+#define YETI_VK_DEVICE_FUNCTIONS( X )						\
+	X( vkDestroyDevice )									\
+	X( vkGetDeviceQueue )									\
+	X( vkDeviceWaitIdle )									\
+	X( vkQueueSubmit )										\
+	X( vkQueuePresentKHR )									\
+	X( vkCreateSwapchainKHR )								\
+	X( vkDestroySwapchainKHR )								\
+	X( vkGetSwapchainImagesKHR )							\
+	X( vkAcquireNextImageKHR )								\
+	X( vkAllocateMemory )									\
+	X( vkFreeMemory )										\
+	X( vkMapMemory )										\
+	X( vkUnmapMemory )										\
+	X( vkFlushMappedMemoryRanges )							\
+	X( vkInvalidateMappedMemoryRanges )						\
+	X( vkCreateBuffer )										\
+	X( vkDestroyBuffer )									\
+	X( vkGetBufferMemoryRequirements )						\
+	X( vkBindBufferMemory )									\
+	X( vkCreateImage )										\
+	X( vkDestroyImage )										\
+	X( vkGetImageMemoryRequirements )						\
+	X( vkBindImageMemory )									\
+	X( vkCreateImageView )									\
+	X( vkDestroyImageView )									\
+	X( vkCreateSampler )									\
+	X( vkDestroySampler )									\
+	X( vkCreateShaderModule )								\
+	X( vkDestroyShaderModule )								\
+	X( vkCreateRenderPass )									\
+	X( vkDestroyRenderPass )								\
+	X( vkCreateFramebuffer )								\
+	X( vkDestroyFramebuffer )								\
+	X( vkCreateDescriptorSetLayout )						\
+	X( vkDestroyDescriptorSetLayout )						\
+	X( vkCreateDescriptorPool )								\
+	X( vkDestroyDescriptorPool )							\
+	X( vkResetDescriptorPool )								\
+	X( vkAllocateDescriptorSets )							\
+	X( vkUpdateDescriptorSets )								\
+	X( vkCreatePipelineLayout )								\
+	X( vkDestroyPipelineLayout )							\
+	X( vkCreatePipelineCache )								\
+	X( vkDestroyPipelineCache )								\
+	X( vkGetPipelineCacheData )								\
+	X( vkCreateGraphicsPipelines )							\
+	X( vkDestroyPipeline )									\
+	X( vkCreateCommandPool )								\
+	X( vkDestroyCommandPool )								\
+	X( vkResetCommandPool )									\
+	X( vkAllocateCommandBuffers )							\
+	X( vkFreeCommandBuffers )								\
+	X( vkBeginCommandBuffer )								\
+	X( vkEndCommandBuffer )									\
+	X( vkCreateFence )										\
+	X( vkDestroyFence )										\
+	X( vkResetFences )										\
+	X( vkWaitForFences )									\
+	X( vkCreateSemaphore )									\
+	X( vkDestroySemaphore )									\
+	X( vkCreateQueryPool )									\
+	X( vkDestroyQueryPool )									\
+	X( vkGetQueryPoolResults )								\
+	X( vkCmdBeginRenderPass )								\
+	X( vkCmdEndRenderPass )									\
+	X( vkCmdExecuteCommands )								\
+	X( vkCmdBindPipeline )									\
+	X( vkCmdBindDescriptorSets )							\
+	X( vkCmdBindVertexBuffers )								\
+	X( vkCmdBindIndexBuffer )								\
+	X( vkCmdPushConstants )									\
+	X( vkCmdSetViewport )									\
+	X( vkCmdSetScissor )									\
+	X( vkCmdDraw )											\
+	X( vkCmdDrawIndexed )									\
+	X( vkCmdPipelineBarrier )								\
+	X( vkCmdCopyBuffer )									\
+	X( vkCmdCopyBufferToImage )								\
+	X( vkCmdCopyImageToBuffer )								\
+	X( vkCmdResetQueryPool )								\
+	X( vkCmdWriteTimestamp )
+
+#define YETI_VK_FUNCTIONS( X )								\
+	X( vkGetInstanceProcAddr )								\
+	YETI_VK_GLOBAL_FUNCTIONS( X )							\
+	YETI_VK_INSTANCE_FUNCTIONS( X )							\
+	YETI_VK_INSTANCE_FUNCTIONS_1_1( X )						\
+	YETI_VK_PLATFORM_FUNCTIONS( X )							\
+	YETI_VK_DEVICE_FUNCTIONS( X )
+
+#define YETI_VK_DECLARE_FUNCTION( name )					extern PFN_##name name;
+#define YETI_VK_DECLARE_FUNCTION_MEMBER( name )				PFN_##name name;
+
+YETI_VK_FUNCTIONS( YETI_VK_DECLARE_FUNCTION )
+
+// one of every function above, whatever they happen to point at
+struct vulkanFunctions_t {
+	YETI_VK_FUNCTIONS( YETI_VK_DECLARE_FUNCTION_MEMBER )
+};
+
+// false if there's no loader on this machine, or the override doesn't want one
+bool32							OpenVulkanLoader();
+void							CloseVulkanLoader();
+
+void							LoadVulkanInstanceFunctions( VkInstance instance );
+void							LoadVulkanDeviceFunctions( VkDevice device );
+
+// every pointer is null when there's no loader, and the ones that haven't been loaded yet
+const vulkanFunctions_t&		GetVulkanDriverFunctions();
+
+// null to go back to the driver, wantsDriver says whether OpenVulkanLoader() should still load it underneath
+void							SetVulkanDispatchOverride( const vulkanFunctions_t* functions, const bool32 wantsDriver );
+bool32							HasVulkanDispatchOverride();
+
+#endif // __VULKAN_DISPATCH_H__
\ No newline at end of file
@@ -0,0 +1,2659 @@
+#include "VulkanStandIn.h"
+
+#include <mutex>
+
+/*
+================================================================================================
+
+	Vulkan Stand-In
+
+================================================================================================
+*/
+
+// without a driver the handles handed out are the addresses of the objects tracking them
+static_assert( sizeof( void* ) == sizeof( u64 ), "The Vulkan stand-in only works in 64 bit builds, where every handle is a pointer!" );
+
+static const u32			MIN_TABLE_SIZE = 1024;		// MUST be a power of 2
+
+static const u32			MAX_SWAP_CHAIN_IMAGES = 8;
+
+// what the stand-in device says it has when there's no driver
+static const VkDeviceSize	NULL_HEAP_SIZE = 4ull * 1024 * 1024 * 1024;
+static const VkDeviceSize	NULL_ALIGNMENT = 256;
+
+enum objectType_t {
+	OBJECT_INSTANCE							= 0,
+	OBJECT_PHYSICAL_DEVICE,
+	OBJECT_SURFACE,
+	OBJECT_DEBUG_CALLBACK,
+	OBJECT_DEVICE,
+	OBJECT_QUEUE,
+	OBJECT_SWAP_CHAIN,
+	OBJECT_MEMORY,
+	OBJECT_BUFFER,
+	OBJECT_IMAGE,
+	OBJECT_IMAGE_VIEW,
+	OBJECT_SAMPLER,
+	OBJECT_SHADER_MODULE,
+	OBJECT_RENDER_PASS,
+	OBJECT_FRAMEBUFFER,
+	OBJECT_DESCRIPTOR_SET_LAYOUT,
+	OBJECT_DESCRIPTOR_POOL,
+	OBJECT_DESCRIPTOR_SET,
+	OBJECT_DESCRIPTOR_UPDATE_TEMPLATE,
+	OBJECT_PIPELINE_LAYOUT,
+	OBJECT_PIPELINE_CACHE,
+	OBJECT_PIPELINE,
+	OBJECT_COMMAND_POOL,
+	OBJECT_COMMAND_BUFFER,
+	OBJECT_FENCE,
+	OBJECT_SEMAPHORE,
+	OBJECT_QUERY_POOL,
+
+	OBJECT_COUNT
+};
+
+static const char* OBJECT_TYPE_NAMES[] = {
+	"VkInstance",
+	"VkPhysicalDevice",
+	"VkSurfaceKHR",
+	"VkDebugReportCallbackEXT",
+	"VkDevice",
+	"VkQueue",
+	"VkSwapchainKHR",
+	"VkDeviceMemory",
+	"VkBuffer",
+	"VkImage",
+	"VkImageView",
+	"VkSampler",
+	"VkShaderModule",
+	"VkRenderPass",
+	"VkFramebuffer",
+	"VkDescriptorSetLayout",
+	"VkDescriptorPool",
+	"VkDescriptorSet",
+	"VkDescriptorUpdateTemplateKHR",
+	"VkPipelineLayout",
+	"VkPipelineCache",
+	"VkPipeline",
+	"VkCommandPool",
+	"VkCommandBuffer",
+	"VkFence",
+	"VkSemaphore",
+	"VkQueryPool",
+};
+
+static_assert( sizeof( OBJECT_TYPE_NAMES ) / sizeof( OBJECT_TYPE_NAMES[0] ) == OBJECT_COUNT, "Every object type needs a name!" );
+
+enum commandBufferState_t {
+	COMMAND_BUFFER_STATE_INITIAL			= 0,
+	COMMAND_BUFFER_STATE_RECORDING,
+	COMMAND_BUFFER_STATE_EXECUTABLE,
+};
+
+// one per live handle, only the fields for its type mean anything
+struct object_t {
+	u64								mHandle;
+	objectType_t					mType;
+
+	// the ones that go when their parent does without being destroyed themselves
+	object_t*						mParent;
+	object_t*						mFirstChild;
+	object_t*						mPrev;
+	object_t*						mNext;
+
+	// memory, buffers and images
+	VkDeviceSize					mSize;
+	u8*								mData;					// only without a driver, and not until it's first mapped
+
+	// images
+	VkFormat						mFormat;
+	VkExtent3D						mExtent;
+	u32								mNumLayers;
+
+	// fences
+	bool32							mSignalled;
+
+	// descriptor pools
+	u32								mMaxSets;
+
+	// descriptor update templates, how many descriptors every update with one writes
+	u32								mNumDescriptors;
+
+	// swap chains
+	u32								mNumImages;
+	u32								mNextImage;
+
+	// command buffers
+	commandBufferState_t			mState;
+	vulkanStandInStats_t			mCounters;
+};
+
+struct standIn_t {
+	std::mutex						mMutex;
+
+	vulkanFunctions_t				mFunctions;
+	const vulkanFunctions_t*		mDriver;
+
+	// open addressed on the handle, guarded by mMutex
+	array<object_t*>				mTable;
+	u32								mNumObjects;
+	u32								mNumRemoved;
+
+	vulkanStandInStats_t			mStats;
+
+	bool32							mInstalled;
+	bool32							mWantsReplay;
+	bool32							mReplay;
+};
+
+static standIn_t					gStandIn;
+
+// marks a slot something was removed from, so probing carries on past it
+static object_t						gRemovedObject;
+
+/*
+========================
+HandleKey
+========================
+*/
+template<typename handle_t>
+static u64 HandleKey( const handle_t handle ) {
+	return reinterpret_cast<u64>( handle );
+}
+
+/*
+========================
+ObjectHandle
+========================
+*/
+template<typename handle_t>
+static handle_t ObjectHandle( const object_t* object ) {
+	return reinterpret_cast<handle_t>( object->mHandle );
+}
+
+/*
+========================
+HashHandle
+========================
+*/
+static u32 HashHandle( const u64 handle ) {
+	// handles are mostly aligned pointers, so the low bits on their own are no good
+	return static_cast<u32>( ( handle * 0x9E3779B97F4A7C15ull ) >> 32 );
+}
+
+/*
+========================
+AddStats
+========================
+*/
+static void AddStats( vulkanStandInStats_t& stats, const vulkanStandInStats_t& counters ) {
+	stats.mCommands += counters.mCommands;
+	stats.mDraws += counters.mDraws;
+	stats.mPipelineBinds += counters.mPipelineBinds;
+	stats.mDescriptorSetBinds += counters.mDescriptorSetBinds;
+	stats.mBufferBinds += counters.mBufferBinds;
+	stats.mPushConstants += counters.mPushConstants;
+	stats.mBarriers += counters.mBarriers;
+	stats.mImageBarriers += counters.mImageBarriers;
+	stats.mRenderPasses += counters.mRenderPasses;
+	stats.mBytesCopied += counters.mBytesCopied;
+}
+
+/*
+========================
+GetFormatBytes
+========================
+*/
+static u32 GetFormatBytes( const VkFormat format ) {
+	// only needs to cover what gets uploaded to, anything else is counted as 4 bytes a texel
+	switch ( format ) {
+	case VK_FORMAT_R8_UNORM:
+		return 1;
+
+	case VK_FORMAT_R8G8_UNORM:
+		return 2;
+
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+		return 8;
+
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return 16;
+
+	default:
+		return 4;
+	}
+}
+
+/*
+================================================================================================
+
+	Handle table, everything in here expects mMutex to be held
+
+================================================================================================
+*/
+
+/*
+========================
+FindObjectLocked
+========================
+*/
+static object_t* FindObjectLocked( const u64 handle ) {
+	if ( handle == 0 || gStandIn.mTable.length() == 0 ) {
+		return nullptr;
+	}
+
+	u32 mask = static_cast<u32>( gStandIn.mTable.length() ) - 1;
+
+	for ( u32 slot = HashHandle( handle ) & mask; ; slot = ( slot + 1 ) & mask ) {
+		object_t* object = gStandIn.mTable[slot];
+
+		if ( !object ) {
+			return nullptr;
+		}
+
+		if ( object != &gRemovedObject && object->mHandle == handle ) {
+			return object;
+		}
+	}
+}
+
+/*
+========================
+InsertObjectLocked
+========================
+*/
+static void InsertObjectLocked( object_t* object ) {
+	u32 mask = static_cast<u32>( gStandIn.mTable.length() ) - 1;
+
+	for ( u32 slot = HashHandle( object->mHandle ) & mask; ; slot = ( slot + 1 ) & mask ) {
+		object_t*& entry = gStandIn.mTable[slot];
+
+		if ( !entry || entry == &gRemovedObject ) {
+			if ( entry == &gRemovedObject ) {
+				gStandIn.mNumRemoved--;
+			}
+
+			entry = object;
+			gStandIn.mNumObjects++;
+			return;
+		}
+	}
+}
+
+/*
+========================
+GrowTableLocked
+========================
+*/
+static void GrowTableLocked() {
+	// kept under half full, removed slots count since probing has to step over them too
+	u32 tableSize = static_cast<u32>( gStandIn.mTable.length() );
+	if ( ( gStandIn.mNumObjects + gStandIn.mNumRemoved + 1 ) * 2 <= tableSize ) {
+		return;
+	}
+
+	u32 newTableSize = max( tableSize, MIN_TABLE_SIZE );
+	while ( ( gStandIn.mNumObjects + 1 ) * 4 > newTableSize ) {
+		newTableSize *= 2;
+	}
+
+	array<object_t*> oldTable = gStandIn.mTable;
+
+	gStandIn.mTable.resize( newTableSize );
+	memset( gStandIn.mTable.data(), 0, newTableSize * sizeof( object_t* ) );
+	gStandIn.mNumObjects = 0;
+	gStandIn.mNumRemoved = 0;
+
+	for ( size_t i = 0; i < oldTable.length(); i++ ) {
+		if ( oldTable[i] && oldTable[i] != &gRemovedObject ) {
+			InsertObjectLocked( oldTable[i] );
+		}
+	}
+}
+
+/*
+========================
+NewObjectLocked
+========================
+*/
+static object_t* NewObjectLocked( const objectType_t type, const u64 handle, object_t* parent ) {
+	object_t* object = new object_t();
+	object->mType = type;
+
+	// without a driver there's nothing else to tell objects apart by
+	object->mHandle = ( handle != 0 ) ? handle : reinterpret_cast<u64>( object );
+
+	if ( parent ) {
+		object->mParent = parent;
+		object->mNext = parent->mFirstChild;
+
+		if ( parent->mFirstChild ) {
+			parent->mFirstChild->mPrev = object;
+		}
+
+		parent->mFirstChild = object;
+	}
+
+	GrowTableLocked();
+	InsertObjectLocked( object );
+
+	return object;
+}
+
+/*
+========================
+DeleteObjectLocked
+========================
+*/
+static void DeleteObjectLocked( object_t* object ) {
+	while ( object->mFirstChild ) {
+		DeleteObjectLocked( object->mFirstChild );
+	}
+
+	if ( object->mParent ) {
+		if ( object->mPrev ) {
+			object->mPrev->mNext = object->mNext;
+		} else {
+			object->mParent->mFirstChild = object->mNext;
+		}
+
+		if ( object->mNext ) {
+			object->mNext->mPrev = object->mPrev;
+		}
+	}
+
+	u32 mask = static_cast<u32>( gStandIn.mTable.length() ) - 1;
+
+	for ( u32 slot = HashHandle( object->mHandle ) & mask; ; slot = ( slot + 1 ) & mask ) {
+		if ( gStandIn.mTable[slot] == object ) {
+			gStandIn.mTable[slot] = &gRemovedObject;
+			gStandIn.mNumObjects--;
+			gStandIn.mNumRemoved++;
+			break;
+		}
+	}
+
+	free( object->mData );
+	object->mData = nullptr;
+
+	delete object;
+	object = nullptr;
+}
+
+/*
+========================
+LookupObjectLocked
+========================
+*/
+static object_t* LookupObjectLocked( const u64 handle, const objectType_t type, const char* function ) {
+	object_t* object = FindObjectLocked( handle );
+
+	if ( !object ) {
+		error( "Vulkan stand-in: %s() was given a %s (0x%llX) that doesn't exist!\n", function, OBJECT_TYPE_NAMES[type], handle );
+		gStandIn.mStats.mValidationErrors++;
+		return nullptr;
+	}
+
+	if ( object->mType != type ) {
+		error( "Vulkan stand-in: %s() was given a %s (0x%llX) where it wanted a %s!\n", function, OBJECT_TYPE_NAMES[object->mType], handle, OBJECT_TYPE_NAMES[type] );
+		gStandIn.mStats.mValidationErrors++;
+		return nullptr;
+	}
+
+	return object;
+}
+
+/*
+================================================================================================
+
+	Locking wrappers around the table, for the stand-in functions
+
+================================================================================================
+*/
+
+/*
+========================
+LookupObject
+========================
+*/
+template<typename handle_t>
+static object_t* LookupObject( const handle_t handle, const objectType_t type, const char* function ) {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+	return LookupObjectLocked( HandleKey( handle ), type, function );
+}
+
+/*
+========================
+CheckObject
+========================
+*/
+// like LookupObject(), but VK_NULL_HANDLE is fine
+template<typename handle_t>
+static void CheckObject( const handle_t handle, const objectType_t type, const char* function ) {
+	if ( handle == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+	LookupObjectLocked( HandleKey( handle ), type, function );
+}
+
+/*
+========================
+TrackObject
+========================
+*/
+template<typename handle_t>
+static object_t* TrackObject( const objectType_t type, handle_t& handle, const u64 parent ) {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	object_t* parentObject = ( parent != 0 ) ? FindObjectLocked( parent ) : nullptr;
+
+	// the driver made the handle, otherwise the stand-in makes one up
+	if ( gStandIn.mReplay ) {
+		return NewObjectLocked( type, HandleKey( handle ), parentObject );
+	}
+
+	object_t* object = NewObjectLocked( type, 0, parentObject );
+	handle = ObjectHandle<handle_t>( object );
+
+	return object;
+}
+
+/*
+========================
+UntrackObject
+========================
+*/
+template<typename handle_t>
+static void UntrackObject( const handle_t handle, const objectType_t type, const char* function ) {
+	if ( handle == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	object_t* object = LookupObjectLocked( HandleKey( handle ), type, function );
+	if ( object ) {
+		DeleteObjectLocked( object );
+	}
+}
+
+/*
+========================
+RecordCommand
+========================
+*/
+// the command buffer if it's recording, with the command already counted
+static object_t* RecordCommand( VkCommandBuffer commandBuffer, const char* function ) {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	object_t* object = LookupObjectLocked( HandleKey( commandBuffer ), OBJECT_COMMAND_BUFFER, function );
+	if ( !object ) {
+		return nullptr;
+	}
+
+	if ( object->mState != COMMAND_BUFFER_STATE_RECORDING ) {
+		error( "Vulkan stand-in: %s() was recorded into a command buffer that isn't recording!\n", function );
+		gStandIn.mStats.mValidationErrors++;
+		return nullptr;
+	}
+
+	object->mCounters.mCommands++;
+
+	return object;
+}
+
+/*
+========================
+CopyArray
+========================
+*/
+// fills in one of Vulkan's count then data arrays
+template<typename element_t>
+static VkResult CopyArray( const element_t* elements, const u32 numElements, uint32_t* pCount, element_t* pElements ) {
+	if ( !pElements ) {
+		*pCount = numElements;
+		return VK_SUCCESS;
+	}
+
+	u32 numCopied = min( *pCount, numElements );
+	memcpy( pElements, elements, numCopied * sizeof( element_t ) );
+	*pCount = numCopied;
+
+	return ( numCopied < numElements ) ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+/*
+================================================================================================
+
+	The stand-in functions. Each one checks and counts, then either passes the call on to
+	the driver or does whatever the driver would have done as far as the engine can tell.
+
+================================================================================================
+*/
+
+/*
+========================
+StandInEnumerateInstanceLayerProperties
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInEnumerateInstanceLayerProperties( uint32_t* pPropertyCount, VkLayerProperties* pProperties ) {
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkEnumerateInstanceLayerProperties( pPropertyCount, pProperties );
+	}
+
+	return CopyArray<VkLayerProperties>( nullptr, 0, pPropertyCount, pProperties );
+}
+
+/*
+========================
+StandInCreateInstance
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateInstance( const VkInstanceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkInstance* pInstance ) {
+	// decided here, by now the context has tried to open the loader
+	gStandIn.mReplay = gStandIn.mWantsReplay && gStandIn.mDriver->vkCreateInstance;
+
+	if ( gStandIn.mWantsReplay && !gStandIn.mReplay ) {
+		warning( "Vulkan stand-in: there's no driver to replay to, every call is going to the stand-in instead.\n" );
+	}
+
+	printf( "Vulkan stand-in installed, %s.\n", gStandIn.mReplay ? "replaying to the driver" : "without a driver" );
+
+	if ( gStandIn.mReplay ) {
+		VkResult result = gStandIn.mDriver->vkCreateInstance( pCreateInfo, pAllocator, pInstance );
+		if ( result == VK_SUCCESS ) {
+			TrackObject( OBJECT_INSTANCE, *pInstance, 0 );
+		}
+
+		return result;
+	}
+
+	object_t* instance = TrackObject( OBJECT_INSTANCE, *pInstance, 0 );
+
+	// the one and only GPU, goes when the instance does
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	TrackObject( OBJECT_PHYSICAL_DEVICE, physicalDevice, instance->mHandle );
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInDestroyInstance
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroyInstance( VkInstance instance, const VkAllocationCallbacks* pAllocator ) {
+	UntrackObject( instance, OBJECT_INSTANCE, "vkDestroyInstance" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkDestroyInstance( instance, pAllocator );
+	}
+}
+
+/*
+========================
+StandInEnumeratePhysicalDevices
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInEnumeratePhysicalDevices( VkInstance instance, uint32_t* pPhysicalDeviceCount, VkPhysicalDevice* pPhysicalDevices ) {
+	object_t* instanceObject = LookupObject( instance, OBJECT_INSTANCE, "vkEnumeratePhysicalDevices" );
+
+	if ( gStandIn.mReplay ) {
+		VkResult result = gStandIn.mDriver->vkEnumeratePhysicalDevices( instance, pPhysicalDeviceCount, pPhysicalDevices );
+
+		// the same GPUs come back every time, they only need tracking once
+		if ( pPhysicalDevices && instanceObject && ( result == VK_SUCCESS || result == VK_INCOMPLETE ) ) {
+			std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+			for ( u32 i = 0; i < *pPhysicalDeviceCount; i++ ) {
+				if ( !FindObjectLocked( HandleKey( pPhysicalDevices[i] ) ) ) {
+					NewObjectLocked( OBJECT_PHYSICAL_DEVICE, HandleKey( pPhysicalDevices[i] ), instanceObject );
+				}
+			}
+		}
+
+		return result;
+	}
+
+	VkPhysicalDevice physicalDevice = instanceObject ? ObjectHandle<VkPhysicalDevice>( instanceObject->mFirstChild ) : VK_NULL_HANDLE;
+
+	return CopyArray( &physicalDevice, instanceObject ? 1 : 0, pPhysicalDeviceCount, pPhysicalDevices );
+}
+
+/*
+========================
+StandInEnumerateDeviceExtensionProperties
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInEnumerateDeviceExtensionProperties( VkPhysicalDevice physicalDevice, const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkEnumerateDeviceExtensionProperties" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkEnumerateDeviceExtensionProperties( physicalDevice, pLayerName, pPropertyCount, pProperties );
+	}
+
+	// just enough to draw, so every optional path that changes what gets recorded stays off
+	VkExtensionProperties extensions[2] = {};
+	u32 numExtensions = 0;
+
+	strcpy( extensions[numExtensions].extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+	extensions[numExtensions].specVersion = VK_KHR_SWAPCHAIN_SPEC_VERSION;
+	numExtensions++;
+
+#ifdef VK_KHR_descriptor_update_template
+	// only changes how sets are written, and the stand-in answers it itself
+	strcpy( extensions[numExtensions].extensionName, VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME );
+	extensions[numExtensions].specVersion = VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_SPEC_VERSION;
+	numExtensions++;
+#endif
+
+	return CopyArray( extensions, numExtensions, pPropertyCount, pProperties );
+}
+
+/*
+========================
+StandInEnumerateDeviceLayerProperties
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInEnumerateDeviceLayerProperties( VkPhysicalDevice physicalDevice, uint32_t* pPropertyCount, VkLayerProperties* pProperties ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkEnumerateDeviceLayerProperties" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkEnumerateDeviceLayerProperties( physicalDevice, pPropertyCount, pProperties );
+	}
+
+	// debug builds insist on there being at least one
+	VkLayerProperties layer = {};
+	strcpy( layer.layerName, "VK_LAYER_YETI_stand_in" );
+	strcpy( layer.description, "Every call is checked and counted by the Vulkan stand-in" );
+	layer.specVersion = VK_API_VERSION_1_0;
+	layer.implementationVersion = 1;
+
+	return CopyArray( &layer, 1, pPropertyCount, pProperties );
+}
+
+/*
+========================
+StandInGetPhysicalDeviceProperties
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceProperties( VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties* pProperties ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceProperties" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetPhysicalDeviceProperties( physicalDevice, pProperties );
+		return;
+	}
+
+	*pProperties = {};
+	pProperties->apiVersion = VK_API_VERSION_1_0;
+	pProperties->driverVersion = 1;
+	pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_CPU;
+	strcpy( pProperties->deviceName, "Yeti Vulkan Stand-In" );
+
+	// roughly a desktop GPU, nothing the engine asks for should come close
+	VkPhysicalDeviceLimits& limits = pProperties->limits;
+	limits.maxImageDimension1D = 16384;
+	limits.maxImageDimension2D = 16384;
+	limits.maxImageDimension3D = 2048;
+	limits.maxImageDimensionCube = 16384;
+	limits.maxImageArrayLayers = 2048;
+	limits.maxTexelBufferElements = 128 * 1024 * 1024;
+	limits.maxUniformBufferRange = 64 * 1024;
+	limits.maxStorageBufferRange = U32_MAX;
+	limits.maxPushConstantsSize = 256;
+	limits.maxMemoryAllocationCount = 4096;
+	limits.maxSamplerAllocationCount = 4000;
+	limits.bufferImageGranularity = 1;
+	limits.maxBoundDescriptorSets = 8;
+	limits.maxPerStageDescriptorSamplers = 1024 * 1024;
+	limits.maxPerStageDescriptorUniformBuffers = 1024 * 1024;
+	limits.maxPerStageDescriptorStorageBuffers = 1024 * 1024;
+	limits.maxPerStageDescriptorSampledImages = 1024 * 1024;
+	limits.maxPerStageDescriptorStorageImages = 1024 * 1024;
+	limits.maxPerStageResources = 1024 * 1024;
+	limits.maxDescriptorSetSamplers = 1024 * 1024;
+	limits.maxDescriptorSetUniformBuffers = 1024 * 1024;
+	limits.maxDescriptorSetUniformBuffersDynamic = 16;
+	limits.maxDescriptorSetStorageBuffers = 1024 * 1024;
+	limits.maxDescriptorSetStorageBuffersDynamic = 16;
+	limits.maxDescriptorSetSampledImages = 1024 * 1024;
+	limits.maxDescriptorSetStorageImages = 1024 * 1024;
+	limits.maxVertexInputAttributes = 32;
+	limits.maxVertexInputBindings = 32;
+	limits.maxVertexInputAttributeOffset = 2047;
+	limits.maxVertexInputBindingStride = 2048;
+	limits.maxColorAttachments = 8;
+	limits.maxFramebufferWidth = 16384;
+	limits.maxFramebufferHeight = 16384;
+	limits.maxFramebufferLayers = 2048;
+	limits.framebufferColorSampleCounts = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+	limits.framebufferDepthSampleCounts = limits.framebufferColorSampleCounts;
+	limits.maxViewports = 16;
+	limits.maxViewportDimensions[0] = 16384;
+	limits.maxViewportDimensions[1] = 16384;
+	limits.viewportBoundsRange[0] = -32768.0f;
+	limits.viewportBoundsRange[1] = 32767.0f;
+	limits.maxSamplerAnisotropy = 16.0f;
+	limits.maxSamplerLodBias = 16.0f;
+	limits.minMemoryMapAlignment = 16;
+	limits.minTexelBufferOffsetAlignment = NULL_ALIGNMENT;
+	limits.minUniformBufferOffsetAlignment = NULL_ALIGNMENT;
+	limits.minStorageBufferOffsetAlignment = NULL_ALIGNMENT;
+	limits.optimalBufferCopyOffsetAlignment = 1;
+	limits.optimalBufferCopyRowPitchAlignment = 1;
+	limits.nonCoherentAtomSize = 64;
+	limits.timestampComputeAndGraphics = VK_TRUE;
+	limits.timestampPeriod = 1.0f;
+}
+
+/*
+========================
+StandInGetPhysicalDeviceFeatures
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceFeatures( VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures* pFeatures ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceFeatures" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetPhysicalDeviceFeatures( physicalDevice, pFeatures );
+		return;
+	}
+
+	// nothing gets drawn, so every feature is as supported as any other
+	VkBool32* features = reinterpret_cast<VkBool32*>( pFeatures );
+	for ( size_t i = 0; i < sizeof( VkPhysicalDeviceFeatures ) / sizeof( VkBool32 ); i++ ) {
+		features[i] = VK_TRUE;
+	}
+}
+
+/*
+========================
+StandInGetPhysicalDeviceMemoryProperties
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceMemoryProperties( VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties* pMemoryProperties ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceMemoryProperties" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetPhysicalDeviceMemoryProperties( physicalDevice, pMemoryProperties );
+		return;
+	}
+
+	// one type that's everything, so whatever the engine asks for it gets the same memory
+	*pMemoryProperties = {};
+	pMemoryProperties->memoryHeapCount = 1;
+	pMemoryProperties->memoryHeaps[0].size = NULL_HEAP_SIZE;
+	pMemoryProperties->memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+	pMemoryProperties->memoryTypeCount = 1;
+	pMemoryProperties->memoryTypes[0].heapIndex = 0;
+	pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+}
+
+/*
+========================
+StandInGetPhysicalDeviceQueueFamilyProperties
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceQueueFamilyProperties( VkPhysicalDevice physicalDevice, uint32_t* pQueueFamilyPropertyCount, VkQueueFamilyProperties* pQueueFamilyProperties ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceQueueFamilyProperties" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetPhysicalDeviceQueueFamilyProperties( physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties );
+		return;
+	}
+
+	VkQueueFamilyProperties family = {};
+	family.queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+	family.queueCount = 1;
+	family.timestampValidBits = 64;
+	family.minImageTransferGranularity = { 1, 1, 1 };
+
+	CopyArray( &family, 1, pQueueFamilyPropertyCount, pQueueFamilyProperties );
+}
+
+#ifdef VK_VERSION_1_1
+/*
+========================
+StandInGetPhysicalDeviceProperties2
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceProperties2( VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties2* pProperties ) {
+	if ( gStandIn.mReplay ) {
+		CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceProperties2" );
+		gStandIn.mDriver->vkGetPhysicalDeviceProperties2( physicalDevice, pProperties );
+		return;
+	}
+
+	// anything chained on is left as it is, there are no extensions to fill it in for
+	StandInGetPhysicalDeviceProperties( physicalDevice, &pProperties->properties );
+}
+
+/*
+========================
+StandInGetPhysicalDeviceFeatures2
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetPhysicalDeviceFeatures2( VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures2* pFeatures ) {
+	if ( gStandIn.mReplay ) {
+		CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceFeatures2" );
+		gStandIn.mDriver->vkGetPhysicalDeviceFeatures2( physicalDevice, pFeatures );
+		return;
+	}
+
+	StandInGetPhysicalDeviceFeatures( physicalDevice, &pFeatures->features );
+}
+#endif
+
+#if MSTD_OS_WINDOWS
+/*
+========================
+StandInCreateWin32SurfaceKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateWin32SurfaceKHR( VkInstance instance, const VkWin32SurfaceCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface ) {
+	CheckObject( instance, OBJECT_INSTANCE, "vkCreateWin32SurfaceKHR" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateWin32SurfaceKHR( instance, pCreateInfo, pAllocator, pSurface ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		TrackObject( OBJECT_SURFACE, *pSurface, 0 );
+	}
+
+	return result;
+}
+#endif
+
+/*
+========================
+StandInDestroySurfaceKHR
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroySurfaceKHR( VkInstance instance, VkSurfaceKHR surface, const VkAllocationCallbacks* pAllocator ) {
+	CheckObject( instance, OBJECT_INSTANCE, "vkDestroySurfaceKHR" );
+	UntrackObject( surface, OBJECT_SURFACE, "vkDestroySurfaceKHR" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkDestroySurfaceKHR( instance, surface, pAllocator );
+	}
+}
+
+/*
+========================
+StandInGetPhysicalDeviceSurfaceSupportKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetPhysicalDeviceSurfaceSupportKHR( VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, VkSurfaceKHR surface, VkBool32* pSupported ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceSurfaceSupportKHR" );
+	CheckObject( surface, OBJECT_SURFACE, "vkGetPhysicalDeviceSurfaceSupportKHR" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetPhysicalDeviceSurfaceSupportKHR( physicalDevice, queueFamilyIndex, surface, pSupported );
+	}
+
+	*pSupported = ( queueFamilyIndex == 0 ) ? VK_TRUE : VK_FALSE;
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInGetPhysicalDeviceSurfaceCapabilitiesKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetPhysicalDeviceSurfaceCapabilitiesKHR( VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkSurfaceCapabilitiesKHR* pSurfaceCapabilities ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR" );
+	CheckObject( surface, OBJECT_SURFACE, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetPhysicalDeviceSurfaceCapabilitiesKHR( physicalDevice, surface, pSurfaceCapabilities );
+	}
+
+	// there's no window, so the swap chain gets to pick its own size
+	*pSurfaceCapabilities = {};
+	pSurfaceCapabilities->minImageCount = 1;
+	pSurfaceCapabilities->maxImageCount = MAX_SWAP_CHAIN_IMAGES;
+	pSurfaceCapabilities->currentExtent = { U32_MAX, U32_MAX };
+	pSurfaceCapabilities->minImageExtent = { 1, 1 };
+	pSurfaceCapabilities->maxImageExtent = { 16384, 16384 };
+	pSurfaceCapabilities->maxImageArrayLayers = 1;
+	pSurfaceCapabilities->supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+	pSurfaceCapabilities->currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+	pSurfaceCapabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	pSurfaceCapabilities->supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInGetPhysicalDeviceSurfaceFormatsKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetPhysicalDeviceSurfaceFormatsKHR( VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pSurfaceFormatCount, VkSurfaceFormatKHR* pSurfaceFormats ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceSurfaceFormatsKHR" );
+	CheckObject( surface, OBJECT_SURFACE, "vkGetPhysicalDeviceSurfaceFormatsKHR" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetPhysicalDeviceSurfaceFormatsKHR( physicalDevice, surface, pSurfaceFormatCount, pSurfaceFormats );
+	}
+
+	VkSurfaceFormatKHR format = { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+
+	return CopyArray( &format, 1, pSurfaceFormatCount, pSurfaceFormats );
+}
+
+/*
+========================
+StandInGetPhysicalDeviceSurfacePresentModesKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetPhysicalDeviceSurfacePresentModesKHR( VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pPresentModeCount, VkPresentModeKHR* pPresentModes ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkGetPhysicalDeviceSurfacePresentModesKHR" );
+	CheckObject( surface, OBJECT_SURFACE, "vkGetPhysicalDeviceSurfacePresentModesKHR" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetPhysicalDeviceSurfacePresentModesKHR( physicalDevice, surface, pPresentModeCount, pPresentModes );
+	}
+
+	VkPresentModeKHR presentModes[] = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+
+	return CopyArray( presentModes, 2, pPresentModeCount, pPresentModes );
+}
+
+/*
+========================
+StandInCreateDevice
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateDevice( VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDevice* pDevice ) {
+	CheckObject( physicalDevice, OBJECT_PHYSICAL_DEVICE, "vkCreateDevice" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateDevice( physicalDevice, pCreateInfo, pAllocator, pDevice ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		TrackObject( OBJECT_DEVICE, *pDevice, 0 );
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInDestroyDevice
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroyDevice( VkDevice device, const VkAllocationCallbacks* pAllocator ) {
+	UntrackObject( device, OBJECT_DEVICE, "vkDestroyDevice" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkDestroyDevice( device, pAllocator );
+	}
+}
+
+/*
+========================
+StandInGetDeviceQueue
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetDeviceQueue( VkDevice device, uint32_t queueFamilyIndex, uint32_t queueIndex, VkQueue* pQueue ) {
+	object_t* deviceObject = LookupObject( device, OBJECT_DEVICE, "vkGetDeviceQueue" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetDeviceQueue( device, queueFamilyIndex, queueIndex, pQueue );
+	}
+
+	if ( !deviceObject ) {
+		return;
+	}
+
+	// the same queue comes back every time it's asked for, and goes with the device
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	if ( gStandIn.mReplay ) {
+		if ( !FindObjectLocked( HandleKey( *pQueue ) ) ) {
+			NewObjectLocked( OBJECT_QUEUE, HandleKey( *pQueue ), deviceObject );
+		}
+
+		return;
+	}
+
+	if ( queueFamilyIndex != 0 || queueIndex != 0 ) {
+		error( "Vulkan stand-in: vkGetDeviceQueue() asked for queue %u of family %u, there's only queue 0 of family 0!\n", queueIndex, queueFamilyIndex );
+		gStandIn.mStats.mValidationErrors++;
+	}
+
+	object_t* queue = deviceObject->mFirstChild;
+	if ( !queue ) {
+		queue = NewObjectLocked( OBJECT_QUEUE, 0, deviceObject );
+	}
+
+	*pQueue = ObjectHandle<VkQueue>( queue );
+}
+
+/*
+========================
+StandInDeviceWaitIdle
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInDeviceWaitIdle( VkDevice device ) {
+	CheckObject( device, OBJECT_DEVICE, "vkDeviceWaitIdle" );
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkDeviceWaitIdle( device ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInQueueSubmit
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInQueueSubmit( VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( queue ), OBJECT_QUEUE, "vkQueueSubmit" );
+
+		gStandIn.mStats.mSubmits++;
+
+		// this is when everything recorded actually happens
+		for ( u32 i = 0; i < submitCount; i++ ) {
+			const VkSubmitInfo& submit = pSubmits[i];
+
+			for ( u32 j = 0; j < submit.commandBufferCount; j++ ) {
+				object_t* commandBuffer = LookupObjectLocked( HandleKey( submit.pCommandBuffers[j] ), OBJECT_COMMAND_BUFFER, "vkQueueSubmit" );
+				if ( !commandBuffer ) {
+					continue;
+				}
+
+				if ( commandBuffer->mState != COMMAND_BUFFER_STATE_EXECUTABLE ) {
+					error( "Vulkan stand-in: vkQueueSubmit() was given a command buffer that hasn't been ended!\n" );
+					gStandIn.mStats.mValidationErrors++;
+					continue;
+				}
+
+				AddStats( gStandIn.mStats, commandBuffer->mCounters );
+				gStandIn.mStats.mCommandBuffersSubmitted++;
+			}
+
+			for ( u32 j = 0; j < submit.waitSemaphoreCount; j++ ) {
+				LookupObjectLocked( HandleKey( submit.pWaitSemaphores[j] ), OBJECT_SEMAPHORE, "vkQueueSubmit" );
+			}
+
+			for ( u32 j = 0; j < submit.signalSemaphoreCount; j++ ) {
+				LookupObjectLocked( HandleKey( submit.pSignalSemaphores[j] ), OBJECT_SEMAPHORE, "vkQueueSubmit" );
+			}
+		}
+
+		if ( fence != VK_NULL_HANDLE ) {
+			object_t* fenceObject = LookupObjectLocked( HandleKey( fence ), OBJECT_FENCE, "vkQueueSubmit" );
+
+			// without a driver the work is done as soon as it's submitted
+			if ( fenceObject ) {
+				fenceObject->mSignalled = true;
+			}
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkQueueSubmit( queue, submitCount, pSubmits, fence ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInQueuePresentKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInQueuePresentKHR( VkQueue queue, const VkPresentInfoKHR* pPresentInfo ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( queue ), OBJECT_QUEUE, "vkQueuePresentKHR" );
+
+		for ( u32 i = 0; i < pPresentInfo->swapchainCount; i++ ) {
+			LookupObjectLocked( HandleKey( pPresentInfo->pSwapchains[i] ), OBJECT_SWAP_CHAIN, "vkQueuePresentKHR" );
+		}
+
+		gStandIn.mStats.mPresents++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkQueuePresentKHR( queue, pPresentInfo );
+	}
+
+	if ( pPresentInfo->pResults ) {
+		for ( u32 i = 0; i < pPresentInfo->swapchainCount; i++ ) {
+			pPresentInfo->pResults[i] = VK_SUCCESS;
+		}
+	}
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInCreateSwapchainKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateSwapchainKHR( VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateSwapchainKHR" );
+	CheckObject( pCreateInfo->surface, OBJECT_SURFACE, "vkCreateSwapchainKHR" );
+	CheckObject( pCreateInfo->oldSwapchain, OBJECT_SWAP_CHAIN, "vkCreateSwapchainKHR" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateSwapchainKHR( device, pCreateInfo, pAllocator, pSwapchain ) : VK_SUCCESS;
+	if ( result != VK_SUCCESS ) {
+		return result;
+	}
+
+	object_t* swapChain = TrackObject( OBJECT_SWAP_CHAIN, *pSwapchain, 0 );
+
+	// with a driver its images are tracked once they're asked for
+	if ( gStandIn.mReplay ) {
+		return VK_SUCCESS;
+	}
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	swapChain->mNumImages = min( max( pCreateInfo->minImageCount, 1u ), MAX_SWAP_CHAIN_IMAGES );
+
+	for ( u32 i = 0; i < swapChain->mNumImages; i++ ) {
+		object_t* image = NewObjectLocked( OBJECT_IMAGE, 0, swapChain );
+		image->mFormat = pCreateInfo->imageFormat;
+		image->mExtent = { pCreateInfo->imageExtent.width, pCreateInfo->imageExtent.height, 1 };
+		image->mNumLayers = pCreateInfo->imageArrayLayers;
+	}
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInDestroySwapchainKHR
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroySwapchainKHR( VkDevice device, VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator ) {
+	CheckObject( device, OBJECT_DEVICE, "vkDestroySwapchainKHR" );
+
+	// takes its images with it
+	UntrackObject( swapchain, OBJECT_SWAP_CHAIN, "vkDestroySwapchainKHR" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkDestroySwapchainKHR( device, swapchain, pAllocator );
+	}
+}
+
+/*
+========================
+StandInGetSwapchainImagesKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetSwapchainImagesKHR( VkDevice device, VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages ) {
+	CheckObject( device, OBJECT_DEVICE, "vkGetSwapchainImagesKHR" );
+	object_t* swapChain = LookupObject( swapchain, OBJECT_SWAP_CHAIN, "vkGetSwapchainImagesKHR" );
+
+	if ( gStandIn.mReplay ) {
+		VkResult result = gStandIn.mDriver->vkGetSwapchainImagesKHR( device, swapchain, pSwapchainImageCount, pSwapchainImages );
+
+		if ( pSwapchainImages && swapChain && ( result == VK_SUCCESS || result == VK_INCOMPLETE ) ) {
+			std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+			for ( u32 i = 0; i < *pSwapchainImageCount; i++ ) {
+				if ( !FindObjectLocked( HandleKey( pSwapchainImages[i] ) ) ) {
+					NewObjectLocked( OBJECT_IMAGE, HandleKey( pSwapchainImages[i] ), swapChain );
+				}
+			}
+		}
+
+		return result;
+	}
+
+	VkImage images[MAX_SWAP_CHAIN_IMAGES] = {};
+	u32 numImages = 0;
+
+	if ( swapChain ) {
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		for ( object_t* image = swapChain->mFirstChild; image; image = image->mNext ) {
+			images[numImages++] = ObjectHandle<VkImage>( image );
+		}
+	}
+
+	return CopyArray( images, numImages, pSwapchainImageCount, pSwapchainImages );
+}
+
+/*
+========================
+StandInAcquireNextImageKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInAcquireNextImageKHR( VkDevice device, VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex ) {
+	CheckObject( device, OBJECT_DEVICE, "vkAcquireNextImageKHR" );
+	CheckObject( semaphore, OBJECT_SEMAPHORE, "vkAcquireNextImageKHR" );
+	object_t* swapChain = LookupObject( swapchain, OBJECT_SWAP_CHAIN, "vkAcquireNextImageKHR" );
+	object_t* fenceObject = ( fence != VK_NULL_HANDLE ) ? LookupObject( fence, OBJECT_FENCE, "vkAcquireNextImageKHR" ) : nullptr;
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkAcquireNextImageKHR( device, swapchain, timeout, semaphore, fence, pImageIndex );
+	}
+
+	if ( !swapChain ) {
+		return VK_ERROR_OUT_OF_DATE_KHR;
+	}
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	// round and round, nothing is ever still on screen
+	*pImageIndex = swapChain->mNextImage;
+	swapChain->mNextImage = ( swapChain->mNextImage + 1 ) % swapChain->mNumImages;
+
+	if ( fenceObject ) {
+		fenceObject->mSignalled = true;
+	}
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInAllocateMemory
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInAllocateMemory( VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory ) {
+	CheckObject( device, OBJECT_DEVICE, "vkAllocateMemory" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkAllocateMemory( device, pAllocateInfo, pAllocator, pMemory ) : VK_SUCCESS;
+	if ( result != VK_SUCCESS ) {
+		return result;
+	}
+
+	object_t* memory = TrackObject( OBJECT_MEMORY, *pMemory, 0 );
+	memory->mSize = pAllocateInfo->allocationSize;
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+	gStandIn.mStats.mMemoryAllocations++;
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInFreeMemory
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInFreeMemory( VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* pAllocator ) {
+	CheckObject( device, OBJECT_DEVICE, "vkFreeMemory" );
+	UntrackObject( memory, OBJECT_MEMORY, "vkFreeMemory" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkFreeMemory( device, memory, pAllocator );
+	}
+}
+
+/*
+========================
+StandInMapMemory
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInMapMemory( VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** ppData ) {
+	CheckObject( device, OBJECT_DEVICE, "vkMapMemory" );
+	object_t* memoryObject = LookupObject( memory, OBJECT_MEMORY, "vkMapMemory" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkMapMemory( device, memory, offset, size, flags, ppData );
+	}
+
+	if ( !memoryObject ) {
+		return VK_ERROR_MEMORY_MAP_FAILED;
+	}
+
+	// device local memory is never touched, so it's only real once something wants to write to it
+	if ( !memoryObject->mData ) {
+		memoryObject->mData = reinterpret_cast<u8*>( malloc( static_cast<size_t>( memoryObject->mSize ) ) );
+
+		if ( !memoryObject->mData ) {
+			return VK_ERROR_MEMORY_MAP_FAILED;
+		}
+	}
+
+	*ppData = memoryObject->mData + offset;
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInUnmapMemory
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInUnmapMemory( VkDevice device, VkDeviceMemory memory ) {
+	CheckObject( device, OBJECT_DEVICE, "vkUnmapMemory" );
+
+	// kept until it's freed, the next map gets the same contents back
+	CheckObject( memory, OBJECT_MEMORY, "vkUnmapMemory" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkUnmapMemory( device, memory );
+	}
+}
+
+/*
+========================
+StandInFlushMappedMemoryRanges
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInFlushMappedMemoryRanges( VkDevice device, uint32_t memoryRangeCount, const VkMappedMemoryRange* pMemoryRanges ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkFlushMappedMemoryRanges" );
+
+		for ( u32 i = 0; i < memoryRangeCount; i++ ) {
+			const VkMappedMemoryRange& range = pMemoryRanges[i];
+
+			object_t* memory = LookupObjectLocked( HandleKey( range.memory ), OBJECT_MEMORY, "vkFlushMappedMemoryRanges" );
+			if ( memory ) {
+				gStandIn.mStats.mBytesFlushed += ( range.size == VK_WHOLE_SIZE ) ? memory->mSize - range.offset : range.size;
+			}
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkFlushMappedMemoryRanges( device, memoryRangeCount, pMemoryRanges ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInInvalidateMappedMemoryRanges
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInInvalidateMappedMemoryRanges( VkDevice device, uint32_t memoryRangeCount, const VkMappedMemoryRange* pMemoryRanges ) {
+	CheckObject( device, OBJECT_DEVICE, "vkInvalidateMappedMemoryRanges" );
+
+	for ( u32 i = 0; i < memoryRangeCount; i++ ) {
+		CheckObject( pMemoryRanges[i].memory, OBJECT_MEMORY, "vkInvalidateMappedMemoryRanges" );
+	}
+
+	// without a driver nothing on the GPU side ever writes to it, so there's nothing to see
+	return gStandIn.mReplay ? gStandIn.mDriver->vkInvalidateMappedMemoryRanges( device, memoryRangeCount, pMemoryRanges ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInCreateBuffer
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateBuffer( VkDevice device, const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkBuffer* pBuffer ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateBuffer" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateBuffer( device, pCreateInfo, pAllocator, pBuffer ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		object_t* buffer = TrackObject( OBJECT_BUFFER, *pBuffer, 0 );
+		buffer->mSize = pCreateInfo->size;
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInGetBufferMemoryRequirements
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetBufferMemoryRequirements( VkDevice device, VkBuffer buffer, VkMemoryRequirements* pMemoryRequirements ) {
+	CheckObject( device, OBJECT_DEVICE, "vkGetBufferMemoryRequirements" );
+	object_t* bufferObject = LookupObject( buffer, OBJECT_BUFFER, "vkGetBufferMemoryRequirements" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetBufferMemoryRequirements( device, buffer, pMemoryRequirements );
+		return;
+	}
+
+	VkDeviceSize size = bufferObject ? bufferObject->mSize : 0;
+
+	pMemoryRequirements->size = ( size + NULL_ALIGNMENT - 1 ) & ~( NULL_ALIGNMENT - 1 );
+	pMemoryRequirements->alignment = NULL_ALIGNMENT;
+	pMemoryRequirements->memoryTypeBits = 1;
+}
+
+/*
+========================
+StandInBindBufferMemory
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInBindBufferMemory( VkDevice device, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset ) {
+	CheckObject( device, OBJECT_DEVICE, "vkBindBufferMemory" );
+	CheckObject( buffer, OBJECT_BUFFER, "vkBindBufferMemory" );
+	CheckObject( memory, OBJECT_MEMORY, "vkBindBufferMemory" );
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkBindBufferMemory( device, buffer, memory, memoryOffset ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInCreateImage
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateImage( VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateImage" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateImage( device, pCreateInfo, pAllocator, pImage ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		object_t* image = TrackObject( OBJECT_IMAGE, *pImage, 0 );
+		image->mFormat = pCreateInfo->format;
+		image->mExtent = pCreateInfo->extent;
+		image->mNumLayers = pCreateInfo->arrayLayers;
+
+		// mips add up to a third on top of the top level
+		image->mSize = static_cast<VkDeviceSize>( pCreateInfo->extent.width ) * pCreateInfo->extent.height * pCreateInfo->extent.depth * pCreateInfo->arrayLayers * GetFormatBytes( pCreateInfo->format );
+		if ( pCreateInfo->mipLevels > 1 ) {
+			image->mSize += image->mSize / 3;
+		}
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInGetImageMemoryRequirements
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInGetImageMemoryRequirements( VkDevice device, VkImage image, VkMemoryRequirements* pMemoryRequirements ) {
+	CheckObject( device, OBJECT_DEVICE, "vkGetImageMemoryRequirements" );
+	object_t* imageObject = LookupObject( image, OBJECT_IMAGE, "vkGetImageMemoryRequirements" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkGetImageMemoryRequirements( device, image, pMemoryRequirements );
+		return;
+	}
+
+	VkDeviceSize size = imageObject ? imageObject->mSize : 0;
+
+	pMemoryRequirements->size = ( size + NULL_ALIGNMENT - 1 ) & ~( NULL_ALIGNMENT - 1 );
+	pMemoryRequirements->alignment = NULL_ALIGNMENT;
+	pMemoryRequirements->memoryTypeBits = 1;
+}
+
+/*
+========================
+StandInBindImageMemory
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInBindImageMemory( VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset ) {
+	CheckObject( device, OBJECT_DEVICE, "vkBindImageMemory" );
+	CheckObject( image, OBJECT_IMAGE, "vkBindImageMemory" );
+	CheckObject( memory, OBJECT_MEMORY, "vkBindImageMemory" );
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkBindImageMemory( device, image, memory, memoryOffset ) : VK_SUCCESS;
+}
+
+// everything there's nothing more to than it being alive
+#define YETI_STAND_IN_CREATE_FUNCTION( name, createInfo_t, handle_t, objectType )																	\
+static VKAPI_ATTR VkResult VKAPI_CALL StandIn##name( VkDevice device, const createInfo_t* pCreateInfo, const VkAllocationCallbacks* pAllocator, handle_t* pHandle ) {	\
+	CheckObject( device, OBJECT_DEVICE, "vk"#name );																								\
+																																					\
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vk##name( device, pCreateInfo, pAllocator, pHandle ) : VK_SUCCESS;						\
+	if ( result == VK_SUCCESS ) {																													\
+		TrackObject( objectType, *pHandle, 0 );																										\
+	}																																				\
+																																					\
+	return result;																																	\
+}
+
+// pools take whatever was allocated from them along too
+#define YETI_STAND_IN_DESTROY_FUNCTION( name, handle_t, objectType )																				\
+static VKAPI_ATTR void VKAPI_CALL StandIn##name( VkDevice device, handle_t handle, const VkAllocationCallbacks* pAllocator ) {						\
+	CheckObject( device, OBJECT_DEVICE, "vk"#name );																								\
+	UntrackObject( handle, objectType, "vk"#name );																									\
+																																					\
+	if ( gStandIn.mReplay ) {																														\
+		gStandIn.mDriver->vk##name( device, handle, pAllocator );																					\
+	}																																				\
+}
+
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyBuffer, VkBuffer, OBJECT_BUFFER )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyImage, VkImage, OBJECT_IMAGE )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateImageView, VkImageViewCreateInfo, VkImageView, OBJECT_IMAGE_VIEW )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyImageView, VkImageView, OBJECT_IMAGE_VIEW )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateSampler, VkSamplerCreateInfo, VkSampler, OBJECT_SAMPLER )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroySampler, VkSampler, OBJECT_SAMPLER )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateShaderModule, VkShaderModuleCreateInfo, VkShaderModule, OBJECT_SHADER_MODULE )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyShaderModule, VkShaderModule, OBJECT_SHADER_MODULE )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateRenderPass, VkRenderPassCreateInfo, VkRenderPass, OBJECT_RENDER_PASS )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyRenderPass, VkRenderPass, OBJECT_RENDER_PASS )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateFramebuffer, VkFramebufferCreateInfo, VkFramebuffer, OBJECT_FRAMEBUFFER )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyFramebuffer, VkFramebuffer, OBJECT_FRAMEBUFFER )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateDescriptorSetLayout, VkDescriptorSetLayoutCreateInfo, VkDescriptorSetLayout, OBJECT_DESCRIPTOR_SET_LAYOUT )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyDescriptorSetLayout, VkDescriptorSetLayout, OBJECT_DESCRIPTOR_SET_LAYOUT )
+
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyDescriptorPool, VkDescriptorPool, OBJECT_DESCRIPTOR_POOL )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreatePipelineLayout, VkPipelineLayoutCreateInfo, VkPipelineLayout, OBJECT_PIPELINE_LAYOUT )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyPipelineLayout, VkPipelineLayout, OBJECT_PIPELINE_LAYOUT )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreatePipelineCache, VkPipelineCacheCreateInfo, VkPipelineCache, OBJECT_PIPELINE_CACHE )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyPipelineCache, VkPipelineCache, OBJECT_PIPELINE_CACHE )
+
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyPipeline, VkPipeline, OBJECT_PIPELINE )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateCommandPool, VkCommandPoolCreateInfo, VkCommandPool, OBJECT_COMMAND_POOL )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyCommandPool, VkCommandPool, OBJECT_COMMAND_POOL )
+
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyFence, VkFence, OBJECT_FENCE )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateSemaphore, VkSemaphoreCreateInfo, VkSemaphore, OBJECT_SEMAPHORE )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroySemaphore, VkSemaphore, OBJECT_SEMAPHORE )
+
+YETI_STAND_IN_CREATE_FUNCTION( CreateQueryPool, VkQueryPoolCreateInfo, VkQueryPool, OBJECT_QUERY_POOL )
+YETI_STAND_IN_DESTROY_FUNCTION( DestroyQueryPool, VkQueryPool, OBJECT_QUERY_POOL )
+
+/*
+========================
+StandInCreateDescriptorPool
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateDescriptorPool( VkDevice device, const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateDescriptorPool" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateDescriptorPool( device, pCreateInfo, pAllocator, pDescriptorPool ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		object_t* object = TrackObject( OBJECT_DESCRIPTOR_POOL, *pDescriptorPool, 0 );
+		object->mMaxSets = pCreateInfo->maxSets;
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInResetDescriptorPool
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInResetDescriptorPool( VkDevice device, VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkResetDescriptorPool" );
+
+		// every set from it is gone
+		object_t* pool = LookupObjectLocked( HandleKey( descriptorPool ), OBJECT_DESCRIPTOR_POOL, "vkResetDescriptorPool" );
+		while ( pool && pool->mFirstChild ) {
+			DeleteObjectLocked( pool->mFirstChild );
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkResetDescriptorPool( device, descriptorPool, flags ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInAllocateDescriptorSets
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInAllocateDescriptorSets( VkDevice device, const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets ) {
+	CheckObject( device, OBJECT_DEVICE, "vkAllocateDescriptorSets" );
+	CheckObject( pAllocateInfo->descriptorPool, OBJECT_DESCRIPTOR_POOL, "vkAllocateDescriptorSets" );
+
+	for ( u32 i = 0; i < pAllocateInfo->descriptorSetCount; i++ ) {
+		CheckObject( pAllocateInfo->pSetLayouts[i], OBJECT_DESCRIPTOR_SET_LAYOUT, "vkAllocateDescriptorSets" );
+	}
+
+	VkResult result = VK_SUCCESS;
+
+	if ( gStandIn.mReplay ) {
+		result = gStandIn.mDriver->vkAllocateDescriptorSets( device, pAllocateInfo, pDescriptorSets );
+	} else {
+		// only maxSets runs out, there are always enough descriptors of every type
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		object_t* pool = FindObjectLocked( HandleKey( pAllocateInfo->descriptorPool ) );
+		if ( pool ) {
+			u32 numSets = 0;
+			for ( object_t* set = pool->mFirstChild; set; set = set->mNext ) {
+				numSets++;
+			}
+
+			if ( numSets + pAllocateInfo->descriptorSetCount > pool->mMaxSets ) {
+				result = VK_ERROR_FRAGMENTED_POOL;
+			}
+		}
+	}
+
+	if ( result == VK_SUCCESS ) {
+		for ( u32 i = 0; i < pAllocateInfo->descriptorSetCount; i++ ) {
+			TrackObject( OBJECT_DESCRIPTOR_SET, pDescriptorSets[i], HandleKey( pAllocateInfo->descriptorPool ) );
+		}
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInUpdateDescriptorSets
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInUpdateDescriptorSets( VkDevice device, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkUpdateDescriptorSets" );
+
+		for ( u32 i = 0; i < descriptorWriteCount; i++ ) {
+			const VkWriteDescriptorSet& write = pDescriptorWrites[i];
+
+			LookupObjectLocked( HandleKey( write.dstSet ), OBJECT_DESCRIPTOR_SET, "vkUpdateDescriptorSets" );
+
+			// null descriptors are fine in partially bound arrays, so only what's there gets checked
+			for ( u32 j = 0; j < write.descriptorCount; j++ ) {
+				if ( write.pBufferInfo && write.pBufferInfo[j].buffer != VK_NULL_HANDLE ) {
+					LookupObjectLocked( HandleKey( write.pBufferInfo[j].buffer ), OBJECT_BUFFER, "vkUpdateDescriptorSets" );
+				}
+
+				if ( write.pImageInfo && write.pImageInfo[j].imageView != VK_NULL_HANDLE ) {
+					LookupObjectLocked( HandleKey( write.pImageInfo[j].imageView ), OBJECT_IMAGE_VIEW, "vkUpdateDescriptorSets" );
+				}
+			}
+
+			gStandIn.mStats.mDescriptorWrites += write.descriptorCount;
+		}
+
+		for ( u32 i = 0; i < descriptorCopyCount; i++ ) {
+			const VkCopyDescriptorSet& copy = pDescriptorCopies[i];
+
+			LookupObjectLocked( HandleKey( copy.srcSet ), OBJECT_DESCRIPTOR_SET, "vkUpdateDescriptorSets" );
+			LookupObjectLocked( HandleKey( copy.dstSet ), OBJECT_DESCRIPTOR_SET, "vkUpdateDescriptorSets" );
+
+			gStandIn.mStats.mDescriptorWrites += copy.descriptorCount;
+		}
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkUpdateDescriptorSets( device, descriptorWriteCount, pDescriptorWrites, descriptorCopyCount, pDescriptorCopies );
+	}
+}
+
+/*
+========================
+StandInGetPipelineCacheData
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetPipelineCacheData( VkDevice device, VkPipelineCache pipelineCache, size_t* pDataSize, void* pData ) {
+	CheckObject( device, OBJECT_DEVICE, "vkGetPipelineCacheData" );
+	CheckObject( pipelineCache, OBJECT_PIPELINE_CACHE, "vkGetPipelineCacheData" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetPipelineCacheData( device, pipelineCache, pDataSize, pData );
+	}
+
+	// nothing was compiled, so there's nothing worth saving
+	*pDataSize = 0;
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInCreateGraphicsPipelines
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateGraphicsPipelines( VkDevice device, VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateGraphicsPipelines" );
+	CheckObject( pipelineCache, OBJECT_PIPELINE_CACHE, "vkCreateGraphicsPipelines" );
+
+	for ( u32 i = 0; i < createInfoCount; i++ ) {
+		const VkGraphicsPipelineCreateInfo& createInfo = pCreateInfos[i];
+
+		CheckObject( createInfo.layout, OBJECT_PIPELINE_LAYOUT, "vkCreateGraphicsPipelines" );
+		CheckObject( createInfo.renderPass, OBJECT_RENDER_PASS, "vkCreateGraphicsPipelines" );
+
+		for ( u32 j = 0; j < createInfo.stageCount; j++ ) {
+			CheckObject( createInfo.pStages[j].module, OBJECT_SHADER_MODULE, "vkCreateGraphicsPipelines" );
+		}
+	}
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateGraphicsPipelines( device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		for ( u32 i = 0; i < createInfoCount; i++ ) {
+			TrackObject( OBJECT_PIPELINE, pPipelines[i], 0 );
+		}
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInResetCommandPool
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInResetCommandPool( VkDevice device, VkCommandPool commandPool, VkCommandPoolResetFlags flags ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkResetCommandPool" );
+
+		// anything recorded and not submitted yet never happened
+		object_t* pool = LookupObjectLocked( HandleKey( commandPool ), OBJECT_COMMAND_POOL, "vkResetCommandPool" );
+		for ( object_t* commandBuffer = pool ? pool->mFirstChild : nullptr; commandBuffer; commandBuffer = commandBuffer->mNext ) {
+			commandBuffer->mState = COMMAND_BUFFER_STATE_INITIAL;
+			commandBuffer->mCounters = {};
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkResetCommandPool( device, commandPool, flags ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInAllocateCommandBuffers
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInAllocateCommandBuffers( VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers ) {
+	CheckObject( device, OBJECT_DEVICE, "vkAllocateCommandBuffers" );
+	CheckObject( pAllocateInfo->commandPool, OBJECT_COMMAND_POOL, "vkAllocateCommandBuffers" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkAllocateCommandBuffers( device, pAllocateInfo, pCommandBuffers ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		for ( u32 i = 0; i < pAllocateInfo->commandBufferCount; i++ ) {
+			TrackObject( OBJECT_COMMAND_BUFFER, pCommandBuffers[i], HandleKey( pAllocateInfo->commandPool ) );
+		}
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInFreeCommandBuffers
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInFreeCommandBuffers( VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers ) {
+	CheckObject( device, OBJECT_DEVICE, "vkFreeCommandBuffers" );
+	CheckObject( commandPool, OBJECT_COMMAND_POOL, "vkFreeCommandBuffers" );
+
+	for ( u32 i = 0; i < commandBufferCount; i++ ) {
+		UntrackObject( pCommandBuffers[i], OBJECT_COMMAND_BUFFER, "vkFreeCommandBuffers" );
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkFreeCommandBuffers( device, commandPool, commandBufferCount, pCommandBuffers );
+	}
+}
+
+/*
+========================
+StandInBeginCommandBuffer
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInBeginCommandBuffer( VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo* pBeginInfo ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		object_t* object = LookupObjectLocked( HandleKey( commandBuffer ), OBJECT_COMMAND_BUFFER, "vkBeginCommandBuffer" );
+		if ( object ) {
+			if ( object->mState == COMMAND_BUFFER_STATE_RECORDING ) {
+				error( "Vulkan stand-in: vkBeginCommandBuffer() was called on a command buffer that's already recording!\n" );
+				gStandIn.mStats.mValidationErrors++;
+			}
+
+			// beginning again throws away whatever was recorded before
+			object->mState = COMMAND_BUFFER_STATE_RECORDING;
+			object->mCounters = {};
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkBeginCommandBuffer( commandBuffer, pBeginInfo ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInEndCommandBuffer
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInEndCommandBuffer( VkCommandBuffer commandBuffer ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		object_t* object = LookupObjectLocked( HandleKey( commandBuffer ), OBJECT_COMMAND_BUFFER, "vkEndCommandBuffer" );
+		if ( object ) {
+			if ( object->mState != COMMAND_BUFFER_STATE_RECORDING ) {
+				error( "Vulkan stand-in: vkEndCommandBuffer() was called on a command buffer that isn't recording!\n" );
+				gStandIn.mStats.mValidationErrors++;
+			}
+
+			object->mState = COMMAND_BUFFER_STATE_EXECUTABLE;
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkEndCommandBuffer( commandBuffer ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInCreateFence
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateFence( VkDevice device, const VkFenceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkFence* pFence ) {
+	CheckObject( device, OBJECT_DEVICE, "vkCreateFence" );
+
+	VkResult result = gStandIn.mReplay ? gStandIn.mDriver->vkCreateFence( device, pCreateInfo, pAllocator, pFence ) : VK_SUCCESS;
+	if ( result == VK_SUCCESS ) {
+		object_t* fence = TrackObject( OBJECT_FENCE, *pFence, 0 );
+		fence->mSignalled = ( pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT ) != 0;
+	}
+
+	return result;
+}
+
+/*
+========================
+StandInResetFences
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInResetFences( VkDevice device, uint32_t fenceCount, const VkFence* pFences ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkResetFences" );
+
+		for ( u32 i = 0; i < fenceCount; i++ ) {
+			object_t* fence = LookupObjectLocked( HandleKey( pFences[i] ), OBJECT_FENCE, "vkResetFences" );
+			if ( fence ) {
+				fence->mSignalled = false;
+			}
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkResetFences( device, fenceCount, pFences ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInWaitForFences
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInWaitForFences( VkDevice device, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout ) {
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkWaitForFences" );
+
+		for ( u32 i = 0; i < fenceCount; i++ ) {
+			object_t* fence = LookupObjectLocked( HandleKey( pFences[i] ), OBJECT_FENCE, "vkWaitForFences" );
+
+			// submitting is the only thing that signals them without a driver, so this would be a hang with one
+			if ( fence && !fence->mSignalled && !gStandIn.mReplay ) {
+				error( "Vulkan stand-in: vkWaitForFences() is waiting on a fence nothing is going to signal!\n" );
+				gStandIn.mStats.mValidationErrors++;
+			}
+		}
+	}
+
+	return gStandIn.mReplay ? gStandIn.mDriver->vkWaitForFences( device, fenceCount, pFences, waitAll, timeout ) : VK_SUCCESS;
+}
+
+/*
+========================
+StandInGetQueryPoolResults
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInGetQueryPoolResults( VkDevice device, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* pData, VkDeviceSize stride, VkQueryResultFlags flags ) {
+	CheckObject( device, OBJECT_DEVICE, "vkGetQueryPoolResults" );
+	CheckObject( queryPool, OBJECT_QUERY_POOL, "vkGetQueryPoolResults" );
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetQueryPoolResults( device, queryPool, firstQuery, queryCount, dataSize, pData, stride, flags );
+	}
+
+	// no time passes on the stand-in GPU
+	memset( pData, 0, dataSize );
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInCmdBeginRenderPass
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdBeginRenderPass( VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo* pRenderPassBegin, VkSubpassContents contents ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdBeginRenderPass" );
+	CheckObject( pRenderPassBegin->renderPass, OBJECT_RENDER_PASS, "vkCmdBeginRenderPass" );
+	CheckObject( pRenderPassBegin->framebuffer, OBJECT_FRAMEBUFFER, "vkCmdBeginRenderPass" );
+
+	if ( object ) {
+		object->mCounters.mRenderPasses++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdBeginRenderPass( commandBuffer, pRenderPassBegin, contents );
+	}
+}
+
+/*
+========================
+StandInCmdEndRenderPass
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdEndRenderPass( VkCommandBuffer commandBuffer ) {
+	RecordCommand( commandBuffer, "vkCmdEndRenderPass" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdEndRenderPass( commandBuffer );
+	}
+}
+
+/*
+========================
+StandInCmdExecuteCommands
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdExecuteCommands( VkCommandBuffer commandBuffer, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdExecuteCommands" );
+
+	{
+		std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+		// the secondaries' commands become the primary's, and get counted when it's submitted
+		for ( u32 i = 0; i < commandBufferCount; i++ ) {
+			object_t* secondary = LookupObjectLocked( HandleKey( pCommandBuffers[i] ), OBJECT_COMMAND_BUFFER, "vkCmdExecuteCommands" );
+			if ( !secondary ) {
+				continue;
+			}
+
+			if ( secondary->mState != COMMAND_BUFFER_STATE_EXECUTABLE ) {
+				error( "Vulkan stand-in: vkCmdExecuteCommands() was given a secondary command buffer that hasn't been ended!\n" );
+				gStandIn.mStats.mValidationErrors++;
+				continue;
+			}
+
+			if ( object ) {
+				AddStats( object->mCounters, secondary->mCounters );
+			}
+		}
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdExecuteCommands( commandBuffer, commandBufferCount, pCommandBuffers );
+	}
+}
+
+/*
+========================
+StandInCmdBindPipeline
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdBindPipeline( VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdBindPipeline" );
+	LookupObject( pipeline, OBJECT_PIPELINE, "vkCmdBindPipeline" );
+
+	if ( object ) {
+		object->mCounters.mPipelineBinds++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdBindPipeline( commandBuffer, pipelineBindPoint, pipeline );
+	}
+}
+
+/*
+========================
+StandInCmdBindDescriptorSets
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdBindDescriptorSets( VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdBindDescriptorSets" );
+	LookupObject( layout, OBJECT_PIPELINE_LAYOUT, "vkCmdBindDescriptorSets" );
+
+	for ( u32 i = 0; i < descriptorSetCount; i++ ) {
+		LookupObject( pDescriptorSets[i], OBJECT_DESCRIPTOR_SET, "vkCmdBindDescriptorSets" );
+	}
+
+	if ( object ) {
+		object->mCounters.mDescriptorSetBinds++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdBindDescriptorSets( commandBuffer, pipelineBindPoint, layout, firstSet, descriptorSetCount, pDescriptorSets, dynamicOffsetCount, pDynamicOffsets );
+	}
+}
+
+/*
+========================
+StandInCmdBindVertexBuffers
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdBindVertexBuffers( VkCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdBindVertexBuffers" );
+
+	for ( u32 i = 0; i < bindingCount; i++ ) {
+		LookupObject( pBuffers[i], OBJECT_BUFFER, "vkCmdBindVertexBuffers" );
+	}
+
+	if ( object ) {
+		object->mCounters.mBufferBinds++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdBindVertexBuffers( commandBuffer, firstBinding, bindingCount, pBuffers, pOffsets );
+	}
+}
+
+/*
+========================
+StandInCmdBindIndexBuffer
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdBindIndexBuffer( VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdBindIndexBuffer" );
+	LookupObject( buffer, OBJECT_BUFFER, "vkCmdBindIndexBuffer" );
+
+	if ( object ) {
+		object->mCounters.mBufferBinds++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdBindIndexBuffer( commandBuffer, buffer, offset, indexType );
+	}
+}
+
+/*
+========================
+StandInCmdPushConstants
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdPushConstants( VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdPushConstants" );
+	LookupObject( layout, OBJECT_PIPELINE_LAYOUT, "vkCmdPushConstants" );
+
+	if ( object ) {
+		object->mCounters.mPushConstants++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdPushConstants( commandBuffer, layout, stageFlags, offset, size, pValues );
+	}
+}
+
+/*
+========================
+StandInCmdSetViewport
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdSetViewport( VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports ) {
+	RecordCommand( commandBuffer, "vkCmdSetViewport" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdSetViewport( commandBuffer, firstViewport, viewportCount, pViewports );
+	}
+}
+
+/*
+========================
+StandInCmdSetScissor
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdSetScissor( VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors ) {
+	RecordCommand( commandBuffer, "vkCmdSetScissor" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdSetScissor( commandBuffer, firstScissor, scissorCount, pScissors );
+	}
+}
+
+/*
+========================
+StandInCmdDraw
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdDraw( VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdDraw" );
+
+	if ( object ) {
+		object->mCounters.mDraws++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdDraw( commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance );
+	}
+}
+
+/*
+========================
+StandInCmdDrawIndexed
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdDrawIndexed( VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdDrawIndexed" );
+
+	if ( object ) {
+		object->mCounters.mDraws++;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdDrawIndexed( commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance );
+	}
+}
+
+/*
+========================
+StandInCmdPipelineBarrier
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdPipelineBarrier( VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags,
+	uint32_t memoryBarrierCount, const VkMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+	uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier* pImageMemoryBarriers ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdPipelineBarrier" );
+
+	for ( u32 i = 0; i < bufferMemoryBarrierCount; i++ ) {
+		LookupObject( pBufferMemoryBarriers[i].buffer, OBJECT_BUFFER, "vkCmdPipelineBarrier" );
+	}
+
+	for ( u32 i = 0; i < imageMemoryBarrierCount; i++ ) {
+		LookupObject( pImageMemoryBarriers[i].image, OBJECT_IMAGE, "vkCmdPipelineBarrier" );
+	}
+
+	if ( object ) {
+		object->mCounters.mBarriers++;
+		object->mCounters.mImageBarriers += imageMemoryBarrierCount;
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdPipelineBarrier( commandBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, pMemoryBarriers,
+			bufferMemoryBarrierCount, pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers );
+	}
+}
+
+/*
+========================
+StandInCmdCopyBuffer
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdCopyBuffer( VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdCopyBuffer" );
+	LookupObject( srcBuffer, OBJECT_BUFFER, "vkCmdCopyBuffer" );
+	LookupObject( dstBuffer, OBJECT_BUFFER, "vkCmdCopyBuffer" );
+
+	if ( object ) {
+		for ( u32 i = 0; i < regionCount; i++ ) {
+			object->mCounters.mBytesCopied += pRegions[i].size;
+		}
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdCopyBuffer( commandBuffer, srcBuffer, dstBuffer, regionCount, pRegions );
+	}
+}
+
+/*
+========================
+StandInCmdCopyBufferToImage
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdCopyBufferToImage( VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkBufferImageCopy* pRegions ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdCopyBufferToImage" );
+	LookupObject( srcBuffer, OBJECT_BUFFER, "vkCmdCopyBufferToImage" );
+	object_t* image = LookupObject( dstImage, OBJECT_IMAGE, "vkCmdCopyBufferToImage" );
+
+	if ( object && image ) {
+		u32 texelBytes = GetFormatBytes( image->mFormat );
+
+		for ( u32 i = 0; i < regionCount; i++ ) {
+			const VkBufferImageCopy& region = pRegions[i];
+			object->mCounters.mBytesCopied += static_cast<u64>( region.imageExtent.width ) * region.imageExtent.height * region.imageExtent.depth * region.imageSubresource.layerCount * texelBytes;
+		}
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdCopyBufferToImage( commandBuffer, srcBuffer, dstImage, dstImageLayout, regionCount, pRegions );
+	}
+}
+
+/*
+========================
+StandInCmdCopyImageToBuffer
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdCopyImageToBuffer( VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout srcImageLayout, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferImageCopy* pRegions ) {
+	object_t* object = RecordCommand( commandBuffer, "vkCmdCopyImageToBuffer" );
+	object_t* image = LookupObject( srcImage, OBJECT_IMAGE, "vkCmdCopyImageToBuffer" );
+	LookupObject( dstBuffer, OBJECT_BUFFER, "vkCmdCopyImageToBuffer" );
+
+	if ( object && image ) {
+		u32 texelBytes = GetFormatBytes( image->mFormat );
+
+		for ( u32 i = 0; i < regionCount; i++ ) {
+			const VkBufferImageCopy& region = pRegions[i];
+			object->mCounters.mBytesCopied += static_cast<u64>( region.imageExtent.width ) * region.imageExtent.height * region.imageExtent.depth * region.imageSubresource.layerCount * texelBytes;
+		}
+	}
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdCopyImageToBuffer( commandBuffer, srcImage, srcImageLayout, dstBuffer, regionCount, pRegions );
+	}
+}
+
+/*
+========================
+StandInCmdResetQueryPool
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdResetQueryPool( VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount ) {
+	RecordCommand( commandBuffer, "vkCmdResetQueryPool" );
+	LookupObject( queryPool, OBJECT_QUERY_POOL, "vkCmdResetQueryPool" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdResetQueryPool( commandBuffer, queryPool, firstQuery, queryCount );
+	}
+}
+
+/*
+========================
+StandInCmdWriteTimestamp
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInCmdWriteTimestamp( VkCommandBuffer commandBuffer, VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t query ) {
+	RecordCommand( commandBuffer, "vkCmdWriteTimestamp" );
+	LookupObject( queryPool, OBJECT_QUERY_POOL, "vkCmdWriteTimestamp" );
+
+	if ( gStandIn.mReplay ) {
+		gStandIn.mDriver->vkCmdWriteTimestamp( commandBuffer, pipelineStage, queryPool, query );
+	}
+}
+
+/*
+========================
+StandInCreateDebugReportCallbackEXT
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateDebugReportCallbackEXT( VkInstance instance, const VkDebugReportCallbackCreateInfoEXT*, const VkAllocationCallbacks*, VkDebugReportCallbackEXT* pCallback ) {
+	// only handed out without a driver, there's nothing to report so the callback is never called
+	CheckObject( instance, OBJECT_INSTANCE, "vkCreateDebugReportCallbackEXT" );
+	TrackObject( OBJECT_DEBUG_CALLBACK, *pCallback, 0 );
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInDestroyDebugReportCallbackEXT
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroyDebugReportCallbackEXT( VkInstance instance, VkDebugReportCallbackEXT callback, const VkAllocationCallbacks* ) {
+	CheckObject( instance, OBJECT_INSTANCE, "vkDestroyDebugReportCallbackEXT" );
+	UntrackObject( callback, OBJECT_DEBUG_CALLBACK, "vkDestroyDebugReportCallbackEXT" );
+}
+
+#ifdef VK_KHR_descriptor_update_template
+/*
+========================
+StandInCreateDescriptorUpdateTemplateKHR
+========================
+*/
+static VKAPI_ATTR VkResult VKAPI_CALL StandInCreateDescriptorUpdateTemplateKHR( VkDevice device, const VkDescriptorUpdateTemplateCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks*, VkDescriptorUpdateTemplateKHR* pDescriptorUpdateTemplate ) {
+	// only handed out without a driver, like the debug report callback
+	CheckObject( device, OBJECT_DEVICE, "vkCreateDescriptorUpdateTemplateKHR" );
+	CheckObject( pCreateInfo->descriptorSetLayout, OBJECT_DESCRIPTOR_SET_LAYOUT, "vkCreateDescriptorUpdateTemplateKHR" );
+
+	object_t* object = TrackObject( OBJECT_DESCRIPTOR_UPDATE_TEMPLATE, *pDescriptorUpdateTemplate, 0 );
+
+	object->mNumDescriptors = 0;
+	for ( u32 i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++ ) {
+		object->mNumDescriptors += pCreateInfo->pDescriptorUpdateEntries[i].descriptorCount;
+	}
+
+	return VK_SUCCESS;
+}
+
+/*
+========================
+StandInDestroyDescriptorUpdateTemplateKHR
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInDestroyDescriptorUpdateTemplateKHR( VkDevice device, VkDescriptorUpdateTemplateKHR descriptorUpdateTemplate, const VkAllocationCallbacks* ) {
+	CheckObject( device, OBJECT_DEVICE, "vkDestroyDescriptorUpdateTemplateKHR" );
+	UntrackObject( descriptorUpdateTemplate, OBJECT_DESCRIPTOR_UPDATE_TEMPLATE, "vkDestroyDescriptorUpdateTemplateKHR" );
+}
+
+/*
+========================
+StandInUpdateDescriptorSetWithTemplateKHR
+========================
+*/
+static VKAPI_ATTR void VKAPI_CALL StandInUpdateDescriptorSetWithTemplateKHR( VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplateKHR descriptorUpdateTemplate, const void* ) {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	LookupObjectLocked( HandleKey( device ), OBJECT_DEVICE, "vkUpdateDescriptorSetWithTemplateKHR" );
+	LookupObjectLocked( HandleKey( descriptorSet ), OBJECT_DESCRIPTOR_SET, "vkUpdateDescriptorSetWithTemplateKHR" );
+
+	// the data isn't looked at, only vkUpdateDescriptorSets() has its handles checked
+	object_t* object = LookupObjectLocked( HandleKey( descriptorUpdateTemplate ), OBJECT_DESCRIPTOR_UPDATE_TEMPLATE, "vkUpdateDescriptorSetWithTemplateKHR" );
+	if ( object ) {
+		gStandIn.mStats.mDescriptorWrites += object->mNumDescriptors;
+	}
+}
+#endif
+
+/*
+========================
+FindStandInFunction
+========================
+*/
+static PFN_vkVoidFunction FindStandInFunction( const char* name ) {
+#define YETI_STAND_IN_FIND_FUNCTION( function )											\
+	if ( strcmp( name, #function ) == 0 ) {												\
+		return reinterpret_cast<PFN_vkVoidFunction>( gStandIn.mFunctions.function );	\
+	}
+	YETI_VK_FUNCTIONS( YETI_STAND_IN_FIND_FUNCTION )
+#undef YETI_STAND_IN_FIND_FUNCTION
+
+	return nullptr;
+}
+
+/*
+========================
+StandInGetInstanceProcAddr
+========================
+*/
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL StandInGetInstanceProcAddr( VkInstance instance, const char* pName ) {
+	PFN_vkVoidFunction function = FindStandInFunction( pName );
+	if ( function ) {
+		return function;
+	}
+
+	// before the instance there's no telling yet whether it'll replay, so anything the driver has is used
+	if ( gStandIn.mWantsReplay && gStandIn.mDriver->vkGetInstanceProcAddr ) {
+		return gStandIn.mDriver->vkGetInstanceProcAddr( instance, pName );
+	}
+
+	if ( strcmp( pName, "vkCreateDebugReportCallbackEXT" ) == 0 ) {
+		return reinterpret_cast<PFN_vkVoidFunction>( StandInCreateDebugReportCallbackEXT );
+	}
+
+	if ( strcmp( pName, "vkDestroyDebugReportCallbackEXT" ) == 0 ) {
+		return reinterpret_cast<PFN_vkVoidFunction>( StandInDestroyDebugReportCallbackEXT );
+	}
+
+	return nullptr;
+}
+
+/*
+========================
+StandInGetDeviceProcAddr
+========================
+*/
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL StandInGetDeviceProcAddr( VkDevice device, const char* pName ) {
+	PFN_vkVoidFunction function = FindStandInFunction( pName );
+	if ( function ) {
+		return function;
+	}
+
+	if ( gStandIn.mReplay ) {
+		return gStandIn.mDriver->vkGetDeviceProcAddr( device, pName );
+	}
+
+	// the only extension advertised without a driver past the swap chain
+#ifdef VK_KHR_descriptor_update_template
+	if ( strcmp( pName, "vkCreateDescriptorUpdateTemplateKHR" ) == 0 ) {
+		return reinterpret_cast<PFN_vkVoidFunction>( StandInCreateDescriptorUpdateTemplateKHR );
+	}
+
+	if ( strcmp( pName, "vkDestroyDescriptorUpdateTemplateKHR" ) == 0 ) {
+		return reinterpret_cast<PFN_vkVoidFunction>( StandInDestroyDescriptorUpdateTemplateKHR );
+	}
+
+	if ( strcmp( pName, "vkUpdateDescriptorSetWithTemplateKHR" ) == 0 ) {
+		return reinterpret_cast<PFN_vkVoidFunction>( StandInUpdateDescriptorSetWithTemplateKHR );
+	}
+#endif
+
+	return nullptr;
+}
+
+/*
+================================================================================================
+
+	VulkanStandIn
+
+================================================================================================
+*/
+
+/*
+========================
+VulkanStandIn::Install
+========================
+*/
+void VulkanStandIn::Install( const bool32 replay ) {
+	if ( gStandIn.mInstalled ) {
+		error( "Attempt to call VulkanStandIn::Install() when already installed! Nothing will happen this time!\n" );
+		return;
+	}
+
+	vulkanFunctions_t& functions = gStandIn.mFunctions;
+	functions.vkGetInstanceProcAddr = StandInGetInstanceProcAddr;
+	functions.vkCreateInstance = StandInCreateInstance;
+	functions.vkEnumerateInstanceLayerProperties = StandInEnumerateInstanceLayerProperties;
+	functions.vkDestroyInstance = StandInDestroyInstance;
+	functions.vkEnumeratePhysicalDevices = StandInEnumeratePhysicalDevices;
+	functions.vkEnumerateDeviceExtensionProperties = StandInEnumerateDeviceExtensionProperties;
+	functions.vkEnumerateDeviceLayerProperties = StandInEnumerateDeviceLayerProperties;
+	functions.vkGetPhysicalDeviceProperties = StandInGetPhysicalDeviceProperties;
+	functions.vkGetPhysicalDeviceFeatures = StandInGetPhysicalDeviceFeatures;
+	functions.vkGetPhysicalDeviceMemoryProperties = StandInGetPhysicalDeviceMemoryProperties;
+	functions.vkGetPhysicalDeviceQueueFamilyProperties = StandInGetPhysicalDeviceQueueFamilyProperties;
+	functions.vkGetPhysicalDeviceSurfaceSupportKHR = StandInGetPhysicalDeviceSurfaceSupportKHR;
+	functions.vkGetPhysicalDeviceSurfaceCapabilitiesKHR = StandInGetPhysicalDeviceSurfaceCapabilitiesKHR;
+	functions.vkGetPhysicalDeviceSurfaceFormatsKHR = StandInGetPhysicalDeviceSurfaceFormatsKHR;
+	functions.vkGetPhysicalDeviceSurfacePresentModesKHR = StandInGetPhysicalDeviceSurfacePresentModesKHR;
+	functions.vkDestroySurfaceKHR = StandInDestroySurfaceKHR;
+	functions.vkCreateDevice = StandInCreateDevice;
+	functions.vkGetDeviceProcAddr = StandInGetDeviceProcAddr;
+#ifdef VK_VERSION_1_1
+	functions.vkGetPhysicalDeviceProperties2 = StandInGetPhysicalDeviceProperties2;
+	functions.vkGetPhysicalDeviceFeatures2 = StandInGetPhysicalDeviceFeatures2;
+#endif
+#if MSTD_OS_WINDOWS
+	functions.vkCreateWin32SurfaceKHR = StandInCreateWin32SurfaceKHR;
+#endif
+	functions.vkDestroyDevice = StandInDestroyDevice;
+	functions.vkGetDeviceQueue = StandInGetDeviceQueue;
+	functions.vkDeviceWaitIdle = StandInDeviceWaitIdle;
+	functions.vkQueueSubmit = StandInQueueSubmit;
+	functions.vkQueuePresentKHR = StandInQueuePresentKHR;
+	functions.vkCreateSwapchainKHR = StandInCreateSwapchainKHR;
+	functions.vkDestroySwapchainKHR = StandInDestroySwapchainKHR;
+	functions.vkGetSwapchainImagesKHR = StandInGetSwapchainImagesKHR;
+	functions.vkAcquireNextImageKHR = StandInAcquireNextImageKHR;
+	functions.vkAllocateMemory = StandInAllocateMemory;
+	functions.vkFreeMemory = StandInFreeMemory;
+	functions.vkMapMemory = StandInMapMemory;
+	functions.vkUnmapMemory = StandInUnmapMemory;
+	functions.vkFlushMappedMemoryRanges = StandInFlushMappedMemoryRanges;
+	functions.vkInvalidateMappedMemoryRanges = StandInInvalidateMappedMemoryRanges;
+	functions.vkCreateBuffer = StandInCreateBuffer;
+	functions.vkDestroyBuffer = StandInDestroyBuffer;
+	functions.vkGetBufferMemoryRequirements = StandInGetBufferMemoryRequirements;
+	functions.vkBindBufferMemory = StandInBindBufferMemory;
+	functions.vkCreateImage = StandInCreateImage;
+	functions.vkDestroyImage = StandInDestroyImage;
+	functions.vkGetImageMemoryRequirements = StandInGetImageMemoryRequirements;
+	functions.vkBindImageMemory = StandInBindImageMemory;
+	functions.vkCreateImageView = StandInCreateImageView;
+	functions.vkDestroyImageView = StandInDestroyImageView;
+	functions.vkCreateSampler = StandInCreateSampler;
+	functions.vkDestroySampler = StandInDestroySampler;
+	functions.vkCreateShaderModule = StandInCreateShaderModule;
+	functions.vkDestroyShaderModule = StandInDestroyShaderModule;
+	functions.vkCreateRenderPass = StandInCreateRenderPass;
+	functions.vkDestroyRenderPass = StandInDestroyRenderPass;
+	functions.vkCreateFramebuffer = StandInCreateFramebuffer;
+	functions.vkDestroyFramebuffer = StandInDestroyFramebuffer;
+	functions.vkCreateDescriptorSetLayout = StandInCreateDescriptorSetLayout;
+	functions.vkDestroyDescriptorSetLayout = StandInDestroyDescriptorSetLayout;
+	functions.vkCreateDescriptorPool = StandInCreateDescriptorPool;
+	functions.vkDestroyDescriptorPool = StandInDestroyDescriptorPool;
+	functions.vkResetDescriptorPool = StandInResetDescriptorPool;
+	functions.vkAllocateDescriptorSets = StandInAllocateDescriptorSets;
+	functions.vkUpdateDescriptorSets = StandInUpdateDescriptorSets;
+	functions.vkCreatePipelineLayout = StandInCreatePipelineLayout;
+	functions.vkDestroyPipelineLayout = StandInDestroyPipelineLayout;
+	functions.vkCreatePipelineCache = StandInCreatePipelineCache;
+	functions.vkDestroyPipelineCache = StandInDestroyPipelineCache;
+	functions.vkGetPipelineCacheData = StandInGetPipelineCacheData;
+	functions.vkCreateGraphicsPipelines = StandInCreateGraphicsPipelines;
+	functions.vkDestroyPipeline = StandInDestroyPipeline;
+	functions.vkCreateCommandPool = StandInCreateCommandPool;
+	functions.vkDestroyCommandPool = StandInDestroyCommandPool;
+	functions.vkResetCommandPool = StandInResetCommandPool;
+	functions.vkAllocateCommandBuffers = StandInAllocateCommandBuffers;
+	functions.vkFreeCommandBuffers = StandInFreeCommandBuffers;
+	functions.vkBeginCommandBuffer = StandInBeginCommandBuffer;
+	functions.vkEndCommandBuffer = StandInEndCommandBuffer;
+	functions.vkCreateFence = StandInCreateFence;
+	functions.vkDestroyFence = StandInDestroyFence;
+	functions.vkResetFences = StandInResetFences;
+	functions.vkWaitForFences = StandInWaitForFences;
+	functions.vkCreateSemaphore = StandInCreateSemaphore;
+	functions.vkDestroySemaphore = StandInDestroySemaphore;
+	functions.vkCreateQueryPool = StandInCreateQueryPool;
+	functions.vkDestroyQueryPool = StandInDestroyQueryPool;
+	functions.vkGetQueryPoolResults = StandInGetQueryPoolResults;
+	functions.vkCmdBeginRenderPass = StandInCmdBeginRenderPass;
+	functions.vkCmdEndRenderPass = StandInCmdEndRenderPass;
+	functions.vkCmdExecuteCommands = StandInCmdExecuteCommands;
+	functions.vkCmdBindPipeline = StandInCmdBindPipeline;
+	functions.vkCmdBindDescriptorSets = StandInCmdBindDescriptorSets;
+	functions.vkCmdBindVertexBuffers = StandInCmdBindVertexBuffers;
+	functions.vkCmdBindIndexBuffer = StandInCmdBindIndexBuffer;
+	functions.vkCmdPushConstants = StandInCmdPushConstants;
+	functions.vkCmdSetViewport = StandInCmdSetViewport;
+	functions.vkCmdSetScissor = StandInCmdSetScissor;
+	functions.vkCmdDraw = StandInCmdDraw;
+	functions.vkCmdDrawIndexed = StandInCmdDrawIndexed;
+	functions.vkCmdPipelineBarrier = StandInCmdPipelineBarrier;
+	functions.vkCmdCopyBuffer = StandInCmdCopyBuffer;
+	functions.vkCmdCopyBufferToImage = StandInCmdCopyBufferToImage;
+	functions.vkCmdCopyImageToBuffer = StandInCmdCopyImageToBuffer;
+	functions.vkCmdResetQueryPool = StandInCmdResetQueryPool;
+	functions.vkCmdWriteTimestamp = StandInCmdWriteTimestamp;
+
+	// a function added to the dispatch without a stand-in for it would call through null
+#define YETI_STAND_IN_CHECK_FUNCTION( name )	assertf( functions.name != nullptr, "The Vulkan stand-in doesn't have " #name "()!\n" );
+	YETI_VK_FUNCTIONS( YETI_STAND_IN_CHECK_FUNCTION )
+#undef YETI_STAND_IN_CHECK_FUNCTION
+
+	gStandIn.mDriver = &GetVulkanDriverFunctions();
+	gStandIn.mStats = {};
+	gStandIn.mWantsReplay = replay;
+	gStandIn.mReplay = false;
+	gStandIn.mInstalled = true;
+
+	SetVulkanDispatchOverride( &gStandIn.mFunctions, replay );
+}
+
+/*
+========================
+VulkanStandIn::Uninstall
+========================
+*/
+void VulkanStandIn::Uninstall() {
+	if ( !gStandIn.mInstalled ) {
+		error( "Attempt to call VulkanStandIn::Uninstall() was made when it's not installed!\n" );
+		return;
+	}
+
+	SetVulkanDispatchOverride( nullptr, false );
+
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+
+	// anything still here was never destroyed
+	u32 numLeaked[OBJECT_COUNT] = {};
+	for ( size_t i = 0; i < gStandIn.mTable.length(); i++ ) {
+		object_t* object = gStandIn.mTable[i];
+
+		if ( object && object != &gRemovedObject && !object->mParent ) {
+			numLeaked[object->mType]++;
+		}
+	}
+
+	for ( u32 i = 0; i < OBJECT_COUNT; i++ ) {
+		if ( numLeaked[i] > 0 ) {
+			warning( "Vulkan stand-in: %u %s were never destroyed!\n", numLeaked[i], OBJECT_TYPE_NAMES[i] );
+		}
+	}
+
+	// children first go with their parents
+	for ( size_t i = 0; i < gStandIn.mTable.length(); i++ ) {
+		object_t* object = gStandIn.mTable[i];
+
+		if ( object && object != &gRemovedObject && !object->mParent ) {
+			DeleteObjectLocked( object );
+		}
+	}
+
+	gStandIn.mTable.clear();
+	gStandIn.mNumObjects = 0;
+	gStandIn.mNumRemoved = 0;
+
+	gStandIn.mInstalled = false;
+	gStandIn.mWantsReplay = false;
+	gStandIn.mReplay = false;
+}
+
+/*
+========================
+VulkanStandIn::IsInstalled
+========================
+*/
+bool32 VulkanStandIn::IsInstalled() {
+	return gStandIn.mInstalled;
+}
+
+/*
+========================
+VulkanStandIn::IsReplaying
+========================
+*/
+bool32 VulkanStandIn::IsReplaying() {
+	return gStandIn.mReplay;
+}
+
+/*
+========================
+VulkanStandIn::GetStats
+========================
+*/
+vulkanStandInStats_t VulkanStandIn::GetStats() {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+	return gStandIn.mStats;
+}
+
+/*
+========================
+VulkanStandIn::ResetStats
+========================
+*/
+void VulkanStandIn::ResetStats() {
+	std::lock_guard<std::mutex> lock( gStandIn.mMutex );
+	gStandIn.mStats = {};
+}
+
+/*
+========================
+VulkanStandIn::PrintStats
+========================
+*/
+void VulkanStandIn::PrintStats() {
+	vulkanStandInStats_t stats = GetStats();
+
+	printf( "Vulkan stand-in: %llu submits of %llu command buffers, %llu presents, %llu validation errors.\n", stats.mSubmits, stats.mCommandBuffersSubmitted, stats.mPresents, stats.mValidationErrors );
+	printf( "Vulkan stand-in: %llu commands, %llu draws, %llu pipeline binds, %llu descriptor set binds, %llu buffer binds, %llu push constants.\n",
+		stats.mCommands, stats.mDraws, stats.mPipelineBinds, stats.mDescriptorSetBinds, stats.mBufferBinds, stats.mPushConstants );
+	printf( "Vulkan stand-in: %llu barriers (%llu image), %llu render passes, %llu bytes copied, %llu bytes flushed, %llu descriptor writes, %llu memory allocations.\n",
+		stats.mBarriers, stats.mImageBarriers, stats.mRenderPasses, stats.mBytesCopied, stats.mBytesFlushed, stats.mDescriptorWrites, stats.mMemoryAllocations );
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef __VULKAN_STAND_IN_H__
+#define __VULKAN_STAND_IN_H__
+
+#include <mstd/mstd.h>
+
+#include "VulkanDispatch.h"
+
+// everything the stand-in counted, per command buffer until it's submitted and then added to the totals
+struct vulkanStandInStats_t {
+	// recorded, only counted once the command buffer holding them gets submitted
+	u64									mCommands;				// every vkCmd* call
+	u64									mDraws;
+	u64									mPipelineBinds;
+	u64									mDescriptorSetBinds;	// vkCmdBindDescriptorSets() calls, not sets
+	u64									mBufferBinds;			// vertex and index
+	u64									mPushConstants;
+	u64									mBarriers;				// vkCmdPipelineBarrier() calls
+	u64									mImageBarriers;			// image memory barriers inside them
+	u64									mRenderPasses;
+	u64									mBytesCopied;			// vkCmdCopyBuffer(), vkCmdCopyBufferToImage() and vkCmdCopyImageToBuffer()
+
+	// counted as they happen
+	u64									mSubmits;
+	u64									mCommandBuffersSubmitted;
+	u64									mPresents;
+	u64									mBytesFlushed;			// vkFlushMappedMemoryRanges(), VK_WHOLE_SIZE counts the whole allocation
+	u64									mDescriptorWrites;		// descriptors, not vkUpdateDescriptorSets() calls
+	u64									mMemoryAllocations;
+
+	// bad handles, commands outside of recording, waits on fences nothing will signal
+	u64									mValidationErrors;
+};
+
+/*
+================================================================================================
+
+	Vulkan Stand-In
+
+	Takes the place of the driver through the VulkanDispatch, so everything under gl/ can run
+	on a machine without a GPU. Install() it before the context is created and Uninstall() it
+	once the context is gone.
+
+	Every handle the engine is given is tracked, and every handle it hands back is checked to
+	still be alive and the right type, so use after destroy and leaks get reported even when
+	there's no validation layer. Commands are counted per command buffer and added to the stats
+	when they're submitted, secondaries when they're executed, so GetStats() is what actually
+	went to the GPU and not what got recorded and thrown away.
+
+	When replaying, and there is a driver, each call is passed on to it straight after being
+	checked and counted, so the game runs exactly as it would otherwise with the counts on top.
+	Without a driver every call is answered by the stand-in itself: one device with one queue
+	family and one memory type that's everything at once, memory that's only real once it's
+	mapped, fences that signal as soon as they're submitted, descriptor pools that only ever
+	run out of sets and no extensions past the swap chain and descriptor update templates, so
+	the context always takes the plain render pass path.
+
+	Extension functions the context loads with vkGet*ProcAddr() go straight to the driver and
+	aren't counted, apart from the descriptor update template ones the stand-in answers itself
+	when there's no driver.
+
+	Safe to call from any thread the engine records or creates pipelines on.
+
+================================================================================================
+*/
+
+class VulkanStandIn {
+public:
+	// replay only matters when there's a driver to replay to
+	static void							Install( const bool32 replay );
+	// reports anything that was never destroyed
+	static void							Uninstall();
+	static bool32						IsInstalled();
+
+	// false before the instance is created, or when there's no driver
+	static bool32						IsReplaying();
+
+	static vulkanStandInStats_t			GetStats();
+	static void							ResetStats();
+	static void							PrintStats();
+};
+
+#endif // __VULKAN_STAND_IN_H__
\ No newline at end of file
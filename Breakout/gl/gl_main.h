@@ -2,12 +2,21 @@
 #define __GL_MAIN_H__
 
 // vulkan
-#include <vulkan/vulkan.h>
+#include "VulkanDispatch.h"
 #include "vma/vma.h"
 
 // main systems
 #include "VulkanContext.h"
 #include "StagingManager.h"
+#include "FrameAllocator.h"
+#include "GPUProfiler.h"
+#include "CommandRecorder.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+#include "BindlessTable.h"
+#include "PipelineCache.h"
+#include "RenderStateManager.h"
+#include "FrameReadback.h"
 
 // data objects
 #include "Buffer.h"
@@ -3,6 +3,7 @@
 #pragma warning( disable : 4127 4100 4189 )
 
 #define VMA_IMPLEMENTATION
+#define VMA_STATIC_VULKAN_FUNCTIONS 0
 #include "vma/vma.h"
 
 #pragma warning( pop )
\ No newline at end of file
@@ -3,25 +3,47 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
-layout( location = 0 ) in vec3 in_position;
+// two clockwise triangles, MUST match Renderer::QUAD_VERTICES
+const vec2 corners[6] = vec2[](
+	vec2( -1.0, 1.0 ), vec2( 1.0, 1.0 ), vec2( 1.0, -1.0 ),
+	vec2( -1.0, 1.0 ), vec2( 1.0, -1.0 ), vec2( -1.0, -1.0 )
+);
+
+// MUST match quadInstance_t, the half size is two packed halves
+struct quad_instance_t {
+	vec2 position;
+	uint half_size;
+	uint material;
+};
 
 layout( binding = 0 ) uniform UBO_static {
 	mat4 view_projection;
 } ubo_static;
 
-layout( binding = 1 ) uniform UBO_dynamic {
-	mat4 model;
-	vec4 color;
-	vec2 scale;
-} ubo_dynamic;
+// MUST match RENDERER_PALETTE_SIZE
+layout( binding = 1 ) uniform UBO_palette {
+	vec4 colors[512];
+} ubo_palette;
+
+layout( binding = 2 ) readonly buffer SSBO_instances {
+	quad_instance_t instances[];
+} ssbo_instances;
+
+layout( location = 0 ) out vec4 out_color;
 
 out gl_PerVertex {
 	vec4 gl_Position;
 };
 
 void main() {
-	vec3 position_vertex = in_position * vec3( ubo_dynamic.scale, 1.0 );
+	// every instance is one quad, the vertex index picks its corner
+	quad_instance_t instance = ssbo_instances.instances[gl_InstanceIndex];
+	vec2 corner = corners[gl_VertexIndex];
+	vec2 half_size = unpackHalf2x16( instance.half_size );
+
+	// the high 16 bits are a bindless texture, which this shader doesn't have
+	out_color = ubo_palette.colors[instance.material & 0xFFFFu];
 
-	mat4 mvp = ubo_static.view_projection * ubo_dynamic.model;
-	gl_Position = mvp * vec4( position_vertex, 1.0 );
+	vec2 position_world = corner * half_size + instance.position;
+	gl_Position = ubo_static.view_projection * vec4( position_world, 1.0, 1.0 );
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout( location = 0 ) in vec4 in_color;
+layout( location = 1 ) in vec2 in_uv;
+layout( location = 2 ) flat in uint in_texture;
+
+// the bindless table's textures, MUST match BindlessTable::MAX_TEXTURES
+layout( set = 1, binding = 0 ) uniform sampler2D textures[4096];
+
+layout( location = 0 ) out vec4 out_color;
+
+void main() {
+	// quads in the same draw can all have different textures
+	out_color = in_color * texture( textures[nonuniformEXT( in_texture )], in_uv );
+}
\ No newline at end of file
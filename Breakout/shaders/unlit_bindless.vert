@@ -0,0 +1,56 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+// two clockwise triangles, MUST match Renderer::QUAD_VERTICES
+const vec2 corners[6] = vec2[](
+	vec2( -1.0, 1.0 ), vec2( 1.0, 1.0 ), vec2( 1.0, -1.0 ),
+	vec2( -1.0, 1.0 ), vec2( 1.0, -1.0 ), vec2( -1.0, -1.0 )
+);
+
+// MUST match quadInstance_t, the half size is two packed halves
+struct quad_instance_t {
+	vec2 position;
+	uint half_size;
+	uint material;
+};
+
+layout( set = 0, binding = 0 ) uniform UBO_static {
+	mat4 view_projection;
+} ubo_static;
+
+// the bindless table's buffers, MUST match BindlessTable::MAX_BUFFERS
+layout( set = 1, binding = 1 ) readonly buffer SSBO_palette {
+	vec4 colors[];
+} buffers[256];
+
+layout( push_constant ) uniform PC_quads {
+	uint palette_buffer;
+} pc_quads;
+
+layout( set = 0, binding = 2 ) readonly buffer SSBO_instances {
+	quad_instance_t instances[];
+} ssbo_instances;
+
+layout( location = 0 ) out vec4 out_color;
+layout( location = 1 ) out vec2 out_uv;
+layout( location = 2 ) flat out uint out_texture;
+
+out gl_PerVertex {
+	vec4 gl_Position;
+};
+
+void main() {
+	// every instance is one quad, the vertex index picks its corner
+	quad_instance_t instance = ssbo_instances.instances[gl_InstanceIndex];
+	vec2 corner = corners[gl_VertexIndex];
+	vec2 half_size = unpackHalf2x16( instance.half_size );
+
+	out_color = buffers[pc_quads.palette_buffer].colors[instance.material & 0xFFFFu];
+	out_uv = corner * vec2( 0.5, -0.5 ) + 0.5;
+	out_texture = instance.material >> 16;
+
+	vec2 position_world = corner * half_size + instance.position;
+	gl_Position = ubo_static.view_projection * vec4( position_world, 1.0, 1.0 );
+}
\ No newline at end of file